@@ -0,0 +1,141 @@
+/* 
+ * File:   AssetCache.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 18 października 2026, 22:55
+ */
+
+#include "AssetCache.h"
+#include "Device.h"
+#include "Texture.h"
+#include "Material.h"
+#include "TextureStreamer.h"
+#include "FileSystem.h"
+
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace zvlk {
+
+    AssetCache::AssetCache(zvlk::Device* device) {
+        this->device = device;
+    }
+
+    AssetCache::~AssetCache() {
+        for (auto& sampler : this->samplers) {
+            this->device->getGraphicsDevice().destroy(sampler.second);
+        }
+    }
+
+    uint64_t AssetCache::hash(const void* content, size_t size) {
+        // FNV-1a
+        const uint8_t* bytes = static_cast<const uint8_t*> (content);
+        uint64_t result = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i) {
+            result ^= bytes[i];
+            result *= 1099511628211ULL;
+        }
+        return result;
+    }
+
+    std::shared_ptr<Texture> AssetCache::getTexture(const std::string& path) {
+        // names may point into mounted archives, so they are only normalized lexically
+        std::string normalizedPath = std::filesystem::path(path).lexically_normal().generic_string();
+
+        std::shared_ptr<Texture> texture = this->texturesByPath[normalizedPath].lock();
+        if (texture) {
+            this->statistics.textureHits++;
+            this->statistics.bytesSaved += texture->getSize();
+            return texture;
+        }
+
+        // a cooked compressed sibling takes the place of the source image
+        std::string source = Texture::findCooked(this->device, normalizedPath);
+        if (source.empty()) {
+            source = normalizedPath;
+        }
+        Blob content = this->device->getFileSystem()->read(source);
+
+        uint64_t contentHash = AssetCache::hash(content.getData(), content.getSize());
+        auto& byContent = this->texturesByContent[contentHash];
+        if (byContent.first == content.getSize()) {
+            texture = byContent.second.lock();
+        }
+        if (texture) {
+            this->statistics.textureHits++;
+            this->statistics.bytesSaved += texture->getSize();
+        } else {
+            TextureStreamer* streamer = this->device->getTextureStreamer();
+            if (streamer->isEnabled()) {
+                // the streamer keeps the encoded image until it is decoded, so it gets its own copy
+                texture = std::make_shared<Texture>(this->device,
+                        std::vector<unsigned char>(content.getData(), content.getData() + content.getSize()), streamer);
+            } else {
+                texture = std::make_shared<Texture>(this->device, content.getData(), content.getSize());
+            }
+            byContent = {content.getSize(), texture};
+            this->statistics.texturesLoaded++;
+        }
+        this->texturesByPath[normalizedPath] = texture;
+        return texture;
+    }
+
+    std::shared_ptr<Material> AssetCache::getMaterial(std::shared_ptr<Frame> frame, const std::string& name,
+            glm::vec4 ambient, glm::vec4 diffuse, glm::vec4 specular, float shiness, const std::string& diffuseTextureName) {
+        // materials are equal when everything uploaded to the device is, names are irrelevant
+        // exact bits of every float, so colors differing in any digit are other materials
+        std::ostringstream key;
+        key << std::hexfloat;
+        for (const glm::vec4& color : {ambient, diffuse, specular}) {
+            key << color.x << ',' << color.y << ',' << color.z << ',' << color.w << ';';
+        }
+        key << shiness << ';' << std::filesystem::path(diffuseTextureName).lexically_normal().generic_string();
+
+        std::shared_ptr<Material> material = this->materials[key.str()].lock();
+        if (material) {
+            this->statistics.materialHits++;
+            this->statistics.bytesSaved += material->getSize() * frame->getImagesNumber();
+            return material;
+        }
+
+        material = std::make_shared<Material>(this->device, frame, name, ambient, diffuse, specular, shiness, diffuseTextureName);
+        this->materials[key.str()] = material;
+        this->statistics.materialsCreated++;
+        return material;
+    }
+
+    vk::Sampler AssetCache::getSampler(const vk::SamplerCreateInfo& samplerInfo) {
+        for (auto& sampler : this->samplers) {
+            if (sampler.first == samplerInfo) {
+                this->statistics.samplerHits++;
+                return sampler.second;
+            }
+        }
+
+        vk::Sampler sampler = this->device->getGraphicsDevice().createSampler(samplerInfo);
+        this->samplers.push_back({samplerInfo, sampler});
+        this->statistics.samplersCreated++;
+        return sampler;
+    }
+
+    void AssetCache::reportMemory(std::ostream& output) const {
+        std::set<const Texture*> reported;
+        vk::DeviceSize total = 0, rgba = 0;
+        for (auto& entry : this->texturesByPath) {
+            std::shared_ptr<Texture> texture = entry.second.lock();
+            if (!texture || !reported.insert(texture.get()).second) {
+                continue;
+            }
+            output << entry.first << ": " << texture->getWidth() << "x" << texture->getHeight() << " "
+                    << vk::to_string(texture->getFormat()) << ", " << texture->getLevelsNumber() << " levels, "
+                    << texture->getSize() / 1024 << " KiB" << std::endl;
+            total += texture->getSize();
+            // what the image would have taken as uncompressed RGBA with its full chain, a third more than the base level
+            rgba += static_cast<vk::DeviceSize> (texture->getWidth()) * texture->getHeight() * 4 * 4 / 3;
+        }
+        output << "Textures: " << reported.size() << ", " << total / 1024 << " KiB of device memory, "
+                << rgba / 1024 << " KiB as RGBA" << std::endl;
+    }
+}
@@ -0,0 +1,395 @@
+/* 
+ * File:   BatchMath.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 18 października 2026, 21:05
+ */
+
+#include "BatchMath.h"
+
+#include <glm/mat3x3.hpp>
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ZVLK_X86
+#include <immintrin.h>
+#endif
+
+namespace zvlk {
+
+    namespace {
+
+        // ----- scalar -----
+
+        void multiplyScalar(const float* a, size_t aStride, const float* b, float* result, size_t count) {
+            for (size_t i = 0; i < count; ++i, a += aStride, b += 16, result += 16) {
+                // read whole before any column is written, as the vector paths do, so result may be a
+                float left[16];
+                std::copy(a, a + 16, left);
+                float column[4];
+                for (int j = 0; j < 4; ++j) {
+                    for (int r = 0; r < 4; ++r) {
+                        column[r] = left[r] * b[4 * j] + left[4 + r] * b[4 * j + 1] + left[8 + r] * b[4 * j + 2] + left[12 + r] * b[4 * j + 3];
+                    }
+                    for (int r = 0; r < 4; ++r) {
+                        result[4 * j + r] = column[r];
+                    }
+                }
+            }
+        }
+
+        void normalMatricesScalar(const glm::mat4* matrices, glm::mat4* normals, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                normals[i] = glm::mat4(glm::transpose(glm::inverse(glm::mat3(matrices[i]))));
+            }
+        }
+
+        void transformBoundsScalar(const glm::mat4* matrices, const Bounds* bounds, BoundsSoA& result, size_t offset, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                const glm::mat4& m = matrices[i];
+                glm::vec3 center = (bounds[i].min + bounds[i].max) * 0.5f;
+                glm::vec3 extent = (bounds[i].max - bounds[i].min) * 0.5f;
+                glm::vec3 newCenter = glm::vec3(m * glm::vec4(center, 1.0f));
+                glm::vec3 newExtent = glm::abs(glm::vec3(m[0])) * extent.x + glm::abs(glm::vec3(m[1])) * extent.y
+                        + glm::abs(glm::vec3(m[2])) * extent.z;
+                size_t j = offset + i;
+                result.minX[j] = newCenter.x - newExtent.x;
+                result.minY[j] = newCenter.y - newExtent.y;
+                result.minZ[j] = newCenter.z - newExtent.z;
+                result.maxX[j] = newCenter.x + newExtent.x;
+                result.maxY[j] = newCenter.y + newExtent.y;
+                result.maxZ[j] = newCenter.z + newExtent.z;
+            }
+        }
+
+        inline bool isBoxVisible(const glm::vec4 planes[6], const BoundsSoA& bounds, size_t i) {
+            for (int p = 0; p < 6; ++p) {
+                const glm::vec4& plane = planes[p];
+                float distance = std::max(plane.x * bounds.minX[i], plane.x * bounds.maxX[i])
+                        + std::max(plane.y * bounds.minY[i], plane.y * bounds.maxY[i])
+                        + std::max(plane.z * bounds.minZ[i], plane.z * bounds.maxZ[i]) + plane.w;
+                if (distance < 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void testFrustumScalar(const glm::vec4 planes[6], const BoundsSoA& bounds, uint8_t* visible, size_t begin) {
+            for (size_t i = begin; i < bounds.size(); ++i) {
+                visible[i] = isBoxVisible(planes, bounds, i) ? 1 : 0;
+            }
+        }
+
+#ifdef ZVLK_X86
+        // ----- SSE4.1 -----
+
+        __attribute__((target("sse4.1")))
+        void multiplySse(const float* a, size_t aStride, const float* b, float* result, size_t count) {
+            for (size_t i = 0; i < count; ++i, a += aStride, b += 16, result += 16) {
+                __m128 a0 = _mm_loadu_ps(a), a1 = _mm_loadu_ps(a + 4), a2 = _mm_loadu_ps(a + 8), a3 = _mm_loadu_ps(a + 12);
+                for (int j = 0; j < 4; ++j) {
+                    __m128 column = _mm_loadu_ps(b + 4 * j);
+                    __m128 x = _mm_mul_ps(a0, _mm_shuffle_ps(column, column, 0x00));
+                    x = _mm_add_ps(x, _mm_mul_ps(a1, _mm_shuffle_ps(column, column, 0x55)));
+                    x = _mm_add_ps(x, _mm_mul_ps(a2, _mm_shuffle_ps(column, column, 0xAA)));
+                    x = _mm_add_ps(x, _mm_mul_ps(a3, _mm_shuffle_ps(column, column, 0xFF)));
+                    _mm_storeu_ps(result + 4 * j, x);
+                }
+            }
+        }
+
+        __attribute__((target("sse4.1")))
+        inline __m128 crossSse(__m128 x, __m128 y) {
+            __m128 xYzx = _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 yYzx = _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 0, 2, 1));
+            __m128 c = _mm_sub_ps(_mm_mul_ps(x, yYzx), _mm_mul_ps(xYzx, y));
+            return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        __attribute__((target("sse4.1")))
+        void normalMatricesSse(const glm::mat4* matrices, glm::mat4* normals, size_t count) {
+            const __m128 lastColumn = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+            const __m128 xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+            for (size_t i = 0; i < count; ++i) {
+                const float* m = &matrices[i][0][0];
+                __m128 m0 = _mm_and_ps(_mm_loadu_ps(m), xyzMask);
+                __m128 m1 = _mm_and_ps(_mm_loadu_ps(m + 4), xyzMask);
+                __m128 m2 = _mm_and_ps(_mm_loadu_ps(m + 8), xyzMask);
+
+                // inverse transpose is the cofactor matrix divided by the determinant
+                __m128 c0 = crossSse(m1, m2);
+                __m128 c1 = crossSse(m2, m0);
+                __m128 c2 = crossSse(m0, m1);
+                __m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.0f), _mm_dp_ps(m0, c0, 0x7F));
+
+                float* n = &normals[i][0][0];
+                _mm_storeu_ps(n, _mm_mul_ps(c0, inverseDeterminant));
+                _mm_storeu_ps(n + 4, _mm_mul_ps(c1, inverseDeterminant));
+                _mm_storeu_ps(n + 8, _mm_mul_ps(c2, inverseDeterminant));
+                _mm_storeu_ps(n + 12, lastColumn);
+            }
+        }
+
+        __attribute__((target("sse4.1")))
+        void transformBoundsSse(const glm::mat4* matrices, const Bounds* bounds, BoundsSoA& result, size_t offset, size_t count) {
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            for (size_t i = 0; i < count; ++i) {
+                const float* m = &matrices[i][0][0];
+                const Bounds& box = bounds[i];
+                __m128 m0 = _mm_loadu_ps(m), m1 = _mm_loadu_ps(m + 4), m2 = _mm_loadu_ps(m + 8), m3 = _mm_loadu_ps(m + 12);
+
+                __m128 center = _mm_add_ps(m3, _mm_mul_ps(m0, _mm_set1_ps(0.5f * (box.min.x + box.max.x))));
+                center = _mm_add_ps(center, _mm_mul_ps(m1, _mm_set1_ps(0.5f * (box.min.y + box.max.y))));
+                center = _mm_add_ps(center, _mm_mul_ps(m2, _mm_set1_ps(0.5f * (box.min.z + box.max.z))));
+                __m128 extent = _mm_mul_ps(_mm_and_ps(m0, absMask), _mm_set1_ps(0.5f * (box.max.x - box.min.x)));
+                extent = _mm_add_ps(extent, _mm_mul_ps(_mm_and_ps(m1, absMask), _mm_set1_ps(0.5f * (box.max.y - box.min.y))));
+                extent = _mm_add_ps(extent, _mm_mul_ps(_mm_and_ps(m2, absMask), _mm_set1_ps(0.5f * (box.max.z - box.min.z))));
+
+                alignas(16) float minimum[4], maximum[4];
+                _mm_store_ps(minimum, _mm_sub_ps(center, extent));
+                _mm_store_ps(maximum, _mm_add_ps(center, extent));
+                size_t j = offset + i;
+                result.minX[j] = minimum[0];
+                result.minY[j] = minimum[1];
+                result.minZ[j] = minimum[2];
+                result.maxX[j] = maximum[0];
+                result.maxY[j] = maximum[1];
+                result.maxZ[j] = maximum[2];
+            }
+        }
+
+        __attribute__((target("sse4.1")))
+        void testFrustumSse(const glm::vec4 planes[6], const BoundsSoA& bounds, uint8_t* visible, size_t begin) {
+            size_t i = begin;
+            for (; i + 4 <= bounds.size(); i += 4) {
+                __m128 minX = _mm_loadu_ps(&bounds.minX[i]), minY = _mm_loadu_ps(&bounds.minY[i]), minZ = _mm_loadu_ps(&bounds.minZ[i]);
+                __m128 maxX = _mm_loadu_ps(&bounds.maxX[i]), maxY = _mm_loadu_ps(&bounds.maxY[i]), maxZ = _mm_loadu_ps(&bounds.maxZ[i]);
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int p = 0; p < 6; ++p) {
+                    __m128 px = _mm_set1_ps(planes[p].x), py = _mm_set1_ps(planes[p].y), pz = _mm_set1_ps(planes[p].z);
+                    __m128 distance = _mm_max_ps(_mm_mul_ps(px, minX), _mm_mul_ps(px, maxX));
+                    distance = _mm_add_ps(distance, _mm_max_ps(_mm_mul_ps(py, minY), _mm_mul_ps(py, maxY)));
+                    distance = _mm_add_ps(distance, _mm_max_ps(_mm_mul_ps(pz, minZ), _mm_mul_ps(pz, maxZ)));
+                    distance = _mm_add_ps(distance, _mm_set1_ps(planes[p].w));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+                }
+                int bits = _mm_movemask_ps(inside);
+                for (int k = 0; k < 4; ++k) {
+                    visible[i + k] = (bits >> k) & 1;
+                }
+            }
+            testFrustumScalar(planes, bounds, visible, i);
+        }
+
+        // ----- AVX2 -----
+
+        __attribute__((target("avx2,fma")))
+        void multiplyAvx2(const float* a, size_t aStride, const float* b, float* result, size_t count) {
+            for (size_t i = 0; i < count; ++i, a += aStride, b += 16, result += 16) {
+                __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*> (a));
+                __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*> (a + 4));
+                __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*> (a + 8));
+                __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*> (a + 12));
+                // two result columns per iteration, one in each 128-bit lane
+                for (int j = 0; j < 4; j += 2) {
+                    __m256 columns = _mm256_loadu_ps(b + 4 * j);
+                    __m256 x = _mm256_mul_ps(a0, _mm256_permute_ps(columns, 0x00));
+                    x = _mm256_fmadd_ps(a1, _mm256_permute_ps(columns, 0x55), x);
+                    x = _mm256_fmadd_ps(a2, _mm256_permute_ps(columns, 0xAA), x);
+                    x = _mm256_fmadd_ps(a3, _mm256_permute_ps(columns, 0xFF), x);
+                    _mm256_storeu_ps(result + 4 * j, x);
+                }
+            }
+        }
+
+        __attribute__((target("avx2,fma")))
+        inline __m256 crossAvx2(__m256 x, __m256 y) {
+            __m256 xYzx = _mm256_shuffle_ps(x, x, _MM_SHUFFLE(3, 0, 2, 1));
+            __m256 yYzx = _mm256_shuffle_ps(y, y, _MM_SHUFFLE(3, 0, 2, 1));
+            __m256 c = _mm256_fmsub_ps(x, yYzx, _mm256_mul_ps(xYzx, y));
+            return _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+        }
+
+        __attribute__((target("avx2,fma")))
+        void normalMatricesAvx2(const glm::mat4* matrices, glm::mat4* normals, size_t count) {
+            const __m256 lastColumn = _mm256_setr_ps(0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+            const __m256 xyzMask = _mm256_castsi256_ps(_mm256_setr_epi32(-1, -1, -1, 0, -1, -1, -1, 0));
+            size_t i = 0;
+            // two matrices per iteration, one in each 128-bit lane
+            for (; i + 2 <= count; i += 2) {
+                const float* m = &matrices[i][0][0];
+                const float* k = &matrices[i + 1][0][0];
+                __m256 m0 = _mm256_and_ps(_mm256_loadu2_m128(k, m), xyzMask);
+                __m256 m1 = _mm256_and_ps(_mm256_loadu2_m128(k + 4, m + 4), xyzMask);
+                __m256 m2 = _mm256_and_ps(_mm256_loadu2_m128(k + 8, m + 8), xyzMask);
+
+                __m256 c0 = crossAvx2(m1, m2);
+                __m256 c1 = crossAvx2(m2, m0);
+                __m256 c2 = crossAvx2(m0, m1);
+                __m256 inverseDeterminant = _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_dp_ps(m0, c0, 0x7F));
+
+                float* n = &normals[i][0][0];
+                float* l = &normals[i + 1][0][0];
+                _mm256_storeu2_m128(l, n, _mm256_mul_ps(c0, inverseDeterminant));
+                _mm256_storeu2_m128(l + 4, n + 4, _mm256_mul_ps(c1, inverseDeterminant));
+                _mm256_storeu2_m128(l + 8, n + 8, _mm256_mul_ps(c2, inverseDeterminant));
+                _mm256_storeu2_m128(l + 12, n + 12, lastColumn);
+            }
+            normalMatricesSse(matrices + i, normals + i, count - i);
+        }
+
+        __attribute__((target("avx2,fma")))
+        void testFrustumAvx2(const glm::vec4 planes[6], const BoundsSoA& bounds, uint8_t* visible, size_t begin) {
+            size_t i = begin;
+            for (; i + 8 <= bounds.size(); i += 8) {
+                __m256 minX = _mm256_loadu_ps(&bounds.minX[i]), minY = _mm256_loadu_ps(&bounds.minY[i]), minZ = _mm256_loadu_ps(&bounds.minZ[i]);
+                __m256 maxX = _mm256_loadu_ps(&bounds.maxX[i]), maxY = _mm256_loadu_ps(&bounds.maxY[i]), maxZ = _mm256_loadu_ps(&bounds.maxZ[i]);
+                __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                for (int p = 0; p < 6; ++p) {
+                    __m256 px = _mm256_set1_ps(planes[p].x), py = _mm256_set1_ps(planes[p].y), pz = _mm256_set1_ps(planes[p].z);
+                    __m256 distance = _mm256_add_ps(_mm256_set1_ps(planes[p].w), _mm256_max_ps(_mm256_mul_ps(px, minX), _mm256_mul_ps(px, maxX)));
+                    distance = _mm256_add_ps(distance, _mm256_max_ps(_mm256_mul_ps(py, minY), _mm256_mul_ps(py, maxY)));
+                    distance = _mm256_add_ps(distance, _mm256_max_ps(_mm256_mul_ps(pz, minZ), _mm256_mul_ps(pz, maxZ)));
+                    inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+                }
+                int bits = _mm256_movemask_ps(inside);
+                for (int k = 0; k < 8; ++k) {
+                    visible[i + k] = (bits >> k) & 1;
+                }
+            }
+            testFrustumSse(planes, bounds, visible, i);
+        }
+#endif
+
+        BatchMathIsa detectIsa() {
+#ifdef ZVLK_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+                return BatchMathIsa::eAvx2;
+            }
+            if (__builtin_cpu_supports("sse4.1")) {
+                return BatchMathIsa::eSse;
+            }
+#endif
+            return BatchMathIsa::eScalar;
+        }
+
+        const BatchMathIsa supportedIsa = detectIsa();
+        // read by scene graph workers while the main thread may switch it
+        std::atomic<BatchMathIsa> currentIsa(supportedIsa);
+    }
+
+    BatchMathIsa BatchMath::getIsa() {
+        return currentIsa.load(std::memory_order_relaxed);
+    }
+
+    void BatchMath::setIsa(BatchMathIsa isa) {
+        if (static_cast<int> (isa) > static_cast<int> (supportedIsa)) {
+            throw std::invalid_argument("instruction set is not supported by this processor");
+        }
+        currentIsa.store(isa, std::memory_order_relaxed);
+    }
+
+    void BatchMath::multiply(const glm::mat4* a, const glm::mat4* b, glm::mat4* result, size_t count) {
+        const float* first = &a[0][0][0];
+        const float* second = &b[0][0][0];
+        float* output = &result[0][0][0];
+        switch (currentIsa.load(std::memory_order_relaxed)) {
+#ifdef ZVLK_X86
+            case BatchMathIsa::eAvx2:
+                return multiplyAvx2(first, 16, second, output, count);
+            case BatchMathIsa::eSse:
+                return multiplySse(first, 16, second, output, count);
+#endif
+            default:
+                return multiplyScalar(first, 16, second, output, count);
+        }
+    }
+
+    void BatchMath::multiply(const glm::mat4& a, const glm::mat4* b, glm::mat4* result, size_t count) {
+        // copy, so that a may be one of the results
+        glm::mat4 left = a;
+        const float* first = &left[0][0];
+        const float* second = &b[0][0][0];
+        float* output = &result[0][0][0];
+        switch (currentIsa.load(std::memory_order_relaxed)) {
+#ifdef ZVLK_X86
+            case BatchMathIsa::eAvx2:
+                return multiplyAvx2(first, 0, second, output, count);
+            case BatchMathIsa::eSse:
+                return multiplySse(first, 0, second, output, count);
+#endif
+            default:
+                return multiplyScalar(first, 0, second, output, count);
+        }
+    }
+
+    void BatchMath::normalMatrices(const glm::mat4* matrices, glm::mat4* normals, size_t count) {
+        switch (currentIsa.load(std::memory_order_relaxed)) {
+#ifdef ZVLK_X86
+            case BatchMathIsa::eAvx2:
+                return normalMatricesAvx2(matrices, normals, count);
+            case BatchMathIsa::eSse:
+                return normalMatricesSse(matrices, normals, count);
+#endif
+            default:
+                return normalMatricesScalar(matrices, normals, count);
+        }
+    }
+
+    void BatchMath::transformBounds(const glm::mat4* matrices, const Bounds* bounds, BoundsSoA& result, size_t offset, size_t count) {
+        if (result.size() < offset + count) {
+            result.resize(offset + count);
+        }
+        switch (currentIsa.load(std::memory_order_relaxed)) {
+#ifdef ZVLK_X86
+            case BatchMathIsa::eAvx2:
+            case BatchMathIsa::eSse:
+                return transformBoundsSse(matrices, bounds, result, offset, count);
+#endif
+            default:
+                return transformBoundsScalar(matrices, bounds, result, offset, count);
+        }
+    }
+
+    void BatchMath::extractFrustumPlanes(const glm::mat4& viewProj, glm::vec4 planes[6]) {
+        glm::vec4 rows[4];
+        for (int r = 0; r < 4; ++r) {
+            rows[r] = glm::vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]);
+        }
+
+        planes[0] = rows[3] + rows[0]; // left
+        planes[1] = rows[3] - rows[0]; // right
+        planes[2] = rows[3] + rows[1]; // bottom
+        planes[3] = rows[3] - rows[1]; // top
+        planes[4] = rows[2]; // near, depth is 0..1
+        planes[5] = rows[3] - rows[2]; // far
+
+        for (int p = 0; p < 6; ++p) {
+            float length = std::sqrt(planes[p].x * planes[p].x + planes[p].y * planes[p].y + planes[p].z * planes[p].z);
+            // degenerate matrices give planes without a normal, those are left unnormalized
+            if (length > 0.0f) {
+                planes[p] = planes[p] / length;
+            }
+        }
+    }
+
+    void BatchMath::testFrustum(const glm::vec4 planes[6], const BoundsSoA& bounds, uint8_t* visible) {
+        switch (currentIsa.load(std::memory_order_relaxed)) {
+#ifdef ZVLK_X86
+            case BatchMathIsa::eAvx2:
+                return testFrustumAvx2(planes, bounds, visible, 0);
+            case BatchMathIsa::eSse:
+                return testFrustumSse(planes, bounds, visible, 0);
+#endif
+            default:
+                return testFrustumScalar(planes, bounds, visible, 0);
+        }
+    }
+}
@@ -0,0 +1,378 @@
+/* 
+ * File:   BlockCompressor.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 18 października 2026, 23:35
+ */
+
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace zvlk {
+
+    namespace {
+
+        const int BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        const int ETC_MODIFIERS[8][2] = {
+            {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+        };
+
+        inline int clampByte(int value) {
+            return std::min(std::max(value, 0), 255);
+        }
+
+        inline void writeBits(uint8_t* output, uint32_t& position, uint32_t value, uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i, ++position) {
+                if (value & (1u << i)) {
+                    output[position >> 3] |= static_cast<uint8_t> (1u << (position & 7));
+                }
+            }
+        }
+
+        template<typename Compress>
+        std::vector<uint8_t> compressBlocks(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockSize,
+                void (*fetch)(const uint8_t*, uint32_t, uint32_t, uint32_t, uint32_t, uint8_t*), Compress compress) {
+            uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+            std::vector<uint8_t> result(static_cast<size_t> (blocksX) * blocksY * blockSize, 0);
+            uint8_t block[64];
+            for (uint32_t y = 0; y < blocksY; ++y) {
+                for (uint32_t x = 0; x < blocksX; ++x) {
+                    fetch(rgba, width, height, x, y, block);
+                    compress(block, &result[(static_cast<size_t> (y) * blocksX + x) * blockSize]);
+                }
+            }
+            return result;
+        }
+    }
+
+    void BlockCompressor::fetchBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t block[64]) {
+        // blocks hanging over the edge repeat the last row and column
+        for (uint32_t y = 0; y < 4; ++y) {
+            uint32_t sourceY = std::min(blockY * 4 + y, height - 1);
+            for (uint32_t x = 0; x < 4; ++x) {
+                uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                std::memcpy(&block[(y * 4 + x) * 4], &rgba[(static_cast<size_t> (sourceY) * width + sourceX) * 4], 4);
+            }
+        }
+    }
+
+    void BlockCompressor::principalAxis(const uint8_t block[64], uint32_t channels, float minimum[4], float maximum[4]) {
+        float mean[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (uint32_t i = 0; i < 16; ++i) {
+            for (uint32_t c = 0; c < channels; ++c) {
+                mean[c] += block[i * 4 + c] / 16.0f;
+            }
+        }
+
+        float covariance[4][4] = {};
+        for (uint32_t i = 0; i < 16; ++i) {
+            for (uint32_t a = 0; a < channels; ++a) {
+                for (uint32_t b = 0; b < channels; ++b) {
+                    covariance[a][b] += (block[i * 4 + a] - mean[a]) * (block[i * 4 + b] - mean[b]);
+                }
+            }
+        }
+
+        // power iteration towards the dominant eigenvector
+        float axis[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            float next[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            float length = 0.0f;
+            for (uint32_t a = 0; a < channels; ++a) {
+                for (uint32_t b = 0; b < channels; ++b) {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+                length += next[a] * next[a];
+            }
+            if (length < 1e-12f) {
+                break;
+            }
+            length = std::sqrt(length);
+            for (uint32_t a = 0; a < channels; ++a) {
+                axis[a] = next[a] / length;
+            }
+        }
+
+        float lowest = 0.0f, highest = 0.0f;
+        for (uint32_t i = 0; i < 16; ++i) {
+            float t = 0.0f;
+            for (uint32_t c = 0; c < channels; ++c) {
+                t += (block[i * 4 + c] - mean[c]) * axis[c];
+            }
+            lowest = std::min(lowest, t);
+            highest = std::max(highest, t);
+        }
+        for (uint32_t c = 0; c < channels; ++c) {
+            minimum[c] = std::min(std::max(mean[c] + lowest * axis[c], 0.0f), 255.0f);
+            maximum[c] = std::min(std::max(mean[c] + highest * axis[c], 0.0f), 255.0f);
+        }
+    }
+
+    std::vector<uint8_t> BlockCompressor::compressBc1(const uint8_t* rgba, uint32_t width, uint32_t height) {
+        return compressBlocks(rgba, width, height, 8, &BlockCompressor::fetchBlock, &BlockCompressor::encodeBc1Block);
+    }
+
+    std::vector<uint8_t> BlockCompressor::compressBc7(const uint8_t* rgba, uint32_t width, uint32_t height) {
+        return compressBlocks(rgba, width, height, 16, &BlockCompressor::fetchBlock, &BlockCompressor::encodeBc7Block);
+    }
+
+    std::vector<uint8_t> BlockCompressor::compressEtc2(const uint8_t* rgba, uint32_t width, uint32_t height) {
+        return compressBlocks(rgba, width, height, 8, &BlockCompressor::fetchBlock, &BlockCompressor::encodeEtc2Block);
+    }
+
+    void BlockCompressor::encodeBc1Block(const uint8_t block[64], uint8_t* output) {
+        float minimum[4], maximum[4];
+        principalAxis(block, 3, minimum, maximum);
+
+        auto pack = [](const float color[4]) {
+            uint32_t r = static_cast<uint32_t> (std::lround(color[0] * 31.0f / 255.0f));
+            uint32_t g = static_cast<uint32_t> (std::lround(color[1] * 63.0f / 255.0f));
+            uint32_t b = static_cast<uint32_t> (std::lround(color[2] * 31.0f / 255.0f));
+            return static_cast<uint16_t> ((r << 11) | (g << 5) | b);
+        };
+        uint16_t color0 = pack(maximum), color1 = pack(minimum);
+        if (color0 < color1) {
+            std::swap(color0, color1);
+        }
+
+        uint32_t indices = 0;
+        if (color0 != color1) {
+            // color0 > color1 selects the four color mode
+            int palette[4][3];
+            for (int i = 0; i < 2; ++i) {
+                uint16_t color = i == 0 ? color0 : color1;
+                uint32_t r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+                palette[i][0] = (r << 3) | (r >> 2);
+                palette[i][1] = (g << 2) | (g >> 4);
+                palette[i][2] = (b << 3) | (b >> 2);
+            }
+            for (int c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+
+            for (uint32_t i = 0; i < 16; ++i) {
+                int best = 0, bestError = INT32_MAX;
+                for (int p = 0; p < 4; ++p) {
+                    int error = 0;
+                    for (int c = 0; c < 3; ++c) {
+                        int difference = block[i * 4 + c] - palette[p][c];
+                        error += difference * difference;
+                    }
+                    if (error < bestError) {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint32_t> (best) << (2 * i);
+            }
+        }
+
+        output[0] = color0 & 0xFF;
+        output[1] = color0 >> 8;
+        output[2] = color1 & 0xFF;
+        output[3] = color1 >> 8;
+        for (int i = 0; i < 4; ++i) {
+            output[4 + i] = (indices >> (8 * i)) & 0xFF;
+        }
+    }
+
+    void BlockCompressor::encodeBc7Block(const uint8_t block[64], uint8_t* output) {
+        float minimum[4], maximum[4];
+        principalAxis(block, 4, minimum, maximum);
+
+        // 7 bit endpoints with a per endpoint parity bit, the one closer to the unquantized color wins
+        uint32_t endpoints[2][4];
+        uint32_t parities[2];
+        const float* sources[2] = {minimum, maximum};
+        for (int e = 0; e < 2; ++e) {
+            float bestError = 1e30f;
+            for (uint32_t p = 0; p < 2; ++p) {
+                uint32_t quantized[4];
+                float error = 0.0f;
+                for (int c = 0; c < 4; ++c) {
+                    int q = static_cast<int> (std::lround((sources[e][c] - p) / 2.0f));
+                    quantized[c] = static_cast<uint32_t> (std::min(std::max(q, 0), 127));
+                    float difference = static_cast<float> ((quantized[c] << 1) | p) - sources[e][c];
+                    error += difference * difference;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    parities[e] = p;
+                    std::memcpy(endpoints[e], quantized, sizeof (quantized));
+                }
+            }
+        }
+
+        int palette[16][4];
+        for (int c = 0; c < 4; ++c) {
+            int first = static_cast<int> ((endpoints[0][c] << 1) | parities[0]);
+            int second = static_cast<int> ((endpoints[1][c] << 1) | parities[1]);
+            for (int w = 0; w < 16; ++w) {
+                palette[w][c] = ((64 - BC7_WEIGHTS[w]) * first + BC7_WEIGHTS[w] * second + 32) >> 6;
+            }
+        }
+
+        uint32_t indices[16];
+        for (uint32_t i = 0; i < 16; ++i) {
+            int bestError = INT32_MAX;
+            for (uint32_t w = 0; w < 16; ++w) {
+                int error = 0;
+                for (int c = 0; c < 4; ++c) {
+                    int difference = block[i * 4 + c] - palette[w][c];
+                    error += difference * difference;
+                }
+                if (error < bestError) {
+                    bestError = error;
+                    indices[i] = w;
+                }
+            }
+        }
+
+        // the anchor index is stored without its top bit, so it has to be below 8
+        if (indices[0] >= 8) {
+            std::swap(endpoints[0], endpoints[1]);
+            std::swap(parities[0], parities[1]);
+            for (uint32_t& index : indices) {
+                index = 15 - index;
+            }
+        }
+
+        std::memset(output, 0, 16);
+        uint32_t position = 0;
+        writeBits(output, position, 1u << 6, 7);
+        for (int c = 0; c < 4; ++c) {
+            writeBits(output, position, endpoints[0][c], 7);
+            writeBits(output, position, endpoints[1][c], 7);
+        }
+        writeBits(output, position, parities[0], 1);
+        writeBits(output, position, parities[1], 1);
+        writeBits(output, position, indices[0], 3);
+        for (uint32_t i = 1; i < 16; ++i) {
+            writeBits(output, position, indices[i], 4);
+        }
+    }
+
+    void BlockCompressor::encodeEtc2Block(const uint8_t block[64], uint8_t* output) {
+        uint64_t bestBlock = 0;
+        int64_t bestError = INT64_MAX;
+
+        for (uint32_t flip = 0; flip < 2; ++flip) {
+            // pixels of both sub-blocks, as indices into the block
+            uint32_t subBlocks[2][8];
+            uint32_t counts[2] = {0, 0};
+            float averages[2][3] = {};
+            for (uint32_t y = 0; y < 4; ++y) {
+                for (uint32_t x = 0; x < 4; ++x) {
+                    uint32_t sub = flip ? (y >= 2) : (x >= 2);
+                    subBlocks[sub][counts[sub]++] = y * 4 + x;
+                    for (int c = 0; c < 3; ++c) {
+                        averages[sub][c] += block[(y * 4 + x) * 4 + c] / 8.0f;
+                    }
+                }
+            }
+
+            for (uint32_t differential = 0; differential < 2; ++differential) {
+                int bases[2][3];
+                int codes[2][3];
+                bool valid = true;
+                for (int sub = 0; sub < 2; ++sub) {
+                    for (int c = 0; c < 3; ++c) {
+                        if (differential) {
+                            codes[sub][c] = static_cast<int> (std::lround(averages[sub][c] * 31.0f / 255.0f));
+                            bases[sub][c] = (codes[sub][c] << 3) | (codes[sub][c] >> 2);
+                        } else {
+                            codes[sub][c] = static_cast<int> (std::lround(averages[sub][c] * 15.0f / 255.0f));
+                            bases[sub][c] = (codes[sub][c] << 4) | codes[sub][c];
+                        }
+                    }
+                }
+                if (differential) {
+                    // an out of range delta would be decoded as one of the ETC2 only modes
+                    for (int c = 0; c < 3; ++c) {
+                        int delta = codes[1][c] - codes[0][c];
+                        valid = valid && delta >= -4 && delta <= 3;
+                    }
+                    if (!valid) {
+                        continue;
+                    }
+                }
+
+                int64_t error = 0;
+                uint32_t tables[2];
+                uint32_t modifiers[16];
+                for (int sub = 0; sub < 2; ++sub) {
+                    int64_t bestTableError = INT64_MAX;
+                    for (uint32_t table = 0; table < 8; ++table) {
+                        int64_t tableError = 0;
+                        uint32_t tableModifiers[8];
+                        for (uint32_t p = 0; p < 8; ++p) {
+                            const uint8_t* pixel = &block[subBlocks[sub][p] * 4];
+                            int bestPixelError = INT32_MAX;
+                            for (uint32_t m = 0; m < 4; ++m) {
+                                int modifier = (m & 2 ? -1 : 1) * ETC_MODIFIERS[table][m & 1];
+                                int pixelError = 0;
+                                for (int c = 0; c < 3; ++c) {
+                                    int difference = clampByte(bases[sub][c] + modifier) - pixel[c];
+                                    pixelError += difference * difference;
+                                }
+                                if (pixelError < bestPixelError) {
+                                    bestPixelError = pixelError;
+                                    tableModifiers[p] = m;
+                                }
+                            }
+                            tableError += bestPixelError;
+                        }
+                        if (tableError < bestTableError) {
+                            bestTableError = tableError;
+                            tables[sub] = table;
+                            for (uint32_t p = 0; p < 8; ++p) {
+                                modifiers[subBlocks[sub][p]] = tableModifiers[p];
+                            }
+                        }
+                    }
+                    error += bestTableError;
+                }
+
+                if (error >= bestError) {
+                    continue;
+                }
+                bestError = error;
+
+                uint64_t bits = 0;
+                for (int c = 0; c < 3; ++c) {
+                    uint64_t shift = 59 - 8 * c;
+                    if (differential) {
+                        bits |= static_cast<uint64_t> (codes[0][c]) << shift;
+                        bits |= static_cast<uint64_t> ((codes[1][c] - codes[0][c]) & 7) << (shift - 3);
+                    } else {
+                        bits |= static_cast<uint64_t> (codes[0][c]) << (shift + 1);
+                        bits |= static_cast<uint64_t> (codes[1][c]) << (shift - 3);
+                    }
+                }
+                bits |= static_cast<uint64_t> (tables[0]) << 37;
+                bits |= static_cast<uint64_t> (tables[1]) << 34;
+                bits |= static_cast<uint64_t> (differential) << 33;
+                bits |= static_cast<uint64_t> (flip) << 32;
+                // pixels are numbered column by column, most significant index bits come first
+                for (uint32_t y = 0; y < 4; ++y) {
+                    for (uint32_t x = 0; x < 4; ++x) {
+                        uint32_t m = modifiers[y * 4 + x];
+                        uint32_t bit = x * 4 + y;
+                        bits |= static_cast<uint64_t> (m >> 1) << (16 + bit);
+                        bits |= static_cast<uint64_t> (m & 1) << bit;
+                    }
+                }
+                bestBlock = bits;
+            }
+        }
+
+        for (int i = 0; i < 8; ++i) {
+            output[i] = static_cast<uint8_t> (bestBlock >> (56 - 8 * i));
+        }
+    }
+}
@@ -6,9 +6,11 @@
  */
 
 #include "Camera.h"
+#include "BatchMath.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/vec4.hpp>
+#include <glm/matrix.hpp>
 
 namespace zvlk {
 
@@ -19,6 +21,12 @@ namespace zvlk {
     UniformBuffer(device, sizeof (CameraUBO), frame), eye(eye), center(center), fov(fov), up(up), near(near), far(far) {
         this->ubos.resize(frame->getImagesNumber());
         this->frame = frame;
+        // until the first update nothing is culled
+        for (glm::vec4& plane : this->frustumPlanes) {
+            plane = glm::vec4(0.0f);
+        }
+        this->view = glm::mat4(1.0f);
+        this->projection = glm::mat4(1.0f);
     }
 
     void* Camera::update(uint32_t index, float time) {
@@ -26,10 +34,19 @@ namespace zvlk {
         this->ubos[index].proj = glm::perspective(fov, this->frame->getWidth() / (float) this->frame->getHeight(), near, far);
         this->ubos[index].eye = this->eye;
         this->ubos[index].center = this->center;
+        this->ubos[index].viewProj = this->ubos[index].proj * this->ubos[index].view;
+        this->ubos[index].invViewProj = glm::inverse(this->ubos[index].viewProj);
+        BatchMath::extractFrustumPlanes(this->ubos[index].viewProj, this->frustumPlanes);
+        this->view = this->ubos[index].view;
+        this->projection = this->ubos[index].proj;
 
         return &this->ubos[index];
     }
     
+    void Camera::resize(uint32_t imagesNumber) {
+        this->ubos.resize(imagesNumber);
+    }
+
     Camera& Camera::rotateEye(float angle, glm::vec3 axis) {
         eye = glm::rotate(glm::mat4(1.0f), glm::radians(angle), axis) * glm::vec4(eye, 1.0f);
         return *this;
@@ -0,0 +1,62 @@
+/* 
+ * File:   CommandRecorder.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 03:20
+ */
+
+#include "CommandRecorder.h"
+
+#include <stdexcept>
+
+namespace zvlk {
+
+    CommandRecorder::CommandRecorder(vk::CommandBuffer commandBuffer, vk::PipelineLayout pipelineLayout) {
+        this->commandBuffer = commandBuffer;
+        this->pipelineLayout = pipelineLayout;
+    }
+
+    void CommandRecorder::bindPipeline(vk::Pipeline pipeline) {
+        if (this->pipeline == pipeline) {
+            this->statistics.bindsSkipped++;
+            return;
+        }
+        this->commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+        this->pipeline = pipeline;
+        this->statistics.pipelineBinds++;
+    }
+
+    void CommandRecorder::bindDescriptorSet(uint32_t set, vk::DescriptorSet descriptorSet) {
+        if (set >= RECORDER_MAX_SETS) {
+            throw std::runtime_error("descriptor set number out of range");
+        }
+        if (this->descriptorSets[set] == descriptorSet) {
+            this->statistics.bindsSkipped++;
+            return;
+        }
+        this->commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->pipelineLayout, set, 1, &descriptorSet, 0, nullptr);
+        this->descriptorSets[set] = descriptorSet;
+        this->statistics.descriptorSetBinds++;
+    }
+
+    void CommandRecorder::bindVertexBuffer(vk::Buffer buffer) {
+        if (this->vertexBuffer == buffer) {
+            this->statistics.bindsSkipped++;
+            return;
+        }
+        vk::DeviceSize offset = 0;
+        this->commandBuffer.bindVertexBuffers(0, 1, &buffer, &offset);
+        this->vertexBuffer = buffer;
+        this->statistics.bufferBinds++;
+    }
+
+    void CommandRecorder::bindIndexBuffer(vk::Buffer buffer) {
+        if (this->indexBuffer == buffer) {
+            this->statistics.bindsSkipped++;
+            return;
+        }
+        this->commandBuffer.bindIndexBuffer(buffer, 0, vk::IndexType::eUint32);
+        this->indexBuffer = buffer;
+        this->statistics.bufferBinds++;
+    }
+}
@@ -0,0 +1,18 @@
+/* 
+ * File:   ComputeShader.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 00:30
+ */
+
+#include "ComputeShader.h"
+
+namespace zvlk {
+
+    ComputeShader::~ComputeShader() {
+    }
+
+    ComputeShader::ComputeShader(vk::Device device, const Blob& code) : Shader(device, code, vk::ShaderStageFlagBits::eCompute) {
+    }
+}
+
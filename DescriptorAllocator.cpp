@@ -0,0 +1,228 @@
+/* 
+ * File:   DescriptorAllocator.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 03:50
+ */
+
+#include "DescriptorAllocator.h"
+#include "Device.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+
+// sets of the first pool, every next one holds twice as many up to the maximum
+#define FIRST_POOL_SETS 64
+#define MAX_POOL_SETS 4096
+
+namespace zvlk {
+
+    namespace {
+
+        bool isImage(vk::DescriptorType type) {
+            return type == vk::DescriptorType::eCombinedImageSampler || type == vk::DescriptorType::eSampledImage
+                    || type == vk::DescriptorType::eStorageImage || type == vk::DescriptorType::eInputAttachment;
+        }
+    }
+
+    DescriptorAllocator::DescriptorAllocator(zvlk::Device* device) {
+        this->device = device;
+        this->graphicsDevice = device->getGraphicsDevice();
+        this->setsPerPool = FIRST_POOL_SETS;
+        this->resets = 0;
+        this->createDescriptorUpdateTemplate = nullptr;
+        this->destroyDescriptorUpdateTemplate = nullptr;
+        this->updateDescriptorSetWithTemplate = nullptr;
+        if (device->isExtensionEnabled(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME)) {
+            VkDevice handle = this->graphicsDevice;
+            this->createDescriptorUpdateTemplate = reinterpret_cast<PFN_vkCreateDescriptorUpdateTemplateKHR> (
+                    vkGetDeviceProcAddr(handle, "vkCreateDescriptorUpdateTemplateKHR"));
+            this->destroyDescriptorUpdateTemplate = reinterpret_cast<PFN_vkDestroyDescriptorUpdateTemplateKHR> (
+                    vkGetDeviceProcAddr(handle, "vkDestroyDescriptorUpdateTemplateKHR"));
+            this->updateDescriptorSetWithTemplate = reinterpret_cast<PFN_vkUpdateDescriptorSetWithTemplateKHR> (
+                    vkGetDeviceProcAddr(handle, "vkUpdateDescriptorSetWithTemplateKHR"));
+        }
+    }
+
+    DescriptorAllocator::~DescriptorAllocator() {
+        for (auto& layout : this->layouts) {
+            if (layout.second.updateTemplate != VK_NULL_HANDLE) {
+                this->destroyDescriptorUpdateTemplate(this->graphicsDevice, layout.second.updateTemplate, nullptr);
+            }
+        }
+        for (vk::DescriptorPool pool : this->usedPools) {
+            this->graphicsDevice.destroy(pool);
+        }
+        for (vk::DescriptorPool pool : this->freePools) {
+            this->graphicsDevice.destroy(pool);
+        }
+    }
+
+    void DescriptorAllocator::registerLayout(vk::DescriptorSetLayout layout, const std::vector<vk::DescriptorSetLayoutBinding>& bindings) {
+        RegisteredLayout registered = {
+            {},
+            {}, VK_NULL_HANDLE
+        };
+        std::vector<VkDescriptorUpdateTemplateEntryKHR> entries;
+        for (size_t i = 0; i < bindings.size(); ++i) {
+            if (bindings[i].descriptorCount != 1) {
+                throw std::runtime_error("registered layouts have one descriptor per binding");
+            }
+            registered.bindings.push_back(bindings[i].binding);
+            registered.types.push_back(bindings[i].descriptorType);
+            // infos are read straight out of the vector written with
+            size_t offset = i * sizeof (DescriptorInfo)
+                    + (isImage(bindings[i].descriptorType) ? offsetof(DescriptorInfo, image) : offsetof(DescriptorInfo, buffer));
+            entries.push_back({bindings[i].binding, 0, 1, static_cast<VkDescriptorType> (bindings[i].descriptorType), offset, sizeof (DescriptorInfo)});
+        }
+
+        if (this->createDescriptorUpdateTemplate != nullptr) {
+            VkDescriptorUpdateTemplateCreateInfoKHR templateInfo = {};
+            templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR;
+            templateInfo.descriptorUpdateEntryCount = static_cast<uint32_t> (entries.size());
+            templateInfo.pDescriptorUpdateEntries = entries.data();
+            templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+            templateInfo.descriptorSetLayout = layout;
+            if (this->createDescriptorUpdateTemplate(this->graphicsDevice, &templateInfo, nullptr, &registered.updateTemplate) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create descriptor update template!");
+            }
+        }
+        this->layouts[layout] = registered;
+    }
+
+    vk::DescriptorSet DescriptorAllocator::allocate(vk::DescriptorSetLayout layout) {
+        return this->allocateFromPools(layout);
+    }
+
+    vk::DescriptorSet DescriptorAllocator::get(vk::DescriptorSetLayout layout, const std::vector<DescriptorInfo>& infos) {
+        vk::DescriptorSet set = this->cache.find(layout, infos);
+        if (set) {
+            this->statistics.setsShared++;
+            return set;
+        }
+
+        set = this->allocateFromPools(layout);
+        this->write(set, layout, infos);
+        this->cache.insert(layout, infos, set);
+        return set;
+    }
+
+    void DescriptorAllocator::write(vk::DescriptorSet set, vk::DescriptorSetLayout layout, const std::vector<DescriptorInfo>& infos) {
+        auto registered = this->layouts.find(layout);
+        if (registered == this->layouts.end() || registered->second.types.size() != infos.size()) {
+            throw std::runtime_error("writing descriptors of an unregistered layout");
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        if (registered->second.updateTemplate != VK_NULL_HANDLE) {
+            this->updateDescriptorSetWithTemplate(this->graphicsDevice, set, registered->second.updateTemplate, infos.data());
+        } else {
+            std::vector<vk::WriteDescriptorSet> writes;
+            for (size_t i = 0; i < infos.size(); ++i) {
+                vk::DescriptorType type = registered->second.types[i];
+                writes.push_back(vk::WriteDescriptorSet(set, registered->second.bindings[i], 0, 1, type,
+                        isImage(type) ? &infos[i].image : nullptr, isImage(type) ? nullptr : &infos[i].buffer,{}));
+            }
+            this->graphicsDevice.updateDescriptorSets(writes,{});
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        this->statistics.writeMilliseconds += std::chrono::duration<double, std::chrono::milliseconds::period>(end - start).count();
+        this->statistics.setsWritten++;
+
+        this->cache.update(set, layout, infos);
+    }
+
+    void DescriptorAllocator::release(vk::DescriptorSetLayout layout, vk::DescriptorSet set) {
+        if (!this->cache.release(set)) {
+            return;
+        }
+        // pools are not created for freeing single sets, the next allocation of the layout rewrites it
+        // once frames which may bind it are complete
+        uint64_t resets = this->resets;
+        this->device->deferDestruction([this, layout, set, resets]() {
+            // a reset in the meantime has freed it with its pool
+            if (resets == this->resets) {
+                this->released[layout].push_back(set);
+            }
+        });
+    }
+
+    void DescriptorAllocator::reset() {
+        // sets of frames in flight stay valid until those complete
+        std::vector<vk::DescriptorPool> pools;
+        pools.swap(this->usedPools);
+        this->device->deferDestruction([this, pools]() {
+            for (vk::DescriptorPool pool : pools) {
+                // allocations made while these were pending created pools of the grown size, the smaller
+                // ones would only split the next allocations over more pools
+                if (this->poolSets[pool] < this->setsPerPool) {
+                    this->poolSets.erase(pool);
+                    this->graphicsDevice.destroy(pool);
+                    this->statistics.pools--;
+                } else {
+                    this->graphicsDevice.resetDescriptorPool(pool);
+                    this->freePools.push_back(pool);
+                }
+            }
+        });
+        this->resets++;
+        this->currentPool = nullptr;
+        this->cache.clear();
+        this->released.clear();
+    }
+
+    vk::DescriptorPool DescriptorAllocator::createPool() {
+        // enough of every type used by the engine layouts for a mix of scene, model and material sets
+        std::array<vk::DescriptorPoolSize, 5> poolSizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eUniformBuffer, 2 * this->setsPerPool),
+            vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, this->setsPerPool),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 3 * this->setsPerPool),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, this->setsPerPool),
+            vk::DescriptorPoolSize(vk::DescriptorType::eInputAttachment, 4 * this->setsPerPool)
+        };
+        vk::DescriptorPool pool = this->graphicsDevice.createDescriptorPool(vk::DescriptorPoolCreateInfo({}, this->setsPerPool,
+                static_cast<uint32_t> (poolSizes.size()), poolSizes.data()));
+        this->poolSets[pool] = this->setsPerPool;
+        this->setsPerPool = std::min(this->setsPerPool * 2, static_cast<uint32_t> (MAX_POOL_SETS));
+        this->statistics.pools++;
+        return pool;
+    }
+
+    vk::DescriptorSet DescriptorAllocator::allocateFromPools(vk::DescriptorSetLayout layout) {
+        vk::DescriptorSet set;
+        auto released = this->released.find(layout);
+        if (released != this->released.end() && !released->second.empty()) {
+            set = released->second.back();
+            released->second.pop_back();
+            this->statistics.setsRecycled++;
+            return set;
+        }
+
+        if (this->currentPool) {
+            vk::DescriptorSetAllocateInfo allocInfo(this->currentPool, 1, &layout);
+            if (this->graphicsDevice.allocateDescriptorSets(&allocInfo, &set) == vk::Result::eSuccess) {
+                this->statistics.setsAllocated++;
+                return set;
+            }
+        }
+
+        // the current pool is full, a recycled one is taken before a new one is created
+        if (this->freePools.empty()) {
+            this->currentPool = this->createPool();
+        } else {
+            this->currentPool = this->freePools.back();
+            this->freePools.pop_back();
+        }
+        this->usedPools.push_back(this->currentPool);
+
+        vk::DescriptorSetAllocateInfo allocInfo(this->currentPool, 1, &layout);
+        if (this->graphicsDevice.allocateDescriptorSets(&allocInfo, &set) != vk::Result::eSuccess) {
+            throw std::runtime_error("failed to allocate descriptor set!");
+        }
+        this->statistics.setsAllocated++;
+        return set;
+    }
+}
@@ -0,0 +1,110 @@
+/* 
+ * File:   DescriptorCache.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 20 października 2026, 01:00
+ */
+
+#include "DescriptorCache.h"
+
+#include <functional>
+
+namespace zvlk {
+
+    namespace {
+
+        void combine(size_t& seed, uint64_t value) {
+            seed ^= std::hash<uint64_t>()(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        }
+    }
+
+    vk::DescriptorSet DescriptorCache::find(vk::DescriptorSetLayout layout, const std::vector<DescriptorInfo>& infos) {
+        auto found = this->sets.find(DescriptorCache::hash(layout, infos));
+        if (found != this->sets.end()) {
+            for (CachedSet& cached : found->second) {
+                if (cached.layout == layout && cached.infos == infos) {
+                    cached.users++;
+                    return cached.set;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    void DescriptorCache::insert(vk::DescriptorSetLayout layout, const std::vector<DescriptorInfo>& infos, vk::DescriptorSet set) {
+        size_t key = DescriptorCache::hash(layout, infos);
+        this->sets[key].push_back({layout, infos, set, 1});
+        this->hashes[set] = key;
+    }
+
+    void DescriptorCache::update(vk::DescriptorSet set, vk::DescriptorSetLayout layout, const std::vector<DescriptorInfo>& infos) {
+        auto cachedHash = this->hashes.find(set);
+        if (cachedHash == this->hashes.end()) {
+            return;
+        }
+        size_t key = DescriptorCache::hash(layout, infos);
+        if (key != cachedHash->second) {
+            uint32_t users = this->remove(set);
+            this->sets[key].push_back({layout, infos, set, users});
+            this->hashes[set] = key;
+        } else {
+            for (CachedSet& cached : this->sets[key]) {
+                if (cached.set == set) {
+                    cached.layout = layout;
+                    cached.infos = infos;
+                }
+            }
+        }
+    }
+
+    bool DescriptorCache::release(vk::DescriptorSet set) {
+        auto cachedHash = this->hashes.find(set);
+        if (cachedHash == this->hashes.end()) {
+            return true;
+        }
+        for (CachedSet& cached : this->sets[cachedHash->second]) {
+            if (cached.set == set && --cached.users > 0) {
+                return false;
+            }
+        }
+        this->remove(set);
+        return true;
+    }
+
+    void DescriptorCache::clear() {
+        this->sets.clear();
+        this->hashes.clear();
+    }
+
+    uint32_t DescriptorCache::remove(vk::DescriptorSet set) {
+        auto cachedHash = this->hashes.find(set);
+        std::vector<CachedSet>& bucket = this->sets[cachedHash->second];
+        uint32_t users = 0;
+        for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+            if (it->set == set) {
+                users = it->users;
+                bucket.erase(it);
+                break;
+            }
+        }
+        if (bucket.empty()) {
+            this->sets.erase(cachedHash->second);
+        }
+        this->hashes.erase(cachedHash);
+        return users;
+    }
+
+    size_t DescriptorCache::hash(vk::DescriptorSetLayout layout, const std::vector<DescriptorInfo>& infos) {
+        size_t seed = 0;
+        combine(seed, (uint64_t) static_cast<VkDescriptorSetLayout> (layout));
+        for (const DescriptorInfo& info : infos) {
+            combine(seed, (uint64_t) static_cast<VkSampler> (info.image.sampler));
+            combine(seed, (uint64_t) static_cast<VkImageView> (info.image.imageView));
+            combine(seed, static_cast<uint64_t> (info.image.imageLayout));
+            combine(seed, (uint64_t) static_cast<VkBuffer> (info.buffer.buffer));
+            combine(seed, info.buffer.offset);
+            combine(seed, info.buffer.range);
+        }
+        return seed;
+    }
+}
@@ -6,10 +6,16 @@
  */
 
 #include "Device.h"
+#include "AssetCache.h"
+#include "TextureStreamer.h"
+#include "MipmapGenerator.h"
+#include "FileSystem.h"
 
+#include <array>
 #include <iomanip>
 #include <set>
 #include <tuple>
+#include <iterator>
 #include <string.h>
 
 template<typename T> void printProperty(std::ostream& os, const char* name, T value, const int& width) {
@@ -20,6 +26,10 @@ namespace zvlk {
 
     Device::Device(vk::PhysicalDevice physicalDevice) {
         this->physicalDevice = physicalDevice;
+        this->assetCache = nullptr;
+        this->textureStreamer = nullptr;
+        this->mipmapGenerator = nullptr;
+        this->fileSystem = new zvlk::FileSystem();
 
         this->deviceProperties = this->physicalDevice.getProperties();
         this->deviceFeatures = this->physicalDevice.getFeatures();
@@ -56,23 +66,38 @@ namespace zvlk {
         vk::PhysicalDeviceFeatures deviceFeatures;
         deviceFeatures.samplerAnisotropy = VK_TRUE;
         deviceFeatures.sampleRateShading = VK_TRUE;
+        // levels of the compute mipmap generator are an array indexed in a loop
+        deviceFeatures.shaderStorageImageArrayDynamicIndexing = this->deviceFeatures.shaderStorageImageArrayDynamicIndexing;
+        // fragment invocations of a frame are counted when available
+        deviceFeatures.pipelineStatisticsQuery = this->deviceFeatures.pipelineStatisticsQuery;
+
+        // descriptor sets of fixed layouts are written through templates when available
+        this->enabledExtensions = deviceExtensions;
+        if (this->doesSupportExtensions({VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME})) {
+            this->enabledExtensions.push_back(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
+        }
 
         vk::DeviceCreateInfo createInfo({}, static_cast<uint32_t> (queueCreateInfos.size()),
                 queueCreateInfos.data(),
                 static_cast<uint32_t> (validationLayers.size()),
                 validationLayers.data(),
-                static_cast<uint32_t> (deviceExtensions.size()),
-                deviceExtensions.data(),
+                static_cast<uint32_t> (this->enabledExtensions.size()),
+                this->enabledExtensions.data(),
                 &deviceFeatures);
 
         this->graphicsDevice = this->physicalDevice.createDevice(createInfo);
 
         this->graphicsQueue = this->graphicsDevice.getQueue(indices.graphicsFamily, 0);
         this->presentQueue = this->graphicsDevice.getQueue(indices.presentFamily, 0);
+        this->timestampValidBits = this->queueFamilies[indices.graphicsFamily].timestampValidBits;
 
+        // frame command buffers are recorded again every frame
         this->commandPool = this->graphicsDevice.createCommandPool({
-            {}, indices.graphicsFamily
+            vk::CommandPoolCreateFlagBits::eResetCommandBuffer, indices.graphicsFamily
         });
+        this->assetCache = new zvlk::AssetCache(this);
+        this->textureStreamer = new zvlk::TextureStreamer(this);
+        this->mipmapGenerator = new zvlk::MipmapGenerator(this);
 
         std::shared_ptr<zvlk::Frame> result(new zvlk::Frame(this, (VkSurfaceKHR) surface));
         return result;
@@ -118,11 +143,27 @@ namespace zvlk {
         return requiredExtensions.empty();
     }
 
+    bool Device::isExtensionEnabled(const std::string& extension) const {
+        for (const char* enabled : this->enabledExtensions) {
+            if (extension == enabled) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     bool Device::doesSupportGraphics(vk::SurfaceKHR surface) {
         return this->findQueueFamilies(surface).isComplete();
     }
 
     Device::~Device() {
+        if (this->graphicsDevice) {
+            this->waitIdle();
+        }
+        delete this->mipmapGenerator;
+        delete this->textureStreamer;
+        delete this->assetCache;
+        delete this->fileSystem;
         if (this->graphicsDevice) {
             if (this->commandPool) {
                 this->graphicsDevice.destroy(this->commandPool);
@@ -136,25 +177,18 @@ namespace zvlk {
     }
 
     vk::SampleCountFlagBits Device::getMaxUsableSampleCount() {
+        return this->getUsableSampleCount(vk::SampleCountFlagBits::e64);
+    }
+
+    vk::SampleCountFlagBits Device::getUsableSampleCount(vk::SampleCountFlagBits requested) {
         vk::SampleCountFlags counts = this->deviceProperties.limits.framebufferColorSampleCounts &
                 this->deviceProperties.limits.framebufferDepthSampleCounts;
-        if (counts & vk::SampleCountFlagBits::e64) {
-            return vk::SampleCountFlagBits::e64;
-        }
-        if (counts & vk::SampleCountFlagBits::e32) {
-            return vk::SampleCountFlagBits::e32;
-        }
-        if (counts & vk::SampleCountFlagBits::e16) {
-            return vk::SampleCountFlagBits::e16;
-        }
-        if (counts & vk::SampleCountFlagBits::e8) {
-            return vk::SampleCountFlagBits::e8;
-        }
-        if (counts & vk::SampleCountFlagBits::e4) {
-            return vk::SampleCountFlagBits::e4;
-        }
-        if (counts & vk::SampleCountFlagBits::e2) {
-            return vk::SampleCountFlagBits::e2;
+        const std::array<vk::SampleCountFlagBits, 6> candidates = {vk::SampleCountFlagBits::e64, vk::SampleCountFlagBits::e32,
+            vk::SampleCountFlagBits::e16, vk::SampleCountFlagBits::e8, vk::SampleCountFlagBits::e4, vk::SampleCountFlagBits::e2};
+        for (vk::SampleCountFlagBits candidate : candidates) {
+            if (static_cast<uint32_t> (candidate) <= static_cast<uint32_t> (requested) && (counts & candidate)) {
+                return candidate;
+            }
         }
 
         return vk::SampleCountFlagBits::e1;
@@ -244,8 +278,8 @@ namespace zvlk {
     void Device::createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
             vk::SampleCountFlagBits numSamples,
             vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-            vk::MemoryPropertyFlags properties, vk::Image& image, vk::DeviceMemory& imageMemory) {
-        vk::ImageCreateInfo imageInfo({}, vk::ImageType::e2D, format, vk::Extent3D(width, height, 1), mipLevels, 1, numSamples, tiling, usage, vk::SharingMode::eExclusive);
+            vk::MemoryPropertyFlags properties, vk::Image& image, vk::DeviceMemory& imageMemory, vk::ImageCreateFlags flags) {
+        vk::ImageCreateInfo imageInfo(flags, vk::ImageType::e2D, format, vk::Extent3D(width, height, 1), mipLevels, 1, numSamples, tiling, usage, vk::SharingMode::eExclusive);
         image = this->graphicsDevice.createImage(imageInfo);
 
         vk::MemoryRequirements memRequirements = this->graphicsDevice.getImageMemoryRequirements(image);
@@ -254,8 +288,26 @@ namespace zvlk {
         this->graphicsDevice.bindImageMemory(image, imageMemory, 0);
     }
 
-    vk::ImageView Device::createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels) {
-        vk::ImageViewCreateInfo viewInfo({}, image, vk::ImageViewType::e2D, format, vk::ComponentMapping(),
+    bool Device::createTransientImage(uint32_t width, uint32_t height, vk::SampleCountFlagBits numSamples, vk::Format format,
+            vk::ImageUsageFlags usage, vk::Image& image, vk::DeviceMemory& imageMemory) {
+        vk::ImageCreateInfo imageInfo({}, vk::ImageType::e2D, format, vk::Extent3D(width, height, 1), 1, 1, numSamples,
+                vk::ImageTiling::eOptimal, usage | vk::ImageUsageFlagBits::eTransientAttachment, vk::SharingMode::eExclusive);
+        image = this->graphicsDevice.createImage(imageInfo);
+
+        // desktop devices usually offer no lazily allocated memory, the image is then an ordinary one
+        vk::MemoryRequirements memRequirements = this->graphicsDevice.getImageMemoryRequirements(image);
+        vk::MemoryPropertyFlags lazyProperties = vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated;
+        bool lazilyAllocated = this->hasMemoryType(memRequirements.memoryTypeBits, lazyProperties);
+        vk::MemoryAllocateInfo allocInfo(memRequirements.size, this->findMemoryType(memRequirements.memoryTypeBits,
+                lazilyAllocated ? lazyProperties : vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal)));
+        imageMemory = this->graphicsDevice.allocateMemory(allocInfo);
+        this->graphicsDevice.bindImageMemory(image, imageMemory, 0);
+        return lazilyAllocated;
+    }
+
+    vk::ImageView Device::createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels,
+            vk::ComponentMapping components) {
+        vk::ImageViewCreateInfo viewInfo({}, image, vk::ImageViewType::e2D, format, components,
                 vk::ImageSubresourceRange(aspectFlags, 0, mipLevels, 0, 1));
 
         return this->graphicsDevice.createImageView(viewInfo);
@@ -293,15 +345,15 @@ namespace zvlk {
     }
 
     void Device::freeMemory(vk::Buffer buffer, vk::DeviceMemory memory) {
-        this->graphicsDevice.destroy(buffer);
-        this->graphicsDevice.freeMemory(memory);
+        this->destroyLater(buffer);
+        this->destroyLater(memory);
     }
 
     void Device::freeMemory(std::vector<vk::Buffer> buffers, vk::DeviceMemory memory) {
         for (vk::Buffer& buffer : buffers) {
-            this->graphicsDevice.destroy(buffer);
+            this->destroyLater(buffer);
         }
-        this->graphicsDevice.freeMemory(memory);
+        this->destroyLater(memory);
     }
 
     void Device::copyBufferToImage(vk::Buffer buffer, vk::Image image, uint32_t width, uint32_t height) {
@@ -326,6 +378,15 @@ namespace zvlk {
         throw std::runtime_error("failed to find suitable memory type!");
     }
 
+    bool Device::hasMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) {
+        for (uint32_t i = 0; i < this->memoryProperties.memoryTypeCount; i++) {
+            if ((typeFilter & (1 << i)) && (this->memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return true;
+            }
+        }
+        return false;
+    }
+
     vk::CommandBuffer Device::beginSingleTimeCommands() {
         vk::CommandBufferAllocateInfo allocInfo(this->commandPool, vk::CommandBufferLevel::ePrimary, 1);
         vk::CommandBuffer commandBuffer = this->graphicsDevice.allocateCommandBuffers(allocInfo)[0];
@@ -360,6 +421,61 @@ namespace zvlk {
         this->graphicsQueue.submit(1, submitInfo, fence);
     }
 
+    void Device::submitFrame(vk::SubmitInfo* submitInfo, vk::Fence fence) {
+        // a fence is reset only after it has been waited for, so its last frame and every earlier one are complete
+        for (auto it = this->framesInFlight.begin(); it != this->framesInFlight.end(); ++it) {
+            if (it->fence == fence) {
+                this->framesCompleted = it->number;
+                this->framesInFlight.erase(this->framesInFlight.begin(), std::next(it));
+                break;
+            }
+        }
+
+        this->graphicsQueue.submit(1, submitInfo, fence);
+        this->framesInFlight.push_back({++this->framesSubmitted, fence});
+    }
+
+    void Device::destroyLater(vk::DeviceMemory memory) {
+        if (memory) {
+            vk::Device graphicsDevice = this->graphicsDevice;
+            this->deferDestruction([graphicsDevice, memory]() {
+                graphicsDevice.freeMemory(memory);
+            });
+        }
+    }
+
+    void Device::deferDestruction(std::function<void()> destroy) {
+        if (this->framesInFlight.empty()) {
+            destroy();
+            this->destructionStatistics.immediate++;
+            return;
+        }
+        this->destructions.push_back({this->framesSubmitted, destroy});
+        this->destructionStatistics.pending = this->destructions.size();
+    }
+
+    void Device::collectGarbage() {
+        while (!this->framesInFlight.empty()
+                && this->graphicsDevice.getFenceStatus(this->framesInFlight.front().fence) == vk::Result::eSuccess) {
+            this->framesCompleted = this->framesInFlight.front().number;
+            this->framesInFlight.pop_front();
+        }
+        // queued in the order of frames, so the first one still in use ends the walk
+        while (!this->destructions.empty() && this->destructions.front().frame <= this->framesCompleted) {
+            this->destructions.front().destroy();
+            this->destructions.pop_front();
+            this->destructionStatistics.destroyed++;
+        }
+        this->destructionStatistics.pending = this->destructions.size();
+    }
+
+    void Device::waitIdle() {
+        this->graphicsDevice.waitIdle();
+        this->framesCompleted = this->framesSubmitted;
+        this->framesInFlight.clear();
+        this->collectGarbage();
+    }
+
     vk::Result Device::present(vk::PresentInfoKHR* presentInfo) {
         return this->presentQueue.presentKHR(presentInfo);
     }
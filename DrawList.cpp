@@ -0,0 +1,85 @@
+/* 
+ * File:   DrawList.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 03:05
+ */
+
+#include "DrawList.h"
+
+#include <array>
+#include <cstring>
+
+#define KEY_PASS_SHIFT 60
+#define KEY_PIPELINE_SHIFT 52
+#define KEY_MATERIAL_SHIFT 36
+#define KEY_MESH_SHIFT 20
+#define KEY_PASS_MASK 0xfull
+#define KEY_PIPELINE_MASK 0xffull
+#define KEY_MATERIAL_MASK 0xffffull
+#define KEY_MESH_MASK 0xffffull
+#define KEY_DEPTH_MASK 0xfffffull
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+
+namespace zvlk {
+
+    uint64_t DrawList::makeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth) {
+        // bits of a positive float grow with its value, the top ones of exponent and mantissa are kept
+        uint32_t depthBits = 0;
+        if (depth > 0.0f) {
+            std::memcpy(&depthBits, &depth, sizeof (depthBits));
+            depthBits >>= 11;
+        }
+        return ((pass & KEY_PASS_MASK) << KEY_PASS_SHIFT)
+                | ((pipeline & KEY_PIPELINE_MASK) << KEY_PIPELINE_SHIFT)
+                | ((material & KEY_MATERIAL_MASK) << KEY_MATERIAL_SHIFT)
+                | ((mesh & KEY_MESH_MASK) << KEY_MESH_SHIFT)
+                | (depthBits & KEY_DEPTH_MASK);
+    }
+
+    uint32_t DrawList::getPass(uint64_t key) {
+        return static_cast<uint32_t> ((key >> KEY_PASS_SHIFT) & KEY_PASS_MASK);
+    }
+
+    void DrawList::sort() {
+        size_t count = this->keys.size();
+        if (count < 2) {
+            return;
+        }
+        this->sortedKeys.resize(count);
+        this->sortedItems.resize(count);
+
+        // histograms of every digit in one pass over the keys
+        std::array<std::array<size_t, RADIX_SIZE>, RADIX_PASSES> histograms = {};
+        for (uint64_t key : this->keys) {
+            for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+                histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+            }
+        }
+
+        for (uint32_t pass = 0; pass < RADIX_PASSES; ++pass) {
+            std::array<size_t, RADIX_SIZE>& histogram = histograms[pass];
+            uint32_t shift = pass * RADIX_BITS;
+            // digits equal in every key leave the order as it is
+            if (histogram[(this->keys[0] >> shift) & (RADIX_SIZE - 1)] == count) {
+                continue;
+            }
+
+            size_t offset = 0;
+            for (size_t& bucket : histogram) {
+                size_t size = bucket;
+                bucket = offset;
+                offset += size;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                size_t target = histogram[(this->keys[i] >> shift) & (RADIX_SIZE - 1)]++;
+                this->sortedKeys[target] = this->keys[i];
+                this->sortedItems[target] = this->items[i];
+            }
+            this->keys.swap(this->sortedKeys);
+            this->items.swap(this->sortedItems);
+        }
+    }
+}
@@ -6,13 +6,30 @@
  */
 
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
+#include <limits>
+#include <unordered_map>
+
+#include <glm/geometric.hpp>
 
 #include "Engine.h"
+#include "TextureStreamer.h"
+#include "CommandRecorder.h"
+#include "AssetCache.h"
+
+#define DRAW_PASS_PREPASS 0
+#define DRAW_PASS_MAIN 1
+// start of the frame, end of the main render pass, end of the post-process pass
+#define TIMESTAMPS_PER_FRAME 3
 
 namespace zvlk {
 
     Engine::~Engine() {
+        // with the device idle everything below is destroyed at once
+        this->deviceObject->waitIdle();
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
             this->device.destroy(renderFinishedSemaphores[i]);
             this->device.destroy(imageAvailableSemaphores[i]);
@@ -20,28 +37,73 @@ namespace zvlk {
         }
         this->clean();
 
+        delete this->descriptorAllocator;
+        this->device.destroy(this->sceneLayout);
+        this->device.destroy(this->modelLayout);
+        this->device.destroy(this->materialLayout);
+        this->device.destroy(this->postPipelineLayout);
+        this->device.destroy(this->postLayout);
         delete this->lights;
     }
 
     void Engine::clean() {
-        this->deviceObject->freeCommandBuffers(commandBuffers);
+        // frames in flight keep using what is dropped here, it is destroyed once they complete
+        this->compiled = false;
+        std::vector<vk::CommandBuffer> commandBuffers = this->commandBuffers;
+        OcclusionCuller* occlusionCuller = this->occlusionCuller;
+        zvlk::Device* deviceObject = this->deviceObject;
+        this->deviceObject->deferDestruction([deviceObject, commandBuffers, occlusionCuller]() mutable {
+            deviceObject->freeCommandBuffers(commandBuffers);
+            delete occlusionCuller;
+        });
+        this->commandBuffers.clear();
+        this->occlusionCuller = nullptr;
 
         for (ExecutionUnit& unit : this->units) {
-            this->device.destroy(unit.graphicsPipeline);
-            this->device.destroy(unit.descriptorPool);
-            unit.descriptorSets.clear();
+            this->deviceObject->destroyLater(unit.graphicsPipeline);
+            unit.graphicsPipeline = nullptr;
             for (ModelUnit& model : unit.models) {
+                model.matrixSets.clear();
                 model.descriptorSets.clear();
-                this->device.destroy(model.descriptorPool);
+                model.textureVersions.clear();
             }
+            // built again by compile
+            this->releaseStaticBatch(unit);
         }
         this->descriptorSets.clear();
-        this->device.destroy(this->pipelineLayout);
-        this->device.destroy(this->descriptorPool);
+        this->deviceObject->destroyLater(this->pipelineLayout);
+        this->pipelineLayout = nullptr;
+        // pools are kept for the sets of the next compile
+        this->descriptorAllocator->reset();
 
-        this->device.destroy(this->sceneLayout);
-        this->device.destroy(this->modelLayout);
-        this->device.destroy(this->materialLayout);
+        this->slotsNumber = 0;
+        this->freeSlots.clear();
+        this->meshIds.clear();
+        this->materialIds.clear();
+        this->drawBounds.clear();
+        this->drawMatrices.clear();
+        this->drawWorldBounds.resize(0);
+        this->drawVisible.clear();
+
+        // lighting objects exist only when the last compile was for a deferred frame
+        this->deviceObject->destroyLater(this->lightingPipeline);
+        this->deviceObject->destroyLater(this->lightingPipelineLayout);
+        this->deviceObject->destroyLater(this->inputLayout);
+        this->lightingPipeline = nullptr;
+        this->lightingPipelineLayout = nullptr;
+        this->inputLayout = nullptr;
+
+        this->deviceObject->destroyLater(this->prepassPipeline);
+        this->deviceObject->destroyLater(this->statisticsQueryPool);
+        this->deviceObject->destroyLater(this->timestampQueryPool);
+        this->prepassPipeline = nullptr;
+        this->statisticsQueryPool = nullptr;
+        this->timestampQueryPool = nullptr;
+
+        // the post-process set went with the pools
+        this->deviceObject->destroyLater(this->postPipeline);
+        this->postPipeline = nullptr;
+        this->postDescriptorSet = nullptr;
     }
 
     Engine::Engine(std::shared_ptr<zvlk::Frame> frame, zvlk::Device* deviceObject) {
@@ -65,201 +127,504 @@ namespace zvlk {
             renderFinishedSemaphores[i] = this->device.createSemaphore(semaphoreInfo);
             inFlightFences[i] = this->device.createFence(fenceInfo);
         }
+
+        // layouts do not depend on the frame, so they and their update templates outlive compiles
+        //per scene
+        vk::DescriptorSetLayoutBinding cameraBinding(0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment);
+        vk::DescriptorSetLayoutBinding lightsBinding(1, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eFragment);
+        vk::DescriptorSetLayoutBinding lightsBufferBinding(2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment);
+        vk::DescriptorSetLayoutBinding clustersBinding(3, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment);
+        vk::DescriptorSetLayoutBinding lightIndicesBinding(4, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment);
+        //per model
+        vk::DescriptorSetLayoutBinding transformationBinding(0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex);
+        //per material
+        vk::DescriptorSetLayoutBinding samplerLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment);
+        vk::DescriptorSetLayoutBinding materialBinding(1, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eFragment);
+
+        std::array<vk::DescriptorSetLayoutBinding, 8> descriptorSetLayoutBindings = {cameraBinding, lightsBinding, lightsBufferBinding,
+            clustersBinding, lightIndicesBinding, transformationBinding, samplerLayoutBinding, materialBinding};
+
+        vk::DescriptorSetLayoutCreateInfo sceneLayoutInfo({}, 5, &descriptorSetLayoutBindings.data()[0]);
+        this->sceneLayout = this->device.createDescriptorSetLayout(sceneLayoutInfo);
+        vk::DescriptorSetLayoutCreateInfo modelLayoutInfo({}, 1, &descriptorSetLayoutBindings.data()[5]);
+        this->modelLayout = this->device.createDescriptorSetLayout(modelLayoutInfo);
+        vk::DescriptorSetLayoutCreateInfo materialLayoutInfo({}, 2, &descriptorSetLayoutBindings.data()[6]);
+        this->materialLayout = this->device.createDescriptorSetLayout(materialLayoutInfo);
+
+        this->descriptorAllocator = new DescriptorAllocator(deviceObject);
+        this->descriptorAllocator->registerLayout(this->sceneLayout,{descriptorSetLayoutBindings.begin(), descriptorSetLayoutBindings.begin() + 5});
+        this->descriptorAllocator->registerLayout(this->modelLayout,{descriptorSetLayoutBindings.begin() + 5, descriptorSetLayoutBindings.begin() + 6});
+        this->descriptorAllocator->registerLayout(this->materialLayout,{descriptorSetLayoutBindings.begin() + 6, descriptorSetLayoutBindings.end()});
+
+        // image sampled by the post-process pass
+        vk::DescriptorSetLayoutBinding sceneBinding(0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment);
+        this->postLayout = this->device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo({}, 1, &sceneBinding));
+        this->descriptorAllocator->registerLayout(this->postLayout,{sceneBinding});
+        this->postPipelineLayout = this->device.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &this->postLayout));
     }
 
-    void Engine::enableShaders(VertexShader& vertexShader, FragmentShader& fragmentShader) {
+    ShaderHandle Engine::enableShaders(VertexShader& vertexShader, FragmentShader& fragmentShader) {
         this->units.push_back({vertexShader, fragmentShader,
-            nullptr,
-            {},
-            {}, nullptr});
+            {}, nullptr,
+            {}, nullptr, nullptr, false});
+        uint32_t index = static_cast<uint32_t> (this->unitRecords.size());
+        if (this->freeUnitRecords.empty()) {
+            this->unitRecords.push_back({0, false,
+                {}});
+        } else {
+            index = this->freeUnitRecords.back();
+            this->freeUnitRecords.pop_back();
+        }
+        UnitRecord& record = this->unitRecords[index];
+        record.live = true;
+        record.unit = std::prev(this->units.end());
+
+        if (this->compiled) {
+            this->compilePipeline(this->units.back());
+        }
+        return {index, record.generation};
+    }
+
+    void Engine::disableShaders(ShaderHandle shaders) {
+        if (shaders.index >= this->unitRecords.size() || !this->unitRecords[shaders.index].live
+                || this->unitRecords[shaders.index].generation != shaders.generation) {
+            throw std::runtime_error("disabling shaders which are not enabled");
+        }
+
+        UnitRecord& record = this->unitRecords[shaders.index];
+        ExecutionUnit& unit = *record.unit;
+        // buffers of the batch are destroyed once frames in flight complete, like the pipeline
+        this->releaseStaticBatch(unit);
+        for (ModelUnit& model : unit.models) {
+            if (this->compiled) {
+                this->releaseModel(model);
+            }
+            this->freeModelRecord(model.handle);
+        }
+        for (ModelUnit& model : unit.staticModels) {
+            this->freeModelRecord(model.handle);
+        }
+        this->deviceObject->destroyLater(unit.graphicsPipeline);
+
+        this->units.erase(record.unit);
+        record.live = false;
+        record.generation++;
+        this->freeUnitRecords.push_back(shaders.index);
+    }
+
+    void Engine::enableDeferredLighting(VertexShader& vertexShader, FragmentShader& fragmentShader) {
+        this->lightingVertexShader = &vertexShader;
+        this->lightingFragmentShader = &fragmentShader;
+    }
+
+    void Engine::enableDepthPrepass(VertexShader& vertexShader) {
+        this->prepassVertexShader = &vertexShader;
+    }
+
+    void Engine::enablePostProcess(VertexShader& vertexShader, FragmentShader& fragmentShader) {
+        this->postVertexShader = &vertexShader;
+        this->postFragmentShader = &fragmentShader;
     }
 
-    void Engine::draw(Model& model, TransformationMatrices& transformationMatrices) {
+    ModelHandle Engine::draw(Model& model, TransformationMatrices& transformationMatrices) {
         if (this->units.empty()) {
             throw std::runtime_error("drawing with no shaders enabled");
         }
+        return this->addModel(std::prev(this->units.end()), model, transformationMatrices, false);
+    }
 
-        ExecutionUnit& unit = this->units.back();
-        unit.models.push_back({model, transformationMatrices,
-            {}});
+    ModelHandle Engine::draw(ShaderHandle shaders, Model& model, TransformationMatrices& transformationMatrices) {
+        if (shaders.index >= this->unitRecords.size() || !this->unitRecords[shaders.index].live
+                || this->unitRecords[shaders.index].generation != shaders.generation) {
+            throw std::runtime_error("drawing with shaders which are not enabled");
+        }
+        return this->addModel(this->unitRecords[shaders.index].unit, model, transformationMatrices, false);
     }
 
-    void Engine::compile() {
-        vk::PipelineInputAssemblyStateCreateInfo inputAssembly({}, vk::PrimitiveTopology::eTriangleList, VK_FALSE);
-        vk::Viewport viewport(0.0f, (float) frame->getHeight(), (float) frame->getWidth(), -(float) frame->getHeight(), 0.0f, 1.0f);
-        vk::Rect2D scissor(vk::Offset2D(0, 0), vk::Extent2D(frame->getWidth(), frame->getHeight()));
-        vk::PipelineViewportStateCreateInfo viewportState({}, 1, &viewport, 1, &scissor);
-        vk::PipelineRasterizationStateCreateInfo rasterizer({}, VK_FALSE, VK_FALSE, vk::PolygonMode::eFill,
-                vk::CullModeFlagBits::eBack, vk::FrontFace::eCounterClockwise, VK_FALSE, 0.0f, 0.0f, 0.0f, 1.0f);
-        vk::PipelineMultisampleStateCreateInfo multisampling({}, deviceObject->getMaxUsableSampleCount(),
-                VK_TRUE, 1.0f, nullptr, VK_FALSE, VK_FALSE);
+    ModelHandle Engine::drawStatic(Model& model, TransformationMatrices& transformationMatrices) {
+        if (this->units.empty()) {
+            throw std::runtime_error("drawing with no shaders enabled");
+        }
+        return this->addModel(std::prev(this->units.end()), model, transformationMatrices, true);
+    }
 
-        vk::PipelineColorBlendAttachmentState colorBlendAttachment(VK_FALSE, vk::BlendFactor::eOne, vk::BlendFactor::eZero,
-                vk::BlendOp::eAdd, vk::BlendFactor::eOne, vk::BlendFactor::eZero, vk::BlendOp::eAdd,
-                vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
-        vk::PipelineColorBlendStateCreateInfo colorBlending({}, VK_FALSE, vk::LogicOp::eCopy, 1, &colorBlendAttachment,{0.0f, 0.0f, 0.0f, 0.0f});
-        vk::PipelineDepthStencilStateCreateInfo depthStencil({}, VK_TRUE, VK_TRUE, vk::CompareOp::eLess, VK_FALSE, VK_FALSE,{},
-        {
-        }, 0.0f, 1.0f);
+    ModelHandle Engine::addModel(std::list<ExecutionUnit>::iterator unit, Model& model, TransformationMatrices& transformationMatrices, bool isStatic) {
+        std::list<ModelUnit>& models = isStatic ? unit->staticModels : unit->models;
+        models.push_back({&model, &transformationMatrices, model.getMaterials()});
+        ModelUnit& added = models.back();
+        added.isStatic = isStatic;
 
-        int i = 0;
+        uint32_t index = static_cast<uint32_t> (this->modelRecords.size());
+        if (this->freeModelRecords.empty()) {
+            this->modelRecords.push_back({0, false,
+                {},
+                {}});
+        } else {
+            index = this->freeModelRecords.back();
+            this->freeModelRecords.pop_back();
+        }
+        ModelRecord& record = this->modelRecords[index];
+        record.live = true;
+        record.unit = unit;
+        record.model = std::prev(models.end());
+        added.handle = index;
 
-        //per scene
-        vk::DescriptorSetLayoutBinding cameraBinding(0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment);
-        vk::DescriptorSetLayoutBinding lightsBinding(1, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eFragment);
-        //per model
-        vk::DescriptorSetLayoutBinding transformationBinding(0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex);
-        //per material
-        vk::DescriptorSetLayoutBinding samplerLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment);
-        vk::DescriptorSetLayoutBinding materialBinding(1, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eFragment);
+        if (isStatic) {
+            unit->staticChanged = true;
+        } else if (this->compiled) {
+            // sets and slots of this model only, every other draw keeps its own
+            this->compileModel(added);
+        }
+        return {index, record.generation};
+    }
 
-        std::array<vk::DescriptorSetLayoutBinding, 5> descriptorSetLayoutBindings = {cameraBinding, lightsBinding, transformationBinding, samplerLayoutBinding, materialBinding};
+    ModelUnit& Engine::getModel(ModelHandle model) {
+        if (model.index >= this->modelRecords.size() || !this->modelRecords[model.index].live
+                || this->modelRecords[model.index].generation != model.generation) {
+            throw std::runtime_error("model is not drawn");
+        }
+        return *this->modelRecords[model.index].model;
+    }
 
-        vk::DescriptorSetLayoutCreateInfo sceneLayoutInfo({}, 2, &descriptorSetLayoutBindings.data()[0]);
-        this->sceneLayout = this->device.createDescriptorSetLayout(sceneLayoutInfo);
-        vk::DescriptorSetLayoutCreateInfo modelLayoutInfo({}, 1, &descriptorSetLayoutBindings.data()[2]);
-        this->modelLayout = this->device.createDescriptorSetLayout(modelLayoutInfo);
-        vk::DescriptorSetLayoutCreateInfo materialLayoutInfo({}, 2, &descriptorSetLayoutBindings.data()[3]);
-        this->materialLayout = this->device.createDescriptorSetLayout(materialLayoutInfo);
+    void Engine::freeModelRecord(uint32_t index) {
+        ModelRecord& record = this->modelRecords[index];
+        record.live = false;
+        record.generation++;
+        this->freeModelRecords.push_back(index);
+    }
 
-        vk::DescriptorPoolSize cameraPoolSize(vk::DescriptorType::eUniformBuffer, this->frameNumber);
-        vk::DescriptorPoolSize lightsPoolSize(vk::DescriptorType::eUniformBuffer, this->frameNumber);
-        vk::DescriptorPoolSize scenePoolSize[] = {cameraPoolSize, lightsPoolSize};
-        vk::DescriptorPoolCreateInfo poolInfo({}, this->frameNumber, 2, scenePoolSize);
-        this->descriptorPool = this->device.createDescriptorPool(poolInfo);
+    void Engine::removeModel(ModelHandle handle) {
+        ModelUnit& model = this->getModel(handle);
+        ModelRecord& record = this->modelRecords[handle.index];
+        if (model.isStatic) {
+            record.unit->staticModels.erase(record.model);
+            record.unit->staticChanged = true;
+        } else {
+            if (this->compiled) {
+                this->releaseModel(model);
+            }
+            record.unit->models.erase(record.model);
+        }
+        this->freeModelRecord(handle.index);
+    }
 
-        std::vector<vk::DescriptorSetLayout> layouts(this->frameNumber, this->sceneLayout);
-        vk::DescriptorSetAllocateInfo allocInfo(this->descriptorPool, this->frameNumber, layouts.data());
-        this->descriptorSets = this->device.allocateDescriptorSets(allocInfo);
+    void Engine::setModelMatrices(ModelHandle handle, TransformationMatrices& transformationMatrices) {
+        ModelUnit& model = this->getModel(handle);
+        model.matrix = &transformationMatrices;
+        if (model.isStatic) {
+            this->modelRecords[handle.index].unit->staticChanged = true;
+            return;
+        }
+        if (!this->compiled) {
+            return;
+        }
 
-        std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {this->sceneLayout, this->modelLayout, this->materialLayout};
-        this->pipelineLayout = this->device.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, descriptorSetLayouts.size(), descriptorSetLayouts.data()));
+        for (size_t j = 0; j < this->frameNumber; j++) {
+            vk::DescriptorSet matrixSet = model.matrixSets[j];
+            model.matrixSets[j] = this->descriptorAllocator->get(this->modelLayout,{transformationMatrices.getDescriptorBufferInfo(j)});
+            this->descriptorAllocator->release(this->modelLayout, matrixSet);
+        }
+    }
+
+    void Engine::setModelMaterial(ModelHandle handle, uint32_t materialIndex, Material& material) {
+        ModelUnit& model = this->getModel(handle);
+        if (materialIndex >= model.materials.size()) {
+            throw std::runtime_error("model has no material of the index");
+        }
+        if (model.isStatic) {
+            throw std::runtime_error("materials of static models are merged into their batch");
+        }
+        model.materials[materialIndex] = &material;
+        if (!this->compiled) {
+            return;
+        }
 
-        std::vector<vk::WriteDescriptorSet> descriptorWrites;
-        std::vector<vk::DescriptorBufferInfo> cameraInfos(this->frameNumber);
-        std::vector<vk::DescriptorBufferInfo> lightsInfos(this->frameNumber);
+        model.materialIds[materialIndex] = this->materialIds.emplace(&material, static_cast<uint32_t> (this->materialIds.size())).first->second;
         for (size_t j = 0; j < this->frameNumber; j++) {
-            cameraInfos[j] = this->camera->getDescriptorBufferInfo(j);
-            lightsInfos[j] = this->lights->getDescriptorBufferInfo(j);
-            descriptorWrites.push_back(vk::WriteDescriptorSet(this->descriptorSets[j],
-                    0, 0, 1, vk::DescriptorType::eUniformBuffer,{}, &cameraInfos[j],{}));
-            descriptorWrites.push_back(vk::WriteDescriptorSet(this->descriptorSets[j],
-                    1, 0, 1, vk::DescriptorType::eUniformBuffer,{}, &lightsInfos[j],{}));
+            uint32_t index = materialIndex * this->frameNumber + j;
+            vk::DescriptorSet materialSet = model.descriptorSets[index];
+            model.descriptorSets[index] = this->descriptorAllocator->get(this->materialLayout,{
+                material.getDescriptorImageInfo(j), material.getDescriptorBufferInfo(j)
+            });
+            model.textureVersions[index] = material.getTexture()->getVersion();
+            this->descriptorAllocator->release(this->materialLayout, materialSet);
         }
-        this->device.updateDescriptorSets(descriptorWrites,{});
+    }
 
+    void Engine::setStatic(TransformationMatrices& transformationMatrices, bool isStatic) {
         for (ExecutionUnit& unit : this->units) {
-            vk::PipelineShaderStageCreateInfo shaderStages[] = {
-                unit.vertexShader.getPipelineShaderStageCreateInfo(),
-                unit.fragmentShader.getPipelineShaderStageCreateInfo()
-            };
+            std::list<ModelUnit>& from = isStatic ? unit.models : unit.staticModels;
+            std::list<ModelUnit>& to = isStatic ? unit.staticModels : unit.models;
+            for (auto it = from.begin(); it != from.end();) {
+                if (!it->isBatch && it->matrix == &transformationMatrices) {
+                    // handles keep referring to the model, list iterators stay valid when spliced
+                    it->isStatic = isStatic;
+                    if (this->compiled && isStatic) {
+                        // drawn only through the batch once it is rebuilt before the next frame
+                        this->releaseModel(*it);
+                    } else if (this->compiled) {
+                        this->compileModel(*it);
+                    }
+                    to.splice(to.end(), from, it++);
+                    unit.staticChanged = true;
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
 
-            vk::PipelineVertexInputStateCreateInfo& iscr = unit.vertexShader.getPipelineVertexInputStateCreateInfo();
+    void Engine::compile() {
+        // a recreated swapchain may have another number of images
+        if (this->frame->getImagesNumber() != this->frameNumber) {
+            this->resizeImages();
+        }
 
-            vk::GraphicsPipelineCreateInfo pipelineInfo({}, 2, shaderStages, &iscr, &inputAssembly,{}, &viewportState,
-                    &rasterizer, &multisampling, &depthStencil, &colorBlending,{}, this->pipelineLayout,
-                    frame->getRenderPass(), 0, vk::Pipeline(), -1);
+        for (ExecutionUnit& unit : this->units) {
+            this->compileStaticBatch(unit);
+        }
 
-            unit.graphicsPipeline = device.createGraphicsPipelines(vk::PipelineCache(),{pipelineInfo})[0];
+        // scene sets are written again when the light buffers grow, so they are not shared
+        for (uint32_t j = 0; j < this->frameNumber; j++) {
+            this->descriptorSets.push_back(this->descriptorAllocator->allocate(this->sceneLayout));
+        }
 
-            vk::DescriptorPoolSize modelPoolSize(vk::DescriptorType::eUniformBuffer, this->frameNumber * unit.models.size());
-            vk::DescriptorPoolCreateInfo poolInfo({}, this->frameNumber * unit.models.size(), 1, &modelPoolSize);
-            unit.descriptorPool = this->device.createDescriptorPool(poolInfo);
+        std::vector<vk::DescriptorSetLayout> descriptorSetLayouts = {this->sceneLayout, this->modelLayout, this->materialLayout};
+        this->pipelineLayout = this->device.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, descriptorSetLayouts.size(), descriptorSetLayouts.data()));
 
-            std::vector<vk::DescriptorSetLayout> layouts(this->frameNumber * unit.models.size(), this->modelLayout);
-            vk::DescriptorSetAllocateInfo allocInfo(unit.descriptorPool, layouts.size(), layouts.data());
-            unit.descriptorSets = this->device.allocateDescriptorSets(allocInfo);
+        for (uint32_t j = 0; j < this->frameNumber; j++) {
+            static_cast<zvlk::UniformBuffer*> (this->lights)->update(j);
+            this->lights->wereBuffersReallocated(j);
+            this->writeSceneDescriptors(j);
+        }
 
-            std::vector<vk::WriteDescriptorSet> descriptorWrites;
-            std::vector<vk::DescriptorBufferInfo> matrixInfos(this->frameNumber * unit.models.size());
-            for (size_t j = 0; j < this->frameNumber; j++) {
-                int i = 0;
-                for (ModelUnit& model : unit.models) {
-                    uint32_t index = i * this->frameNumber + j;
-                    matrixInfos[index] = model.matrix.getDescriptorBufferInfo(j);
-                    descriptorWrites.push_back(vk::WriteDescriptorSet(unit.descriptorSets[index],
-                            0, 0, 1, vk::DescriptorType::eUniformBuffer,{
-                    }, &matrixInfos[index],{}));
-                    i++;
-                }
+        for (ExecutionUnit& unit : this->units) {
+            this->compilePipeline(unit);
+            for (ModelUnit& model : unit.models) {
+                this->compileModel(model);
             }
-            this->device.updateDescriptorSets(descriptorWrites,{});
+        }
 
-            for (ModelUnit& model : unit.models) {
-                uint32_t modelPartsCount = model.model.getMaterials().size();
-                vk::DescriptorPoolSize samplerPoolSize(vk::DescriptorType::eCombinedImageSampler, this->frameNumber * modelPartsCount);
-                vk::DescriptorPoolSize materialPoolSize(vk::DescriptorType::eUniformBuffer, this->frameNumber * modelPartsCount);
-                vk::DescriptorPoolSize modelPoolSizes[] = {samplerPoolSize, materialPoolSize};
-                vk::DescriptorPoolCreateInfo poolInfo({}, this->frameNumber * modelPartsCount, 2, modelPoolSizes);
-                model.descriptorPool = this->device.createDescriptorPool(poolInfo);
-
-                std::vector<vk::DescriptorSetLayout> layouts(this->frameNumber * modelPartsCount, this->materialLayout);
-                vk::DescriptorSetAllocateInfo allocInfo(model.descriptorPool, layouts.size(), layouts.data());
-                model.descriptorSets = this->device.allocateDescriptorSets(allocInfo);
-
-                std::vector<vk::WriteDescriptorSet> partWrites;
-                std::vector<vk::DescriptorBufferInfo> materialInfos(this->frameNumber * modelPartsCount);
-                std::vector<vk::DescriptorImageInfo> texturesInfos(this->frameNumber * modelPartsCount);
-                for (size_t j = 0; j < this->frameNumber; j++) {
-                    for (uint32_t i = 0; i < modelPartsCount; ++i) {
-                        uint32_t index = i * this->frameNumber + j;
-                        zvlk::Material* material = model.model.getMaterials()[i];
-                        materialInfos[index] = material->getDescriptorBufferInfo(j);
-                        texturesInfos[index] = material->getDescriptorImageInfo(j);
-                        partWrites.push_back(
-                                vk::WriteDescriptorSet(model.descriptorSets[index], 0, 0, 1, vk::DescriptorType::eCombinedImageSampler, &texturesInfos[index],{},
-                        {
-                        }));
-                        partWrites.push_back(
-                                vk::WriteDescriptorSet(model.descriptorSets[index], 1, 0, 1, vk::DescriptorType::eUniformBuffer,{}, &materialInfos[index],{
-                        }));
+        if (this->frame->getRenderMode() == RenderMode::eDeferred) {
+            this->compileDeferredLighting();
+        }
+        if (this->prepassVertexShader != nullptr) {
+            this->compileDepthPrepass();
+        }
+        if (this->frame->getPostRenderPass()) {
+            this->compilePostProcess();
+        }
+        if (this->deviceObject->getFeatures().pipelineStatisticsQuery) {
+            this->statisticsQueryPool = this->device.createQueryPool(vk::QueryPoolCreateInfo({}, vk::QueryType::ePipelineStatistics,
+                    this->frameNumber, vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations));
+            this->statisticsQueried.assign(this->frameNumber, false);
+        }
+        if (this->deviceObject->getTimestampValidBits() != 0) {
+            this->timestampQueryPool = this->device.createQueryPool(vk::QueryPoolCreateInfo({}, vk::QueryType::eTimestamp,
+                    TIMESTAMPS_PER_FRAME * this->frameNumber));
+            this->timestampsQueried.assign(this->frameNumber, false);
+        }
+
+        this->partDraws.reserve(this->slotsNumber);
+        if (this->occlusionCulling) {
+            // room for models drawn later, the culler is replaced when they outgrow it
+            this->occlusionCuller = new OcclusionCuller(this->deviceObject, this->frame, this->pipelineLayout, 2 * this->slotsNumber);
+        }
+
+        this->deviceObject->allocateCommandBuffers(this->frameNumber, this->commandBuffers);
+        this->compiled = true;
+    }
+
+    void Engine::resizeImages() {
+        this->frameNumber = this->frame->getImagesNumber();
+        // command buffers, sets and buffers of the images are all new, frames in flight keep the old ones
+        this->imagesInFlight.assign(this->frameNumber, vk::Fence());
+        static_cast<zvlk::UniformBuffer*> (this->lights)->resize(this->frame);
+        static_cast<zvlk::UniformBuffer*> (this->camera)->resize(this->frame);
+        // shared buffers are resized by their first model
+        for (ExecutionUnit& unit : this->units) {
+            for (std::list<ModelUnit>* models : {&unit.models, &unit.staticModels}) {
+                for (ModelUnit& model : *models) {
+                    static_cast<zvlk::UniformBuffer*> (model.matrix)->resize(this->frame);
+                    for (zvlk::Material* material : model.materials) {
+                        static_cast<zvlk::UniformBuffer*> (material)->resize(this->frame);
                     }
                 }
-                this->device.updateDescriptorSets(partWrites,{});
             }
+        }
+    }
 
-            i++;
+    void Engine::resize() {
+        if (!this->compiled) {
+            return;
         }
 
-        this->deviceObject->allocateCommandBuffers(this->frameNumber, this->commandBuffers);
+        // pipelines take the viewport when recording, only what refers to the attachments of the old size is replaced
+        if (this->frame->getRenderMode() == RenderMode::eDeferred) {
+            // frames in flight still read the old G-buffer through the current set
+            this->descriptorAllocator->release(this->inputLayout, this->inputDescriptorSet);
+            this->writeInputDescriptors();
+        }
+        if (this->postPipeline) {
+            this->descriptorAllocator->release(this->postLayout, this->postDescriptorSet);
+            this->writePostDescriptors();
+        }
+        if (this->occlusionCuller != nullptr) {
+            // targets of the culler have the size of the frame
+            OcclusionCuller* culler = this->occlusionCuller;
+            uint32_t drawsNumber = culler->getDrawsNumber();
+            this->deviceObject->deferDestruction([culler]() {
+                delete culler;
+            });
+            this->occlusionCuller = new OcclusionCuller(this->deviceObject, this->frame, this->pipelineLayout, drawsNumber);
+        }
+    }
 
-        for (size_t i = 0; i < this->commandBuffers.size(); i++) {
-            this->commandBuffers[i].begin(vk::CommandBufferBeginInfo());
-            vk::RenderPassBeginInfo renderPassInfo = this->frame->getRenderPassBeginInfo(i);
-            //attachmets, like depth buffer and color frame are attached
-            commandBuffers[i].beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+    const vk::PipelineDynamicStateCreateInfo* Engine::dynamicViewportState() {
+        // viewport and scissor are set when recording, so pipelines outlive a resize of the frame
+        static const std::array<vk::DynamicState, 2> dynamicStates = {vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+        static const vk::PipelineDynamicStateCreateInfo dynamicState({}, static_cast<uint32_t> (dynamicStates.size()), dynamicStates.data());
+        return &dynamicState;
+    }
 
-            for (ExecutionUnit& unit : this->units) {
-                commandBuffers[i].bindPipeline(vk::PipelineBindPoint::eGraphics, unit.graphicsPipeline);
-                commandBuffers[i].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->pipelineLayout, 0, 1, &this->descriptorSets[i], 0, nullptr);
+    void Engine::compilePipeline(ExecutionUnit& unit) {
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly({}, vk::PrimitiveTopology::eTriangleList, VK_FALSE);
+        vk::PipelineViewportStateCreateInfo viewportState({}, 1, nullptr, 1, nullptr);
+        vk::PipelineRasterizationStateCreateInfo rasterizer({}, VK_FALSE, VK_FALSE, vk::PolygonMode::eFill,
+                vk::CullModeFlagBits::eBack, vk::FrontFace::eCounterClockwise, VK_FALSE, 0.0f, 0.0f, 0.0f, 1.0f);
+        // fragments are shaded once per pixel unless the frame asks for a fraction of the samples to be shaded
+        vk::PipelineMultisampleStateCreateInfo multisampling({}, frame->getSampleCount(),
+                frame->getMinSampleShading() > 0.0f, frame->getMinSampleShading(), nullptr, VK_FALSE, VK_FALSE);
 
-                int j = 0;
-                for (ModelUnit& model : unit.models) {
-                    vk::Buffer vertexBuffers[] = {model.model.getVertexBuffer()};
-                    vk::DeviceSize offsets[] = {0};
-                    commandBuffers[i].bindVertexBuffers(0, 1, vertexBuffers, offsets);
-                    commandBuffers[i].bindIndexBuffer(model.model.getIndexBuffer(), 0, vk::IndexType::eUint32);
+        vk::PipelineColorBlendAttachmentState colorBlendAttachment(VK_FALSE, vk::BlendFactor::eOne, vk::BlendFactor::eZero,
+                vk::BlendOp::eAdd, vk::BlendFactor::eOne, vk::BlendFactor::eZero, vk::BlendOp::eAdd,
+                vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+        // geometry subpass of a deferred frame writes every G-buffer attachment
+        std::vector<vk::PipelineColorBlendAttachmentState> colorBlendAttachments(frame->getColorAttachmentsNumber(), colorBlendAttachment);
+        vk::PipelineColorBlendStateCreateInfo colorBlending({}, VK_FALSE, vk::LogicOp::eCopy,
+                static_cast<uint32_t> (colorBlendAttachments.size()), colorBlendAttachments.data(),{0.0f, 0.0f, 0.0f, 0.0f});
+        // after a prepass depth is final, only the nearest fragment of every sample passes
+        vk::PipelineDepthStencilStateCreateInfo depthStencil({}, VK_TRUE, this->prepassVertexShader == nullptr,
+                this->prepassVertexShader == nullptr ? vk::CompareOp::eLess : vk::CompareOp::eEqual, VK_FALSE, VK_FALSE,{},
+        {
+        }, 0.0f, 1.0f);
 
-                    commandBuffers[i].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->pipelineLayout, 1, 1, &unit.descriptorSets[j * this->frameNumber + i], 0, nullptr);
+        vk::PipelineShaderStageCreateInfo shaderStages[] = {
+            unit.vertexShader.getPipelineShaderStageCreateInfo(),
+            unit.fragmentShader.getPipelineShaderStageCreateInfo()
+        };
 
-                    int k = 0;
-                    for (zvlk::Material* material : model.model.getMaterials()) {
-                        commandBuffers[i].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->pipelineLayout, 2, 1, &model.descriptorSets[k * this->frameNumber + i], 0, nullptr);
-                        for (zvlk::ModelPart& modelPart : model.model.getModelParts(material)) {
-                            commandBuffers[i].drawIndexed(modelPart.numberOfIndices, 1, modelPart.indexOffset, 0, 0);
-                        }
-                        k++;
-                    }
-                    j++;
+        vk::PipelineVertexInputStateCreateInfo& iscr = unit.vertexShader.getPipelineVertexInputStateCreateInfo();
+
+        vk::GraphicsPipelineCreateInfo pipelineInfo({}, 2, shaderStages, &iscr, &inputAssembly,{}, &viewportState,
+                &rasterizer, &multisampling, &depthStencil, &colorBlending, Engine::dynamicViewportState(), this->pipelineLayout,
+                frame->getRenderPass(), 0, vk::Pipeline(), -1);
+
+        unit.graphicsPipeline = device.createGraphicsPipelines(vk::PipelineCache(),{pipelineInfo})[0];
+    }
+
+    void Engine::compileModel(ModelUnit& model) {
+        model.matrixSets.resize(this->frameNumber);
+        for (size_t j = 0; j < this->frameNumber; j++) {
+            model.matrixSets[j] = this->descriptorAllocator->get(this->modelLayout,{model.matrix->getDescriptorBufferInfo(j)});
+        }
+
+        // models with a material share its sets
+        uint32_t materialsNumber = model.materials.size();
+        model.descriptorSets.resize(this->frameNumber * materialsNumber);
+        model.textureVersions.resize(this->frameNumber * materialsNumber);
+        for (size_t j = 0; j < this->frameNumber; j++) {
+            for (uint32_t i = 0; i < materialsNumber; ++i) {
+                uint32_t index = i * this->frameNumber + j;
+                zvlk::Material* material = model.materials[i];
+                model.descriptorSets[index] = this->descriptorAllocator->get(this->materialLayout,{
+                    material->getDescriptorImageInfo(j), material->getDescriptorBufferInfo(j)
+                });
+                model.textureVersions[index] = material->getTexture()->getVersion();
+            }
+        }
+
+        // models sharing buffers and parts sharing materials get equal identifiers in draw keys
+        model.meshId = this->meshIds.emplace(model.model, static_cast<uint32_t> (this->meshIds.size())).first->second;
+        model.materialIds.clear();
+        for (zvlk::Material* material : model.materials) {
+            model.materialIds.push_back(this->materialIds.emplace(material, static_cast<uint32_t> (this->materialIds.size())).first->second);
+        }
+
+        model.slotsNumber = 0;
+        for (zvlk::Material* material : model.model->getMaterials()) {
+            model.slotsNumber += model.model->getModelParts(material).size();
+        }
+        model.firstSlot = this->allocateSlots(model.slotsNumber);
+        model.slotsFrame = this->frameCounter;
+        uint32_t slot = model.firstSlot;
+        for (zvlk::Material* material : model.model->getMaterials()) {
+            for (zvlk::ModelPart& modelPart : model.model->getModelParts(material)) {
+                this->drawBounds[slot++] = modelPart.bounds;
+            }
+        }
+    }
+
+    void Engine::releaseModel(ModelUnit& model) {
+        // sets may be bound in frames in flight, the allocator hands them out again once those complete
+        for (vk::DescriptorSet set : model.matrixSets) {
+            this->descriptorAllocator->release(this->modelLayout, set);
+        }
+        for (vk::DescriptorSet set : model.descriptorSets) {
+            this->descriptorAllocator->release(this->materialLayout, set);
+        }
+        model.matrixSets.clear();
+        model.descriptorSets.clear();
+        model.textureVersions.clear();
+
+        // commands of frames in flight are in buffers of their images, slots may be taken right away
+        if (model.slotsNumber > 0) {
+            this->freeSlots.push_back({model.firstSlot, model.slotsNumber});
+        }
+        model.slotsNumber = 0;
+    }
+
+    uint32_t Engine::allocateSlots(uint32_t count) {
+        for (auto it = this->freeSlots.begin(); it != this->freeSlots.end(); ++it) {
+            if (it->second >= count) {
+                uint32_t first = it->first;
+                it->first += count;
+                it->second -= count;
+                if (it->second == 0) {
+                    this->freeSlots.erase(it);
                 }
+                return first;
             }
-            commandBuffers[i].endRenderPass();
-            commandBuffers[i].end();
         }
+
+        uint32_t first = this->slotsNumber;
+        this->slotsNumber += count;
+        this->drawBounds.resize(this->slotsNumber);
+        this->drawMatrices.resize(this->slotsNumber);
+        this->drawWorldBounds.resize(this->slotsNumber);
+        this->drawVisible.resize(this->slotsNumber);
+        if (this->occlusionCuller != nullptr && this->slotsNumber > this->occlusionCuller->getDrawsNumber()) {
+            // frames in flight still cull with the old one
+            OcclusionCuller* culler = this->occlusionCuller;
+            this->deviceObject->deferDestruction([culler]() {
+                delete culler;
+            });
+            this->occlusionCuller = new OcclusionCuller(this->deviceObject, this->frame, this->pipelineLayout, 2 * this->slotsNumber);
+        }
+        return first;
     }
 
     vk::Bool32 Engine::execute(vk::Bool32 framebufferResized) {
+        for (ExecutionUnit& unit : this->units) {
+            if (unit.staticChanged) {
+                // every other draw keeps its sets and slots, frames in flight finish with the old batch
+                this->releaseStaticBatch(unit);
+                this->compileStaticBatch(unit);
+            }
+        }
+
         this->device.waitForFences(1, &this->inFlightFences[this->currentFrame], VK_TRUE, UINT64_MAX);
+        this->deviceObject->collectGarbage();
 
         uint32_t imageIndex;
         vk::Result result = this->device.acquireNextImageKHR(this->frame->getSwapChain(), UINT64_MAX,
@@ -279,6 +644,14 @@ namespace zvlk {
             device.waitForFences(1, &imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
         }
 
+        // the image is no longer used by the device, so its light clusters and descriptors can be rewritten
+        static_cast<zvlk::UniformBuffer*> (this->lights)->update(imageIndex);
+        if (this->lights->wereBuffersReallocated(imageIndex)) {
+            this->writeSceneDescriptors(imageIndex);
+        }
+        this->streamTextures(imageIndex);
+        this->record(imageIndex);
+
         imagesInFlight[imageIndex] = inFlightFences[currentFrame];
         device.resetFences(1, &inFlightFences[currentFrame]);
 
@@ -286,11 +659,14 @@ namespace zvlk {
         vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
         vk::Semaphore signalSemaphores[] = {renderFinishedSemaphores[currentFrame]};
         vk::SubmitInfo submitInfo(1, waitSemaphores, waitStages, 1, &commandBuffers[imageIndex], 1, signalSemaphores);
-        this->deviceObject->submitGraphics(&submitInfo, inFlightFences[currentFrame]);
+        this->deviceObject->submitFrame(&submitInfo, inFlightFences[currentFrame]);
+        this->frameCounter++;
 
         vk::SwapchainKHR swapChains[] = {this->frame->getSwapChain()};
         vk::PresentInfoKHR presentInfo(1, signalSemaphores, 1, swapChains, &imageIndex);
         result = this->deviceObject->present(&presentInfo);
+        // the frame is submitted either way, the next one must not wait for its fence
+        currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 
         if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR || framebufferResized) {
             return false;
@@ -299,7 +675,468 @@ namespace zvlk {
             throw std::runtime_error("failed to present swap chain image!");
         }
 
-        currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
         return true;
     }
+
+    void Engine::record(uint32_t index) {
+        this->statistics = {};
+        OcclusionCuller* culler = this->occlusionCuller != nullptr && this->occlusionCuller->isSupported() ? this->occlusionCuller : nullptr;
+        if (culler != nullptr) {
+            // fence of the image has been waited for, so its last count is complete
+            this->statistics.drawsOccluded = culler->getOccluded(index);
+        }
+
+        for (ExecutionUnit& unit : this->units) {
+            for (ModelUnit& model : unit.models) {
+                std::fill_n(this->drawMatrices.begin() + model.firstSlot, model.slotsNumber, model.matrix->getModelMatrix());
+            }
+        }
+        if (this->slotsNumber > 0) {
+            BatchMath::transformBounds(this->drawMatrices.data(), this->drawBounds.data(), this->drawWorldBounds, 0, this->slotsNumber);
+            BatchMath::testFrustum(this->camera->getFrustumPlanes(), this->drawWorldBounds, this->drawVisible.data());
+        }
+        // slots of removed models are neither drawn nor counted by the culling pass
+        for (const std::pair<uint32_t, uint32_t>& range : this->freeSlots) {
+            std::fill_n(this->drawVisible.begin() + range.first, range.second, 0);
+            if (culler != nullptr) {
+                std::fill_n(culler->getCommands(index) + range.first, range.second, vk::DrawIndexedIndirectCommand());
+            }
+        }
+
+        // commands of the selected detail, draws outside the frustum get no instances
+        // and visible parts are keyed into the draw list
+        this->partDraws.clear();
+        this->drawList.clear();
+        const glm::mat4& view = this->camera->getView();
+        uint32_t pipelineId = 0;
+        for (ExecutionUnit& unit : this->units) {
+            for (ModelUnit& model : unit.models) {
+                uint32_t lod = this->selectLod(model);
+                uint32_t k = 0;
+                size_t slot = model.firstSlot;
+                for (zvlk::Material* material : model.model->getMaterials()) {
+                    std::vector<zvlk::ModelPart>& modelParts = model.model->getModelParts(material, lod);
+                    std::vector<zvlk::ModelPart>& fullParts = model.model->getModelParts(material);
+                    for (size_t p = 0; p < modelParts.size(); ++p, ++slot) {
+                        if (fullParts[p].numberOfIndices == 0) {
+                            this->drawVisible[slot] = 0;
+                        } else if (this->drawVisible[slot]) {
+                            this->statistics.trianglesSubmitted += modelParts[p].numberOfIndices / 3;
+                            this->statistics.trianglesWithoutLod += fullParts[p].numberOfIndices / 3;
+
+                            glm::vec4 center = view * glm::vec4(
+                                    (this->drawWorldBounds.minX[slot] + this->drawWorldBounds.maxX[slot]) * 0.5f,
+                                    (this->drawWorldBounds.minY[slot] + this->drawWorldBounds.maxY[slot]) * 0.5f,
+                                    (this->drawWorldBounds.minZ[slot] + this->drawWorldBounds.maxZ[slot]) * 0.5f, 1.0f);
+                            uint32_t item = static_cast<uint32_t> (this->partDraws.size());
+                            this->partDraws.push_back({&unit, &model, k, &modelParts[p], static_cast<uint32_t> (slot)});
+                            this->drawList.add(DrawList::makeKey(DRAW_PASS_MAIN, pipelineId, model.materialIds[k], model.meshId, -center.z), item);
+                            if (this->prepassPipeline) {
+                                this->drawList.add(DrawList::makeKey(DRAW_PASS_PREPASS, 0, 0, model.meshId, -center.z), item);
+                            }
+                        } else {
+                            this->statistics.drawsFrustumCulled++;
+                        }
+                        if (culler != nullptr) {
+                            culler->getCommands(index)[slot] = vk::DrawIndexedIndirectCommand(modelParts[p].numberOfIndices,
+                                    this->drawVisible[slot], modelParts[p].indexOffset, 0, 0);
+                            culler->getBounds(index)[2 * slot] = glm::vec4(this->drawWorldBounds.minX[slot],
+                                    this->drawWorldBounds.minY[slot], this->drawWorldBounds.minZ[slot], 1.0f);
+                            culler->getBounds(index)[2 * slot + 1] = glm::vec4(this->drawWorldBounds.maxX[slot],
+                                    this->drawWorldBounds.maxY[slot], this->drawWorldBounds.maxZ[slot], 1.0f);
+                        }
+                    }
+                    k++;
+                }
+            }
+            pipelineId++;
+        }
+        this->drawList.sort();
+
+        this->commandBuffers[index].begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        uint32_t firstTimestamp = TIMESTAMPS_PER_FRAME * index;
+        if (this->timestampQueryPool) {
+            if (this->timestampsQueried[index]) {
+                // fence of the image has been waited for, so the timestamps of its last frame are available
+                std::array<uint64_t, TIMESTAMPS_PER_FRAME> timestamps;
+                this->device.getQueryPoolResults(this->timestampQueryPool, firstTimestamp, TIMESTAMPS_PER_FRAME, sizeof (timestamps),
+                        timestamps.data(), sizeof (uint64_t), vk::QueryResultFlagBits::e64);
+                // bits above the valid ones are undefined, differences are taken modulo the valid range so a
+                // wrap between two timestamps still gives the elapsed ticks
+                uint32_t validBits = this->deviceObject->getTimestampValidBits();
+                uint64_t mask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+                float period = this->deviceObject->getProperties().limits.timestampPeriod * 1e-6f;
+                this->statistics.gpuMilliseconds = static_cast<float> ((timestamps[2] - timestamps[0]) & mask) * period;
+                this->statistics.postProcessMilliseconds = static_cast<float> ((timestamps[2] - timestamps[1]) & mask) * period;
+            }
+            commandBuffers[index].resetQueryPool(this->timestampQueryPool, firstTimestamp, TIMESTAMPS_PER_FRAME);
+            commandBuffers[index].writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, this->timestampQueryPool, firstTimestamp);
+            this->timestampsQueried[index] = true;
+        }
+        vk::DeviceSize commandSize = sizeof (vk::DrawIndexedIndirectCommand);
+        if (culler != nullptr) {
+            // depth of what was visible in the last frame, seen from the current camera
+            culler->beginOccluders(commandBuffers[index]);
+            commandBuffers[index].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->pipelineLayout, 0, 1, &this->descriptorSets[index], 0, nullptr);
+            for (ExecutionUnit& unit : this->units) {
+                for (ModelUnit& model : unit.models) {
+                    if (model.slotsFrame >= this->frameCounter) {
+                        // not culled yet, its occluder commands are those of the last model in its slots
+                        continue;
+                    }
+                    vk::Buffer vertexBuffers[] = {model.model->getVertexBuffer()};
+                    vk::DeviceSize offsets[] = {0};
+                    commandBuffers[index].bindVertexBuffers(0, 1, vertexBuffers, offsets);
+                    commandBuffers[index].bindIndexBuffer(model.model->getIndexBuffer(), 0, vk::IndexType::eUint32);
+                    commandBuffers[index].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->pipelineLayout, 1, 1, &model.matrixSets[index], 0, nullptr);
+                    for (size_t slot = model.firstSlot; slot < model.firstSlot + model.slotsNumber; ++slot) {
+                        commandBuffers[index].drawIndexedIndirect(culler->getOccludersBuffer(), slot * commandSize, 1, commandSize);
+                    }
+                }
+            }
+            culler->endOccluders(commandBuffers[index], index, this->camera->getProjection() * this->camera->getView());
+        }
+
+        if (this->statisticsQueryPool) {
+            if (this->statisticsQueried[index]) {
+                // fence of the image has been waited for, so the query of its last frame is available
+                this->device.getQueryPoolResults(this->statisticsQueryPool, index, 1, sizeof (uint64_t),
+                        &this->statistics.fragmentInvocations, sizeof (uint64_t), vk::QueryResultFlagBits::e64);
+            }
+            commandBuffers[index].resetQueryPool(this->statisticsQueryPool, index, 1);
+            commandBuffers[index].beginQuery(this->statisticsQueryPool, index,{});
+            this->statisticsQueried[index] = true;
+        }
+
+        vk::RenderPassBeginInfo renderPassInfo = this->frame->getRenderPassBeginInfo(index);
+        //attachmets, like depth buffer and color frame are attached
+        commandBuffers[index].beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+        // flipped, so that y points up as in the projection
+        float width = static_cast<float> (this->frame->getWidth());
+        float height = static_cast<float> (this->frame->getHeight());
+        vk::Rect2D scissor(vk::Offset2D(0, 0), vk::Extent2D(this->frame->getWidth(), this->frame->getHeight()));
+        commandBuffers[index].setViewport(0, vk::Viewport(0.0f, height, width, -height, 0.0f, 1.0f));
+        commandBuffers[index].setScissor(0, scissor);
+
+        // prepass draws sort before the main ones, every pass groups draws sharing state and orders them front to back
+        CommandRecorder recorder(commandBuffers[index], this->pipelineLayout);
+        recorder.bindDescriptorSet(0, this->descriptorSets[index]);
+        for (size_t i = 0; i < this->drawList.size(); ++i) {
+            const PartDraw& draw = this->partDraws[this->drawList[i]];
+            if (DrawList::getPass(this->drawList.getKey(i)) == DRAW_PASS_PREPASS) {
+                recorder.bindPipeline(this->prepassPipeline);
+            } else {
+                recorder.bindPipeline(draw.unit->graphicsPipeline);
+                recorder.bindDescriptorSet(2, draw.model->descriptorSets[draw.materialIndex * this->frameNumber + index]);
+            }
+            recorder.bindDescriptorSet(1, draw.model->matrixSets[index]);
+            recorder.bindVertexBuffer(draw.model->model->getVertexBuffer());
+            recorder.bindIndexBuffer(draw.model->model->getIndexBuffer());
+            this->drawPart(index, draw.slot, *draw.modelPart);
+        }
+        this->statistics.pipelineBinds = recorder.getStatistics().pipelineBinds;
+        this->statistics.descriptorSetBinds = recorder.getStatistics().descriptorSetBinds;
+        this->statistics.bufferBinds = recorder.getStatistics().bufferBinds;
+        this->statistics.bindsSkipped = recorder.getStatistics().bindsSkipped;
+
+        if (this->frame->getRenderMode() == RenderMode::eDeferred) {
+            commandBuffers[index].nextSubpass(vk::SubpassContents::eInline);
+            commandBuffers[index].bindPipeline(vk::PipelineBindPoint::eGraphics, this->lightingPipeline);
+            commandBuffers[index].setViewport(0, vk::Viewport(0.0f, 0.0f, width, height, 0.0f, 1.0f));
+            std::array<vk::DescriptorSet, 2> lightingSets = {this->descriptorSets[index], this->inputDescriptorSet};
+            commandBuffers[index].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->lightingPipelineLayout, 0,
+                    static_cast<uint32_t> (lightingSets.size()), lightingSets.data(), 0, nullptr);
+            // fullscreen triangle generated from vertex indices
+            commandBuffers[index].draw(3, 1, 0, 0);
+        }
+        commandBuffers[index].endRenderPass();
+        if (this->statisticsQueryPool) {
+            commandBuffers[index].endQuery(this->statisticsQueryPool, index);
+        }
+        if (this->timestampQueryPool) {
+            commandBuffers[index].writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, this->timestampQueryPool, firstTimestamp + 1);
+        }
+
+        if (this->postPipeline) {
+            // the scene image is smoothed into the swapchain image with a fullscreen triangle
+            commandBuffers[index].beginRenderPass(this->frame->getPostRenderPassBeginInfo(index), vk::SubpassContents::eInline);
+            commandBuffers[index].bindPipeline(vk::PipelineBindPoint::eGraphics, this->postPipeline);
+            commandBuffers[index].setViewport(0, vk::Viewport(0.0f, 0.0f, width, height, 0.0f, 1.0f));
+            commandBuffers[index].setScissor(0, scissor);
+            commandBuffers[index].bindDescriptorSets(vk::PipelineBindPoint::eGraphics, this->postPipelineLayout, 0, 1, &this->postDescriptorSet, 0, nullptr);
+            commandBuffers[index].draw(3, 1, 0, 0);
+            commandBuffers[index].endRenderPass();
+        }
+        if (this->timestampQueryPool) {
+            commandBuffers[index].writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, this->timestampQueryPool, firstTimestamp + 2);
+        }
+        commandBuffers[index].end();
+    }
+
+    void Engine::drawPart(uint32_t index, size_t slot, const zvlk::ModelPart& modelPart) {
+        if (!this->drawVisible[slot]) {
+            return;
+        }
+        this->statistics.drawCalls++;
+        if (this->occlusionCuller != nullptr && this->occlusionCuller->isSupported()) {
+            // occluded draws have had their instances removed by the culling pass
+            vk::DeviceSize commandSize = sizeof (vk::DrawIndexedIndirectCommand);
+            this->commandBuffers[index].drawIndexedIndirect(this->occlusionCuller->getCommandsBuffer(index), slot * commandSize, 1, commandSize);
+        } else {
+            this->commandBuffers[index].drawIndexed(modelPart.numberOfIndices, 1, modelPart.indexOffset, 0, 0);
+        }
+    }
+
+    uint32_t Engine::selectLod(const ModelUnit& model) const {
+        const std::vector<ModelLod>& lods = model.model->getLods();
+        if (this->lodThreshold <= 0.0f || lods.size() == 1) {
+            return 0;
+        }
+
+        // error of each level projected at the point of the bounding sphere nearest to the camera
+        const glm::mat4& view = this->camera->getView();
+        float scale = this->camera->getProjection()[1][1] * 0.5f * static_cast<float> (this->frame->getHeight());
+        const Bounds& bounds = model.model->getBounds();
+        const glm::mat4& matrix = model.matrix->getModelMatrix();
+        glm::vec3 center = glm::vec3(view * matrix * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.0f));
+        float axisScale = std::max(glm::length(glm::vec3(matrix[0])), std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+        float radius = glm::length(bounds.max - bounds.min) * 0.5f * axisScale;
+        float distance = glm::length(center) - radius;
+        if (distance <= 0.0f) {
+            return 0;
+        }
+
+        uint32_t lod = 0;
+        while (lod + 1 < lods.size() && lods[lod + 1].error * axisScale * scale / distance <= this->lodThreshold) {
+            lod++;
+        }
+        return lod;
+    }
+
+    void Engine::writeSceneDescriptors(uint32_t index) {
+        vk::DescriptorBufferInfo cameraInfo = this->camera->getDescriptorBufferInfo(index);
+        vk::DescriptorBufferInfo lightsInfo = this->lights->getDescriptorBufferInfo(index);
+        vk::DescriptorBufferInfo lightsBufferInfo = this->lights->getLightsBufferInfo(index);
+        vk::DescriptorBufferInfo clustersInfo = this->lights->getClustersBufferInfo(index);
+        vk::DescriptorBufferInfo lightIndicesInfo = this->lights->getLightIndicesBufferInfo(index);
+
+        this->descriptorAllocator->write(this->descriptorSets[index], this->sceneLayout,{
+            cameraInfo, lightsInfo, lightsBufferInfo, clustersInfo, lightIndicesInfo
+        });
+    }
+
+    void Engine::streamTextures(uint32_t index) {
+        TextureStreamer* streamer = this->deviceObject->getTextureStreamer();
+        if (!streamer->isEnabled()) {
+            return;
+        }
+
+        // textures are requested at the size of the meshes using them, from bounding spheres
+        const glm::mat4& view = this->camera->getView();
+        float scale = this->camera->getProjection()[1][1] * 0.5f * static_cast<float> (this->frame->getHeight());
+        for (ExecutionUnit& unit : this->units) {
+            for (ModelUnit& model : unit.models) {
+                const Bounds& bounds = model.model->getBounds();
+                const glm::mat4& matrix = model.matrix->getModelMatrix();
+                glm::vec3 center = glm::vec3(view * matrix * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.0f));
+                float axisScale = std::max(glm::length(glm::vec3(matrix[0])), std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+                float radius = glm::length(bounds.max - bounds.min) * 0.5f * axisScale;
+                float distance = glm::length(center);
+                float pixels = distance > radius ? 2.0f * radius * scale / distance : std::numeric_limits<float>::max();
+                for (zvlk::Material* material : model.materials) {
+                    streamer->request(material->getTexture().get(), pixels);
+                }
+            }
+        }
+        streamer->update();
+
+        // sets of the image are not in use any more, those of textures with new levels are rewritten
+        // in place, which also updates every model sharing the set
+        for (ExecutionUnit& unit : this->units) {
+            for (ModelUnit& model : unit.models) {
+                uint32_t i = 0;
+                for (zvlk::Material* material : model.materials) {
+                    uint32_t setIndex = i * this->frameNumber + index;
+                    uint64_t version = material->getTexture()->getVersion();
+                    if (model.textureVersions[setIndex] != version) {
+                        this->descriptorAllocator->write(model.descriptorSets[setIndex], this->materialLayout,{
+                            material->getDescriptorImageInfo(index), material->getDescriptorBufferInfo(index)
+                        });
+                        model.textureVersions[setIndex] = version;
+                    }
+                    i++;
+                }
+            }
+        }
+    }
+
+    void Engine::compileDeferredLighting() {
+        if (this->lightingVertexShader == nullptr || this->lightingFragmentShader == nullptr) {
+            throw std::runtime_error("deferred rendering with no lighting shaders enabled");
+        }
+
+        std::vector<vk::ImageView> inputAttachments = this->frame->getInputAttachments();
+        std::vector<vk::DescriptorSetLayoutBinding> inputBindings;
+        for (uint32_t i = 0; i < inputAttachments.size(); ++i) {
+            inputBindings.push_back(vk::DescriptorSetLayoutBinding(i, vk::DescriptorType::eInputAttachment, 1, vk::ShaderStageFlagBits::eFragment));
+        }
+        this->inputLayout = this->device.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo({},
+                static_cast<uint32_t> (inputBindings.size()), inputBindings.data()));
+
+        this->writeInputDescriptors();
+
+        std::array<vk::DescriptorSetLayout, 2> lightingLayouts = {this->sceneLayout, this->inputLayout};
+        this->lightingPipelineLayout = this->device.createPipelineLayout(vk::PipelineLayoutCreateInfo({},
+                static_cast<uint32_t> (lightingLayouts.size()), lightingLayouts.data()));
+
+        vk::PipelineShaderStageCreateInfo shaderStages[] = {
+            this->lightingVertexShader->getPipelineShaderStageCreateInfo(),
+            this->lightingFragmentShader->getPipelineShaderStageCreateInfo()
+        };
+        vk::PipelineVertexInputStateCreateInfo vertexInput;
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly({}, vk::PrimitiveTopology::eTriangleList, VK_FALSE);
+        vk::PipelineViewportStateCreateInfo viewportState({}, 1, nullptr, 1, nullptr);
+        vk::PipelineRasterizationStateCreateInfo rasterizer({}, VK_FALSE, VK_FALSE, vk::PolygonMode::eFill,
+                vk::CullModeFlagBits::eNone, vk::FrontFace::eCounterClockwise, VK_FALSE, 0.0f, 0.0f, 0.0f, 1.0f);
+        vk::PipelineMultisampleStateCreateInfo multisampling({}, vk::SampleCountFlagBits::e1);
+        vk::PipelineColorBlendAttachmentState colorBlendAttachment(VK_FALSE, vk::BlendFactor::eOne, vk::BlendFactor::eZero,
+                vk::BlendOp::eAdd, vk::BlendFactor::eOne, vk::BlendFactor::eZero, vk::BlendOp::eAdd,
+                vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+        vk::PipelineColorBlendStateCreateInfo colorBlending({}, VK_FALSE, vk::LogicOp::eCopy, 1, &colorBlendAttachment,{0.0f, 0.0f, 0.0f, 0.0f});
+        vk::PipelineDepthStencilStateCreateInfo depthStencil({}, VK_FALSE, VK_FALSE, vk::CompareOp::eAlways);
+
+        vk::GraphicsPipelineCreateInfo pipelineInfo({}, 2, shaderStages, &vertexInput, &inputAssembly,{}, &viewportState,
+                &rasterizer, &multisampling, &depthStencil, &colorBlending, Engine::dynamicViewportState(), this->lightingPipelineLayout,
+                frame->getRenderPass(), 1, vk::Pipeline(), -1);
+        this->lightingPipeline = device.createGraphicsPipelines(vk::PipelineCache(),{pipelineInfo})[0];
+    }
+
+    void Engine::writeInputDescriptors() {
+        this->inputDescriptorSet = this->descriptorAllocator->allocate(this->inputLayout);
+
+        // G-buffer attachments are shared by all framebuffers, so a single set serves every image
+        std::vector<vk::ImageView> inputAttachments = this->frame->getInputAttachments();
+        std::vector<vk::DescriptorImageInfo> inputInfos;
+        for (uint32_t i = 0; i < inputAttachments.size(); ++i) {
+            bool depth = i + 1 == inputAttachments.size();
+            inputInfos.push_back(vk::DescriptorImageInfo(vk::Sampler(), inputAttachments[i],
+                    depth ? vk::ImageLayout::eDepthStencilReadOnlyOptimal : vk::ImageLayout::eShaderReadOnlyOptimal));
+        }
+        std::vector<vk::WriteDescriptorSet> inputWrites;
+        for (uint32_t i = 0; i < inputInfos.size(); ++i) {
+            inputWrites.push_back(vk::WriteDescriptorSet(this->inputDescriptorSet, i, 0, 1, vk::DescriptorType::eInputAttachment, &inputInfos[i],{},{}));
+        }
+        this->device.updateDescriptorSets(inputWrites,{});
+    }
+
+    void Engine::compilePostProcess() {
+        if (this->postVertexShader == nullptr || this->postFragmentShader == nullptr) {
+            throw std::runtime_error("post-process anti-aliasing with no shaders enabled");
+        }
+        this->writePostDescriptors();
+
+        vk::PipelineShaderStageCreateInfo shaderStages[] = {
+            this->postVertexShader->getPipelineShaderStageCreateInfo(),
+            this->postFragmentShader->getPipelineShaderStageCreateInfo()
+        };
+        vk::PipelineVertexInputStateCreateInfo vertexInput;
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly({}, vk::PrimitiveTopology::eTriangleList, VK_FALSE);
+        vk::PipelineViewportStateCreateInfo viewportState({}, 1, nullptr, 1, nullptr);
+        vk::PipelineRasterizationStateCreateInfo rasterizer({}, VK_FALSE, VK_FALSE, vk::PolygonMode::eFill,
+                vk::CullModeFlagBits::eNone, vk::FrontFace::eCounterClockwise, VK_FALSE, 0.0f, 0.0f, 0.0f, 1.0f);
+        vk::PipelineMultisampleStateCreateInfo multisampling({}, vk::SampleCountFlagBits::e1);
+        vk::PipelineColorBlendAttachmentState colorBlendAttachment(VK_FALSE, vk::BlendFactor::eOne, vk::BlendFactor::eZero,
+                vk::BlendOp::eAdd, vk::BlendFactor::eOne, vk::BlendFactor::eZero, vk::BlendOp::eAdd,
+                vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+        vk::PipelineColorBlendStateCreateInfo colorBlending({}, VK_FALSE, vk::LogicOp::eCopy, 1, &colorBlendAttachment,{0.0f, 0.0f, 0.0f, 0.0f});
+        vk::PipelineDepthStencilStateCreateInfo depthStencil({}, VK_FALSE, VK_FALSE, vk::CompareOp::eAlways);
+
+        vk::GraphicsPipelineCreateInfo pipelineInfo({}, 2, shaderStages, &vertexInput, &inputAssembly,{}, &viewportState,
+                &rasterizer, &multisampling, &depthStencil, &colorBlending, Engine::dynamicViewportState(), this->postPipelineLayout,
+                frame->getPostRenderPass(), 0, vk::Pipeline(), -1);
+        this->postPipeline = device.createGraphicsPipelines(vk::PipelineCache(),{pipelineInfo})[0];
+    }
+
+    void Engine::writePostDescriptors() {
+        // filtered, so edges are blended by sampling between texels
+        vk::SamplerCreateInfo samplerInfo({}, vk::Filter::eLinear, vk::Filter::eLinear, vk::SamplerMipmapMode::eNearest,
+                vk::SamplerAddressMode::eClampToEdge, vk::SamplerAddressMode::eClampToEdge, vk::SamplerAddressMode::eClampToEdge,
+                0.0f, VK_FALSE, 1.0f, VK_FALSE, vk::CompareOp::eAlways, 0.0f, 0.0f);
+        vk::Sampler sampler = this->deviceObject->getAssetCache()->getSampler(samplerInfo);
+
+        this->postDescriptorSet = this->descriptorAllocator->allocate(this->postLayout);
+        this->descriptorAllocator->write(this->postDescriptorSet, this->postLayout,{
+            vk::DescriptorImageInfo(sampler, this->frame->getSceneImageView(), vk::ImageLayout::eShaderReadOnlyOptimal)
+        });
+    }
+
+    void Engine::compileDepthPrepass() {
+        // positions only, with the stride of full vertices
+        vk::VertexInputBindingDescription binding = Vertex::getBindingDescription();
+        vk::VertexInputAttributeDescription position = Vertex::getAttributeDescriptions()[0];
+        vk::PipelineVertexInputStateCreateInfo vertexInput({}, 1, &binding, 1, &position);
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly({}, vk::PrimitiveTopology::eTriangleList, VK_FALSE);
+        vk::PipelineViewportStateCreateInfo viewportState({}, 1, nullptr, 1, nullptr);
+        vk::PipelineRasterizationStateCreateInfo rasterizer({}, VK_FALSE, VK_FALSE, vk::PolygonMode::eFill,
+                vk::CullModeFlagBits::eBack, vk::FrontFace::eCounterClockwise, VK_FALSE, 0.0f, 0.0f, 0.0f, 1.0f);
+        vk::PipelineMultisampleStateCreateInfo multisampling({}, frame->getSampleCount());
+        vk::PipelineDepthStencilStateCreateInfo depthStencil({}, VK_TRUE, VK_TRUE, vk::CompareOp::eLess);
+        // no fragment shader, attachments of the subpass are left untouched
+        vk::PipelineColorBlendAttachmentState colorBlendAttachment(VK_FALSE);
+        std::vector<vk::PipelineColorBlendAttachmentState> colorBlendAttachments(frame->getColorAttachmentsNumber(), colorBlendAttachment);
+        vk::PipelineColorBlendStateCreateInfo colorBlending({}, VK_FALSE, vk::LogicOp::eCopy,
+                static_cast<uint32_t> (colorBlendAttachments.size()), colorBlendAttachments.data());
+
+        vk::GraphicsPipelineCreateInfo pipelineInfo({}, 1, &this->prepassVertexShader->getPipelineShaderStageCreateInfo(), &vertexInput, &inputAssembly,{},
+                &viewportState, &rasterizer, &multisampling, &depthStencil, &colorBlending, Engine::dynamicViewportState(), this->pipelineLayout,
+                frame->getRenderPass(), 0, vk::Pipeline(), -1);
+        this->prepassPipeline = this->device.createGraphicsPipelines(vk::PipelineCache(),{pipelineInfo})[0];
+    }
+
+    void Engine::compileStaticBatch(ExecutionUnit& unit) {
+        unit.staticChanged = false;
+        if (unit.staticModels.empty()) {
+            return;
+        }
+
+        std::vector<std::pair<zvlk::Model*, glm::mat4>> sources;
+        for (ModelUnit& model : unit.staticModels) {
+            sources.push_back({model.model, model.matrix->getModelMatrix()});
+        }
+        unit.staticBatch = new Model(this->deviceObject, sources);
+        // geometry is already in world space, the identity matrices never change after this upload
+        unit.staticMatrices = new TransformationMatrices(this->deviceObject, this->frame);
+        for (uint32_t j = 0; j < this->frameNumber; j++) {
+            static_cast<zvlk::UniformBuffer*> (unit.staticMatrices)->update(j);
+        }
+        unit.models.push_back({unit.staticBatch, unit.staticMatrices, unit.staticBatch->getMaterials()});
+        unit.models.back().isBatch = true;
+        unit.models.back().handle = std::numeric_limits<uint32_t>::max();
+        if (this->compiled) {
+            this->compileModel(unit.models.back());
+        }
+    }
+
+    void Engine::releaseStaticBatch(ExecutionUnit& unit) {
+        for (auto it = unit.models.begin(); it != unit.models.end(); ++it) {
+            if (it->isBatch) {
+                if (this->compiled) {
+                    this->releaseModel(*it);
+                }
+                unit.models.erase(it);
+                break;
+            }
+        }
+        // buffers of the batch may be read by frames in flight
+        Model* batch = unit.staticBatch;
+        TransformationMatrices* matrices = unit.staticMatrices;
+        if (batch != nullptr) {
+            this->deviceObject->deferDestruction([batch, matrices]() {
+                delete batch;
+                delete matrices;
+            });
+        }
+        unit.staticBatch = nullptr;
+        unit.staticMatrices = nullptr;
+    }
 }
@@ -0,0 +1,224 @@
+/* 
+ * File:   FileSystem.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 00:50
+ */
+
+#include "FileSystem.h"
+#include "MappedFile.h"
+#include "Pack.h"
+
+#include <stdexcept>
+#include <filesystem>
+#include <future>
+#include <thread>
+
+#include <zip.h>
+
+namespace zvlk {
+
+    namespace {
+
+        class DirectoryMount : public Mount {
+        public:
+
+            DirectoryMount(const std::string& path) {
+                this->root = path;
+                if (!std::filesystem::is_directory(this->root)) {
+                    throw std::runtime_error("failed to mount directory " + path);
+                }
+            }
+
+            bool exists(const std::string& name) override {
+                return std::filesystem::is_regular_file(this->root / name);
+            }
+
+            Blob read(const std::string& name) override {
+                if (!this->exists(name)) {
+                    return Blob();
+                }
+                return Blob(std::make_shared<MappedFile>((this->root / name).string()));
+            }
+
+            std::vector<std::string> list() override {
+                std::vector<std::string> names;
+                for (const auto& entry : std::filesystem::recursive_directory_iterator(this->root)) {
+                    if (entry.is_regular_file()) {
+                        names.push_back(entry.path().lexically_relative(this->root).generic_string());
+                    }
+                }
+                return names;
+            }
+        private:
+            std::filesystem::path root;
+        };
+
+        class ArchiveMount : public Mount {
+        public:
+
+            ArchiveMount(const std::string& path) {
+                int error;
+                this->archive = zip_open(path.c_str(), ZIP_RDONLY, &error);
+                if (this->archive == nullptr) {
+                    throw std::runtime_error("failed to mount archive " + path);
+                }
+            }
+
+            ~ArchiveMount() override {
+                // opened read only, there is nothing to write back
+                zip_discard(this->archive);
+            }
+
+            bool exists(const std::string& name) override {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                return zip_name_locate(this->archive, name.c_str(), 0) >= 0;
+            }
+
+            Blob read(const std::string& name) override {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                zip_int64_t index = zip_name_locate(this->archive, name.c_str(), 0);
+                zip_stat_t stat;
+                if (index < 0 || zip_stat_index(this->archive, index, 0, &stat) != 0) {
+                    return Blob();
+                }
+                zip_file_t* file = zip_fopen_index(this->archive, index, 0);
+                if (file == nullptr) {
+                    throw std::runtime_error("failed to open " + name + " in archive");
+                }
+                std::vector<uint8_t> content(stat.size);
+                zip_int64_t read = zip_fread(file, content.data(), content.size());
+                zip_fclose(file);
+                if (read != static_cast<zip_int64_t> (content.size())) {
+                    throw std::runtime_error("failed to inflate " + name + " from archive");
+                }
+                return Blob(std::move(content));
+            }
+
+            std::vector<std::string> list() override {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                std::vector<std::string> names;
+                zip_int64_t entries = zip_get_num_entries(this->archive, 0);
+                for (zip_int64_t i = 0; i < entries; ++i) {
+                    std::string name = zip_get_name(this->archive, i, 0);
+                    if (!name.empty() && name.back() != '/') {
+                        names.push_back(name);
+                    }
+                }
+                return names;
+            }
+        private:
+            zip_t* archive;
+            // libzip handles are not safe for concurrent use
+            std::mutex mutex;
+        };
+
+        std::string normalize(const std::string& name) {
+            return std::filesystem::path(name).lexically_normal().generic_string();
+        }
+    }
+
+    Blob::Blob() {
+        this->data = nullptr;
+        this->size = 0;
+    }
+
+    Blob::Blob(std::vector<uint8_t> content) {
+        this->content = std::make_shared<const std::vector<uint8_t>>(std::move(content));
+        this->data = this->content->data();
+        this->size = this->content->size();
+    }
+
+    Blob::Blob(std::shared_ptr<MappedFile> file) {
+        this->file = file;
+        this->data = file->getData();
+        this->size = file->getSize();
+    }
+
+    Blob::Blob(std::shared_ptr<MappedFile> file, size_t offset, size_t size) {
+        if (offset > file->getSize() || size > file->getSize() - offset) {
+            throw std::out_of_range("blob outside of its mapped file");
+        }
+        this->file = file;
+        this->data = file->getData() + offset;
+        this->size = size;
+    }
+
+    FileSystem::FileSystem() {
+    }
+
+    FileSystem::~FileSystem() {
+    }
+
+    Mount* FileSystem::mountDirectory(const std::string& path) {
+        return this->mount(std::make_unique<DirectoryMount>(path));
+    }
+
+    Mount* FileSystem::mountArchive(const std::string& path) {
+        return this->mount(std::make_unique<ArchiveMount>(path));
+    }
+
+    Mount* FileSystem::mountPack(const std::string& path) {
+        return this->mount(std::make_unique<Pack>(path));
+    }
+
+    Mount* FileSystem::mount(std::unique_ptr<Mount> mount) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->mounts.push_back(std::move(mount));
+        return this->mounts.back().get();
+    }
+
+    Mount* FileSystem::find(const std::string& name) {
+        // mounts are never removed, so the one found stays valid after the lock is released
+        std::lock_guard<std::mutex> lock(this->mutex);
+        for (auto mount = this->mounts.rbegin(); mount != this->mounts.rend(); ++mount) {
+            if ((*mount)->exists(name)) {
+                return mount->get();
+            }
+        }
+        return nullptr;
+    }
+
+    bool FileSystem::exists(const std::string& name) {
+        return this->find(normalize(name)) != nullptr || std::filesystem::is_regular_file(name);
+    }
+
+    Blob FileSystem::read(const std::string& name) {
+        std::string normalized = normalize(name);
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            auto prefetched = this->prefetched.find(normalized);
+            if (prefetched != this->prefetched.end()) {
+                Blob content = prefetched->second;
+                this->prefetched.erase(prefetched);
+                return content;
+            }
+        }
+        Mount* mount = this->find(normalized);
+        if (mount) {
+            return mount->read(normalized);
+        }
+        if (!std::filesystem::is_regular_file(name)) {
+            throw std::runtime_error("failed to open file " + name);
+        }
+        return Blob(std::make_shared<MappedFile>(name));
+    }
+
+    void FileSystem::prefetch(const std::vector<std::string>& names) {
+        std::vector<std::future<Blob>> tasks;
+        for (const std::string& name : names) {
+            tasks.push_back(std::async(std::launch::async, [this, name]() {
+                return this->read(name);
+            }));
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            try {
+                Blob content = tasks[i].get();
+                std::lock_guard<std::mutex> lock(this->mutex);
+                this->prefetched[normalize(names[i])] = content;
+            } catch (const std::exception&) {
+                // reported when the file is actually read
+            }
+        }
+    }
+}
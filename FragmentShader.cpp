@@ -13,6 +13,6 @@ namespace zvlk {
     FragmentShader::~FragmentShader() {
     }
 
-    FragmentShader::FragmentShader(vk::Device device, const char* name) : Shader(device, name, vk::ShaderStageFlagBits::eFragment) {
+    FragmentShader::FragmentShader(vk::Device device, const Blob& code) : Shader(device, code, vk::ShaderStageFlagBits::eFragment) {
     }
 }
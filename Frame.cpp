@@ -11,34 +11,80 @@
 
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
 #include <array>
 #include <tuple>
 
 namespace zvlk {
 
+    // albedo, normal with shininess, specular, ambient
+    static const std::array<vk::Format, 4> gBufferFormats = {vk::Format::eR8G8B8A8Unorm, vk::Format::eR16G16B16A16Sfloat,
+        vk::Format::eR8G8B8A8Unorm, vk::Format::eR8G8B8A8Unorm};
+
     Frame::~Frame() {
         this->destroy();
     }
     
     void Frame::destroy() {
+        this->destroyAttachments();
+
+        this->device->destroyLater(this->renderPass);
+        this->device->destroyLater(this->postRenderPass);
+        this->device->destroyLater(this->swapChain);
+        this->renderPass = nullptr;
+        this->postRenderPass = nullptr;
+        this->swapChain = nullptr;
+    }
+
+    void Frame::destroyAttachments() {
+        // frames in flight may still render into the attachments, they are destroyed once those complete
         for (auto imageView : this->swapChainImageViews) {
-            this->graphicsDevice.destroy(imageView);
+            this->device->destroyLater(imageView);
         }
+        this->swapChainImageViews.clear();
+
+        this->device->destroyLater(this->colorImageView);
+        this->device->destroyLater(this->colorImage);
+        this->device->destroyLater(this->colorImageMemory);
+        // the next create may be in a mode with no multisampled color image
+        this->colorImageView = nullptr;
+        this->colorImage = nullptr;
+        this->colorImageMemory = nullptr;
+
+        for (size_t i = 0; i < this->gBufferImages.size(); i++) {
+            this->device->destroyLater(this->gBufferImageViews[i]);
+            this->device->destroyLater(this->gBufferImages[i]);
+            this->device->destroyLater(this->gBufferImagesMemory[i]);
+        }
+        this->gBufferImageViews.clear();
+        this->gBufferImages.clear();
+        this->gBufferImagesMemory.clear();
 
-        this->graphicsDevice.destroy(this->renderPass);
-        this->graphicsDevice.destroy(this->swapChain);
-
-        this->graphicsDevice.destroy(this->colorImageView);
-        this->graphicsDevice.destroy(this->colorImage);
-        this->graphicsDevice.free(this->colorImageMemory);
-
-        this->graphicsDevice.destroy(this->depthImageView);
-        this->graphicsDevice.destroy(this->depthImage);
-        this->graphicsDevice.free(this->depthImageMemory);
+        this->device->destroyLater(this->depthImageView);
+        this->device->destroyLater(this->depthImage);
+        this->device->destroyLater(this->depthImageMemory);
+        this->depthImageView = nullptr;
+        this->depthImage = nullptr;
+        this->depthImageMemory = nullptr;
 
         for (auto framebuffer : this->swapChainFramebuffers) {
-            this->graphicsDevice.destroy(framebuffer);
+            this->device->destroyLater(framebuffer);
+        }
+        this->swapChainFramebuffers.clear();
+
+        this->device->destroyLater(this->sceneImageView);
+        this->device->destroyLater(this->sceneImage);
+        this->device->destroyLater(this->sceneImageMemory);
+        this->sceneImageView = nullptr;
+        this->sceneImage = nullptr;
+        this->sceneImageMemory = nullptr;
+        for (auto framebuffer : this->postFramebuffers) {
+            this->device->destroyLater(framebuffer);
         }
+        this->postFramebuffers.clear();
+
+        this->lazyMemory.clear();
+        this->attachmentStatistics = {};
     }
 
     uint32_t Frame::getImagesNumber() {
@@ -54,28 +100,66 @@ namespace zvlk {
     }
 
     Frame::Frame(zvlk::Device* device, vk::SurfaceKHR surface) {
+        this->device = device;
         this->graphicsDevice = device->getGraphicsDevice();
         this->create(device, surface);
     }
     
     void Frame::create(zvlk::Device* device, vk::SurfaceKHR surface) {
+        this->device = device;
         zvlk::SwapChainSupportDetails swapChainSupport = device->querySwapChainSupport(surface);
 
+        this->createSwapChain(surface, swapChainSupport.capabilities.minImageCount + 1, vk::SwapchainKHR());
+
+        this->depthFormat = this->findDepthFormat(device);
+        this->createRenderPasses();
+        this->createAttachments();
+    }
+
+    bool Frame::recreate(vk::SurfaceKHR surface) {
+        // frames in flight keep presenting images of the retired swapchain and rendering into the old
+        // attachments, all of them are destroyed once those frames complete
+        vk::SwapchainKHR oldSwapChain = this->swapChain;
+        vk::Format oldFormat = this->swapChainImageFormat;
+        uint32_t imagesNumber = static_cast<uint32_t> (this->swapChainImages.size());
+        this->destroyAttachments();
+
+        // the count is only a minimum, the driver or new surface limits may give another one
+        this->createSwapChain(surface, imagesNumber, oldSwapChain);
+        this->device->destroyLater(oldSwapChain);
+
+        // a render pass of the same formats stays compatible with every pipeline created for it
+        bool formatsKept = this->swapChainImageFormat == oldFormat && !this->configurationChanged;
+        if (!formatsKept) {
+            this->device->destroyLater(this->renderPass);
+            this->device->destroyLater(this->postRenderPass);
+            this->postRenderPass = nullptr;
+            this->createRenderPasses();
+        }
+        this->createAttachments();
+        // per image buffers of the engine are sized on compile
+        return formatsKept && this->swapChainImages.size() == imagesNumber;
+    }
+
+    void Frame::createSwapChain(vk::SurfaceKHR surface, uint32_t imageCount, vk::SwapchainKHR oldSwapChain) {
+        zvlk::SwapChainSupportDetails swapChainSupport = this->device->querySwapChainSupport(surface);
+
         vk::SurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
         vk::PresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
         vk::Extent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
-        uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+        imageCount = std::max(imageCount, swapChainSupport.capabilities.minImageCount);
         if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) {
             imageCount = swapChainSupport.capabilities.maxImageCount;
         }
 
+        // the retired swapchain hands its resources over, images it already acquired can still be presented
         vk::SwapchainCreateInfoKHR createInfo({}, surface, imageCount, surfaceFormat.format, surfaceFormat.colorSpace,
                 extent, 1, vk::ImageUsageFlagBits::eColorAttachment, vk::SharingMode::eExclusive, 0, nullptr,
                 swapChainSupport.capabilities.currentTransform, vk::CompositeAlphaFlagBitsKHR::eOpaque,
-                presentMode, VK_TRUE);
+                presentMode, VK_TRUE, oldSwapChain);
 
-        std::set<uint32_t> uniqueQueueFamiliesSet = device->findQueueFamilies(surface).getUniqueQueueFamilies();
+        std::set<uint32_t> uniqueQueueFamiliesSet = this->device->findQueueFamilies(surface).getUniqueQueueFamilies();
         std::vector<uint32_t> uniqueQueueFamilies(uniqueQueueFamiliesSet.begin(), uniqueQueueFamiliesSet.end());
         if (uniqueQueueFamilies.size() == 2) { //if ownership has to be transferred between  queues (for multiple queues)
             createInfo.setImageSharingMode(vk::SharingMode::eConcurrent)
@@ -91,67 +175,226 @@ namespace zvlk {
 
         this->swapChainImageViews.resize(this->swapChainImages.size());
         for (size_t i = 0; i < this->swapChainImages.size(); i++) {
-            swapChainImageViews[i] = device->createImageView(swapChainImages[i], swapChainImageFormat, vk::ImageAspectFlagBits::eColor, 1);
+            swapChainImageViews[i] = this->device->createImageView(swapChainImages[i], swapChainImageFormat, vk::ImageAspectFlagBits::eColor, 1);
         }
+    }
 
-        vk::SampleCountFlagBits msaaSamples = device->getMaxUsableSampleCount();
-        vk::Format depthFormat = this->findDepthFormat(device);
-
-        vk::AttachmentDescription colorAttachment({}, swapChainImageFormat, msaaSamples,
-                vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
-                vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
-                vk::ImageLayout::eUndefined, vk::ImageLayout::eColorAttachmentOptimal);
-        vk::AttachmentReference colorAttachmentRef(0, vk::ImageLayout::eColorAttachmentOptimal);
+    void Frame::createRenderPasses() {
+        if (this->renderMode == RenderMode::eDeferred) {
+            this->createDeferredRenderPass();
+        } else {
+            this->createRenderPass();
+        }
+        if (this->antiAliasing == AntiAliasing::eFxaa) {
+            this->createPostRenderPass();
+        }
+        this->configurationChanged = false;
+    }
 
-        vk::AttachmentDescription depthAttachment({}, depthFormat, msaaSamples,
+    void Frame::createRenderPass() {
+        bool fxaa = this->antiAliasing == AntiAliasing::eFxaa;
+        this->sampleCount = fxaa ? vk::SampleCountFlagBits::e1 : this->device->getUsableSampleCount(this->requestedSampleCount);
+        bool multisampled = this->sampleCount != vk::SampleCountFlagBits::e1;
+
+        std::vector<vk::AttachmentDescription> attachments;
+        if (multisampled) {
+            // multisampled color is resolved within the subpass, like depth it never has to be written to memory
+            attachments.push_back(vk::AttachmentDescription({}, swapChainImageFormat, this->sampleCount,
+                    vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
+                    vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+                    vk::ImageLayout::eUndefined, vk::ImageLayout::eColorAttachmentOptimal));
+        }
+        uint32_t depthIndex = static_cast<uint32_t> (attachments.size());
+        attachments.push_back(vk::AttachmentDescription({}, this->depthFormat, this->sampleCount,
                 vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
                 vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
-                vk::ImageLayout::eUndefined, vk::ImageLayout::eDepthStencilAttachmentOptimal);
-        vk::AttachmentReference depthAttachmentRef(1, vk::ImageLayout::eDepthStencilAttachmentOptimal);
-
-        vk::AttachmentDescription colorAttachmentResolve({}, swapChainImageFormat,
-                vk::SampleCountFlagBits::e1, vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eStore,
+                vk::ImageLayout::eUndefined, vk::ImageLayout::eDepthStencilAttachmentOptimal));
+        // the swapchain image, or the scene image sampled by the post-process pass
+        uint32_t targetIndex = static_cast<uint32_t> (attachments.size());
+        attachments.push_back(vk::AttachmentDescription({}, swapChainImageFormat,
+                vk::SampleCountFlagBits::e1, multisampled ? vk::AttachmentLoadOp::eDontCare : vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
                 vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
-                vk::ImageLayout::eUndefined, vk::ImageLayout::ePresentSrcKHR);
-        vk::AttachmentReference colorAttachmentResolveRef(2, vk::ImageLayout::eColorAttachmentOptimal);
+                vk::ImageLayout::eUndefined, fxaa ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::ePresentSrcKHR));
+
+        vk::AttachmentReference colorAttachmentRef(0, vk::ImageLayout::eColorAttachmentOptimal);
+        vk::AttachmentReference depthAttachmentRef(depthIndex, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+        vk::AttachmentReference targetAttachmentRef(targetIndex, vk::ImageLayout::eColorAttachmentOptimal);
 
         vk::SubpassDescription subpass({}, vk::PipelineBindPoint::eGraphics, 0, nullptr,
-                1, &colorAttachmentRef, &colorAttachmentResolveRef, &depthAttachmentRef);
+                1, multisampled ? &colorAttachmentRef : &targetAttachmentRef, multisampled ? &targetAttachmentRef : nullptr, &depthAttachmentRef);
 
-        vk::SubpassDependency dependency(VK_SUBPASS_EXTERNAL, 0,
+        std::vector<vk::SubpassDependency> dependencies = {vk::SubpassDependency(VK_SUBPASS_EXTERNAL, 0,
                 vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eColorAttachmentOutput,
-        {}, vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite);
+        {}, vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite)};
+        if (fxaa) {
+            this->addPostDependencies(dependencies, 0);
+        }
 
-        std::array<vk::AttachmentDescription, 3> attachments = {colorAttachment, depthAttachment, colorAttachmentResolve};
         vk::RenderPassCreateInfo renderPassInfo({},
         static_cast<uint32_t> (attachments.size()), attachments.data(),
                 1, &subpass,
-                1, &dependency);
+                static_cast<uint32_t> (dependencies.size()), dependencies.data());
+
+        this->renderPass = this->graphicsDevice.createRenderPass(renderPassInfo);
+
+        this->clearValues.clear();
+        if (multisampled) {
+            this->clearValues.push_back(vk::ClearValue(vk::ClearColorValue(std::array<float,4>({0.0f, 0.0f, 0.0f, 1.0f}))));
+        }
+        this->clearValues.push_back(vk::ClearValue(vk::ClearDepthStencilValue(1.0f, 0)));
+        this->clearValues.push_back(vk::ClearValue(vk::ClearColorValue(std::array<float,4>({0.0f, 0.0f, 0.0f, 1.0f}))));
+    }
+
+    void Frame::addPostDependencies(std::vector<vk::SubpassDependency>& dependencies, uint32_t lastSubpass) {
+        // the post-process pass of the previous frame must be done sampling the scene image before it is overwritten,
+        // and the one of this frame samples it only once it is written
+        dependencies.push_back(vk::SubpassDependency(VK_SUBPASS_EXTERNAL, lastSubpass,
+                vk::PipelineStageFlagBits::eFragmentShader, vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                {}, vk::AccessFlagBits::eColorAttachmentWrite));
+        dependencies.push_back(vk::SubpassDependency(lastSubpass, VK_SUBPASS_EXTERNAL,
+                vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eFragmentShader,
+                vk::AccessFlagBits::eColorAttachmentWrite, vk::AccessFlagBits::eShaderRead));
+    }
 
+    void Frame::createPostRenderPass() {
+        // every pixel is written by the fullscreen pass, so nothing is loaded
+        vk::AttachmentDescription presentAttachment({}, swapChainImageFormat, vk::SampleCountFlagBits::e1,
+                vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eStore,
+                vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+                vk::ImageLayout::eUndefined, vk::ImageLayout::ePresentSrcKHR);
+        vk::AttachmentReference presentAttachmentRef(0, vk::ImageLayout::eColorAttachmentOptimal);
+        vk::SubpassDescription subpass({}, vk::PipelineBindPoint::eGraphics, 0, nullptr, 1, &presentAttachmentRef);
+        vk::SubpassDependency dependency(VK_SUBPASS_EXTERNAL, 0,
+                vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eColorAttachmentOutput,
+                {}, vk::AccessFlagBits::eColorAttachmentWrite);
+
+        this->postRenderPass = this->graphicsDevice.createRenderPass(vk::RenderPassCreateInfo({}, 1, &presentAttachment, 1, &subpass, 1, &dependency));
+    }
+
+    void Frame::createDeferredRenderPass() {
+        const uint32_t gBufferSize = static_cast<uint32_t> (gBufferFormats.size());
+        const uint32_t depthIndex = gBufferSize;
+        const uint32_t presentIndex = gBufferSize + 1;
+        this->sampleCount = vk::SampleCountFlagBits::e1;
+
+        // G-buffer is only consumed within the render pass, so it never has to leave tile memory
+        std::vector<vk::AttachmentDescription> attachments;
+        std::vector<vk::AttachmentReference> gBufferRefs;
+        std::vector<vk::AttachmentReference> inputRefs;
+        for (uint32_t i = 0; i < gBufferSize; ++i) {
+            attachments.push_back(vk::AttachmentDescription({}, gBufferFormats[i], vk::SampleCountFlagBits::e1,
+                    vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
+                    vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+                    vk::ImageLayout::eUndefined, vk::ImageLayout::eShaderReadOnlyOptimal));
+            gBufferRefs.push_back(vk::AttachmentReference(i, vk::ImageLayout::eColorAttachmentOptimal));
+            inputRefs.push_back(vk::AttachmentReference(i, vk::ImageLayout::eShaderReadOnlyOptimal));
+        }
+        attachments.push_back(vk::AttachmentDescription({}, this->depthFormat, vk::SampleCountFlagBits::e1,
+                vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
+                vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+                vk::ImageLayout::eUndefined, vk::ImageLayout::eDepthStencilReadOnlyOptimal));
+        vk::AttachmentReference depthAttachmentRef(depthIndex, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+        inputRefs.push_back(vk::AttachmentReference(depthIndex, vk::ImageLayout::eDepthStencilReadOnlyOptimal));
+
+        bool fxaa = this->antiAliasing == AntiAliasing::eFxaa;
+        attachments.push_back(vk::AttachmentDescription({}, swapChainImageFormat, vk::SampleCountFlagBits::e1,
+                vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eStore,
+                vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+                vk::ImageLayout::eUndefined, fxaa ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::ePresentSrcKHR));
+        vk::AttachmentReference presentAttachmentRef(presentIndex, vk::ImageLayout::eColorAttachmentOptimal);
+
+        std::array<vk::SubpassDescription, 2> subpasses = {
+            vk::SubpassDescription({}, vk::PipelineBindPoint::eGraphics, 0, nullptr,
+            gBufferSize, gBufferRefs.data(), nullptr, &depthAttachmentRef),
+            vk::SubpassDescription({}, vk::PipelineBindPoint::eGraphics,
+            static_cast<uint32_t> (inputRefs.size()), inputRefs.data(), 1, &presentAttachmentRef, nullptr, nullptr)
+        };
+
+        std::vector<vk::SubpassDependency> dependencies = {
+            // previous frame must be done with the shared G-buffer before it is cleared
+            vk::SubpassDependency(VK_SUBPASS_EXTERNAL, 0,
+            vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eLateFragmentTests | vk::PipelineStageFlagBits::eFragmentShader,
+            vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eEarlyFragmentTests,
+            vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+            vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite),
+            vk::SubpassDependency(0, 1,
+            vk::PipelineStageFlagBits::eColorAttachmentOutput | vk::PipelineStageFlagBits::eLateFragmentTests,
+            vk::PipelineStageFlagBits::eFragmentShader,
+            vk::AccessFlagBits::eColorAttachmentWrite | vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+            vk::AccessFlagBits::eInputAttachmentRead, vk::DependencyFlagBits::eByRegion)
+        };
+        if (fxaa) {
+            this->addPostDependencies(dependencies, 1);
+        }
+
+        vk::RenderPassCreateInfo renderPassInfo({},
+        static_cast<uint32_t> (attachments.size()), attachments.data(),
+                static_cast<uint32_t> (subpasses.size()), subpasses.data(),
+                static_cast<uint32_t> (dependencies.size()), dependencies.data());
         this->renderPass = this->graphicsDevice.createRenderPass(renderPassInfo);
 
-        device->createImage(swapChainExtent.width, swapChainExtent.height, 1, msaaSamples,
-                swapChainImageFormat, vk::ImageTiling::eOptimal,
-                vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eColorAttachment,
-                vk::MemoryPropertyFlagBits::eDeviceLocal, colorImage, colorImageMemory);
-        this->colorImageView = device->createImageView(colorImage, swapChainImageFormat, vk::ImageAspectFlagBits::eColor, 1);
+        this->clearValues.assign(gBufferSize, vk::ClearValue(vk::ClearColorValue(std::array<float, 4>({0.0f, 0.0f, 0.0f, 0.0f}))));
+        this->clearValues.push_back(vk::ClearValue(vk::ClearDepthStencilValue(1.0f, 0)));
+        this->clearValues.push_back(vk::ClearValue(vk::ClearColorValue(std::array<float, 4>({0.0f, 0.0f, 0.0f, 1.0f}))));
+    }
 
-        device->createImage(swapChainExtent.width, swapChainExtent.height, 1, msaaSamples, depthFormat,
-                vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eDepthStencilAttachment,
-                vk::MemoryPropertyFlagBits::eDeviceLocal, depthImage, depthImageMemory);
-        this->depthImageView = device->createImageView(this->depthImage, depthFormat, vk::ImageAspectFlagBits::eDepth, 1);
+    void Frame::createAttachments() {
+        this->attachmentStatistics = {};
+        std::vector<vk::ImageView> views;
+        if (this->renderMode == RenderMode::eDeferred) {
+            const uint32_t gBufferSize = static_cast<uint32_t> (gBufferFormats.size());
+            this->gBufferImages.resize(gBufferSize);
+            this->gBufferImagesMemory.resize(gBufferSize);
+            this->gBufferImageViews.resize(gBufferSize);
+            for (uint32_t i = 0; i < gBufferSize; ++i) {
+                this->createAttachment(vk::SampleCountFlagBits::e1, gBufferFormats[i],
+                        vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eInputAttachment,
+                        this->gBufferImages[i], this->gBufferImagesMemory[i]);
+                this->gBufferImageViews[i] = this->device->createImageView(this->gBufferImages[i], gBufferFormats[i], vk::ImageAspectFlagBits::eColor, 1);
+            }
 
-        device->transitionImageLayout(this->depthImage, depthFormat, vk::ImageLayout::eUndefined,
-                vk::ImageLayout::eDepthStencilAttachmentOptimal, 1);
+            this->createAttachment(vk::SampleCountFlagBits::e1, this->depthFormat,
+                    vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eInputAttachment,
+                    depthImage, depthImageMemory);
+            this->depthImageView = this->device->createImageView(this->depthImage, this->depthFormat, vk::ImageAspectFlagBits::eDepth, 1);
 
-        swapChainFramebuffers.resize(this->swapChainImageViews.size());
+            views = this->gBufferImageViews;
+            views.push_back(this->depthImageView);
+        } else {
+            // only the resolved image leaves the render pass, layouts of both are set by it from undefined
+            if (this->sampleCount != vk::SampleCountFlagBits::e1) {
+                this->createAttachment(this->sampleCount, swapChainImageFormat, vk::ImageUsageFlagBits::eColorAttachment,
+                        colorImage, colorImageMemory);
+                this->colorImageView = this->device->createImageView(colorImage, swapChainImageFormat, vk::ImageAspectFlagBits::eColor, 1);
+                views.push_back(this->colorImageView);
+            }
 
+            this->createAttachment(this->sampleCount, this->depthFormat, vk::ImageUsageFlagBits::eDepthStencilAttachment,
+                    depthImage, depthImageMemory);
+            this->depthImageView = this->device->createImageView(this->depthImage, this->depthFormat, vk::ImageAspectFlagBits::eDepth, 1);
+            views.push_back(this->depthImageView);
+        }
+
+        if (this->postRenderPass) {
+            // the scene is rendered into an image of its own, which the post-process pass samples into the swapchain image
+            this->device->createImage(swapChainExtent.width, swapChainExtent.height, 1, vk::SampleCountFlagBits::e1,
+                    swapChainImageFormat, vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled,
+                    vk::MemoryPropertyFlagBits::eDeviceLocal, this->sceneImage, this->sceneImageMemory);
+            this->sceneImageView = this->device->createImageView(this->sceneImage, swapChainImageFormat, vk::ImageAspectFlagBits::eColor, 1);
+            this->attachmentStatistics.allocated += this->graphicsDevice.getImageMemoryRequirements(this->sceneImage).size;
+
+            this->postFramebuffers.resize(this->swapChainImageViews.size());
+            for (size_t i = 0; i < this->swapChainImageViews.size(); i++) {
+                this->postFramebuffers[i] = this->graphicsDevice.createFramebuffer(vk::FramebufferCreateInfo({}, this->postRenderPass,
+                        1, &this->swapChainImageViews[i], swapChainExtent.width, swapChainExtent.height, 1));
+            }
+        }
+
+        // swapchain or scene image is the last attachment of every framebuffer
+        swapChainFramebuffers.resize(this->swapChainImageViews.size());
         for (size_t i = 0; i < this->swapChainImageViews.size(); i++) {
-            std::array<vk::ImageView, 3> attachments = {
-                colorImageView,
-                depthImageView,
-                swapChainImageViews[i]
-            };
+            std::vector<vk::ImageView> attachments(views);
+            attachments.push_back(this->postRenderPass ? this->sceneImageView : this->swapChainImageViews[i]);
 
             vk::FramebufferCreateInfo framebufferInfo({}, this->renderPass,
                     static_cast<uint32_t> (attachments.size()), attachments.data(),
@@ -159,10 +402,34 @@ namespace zvlk {
                     1);
             swapChainFramebuffers[i] = this->graphicsDevice.createFramebuffer(framebufferInfo);
         }
+    }
+
+    void Frame::createAttachment(vk::SampleCountFlagBits samples, vk::Format format, vk::ImageUsageFlags usage,
+            vk::Image& image, vk::DeviceMemory& memory) {
+        bool lazilyAllocated = this->device->createTransientImage(swapChainExtent.width, swapChainExtent.height, samples,
+                format, usage, image, memory);
+
+        vk::DeviceSize size = this->graphicsDevice.getImageMemoryRequirements(image).size;
+        this->attachmentStatistics.allocated += size;
+        if (lazilyAllocated) {
+            this->attachmentStatistics.lazilyAllocated += size;
+            this->lazyMemory.push_back(memory);
+        }
+    }
 
-        this->clearValues = {vk::ClearValue(vk::ClearColorValue(std::array<float,4>({0.0f, 0.0f, 0.0f, 1.0f}))),
-            vk::ClearValue(vk::ClearDepthStencilValue(1.0f, 0)),
-            vk::ClearValue(vk::ClearColorValue(std::array<float,4>({0.0f, 0.0f, 0.0f, 1.0f})))};
+    AttachmentStatistics Frame::getAttachmentStatistics() const {
+        // tilers commit lazily allocated memory only when attachments spill out of tile memory
+        AttachmentStatistics statistics = this->attachmentStatistics;
+        for (vk::DeviceMemory memory : this->lazyMemory) {
+            statistics.committed += this->graphicsDevice.getMemoryCommitment(memory);
+        }
+        return statistics;
+    }
+
+    std::vector<vk::ImageView> Frame::getInputAttachments() const {
+        std::vector<vk::ImageView> views(this->gBufferImageViews);
+        views.push_back(this->depthImageView);
+        return views;
     }
 
     vk::SurfaceFormatKHR Frame::chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats) {
@@ -223,6 +490,11 @@ namespace zvlk {
         return this->renderPass;
     }
 
+    vk::RenderPassBeginInfo Frame::getPostRenderPassBeginInfo(uint32_t index) const {
+        return vk::RenderPassBeginInfo(this->postRenderPass, this->postFramebuffers[index],
+                vk::Rect2D(vk::Offset2D(0, 0), this->swapChainExtent), 0, nullptr);
+    }
+
     vk::RenderPassBeginInfo Frame::getRenderPassBeginInfo(uint32_t index) const {
         vk::RenderPassBeginInfo renderPassInfo(this->renderPass, this->swapChainFramebuffers[index],
                 vk::Rect2D(vk::Offset2D(0, 0), this->swapChainExtent),
@@ -0,0 +1,179 @@
+/* 
+ * File:   Ktx2.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 18 października 2026, 23:50
+ */
+
+#include "Ktx2.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace zvlk {
+
+    namespace {
+
+        const uint8_t IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+        // identifier, 9 header words, 4 index words and 2 global data words
+        const size_t HEADER_SIZE = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+        const size_t LEVEL_INDEX_SIZE = 3 * 8;
+
+        // data format descriptor model, channel and block size of the formats written by the cook
+        struct FormatDescription {
+            uint8_t model;
+            uint8_t channel;
+            uint8_t blockSize;
+            bool srgb;
+        };
+
+        FormatDescription describe(vk::Format format) {
+            switch (format) {
+                case vk::Format::eBc1RgbSrgbBlock: return {128, 0, 8, true};
+                case vk::Format::eBc1RgbUnormBlock: return {128, 0, 8, false};
+                case vk::Format::eBc7SrgbBlock: return {134, 0, 16, true};
+                case vk::Format::eBc7UnormBlock: return {134, 0, 16, false};
+                case vk::Format::eEtc2R8G8B8SrgbBlock: return {161, 2, 8, true};
+                case vk::Format::eEtc2R8G8B8UnormBlock: return {161, 2, 8, false};
+                default: throw std::invalid_argument("format not supported in KTX2 files");
+            }
+        }
+
+        template<typename T> void put(std::vector<uint8_t>& output, size_t offset, T value) {
+            std::memcpy(&output[offset], &value, sizeof (T));
+        }
+
+        template<typename T> T get(const uint8_t* content, size_t size, size_t offset) {
+            if (offset + sizeof (T) > size) {
+                throw std::runtime_error("truncated KTX2 file");
+            }
+            T value;
+            std::memcpy(&value, content + offset, sizeof (T));
+            return value;
+        }
+    }
+
+    Ktx2::Ktx2(vk::Format format, uint32_t width, uint32_t height) {
+        describe(format);
+        this->format = format;
+        this->width = width;
+        this->height = height;
+    }
+
+    Ktx2::Ktx2(const uint8_t* content, size_t size) {
+        if (!Ktx2::isKtx2(content, size)) {
+            throw std::runtime_error("not a KTX2 file");
+        }
+        this->format = static_cast<vk::Format> (get<uint32_t>(content, size, 12));
+        this->width = get<uint32_t>(content, size, 20);
+        this->height = get<uint32_t>(content, size, 24);
+        uint32_t faces = get<uint32_t>(content, size, 36);
+        uint32_t levelsNumber = std::max(get<uint32_t>(content, size, 40), 1u);
+        uint32_t supercompression = get<uint32_t>(content, size, 44);
+        if (faces != 1 || supercompression != 0) {
+            throw std::runtime_error("only single face KTX2 files without supercompression are supported");
+        }
+
+        for (uint32_t i = 0; i < levelsNumber; ++i) {
+            size_t entry = HEADER_SIZE + i * LEVEL_INDEX_SIZE;
+            uint64_t offset = get<uint64_t>(content, size, entry);
+            uint64_t length = get<uint64_t>(content, size, entry + 8);
+            if (offset + length > size) {
+                throw std::runtime_error("truncated KTX2 file");
+            }
+            this->levels.push_back(std::vector<uint8_t>(content + offset, content + offset + length));
+        }
+    }
+
+    Ktx2::~Ktx2() {
+    }
+
+    bool Ktx2::isKtx2(const uint8_t* content, size_t size) {
+        return size >= HEADER_SIZE && std::memcmp(content, IDENTIFIER, sizeof (IDENTIFIER)) == 0;
+    }
+
+    void Ktx2::addLevel(std::vector<uint8_t> level) {
+        this->levels.push_back(std::move(level));
+    }
+
+    std::vector<uint8_t> Ktx2::serialize() const {
+        FormatDescription description = describe(this->format);
+        const uint32_t levelsNumber = static_cast<uint32_t> (this->levels.size());
+
+        // a basic descriptor block with one sample covering the whole compressed block
+        const uint32_t descriptorBlockSize = 24 + 16;
+        const uint32_t dfdSize = 4 + descriptorBlockSize;
+        const size_t dfdOffset = HEADER_SIZE + levelsNumber * LEVEL_INDEX_SIZE;
+
+        // level data follows the descriptor, smallest level first, aligned to the block size
+        size_t end = dfdOffset + dfdSize;
+        std::vector<size_t> offsets(levelsNumber);
+        for (uint32_t i = levelsNumber; i-- > 0;) {
+            end = (end + description.blockSize - 1) / description.blockSize * description.blockSize;
+            offsets[i] = end;
+            end += this->levels[i].size();
+        }
+
+        std::vector<uint8_t> output(end, 0);
+        std::memcpy(output.data(), IDENTIFIER, sizeof (IDENTIFIER));
+        put<uint32_t>(output, 12, static_cast<uint32_t> (this->format));
+        put<uint32_t>(output, 16, 1);
+        put<uint32_t>(output, 20, this->width);
+        put<uint32_t>(output, 24, this->height);
+        put<uint32_t>(output, 28, 0);
+        put<uint32_t>(output, 32, 0);
+        put<uint32_t>(output, 36, 1);
+        put<uint32_t>(output, 40, levelsNumber);
+        put<uint32_t>(output, 44, 0);
+        put<uint32_t>(output, 48, static_cast<uint32_t> (dfdOffset));
+        put<uint32_t>(output, 52, dfdSize);
+        put<uint32_t>(output, 56, 0);
+        put<uint32_t>(output, 60, 0);
+        put<uint64_t>(output, 64, 0);
+        put<uint64_t>(output, 72, 0);
+
+        for (uint32_t i = 0; i < levelsNumber; ++i) {
+            size_t entry = HEADER_SIZE + i * LEVEL_INDEX_SIZE;
+            put<uint64_t>(output, entry, offsets[i]);
+            put<uint64_t>(output, entry + 8, this->levels[i].size());
+            put<uint64_t>(output, entry + 16, this->levels[i].size());
+            std::memcpy(&output[offsets[i]], this->levels[i].data(), this->levels[i].size());
+        }
+
+        size_t dfd = dfdOffset;
+        put<uint32_t>(output, dfd, dfdSize);
+        // vendor and descriptor type are both zero for the basic block
+        put<uint32_t>(output, dfd + 4, 0);
+        put<uint32_t>(output, dfd + 8, 2 | (descriptorBlockSize << 16));
+        // model, BT.709 primaries, sRGB or linear transfer, straight alpha
+        output[dfd + 12] = description.model;
+        output[dfd + 13] = 1;
+        output[dfd + 14] = description.srgb ? 2 : 1;
+        output[dfd + 15] = 0;
+        // 4x4x1x1 texels per block
+        output[dfd + 16] = 3;
+        output[dfd + 17] = 3;
+        output[dfd + 18] = 0;
+        output[dfd + 19] = 0;
+        output[dfd + 20] = description.blockSize;
+        // sample: bit offset, bit length - 1, channel, position, lower and upper
+        put<uint16_t>(output, dfd + 28, 0);
+        output[dfd + 30] = description.blockSize * 8 - 1;
+        output[dfd + 31] = description.channel;
+        put<uint32_t>(output, dfd + 32, 0);
+        put<uint32_t>(output, dfd + 36, 0);
+        put<uint32_t>(output, dfd + 40, UINT32_MAX);
+        return output;
+    }
+
+    void Ktx2::write(const std::string& path) const {
+        std::vector<uint8_t> content = this->serialize();
+        std::ofstream output(path, std::ios::out | std::ios::binary);
+        if (!output.is_open()) {
+            throw std::runtime_error("failed to open " + path + " for writing");
+        }
+        output.write(reinterpret_cast<const char*> (content.data()), content.size());
+        output.close();
+    }
+}
@@ -7,24 +7,195 @@
 
 #include "Light.h"
 
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+// default contribution below which a light is considered not to reach a point, one step of 8 bit color
+#define LIGHT_CUTOFF (1.0f / 256.0f)
+
 namespace zvlk {
 
     Lights::Lights(zvlk::Device* device, std::shared_ptr<zvlk::Frame> frame) : UniformBuffer(device, sizeof (LightsUBO), frame) {
         this->ubos.resize(frame->getImagesNumber());
+        this->frame = frame;
+        this->camera = nullptr;
+        this->cutoff = LIGHT_CUTOFF;
+
+        this->lightsBuffer = new StorageBuffer(device, 16 * sizeof (LightData), frame);
+        this->clustersBuffer = new StorageBuffer(device, CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z * sizeof (LightCluster), frame);
+        this->lightIndicesBuffer = new StorageBuffer(device, 1024 * sizeof (uint32_t), frame);
+        this->reallocated.resize(frame->getImagesNumber(), 0);
     }
 
     Lights::~Lights() {
         for (Light* light: this->lights) {
             delete light;
         }
+        delete this->lightsBuffer;
+        delete this->clustersBuffer;
+        delete this->lightIndicesBuffer;
     }
 
     void* Lights::update(uint32_t index, float time) {
-        this->ubos[index].numberOfLights = static_cast<float>(this->lights.size());
-        for (size_t i = 0; i<this->ubos[index].numberOfLights; ++i) {
-            this->ubos[index].lights[i] = {this->lights[i]->position, this->lights[i]->color, this->lights[i]->attenuation};
+        LightsUBO& header = this->ubos[index];
+        header.numberOfLights = static_cast<uint32_t> (this->lights.size());
+        header.clustersX = CLUSTERS_X;
+        header.clustersY = CLUSTERS_Y;
+        header.clustersZ = CLUSTERS_Z;
+        header.width = static_cast<float> (this->frame->getWidth());
+        header.height = static_cast<float> (this->frame->getHeight());
+
+        this->lightData.resize(this->lights.size());
+        for (size_t i = 0; i < this->lights.size(); ++i) {
+            this->lightData[i] = {this->lights[i]->position, this->lights[i]->color, this->lights[i]->attenuation};
+        }
+
+        this->bin(header);
+
+        bool reallocated = this->lightsBuffer->write(index, this->lightData.data(), this->lightData.size() * sizeof (LightData));
+        reallocated |= this->clustersBuffer->write(index, this->clusters.data(), this->clusters.size() * sizeof (LightCluster));
+        reallocated |= this->lightIndicesBuffer->write(index, this->lightIndices.data(), this->lightIndices.size() * sizeof (uint32_t));
+        if (reallocated) {
+            this->reallocated[index] = 1;
+        }
+        return &header;
+    }
+
+    void Lights::bin(LightsUBO& header) {
+        const uint32_t clustersNumber = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+        this->clusters.assign(clustersNumber, {0, 0});
+        this->lightIndices.clear();
+        this->lightMinimums.resize(this->lights.size());
+        this->lightMaximums.resize(this->lights.size());
+
+        header.numberOfGlobalLights = 0;
+        if (this->camera == nullptr) {
+            // without a view there is nothing to bin against, every light is global
+            header.near = 1.0f;
+            header.far = 2.0f;
+            for (uint32_t i = 0; i < this->lights.size(); ++i) {
+                this->lightIndices.push_back(i);
+            }
+            header.numberOfGlobalLights = static_cast<uint32_t> (this->lights.size());
+            return;
+        }
+
+        const float near = this->camera->getNear();
+        const float far = this->camera->getFar();
+        const float logDepthRange = std::log(far / near);
+        const glm::mat4& view = this->camera->getView();
+        const glm::mat4& projection = this->camera->getProjection();
+        header.near = near;
+        header.far = far;
+
+        auto slice = [&](float depth) {
+            float z = std::log(depth / near) / logDepthRange * CLUSTERS_Z;
+            return static_cast<uint32_t> (std::min(std::max(z, 0.0f), CLUSTERS_Z - 1.0f));
+        };
+        auto tile = [](float coordinate, uint32_t tiles) {
+            float t = coordinate * tiles;
+            return static_cast<uint32_t> (std::min(std::max(t, 0.0f), tiles - 1.0f));
+        };
+
+        for (uint32_t i = 0; i < this->lights.size(); ++i) {
+            float radius = this->lights[i]->getRadius(this->cutoff);
+            if (std::isinf(radius)) {
+                this->lightIndices.push_back(i);
+                this->lightMinimums[i] = glm::uvec3(1);
+                this->lightMaximums[i] = glm::uvec3(0);
+                continue;
+            }
+
+            glm::vec3 center = glm::vec3(view * glm::vec4(this->lights[i]->position, 1.0f));
+            float depth = -center.z;
+            if (depth + radius < near || depth - radius > far) {
+                this->lightMinimums[i] = glm::uvec3(1);
+                this->lightMaximums[i] = glm::uvec3(0);
+                continue;
+            }
+
+            // screen bounds of the view space box around the sphere, cut at the near plane
+            float minX = std::numeric_limits<float>::max(), minY = minX;
+            float maxX = -minX, maxY = -minX;
+            for (int corner = 0; corner < 8; ++corner) {
+                glm::vec4 point(center.x + (corner & 1 ? radius : -radius),
+                        center.y + (corner & 2 ? radius : -radius),
+                        std::min(center.z + (corner & 4 ? radius : -radius), -near), 1.0f);
+                glm::vec4 clip = projection * point;
+                float x = clip.x / clip.w, y = clip.y / clip.w;
+                minX = std::min(minX, x);
+                maxX = std::max(maxX, x);
+                minY = std::min(minY, y);
+                maxY = std::max(maxY, y);
+            }
+            if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f) {
+                this->lightMinimums[i] = glm::uvec3(1);
+                this->lightMaximums[i] = glm::uvec3(0);
+                continue;
+            }
+
+            // viewport is flipped, so framebuffer rows grow with decreasing NDC y
+            this->lightMinimums[i] = glm::uvec3(tile(minX * 0.5f + 0.5f, CLUSTERS_X),
+                    tile((1.0f - maxY) * 0.5f, CLUSTERS_Y), slice(std::max(depth - radius, near)));
+            this->lightMaximums[i] = glm::uvec3(tile(maxX * 0.5f + 0.5f, CLUSTERS_X),
+                    tile((1.0f - minY) * 0.5f, CLUSTERS_Y), slice(std::min(depth + radius, far)));
+
+            for (uint32_t z = this->lightMinimums[i].z; z <= this->lightMaximums[i].z; ++z) {
+                for (uint32_t y = this->lightMinimums[i].y; y <= this->lightMaximums[i].y; ++y) {
+                    for (uint32_t x = this->lightMinimums[i].x; x <= this->lightMaximums[i].x; ++x) {
+                        this->clusters[(z * CLUSTERS_Y + y) * CLUSTERS_X + x].count++;
+                    }
+                }
+            }
+        }
+        header.numberOfGlobalLights = static_cast<uint32_t> (this->lightIndices.size());
+
+        uint32_t offset = header.numberOfGlobalLights;
+        for (LightCluster& cluster : this->clusters) {
+            cluster.offset = offset;
+            offset += cluster.count;
+            cluster.count = 0;
+        }
+        this->lightIndices.resize(offset);
+
+        for (uint32_t i = 0; i < this->lights.size(); ++i) {
+            for (uint32_t z = this->lightMinimums[i].z; z <= this->lightMaximums[i].z; ++z) {
+                for (uint32_t y = this->lightMinimums[i].y; y <= this->lightMaximums[i].y; ++y) {
+                    for (uint32_t x = this->lightMinimums[i].x; x <= this->lightMaximums[i].x; ++x) {
+                        LightCluster& cluster = this->clusters[(z * CLUSTERS_Y + y) * CLUSTERS_X + x];
+                        this->lightIndices[cluster.offset + cluster.count++] = i;
+                    }
+                }
+            }
         }
-        return &this->ubos[index];
+    }
+
+    void Lights::resize(uint32_t imagesNumber) {
+        this->ubos.resize(imagesNumber);
+        this->lightsBuffer->resize(this->frame);
+        this->clustersBuffer->resize(this->frame);
+        this->lightIndicesBuffer->resize(this->frame);
+        // scene sets are written for the new buffers on compile
+        this->reallocated.assign(imagesNumber, 0);
+    }
+
+    bool Lights::wereBuffersReallocated(uint32_t index) {
+        bool reallocated = this->reallocated[index] != 0;
+        this->reallocated[index] = 0;
+        return reallocated;
+    }
+
+    vk::DescriptorBufferInfo Lights::getLightsBufferInfo(uint32_t index) {
+        return this->lightsBuffer->getDescriptorBufferInfo(index);
+    }
+
+    vk::DescriptorBufferInfo Lights::getClustersBufferInfo(uint32_t index) {
+        return this->clustersBuffer->getDescriptorBufferInfo(index);
+    }
+
+    vk::DescriptorBufferInfo Lights::getLightIndicesBufferInfo(uint32_t index) {
+        return this->lightIndicesBuffer->getDescriptorBufferInfo(index);
     }
 
     Light::Light(glm::vec3 position, glm::vec4 color, float attenuation) {
@@ -35,4 +206,12 @@ namespace zvlk {
 
     Light::~Light() {
     }
+
+    float Light::getRadius(float cutoff) const {
+        if (this->attenuation <= 0.0f || cutoff <= 0.0f) {
+            return std::numeric_limits<float>::infinity();
+        }
+        // 1 / (attenuation * d^2) = cutoff
+        return std::sqrt(1.0f / (this->attenuation * cutoff));
+    }
 }
@@ -0,0 +1,155 @@
+/* 
+ * File:   Lz4.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 01:10
+ */
+
+#include "Lz4.h"
+
+#include <stdexcept>
+#include <cstring>
+
+#define MIN_MATCH 4
+#define MAX_OFFSET 65535
+// the format requires the last literals to be at least this long
+#define LAST_LITERALS 5
+// and the last match to start this far from the end
+#define MATCH_FIND_LIMIT 12
+#define HASH_BITS 16
+
+namespace zvlk {
+
+    namespace {
+
+        uint32_t read32(const uint8_t* p) {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof (value));
+            return value;
+        }
+
+        uint32_t hash(uint32_t sequence) {
+            return (sequence * 2654435761U) >> (32 - HASH_BITS);
+        }
+    }
+
+    void Lz4::writeLength(std::vector<uint8_t>& output, size_t length) {
+        for (; length >= 255; length -= 255) {
+            output.push_back(255);
+        }
+        output.push_back(static_cast<uint8_t> (length));
+    }
+
+    std::vector<uint8_t> Lz4::compress(const uint8_t* source, size_t size) {
+        std::vector<uint8_t> output;
+        output.reserve(size + size / 255 + 16);
+        std::vector<int64_t> table(1 << HASH_BITS, -1);
+
+        size_t position = 0, anchor = 0;
+        while (size >= MATCH_FIND_LIMIT && position < size - MATCH_FIND_LIMIT) {
+            uint32_t sequence = read32(source + position);
+            uint32_t slot = hash(sequence);
+            int64_t candidate = table[slot];
+            table[slot] = static_cast<int64_t> (position);
+            if (candidate < 0 || position - candidate > MAX_OFFSET || read32(source + candidate) != sequence) {
+                ++position;
+                continue;
+            }
+
+            size_t length = MIN_MATCH;
+            while (position + length < size - LAST_LITERALS && source[candidate + length] == source[position + length]) {
+                ++length;
+            }
+
+            size_t literals = position - anchor;
+            size_t tokenPosition = output.size();
+            output.push_back(static_cast<uint8_t> ((literals < 15 ? literals : 15) << 4));
+            if (literals >= 15) {
+                Lz4::writeLength(output, literals - 15);
+            }
+            output.insert(output.end(), source + anchor, source + position);
+
+            size_t offset = position - candidate;
+            output.push_back(static_cast<uint8_t> (offset & 0xFF));
+            output.push_back(static_cast<uint8_t> (offset >> 8));
+            size_t matchLength = length - MIN_MATCH;
+            output[tokenPosition] |= static_cast<uint8_t> (matchLength < 15 ? matchLength : 15);
+            if (matchLength >= 15) {
+                Lz4::writeLength(output, matchLength - 15);
+            }
+
+            position += length;
+            anchor = position;
+        }
+
+        size_t literals = size - anchor;
+        output.push_back(static_cast<uint8_t> ((literals < 15 ? literals : 15) << 4));
+        if (literals >= 15) {
+            Lz4::writeLength(output, literals - 15);
+        }
+        output.insert(output.end(), source + anchor, source + size);
+        return output;
+    }
+
+    void Lz4::decompress(const uint8_t* source, size_t size, uint8_t* destination, size_t destinationSize) {
+        const uint8_t* input = source;
+        const uint8_t* inputEnd = source + size;
+        size_t written = 0;
+
+        auto readLength = [&](size_t length) {
+            if (length == 15) {
+                uint8_t byte;
+                do {
+                    if (input >= inputEnd) {
+                        throw std::runtime_error("truncated LZ4 block");
+                    }
+                    byte = *input++;
+                    length += byte;
+                } while (byte == 255);
+            }
+            return length;
+        };
+
+        while (input < inputEnd) {
+            uint8_t token = *input++;
+            size_t literals = readLength(token >> 4);
+            if (literals > static_cast<size_t> (inputEnd - input) || literals > destinationSize - written) {
+                throw std::runtime_error("LZ4 literals out of bounds");
+            }
+            std::memcpy(destination + written, input, literals);
+            input += literals;
+            written += literals;
+            if (input == inputEnd) {
+                // the last sequence has literals only
+                break;
+            }
+
+            if (inputEnd - input < 2) {
+                throw std::runtime_error("truncated LZ4 block");
+            }
+            size_t offset = input[0] | (static_cast<size_t> (input[1]) << 8);
+            input += 2;
+            if (offset == 0 || offset > written) {
+                throw std::runtime_error("LZ4 match offset out of bounds");
+            }
+            size_t length = readLength(token & 15) + MIN_MATCH;
+            if (length > destinationSize - written) {
+                throw std::runtime_error("LZ4 match out of bounds");
+            }
+            // matches may overlap their own output, so bytes are copied one by one when they do
+            uint8_t* match = destination + written - offset;
+            if (offset >= length) {
+                std::memcpy(destination + written, match, length);
+            } else {
+                for (size_t i = 0; i < length; ++i) {
+                    destination[written + i] = match[i];
+                }
+            }
+            written += length;
+        }
+
+        if (written != destinationSize) {
+            throw std::runtime_error("LZ4 block decompressed to an unexpected size");
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/* 
+ * File:   MappedFile.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 00:30
+ */
+
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace zvlk {
+
+    MappedFile::MappedFile(const std::string& path) {
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("failed to open " + path);
+        }
+        struct stat status;
+        if (fstat(descriptor, &status) != 0) {
+            close(descriptor);
+            throw std::runtime_error("failed to read the size of " + path);
+        }
+
+        this->size = static_cast<size_t> (status.st_size);
+        this->data = nullptr;
+        if (this->size > 0) {
+            void* mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (mapping == MAP_FAILED) {
+                close(descriptor);
+                throw std::runtime_error("failed to map " + path);
+            }
+            // the whole file is read anyway, so the system may start early
+            madvise(mapping, this->size, MADV_WILLNEED);
+            this->data = static_cast<const uint8_t*> (mapping);
+        }
+        // the mapping stays valid without the descriptor
+        close(descriptor);
+    }
+
+    MappedFile::~MappedFile() {
+        if (this->data) {
+            munmap(const_cast<uint8_t*> (this->data), this->size);
+        }
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "Material.h"
+#include "AssetCache.h"
 
 namespace zvlk {
 
@@ -20,15 +21,19 @@ namespace zvlk {
             this->ubos[i].shiness = shiness;
             dynamic_cast<UniformBuffer*>(this)->update(i);
         }
-        this->diffuseTexture = new Texture(device, diffuseTextureName);
+        this->diffuseTexture = device->getAssetCache()->getTexture(diffuseTextureName);
     }
 
     void* Material::update(uint32_t index, float time) {
         return &this->ubos[index];
     }
 
+    void Material::resize(uint32_t imagesNumber) {
+        // every image holds the same material
+        this->ubos.resize(imagesNumber, this->ubos[0]);
+    }
+
     Material::~Material() {
-        delete this->diffuseTexture;
     }
 
     vk::DescriptorImageInfo Material::getDescriptorImageInfo(uint32_t index) {
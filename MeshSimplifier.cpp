@@ -0,0 +1,350 @@
+/* 
+ * File:   MeshSimplifier.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 01:40
+ */
+
+#include "MeshSimplifier.h"
+
+#include <glm/geometric.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+
+// weight of the planes keeping open borders in place, relative to those of triangles
+#define BORDER_WEIGHT 10.0
+// smallest cosine between a triangle normal before and after a collapse
+#define MIN_NORMAL_COSINE 0.25f
+
+namespace zvlk {
+
+    namespace {
+
+        enum VertexKind : uint8_t {
+            eManifold,
+            // on an open border of the part, moves along it
+            eBorder,
+            // on a texture seam, moves along it together with its sibling on the other side
+            eSeam,
+            eLocked
+        };
+
+        // weighted sum of squared distances from planes, symmetric so upper triangle only
+        struct Quadric {
+            double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+            double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+            double a22 = 0.0, a23 = 0.0;
+            double a33 = 0.0;
+            double weight = 0.0;
+
+            void addPlane(const glm::dvec3& normal, double distance, double weight) {
+                a00 += weight * normal.x * normal.x;
+                a01 += weight * normal.x * normal.y;
+                a02 += weight * normal.x * normal.z;
+                a03 += weight * normal.x * distance;
+                a11 += weight * normal.y * normal.y;
+                a12 += weight * normal.y * normal.z;
+                a13 += weight * normal.y * distance;
+                a22 += weight * normal.z * normal.z;
+                a23 += weight * normal.z * distance;
+                a33 += weight * distance * distance;
+                this->weight += weight;
+            }
+
+            void add(const Quadric& other) {
+                a00 += other.a00;
+                a01 += other.a01;
+                a02 += other.a02;
+                a03 += other.a03;
+                a11 += other.a11;
+                a12 += other.a12;
+                a13 += other.a13;
+                a22 += other.a22;
+                a23 += other.a23;
+                a33 += other.a33;
+                weight += other.weight;
+            }
+
+            double evaluate(const glm::vec3& position) const {
+                double x = position.x;
+                double y = position.y;
+                double z = position.z;
+                double result = a00 * x * x + a11 * y * y + a22 * z * z + a33
+                        + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z + a03 * x + a13 * y + a23 * z);
+                return std::max(result, 0.0);
+            }
+        };
+
+        struct Collapse {
+            uint32_t from;
+            uint32_t to;
+            double cost;
+            // squared distance the surface moves
+            double error;
+        };
+
+        inline uint64_t edgeKey(uint32_t from, uint32_t to) {
+            return (static_cast<uint64_t> (from) << 32) | to;
+        }
+    }
+
+    MeshSimplifier::MeshSimplifier(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<ModelPart>& parts) :
+    vertices(vertices), indices(indices) {
+        std::unordered_map<glm::vec3, uint32_t> uniquePositions;
+        this->positionIds.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            auto inserted = uniquePositions.emplace(vertices[i].position, static_cast<uint32_t> (uniquePositions.size()));
+            this->positionIds[i] = inserted.first->second;
+        }
+
+        // a position used by several parts lies on a material boundary
+        std::vector<int32_t> positionParts(uniquePositions.size(), -1);
+        this->lockedPositions.resize(uniquePositions.size(), 0);
+        for (size_t part = 0; part < parts.size(); ++part) {
+            for (uint32_t i = 0; i < parts[part].numberOfIndices; ++i) {
+                uint32_t position = this->positionIds[indices[parts[part].indexOffset + i]];
+                if (positionParts[position] == -1) {
+                    positionParts[position] = static_cast<int32_t> (part);
+                } else if (positionParts[position] != static_cast<int32_t> (part)) {
+                    this->lockedPositions[position] = 1;
+                }
+            }
+        }
+    }
+
+    MeshSimplifier::~MeshSimplifier() {
+    }
+
+    std::vector<uint32_t> MeshSimplifier::simplify(const ModelPart& part, size_t targetIndices, float& error) const {
+        std::vector<uint32_t> triangles(this->indices.begin() + part.indexOffset, this->indices.begin() + part.indexOffset + part.numberOfIndices);
+        error = 0.0f;
+        if (triangles.size() <= targetIndices) {
+            return triangles;
+        }
+
+        std::unordered_set<uint64_t> edges;
+        for (size_t t = 0; t < triangles.size(); t += 3) {
+            for (uint32_t k = 0; k < 3; ++k) {
+                edges.insert(edgeKey(triangles[t + k], triangles[t + (k + 1) % 3]));
+            }
+        }
+        auto isOpen = [&edges](uint32_t from, uint32_t to) {
+            return edges.count(edgeKey(from, to)) != 0 && edges.count(edgeKey(to, from)) == 0;
+        };
+
+        // siblings are the other vertices of the part at the same position, split by texture coordinates or normals
+        std::unordered_map<uint32_t, std::vector<uint32_t>> verticesAtPosition;
+        std::unordered_map<uint32_t, uint32_t> openEdges;
+        for (size_t t = 0; t < triangles.size(); t += 3) {
+            for (uint32_t k = 0; k < 3; ++k) {
+                uint32_t from = triangles[t + k];
+                uint32_t to = triangles[t + (k + 1) % 3];
+                std::vector<uint32_t>& atPosition = verticesAtPosition[this->positionIds[from]];
+                if (std::find(atPosition.begin(), atPosition.end(), from) == atPosition.end()) {
+                    atPosition.push_back(from);
+                }
+                if (isOpen(from, to)) {
+                    openEdges[from]++;
+                    openEdges[to]++;
+                }
+            }
+        }
+
+        std::unordered_map<uint32_t, VertexKind> kinds;
+        std::unordered_map<uint32_t, uint32_t> siblings;
+        for (const auto& atPosition : verticesAtPosition) {
+            const std::vector<uint32_t>& group = atPosition.second;
+            bool locked = this->lockedPositions[atPosition.first] || group.size() > 2;
+            for (uint32_t vertex : group) {
+                VertexKind kind = eManifold;
+                if (locked) {
+                    kind = eLocked;
+                } else if (group.size() == 2) {
+                    uint32_t sibling = group[0] == vertex ? group[1] : group[0];
+                    siblings[vertex] = sibling;
+                    // seam has a single open edge in and out on both sides, anything else is a corner of it
+                    kind = openEdges[vertex] == 2 && openEdges[sibling] == 2 ? eSeam : eLocked;
+                } else if (openEdges[vertex] == 2) {
+                    kind = eBorder;
+                } else if (openEdges[vertex] != 0) {
+                    kind = eLocked;
+                }
+                kinds[vertex] = kind;
+            }
+        }
+
+        std::unordered_map<uint32_t, Quadric> quadrics;
+        for (size_t t = 0; t < triangles.size(); t += 3) {
+            glm::dvec3 p0 = this->vertices[triangles[t]].position;
+            glm::dvec3 p1 = this->vertices[triangles[t + 1]].position;
+            glm::dvec3 p2 = this->vertices[triangles[t + 2]].position;
+            glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+            double length = glm::length(normal);
+            if (length == 0.0) {
+                continue;
+            }
+            normal /= length;
+            // weighted by area, so the error is a mean distance over the surface around the vertex
+            for (uint32_t k = 0; k < 3; ++k) {
+                quadrics[this->positionIds[triangles[t + k]]].addPlane(normal, -glm::dot(normal, p0), length * 0.5);
+            }
+            // planes through open borders, perpendicular to the triangle, keep them from shrinking
+            for (uint32_t k = 0; k < 3; ++k) {
+                uint32_t from = triangles[t + k];
+                uint32_t to = triangles[t + (k + 1) % 3];
+                if (kinds[from] != eBorder && kinds[to] != eBorder) {
+                    continue;
+                }
+                if (!isOpen(from, to)) {
+                    continue;
+                }
+                glm::dvec3 a = this->vertices[from].position;
+                glm::dvec3 edge = glm::dvec3(this->vertices[to].position) - a;
+                glm::dvec3 borderNormal = glm::cross(edge, normal);
+                double borderLength = glm::length(borderNormal);
+                if (borderLength == 0.0) {
+                    continue;
+                }
+                borderNormal /= borderLength;
+                double weight = BORDER_WEIGHT * glm::dot(edge, edge);
+                quadrics[this->positionIds[from]].addPlane(borderNormal, -glm::dot(borderNormal, a), weight);
+                quadrics[this->positionIds[to]].addPlane(borderNormal, -glm::dot(borderNormal, a), weight);
+            }
+        }
+
+        double maxError = 0.0;
+        while (triangles.size() > targetIndices) {
+            edges.clear();
+            std::unordered_map<uint32_t, std::vector<uint32_t>> adjacency;
+            for (size_t t = 0; t < triangles.size(); t += 3) {
+                for (uint32_t k = 0; k < 3; ++k) {
+                    edges.insert(edgeKey(triangles[t + k], triangles[t + (k + 1) % 3]));
+                    adjacency[triangles[t + k]].push_back(static_cast<uint32_t> (t));
+                }
+            }
+
+            auto allowed = [&](uint32_t from, uint32_t to) {
+                VertexKind fromKind = kinds[from];
+                VertexKind toKind = kinds[to];
+                if (fromKind == eManifold) {
+                    return true;
+                } else if (fromKind == eBorder) {
+                    return toKind == eBorder && (isOpen(from, to) || isOpen(to, from));
+                } else if (fromKind == eSeam) {
+                    if (toKind != eSeam || !(isOpen(from, to) || isOpen(to, from))) {
+                        return false;
+                    }
+                    uint32_t fromSibling = siblings[from];
+                    uint32_t toSibling = siblings[to];
+                    return edges.count(edgeKey(fromSibling, toSibling)) != 0 || edges.count(edgeKey(toSibling, fromSibling)) != 0;
+                }
+                return false;
+            };
+
+            std::vector<Collapse> collapses;
+            for (size_t t = 0; t < triangles.size(); t += 3) {
+                for (uint32_t k = 0; k < 3; ++k) {
+                    uint32_t a = triangles[t + k];
+                    uint32_t b = triangles[t + (k + 1) % 3];
+                    if (allowed(a, b)) {
+                        const Quadric& quadric = quadrics[this->positionIds[a]];
+                        double cost = quadric.evaluate(this->vertices[b].position);
+                        collapses.push_back({a, b, cost, quadric.weight > 0.0 ? cost / quadric.weight : 0.0});
+                    }
+                    if (allowed(b, a)) {
+                        const Quadric& quadric = quadrics[this->positionIds[b]];
+                        double cost = quadric.evaluate(this->vertices[a].position);
+                        collapses.push_back({b, a, cost, quadric.weight > 0.0 ? cost / quadric.weight : 0.0});
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& left, const Collapse& right) {
+                return left.cost < right.cost;
+            });
+
+            // moving a vertex must not turn any of its remaining triangles over, nor flatten one to a line,
+            // whose orientation no later check could see
+            auto flips = [&](uint32_t from, uint32_t to) {
+                const glm::vec3& target = this->vertices[to].position;
+                for (uint32_t t : adjacency[from]) {
+                    uint32_t a = triangles[t];
+                    uint32_t b = triangles[t + 1];
+                    uint32_t c = triangles[t + 2];
+                    if (a == to || b == to || c == to) {
+                        continue;
+                    }
+                    const glm::vec3& pa = this->vertices[a].position;
+                    const glm::vec3& pb = this->vertices[b].position;
+                    const glm::vec3& pc = this->vertices[c].position;
+                    glm::vec3 before = glm::cross(pb - pa, pc - pa);
+                    glm::vec3 after = glm::cross((b == from ? target : pb) - (a == from ? target : pa), (c == from ? target : pc) - (a == from ? target : pa));
+                    if (glm::dot(before, after) <= MIN_NORMAL_COSINE * glm::length(before) * glm::length(after)) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            // collapses of a pass touch separate neighbourhoods, so each sees the triangles it was checked against
+            std::unordered_set<uint32_t> touched;
+            std::unordered_map<uint32_t, uint32_t> remap;
+            size_t removed = 0;
+            size_t toRemove = triangles.size() - targetIndices;
+            for (const Collapse& collapse : collapses) {
+                std::vector<std::pair<uint32_t, uint32_t>> moves = {{collapse.from, collapse.to}};
+                if (kinds[collapse.from] == eSeam) {
+                    moves.push_back({siblings[collapse.from], siblings[collapse.to]});
+                }
+                bool possible = true;
+                for (const auto& move : moves) {
+                    possible = possible && touched.count(move.first) == 0 && touched.count(move.second) == 0 && !flips(move.first, move.second);
+                }
+                if (!possible) {
+                    continue;
+                }
+
+                for (const auto& move : moves) {
+                    remap[move.first] = move.second;
+                    for (uint32_t t : adjacency[move.first]) {
+                        bool degenerate = false;
+                        for (uint32_t k = 0; k < 3; ++k) {
+                            touched.insert(triangles[t + k]);
+                            degenerate = degenerate || triangles[t + k] == move.second;
+                        }
+                        removed += degenerate ? 3 : 0;
+                    }
+                }
+                quadrics[this->positionIds[collapse.to]].add(quadrics[this->positionIds[collapse.from]]);
+                maxError = std::max(maxError, collapse.error);
+                if (removed >= toRemove) {
+                    break;
+                }
+            }
+            if (remap.empty()) {
+                break;
+            }
+
+            size_t kept = 0;
+            for (size_t t = 0; t < triangles.size(); t += 3) {
+                uint32_t corners[3];
+                for (uint32_t k = 0; k < 3; ++k) {
+                    auto moved = remap.find(triangles[t + k]);
+                    corners[k] = moved == remap.end() ? triangles[t + k] : moved->second;
+                }
+                if (corners[0] == corners[1] || corners[1] == corners[2] || corners[0] == corners[2]) {
+                    continue;
+                }
+                for (uint32_t k = 0; k < 3; ++k) {
+                    triangles[kept++] = corners[k];
+                }
+            }
+            triangles.resize(kept);
+        }
+
+        error = static_cast<float> (std::sqrt(maxError));
+        return triangles;
+    }
+}
@@ -0,0 +1,328 @@
+/* 
+ * File:   MipChain.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 18 października 2026, 23:30
+ */
+
+#include "MipChain.h"
+#include "BatchMath.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <future>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ZVLK_X86
+#include <immintrin.h>
+#endif
+
+// below this number of rows spawning workers costs more than it saves
+#define PARALLEL_ROWS_THRESHOLD 128
+// half width of the windowed sinc kernels, in texels of the smaller level
+#define SINC_LOBES 3
+#define KAISER_ALPHA 4.0
+
+namespace zvlk {
+
+    namespace {
+
+        // texels of the larger level taken by one texel of the smaller one, starting at 2x + first
+        struct Kernel {
+            int32_t first;
+            std::vector<float> weights;
+        };
+
+        double sinc(double x) {
+            if (std::abs(x) < 1e-9) {
+                return 1.0;
+            }
+            return std::sin(M_PI * x) / (M_PI * x);
+        }
+
+        // modified Bessel function of the first kind, order 0
+        double bessel0(double x) {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; ++k) {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        }
+
+        Kernel makeKernel(MipFilter filter) {
+            if (filter == MipFilter::eBox) {
+                return {0,
+                    {0.5f, 0.5f}};
+            }
+
+            Kernel kernel;
+            int32_t radius = 2 * SINC_LOBES;
+            kernel.first = 1 - radius;
+            double sum = 0.0;
+            std::vector<double> weights;
+            for (int32_t i = kernel.first; i <= radius; ++i) {
+                // distance between centres of the texels, in texels of the smaller level
+                double t = (i - 0.5) / 2.0;
+                double x = t / SINC_LOBES;
+                double window = filter == MipFilter::eKaiser
+                        ? bessel0(KAISER_ALPHA * std::sqrt(std::max(0.0, 1.0 - x * x))) / bessel0(KAISER_ALPHA)
+                        : sinc(x);
+                weights.push_back(sinc(t) * window);
+                sum += weights.back();
+            }
+            for (double weight : weights) {
+                kernel.weights.push_back(static_cast<float> (weight / sum));
+            }
+            return kernel;
+        }
+
+        const float* srgbToLinear() {
+            static std::vector<float> table = []() {
+                std::vector<float> values(256);
+                for (int i = 0; i < 256; ++i) {
+                    double c = i / 255.0;
+                    values[i] = static_cast<float> (c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+                }
+                return values;
+            }();
+            return table.data();
+        }
+
+        // indexed by the linear value scaled to 16 bits, fine enough for dark sRGB steps
+        const uint8_t* linearToSrgb() {
+            static std::vector<uint8_t> table = []() {
+                std::vector<uint8_t> values(65536);
+                for (int i = 0; i < 65536; ++i) {
+                    double c = i / 65535.0;
+                    double s = c <= 0.0031308 ? c * 12.92 : 1.055 * std::pow(c, 1.0 / 2.4) - 0.055;
+                    values[i] = static_cast<uint8_t> (std::lround(s * 255.0));
+                }
+                return values;
+            }();
+            return table.data();
+        }
+
+        void parallelRows(uint32_t rows, const std::function<void(uint32_t, uint32_t)>& task) {
+            uint32_t workers = std::thread::hardware_concurrency();
+            if (workers <= 1 || rows < PARALLEL_ROWS_THRESHOLD) {
+                task(0, rows);
+                return;
+            }
+            uint32_t chunk = (rows + workers - 1) / workers;
+            std::vector<std::future<void>> tasks;
+            for (uint32_t begin = 0; begin < rows; begin += chunk) {
+                tasks.push_back(std::async(std::launch::async, task, begin, std::min(begin + chunk, rows)));
+            }
+            for (std::future<void>& result : tasks) {
+                result.get();
+            }
+        }
+
+        // ----- scalar -----
+
+        void horizontalScalar(const float* row, const float* weights, size_t taps, const uint32_t* indices,
+                uint32_t width, uint32_t channels, float* result) {
+            for (uint32_t x = 0; x < width; ++x, indices += taps) {
+                for (uint32_t c = 0; c < channels; ++c) {
+                    float sum = 0.0f;
+                    for (size_t k = 0; k < taps; ++k) {
+                        sum += weights[k] * row[indices[k] * channels + c];
+                    }
+                    result[x * channels + c] = sum;
+                }
+            }
+        }
+
+        void verticalScalar(const float* const* rows, const float* weights, size_t taps, float* result, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                result[i] = weights[0] * rows[0][i];
+            }
+            // row by row, so that compilers vectorize it for other instruction sets too
+            for (size_t k = 1; k < taps; ++k) {
+                for (size_t i = 0; i < count; ++i) {
+                    result[i] += weights[k] * rows[k][i];
+                }
+            }
+        }
+
+#ifdef ZVLK_X86
+        // ----- SSE -----
+
+        // four channels fill a register, one texel at a time
+        __attribute__((target("sse4.1")))
+        void horizontal4Sse(const float* row, const float* weights, size_t taps, const uint32_t* indices,
+                uint32_t width, float* result) {
+            for (uint32_t x = 0; x < width; ++x, indices += taps) {
+                __m128 sum = _mm_setzero_ps();
+                for (size_t k = 0; k < taps; ++k) {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(row + indices[k] * 4)));
+                }
+                _mm_storeu_ps(result + x * 4, sum);
+            }
+        }
+
+        __attribute__((target("sse4.1")))
+        void verticalSse(const float* const* rows, const float* weights, size_t taps, float* result, size_t count) {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m128 sum = _mm_setzero_ps();
+                for (size_t k = 0; k < taps; ++k) {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i)));
+                }
+                _mm_storeu_ps(result + i, sum);
+            }
+            for (; i < count; ++i) {
+                float sum = 0.0f;
+                for (size_t k = 0; k < taps; ++k) {
+                    sum += weights[k] * rows[k][i];
+                }
+                result[i] = sum;
+            }
+        }
+
+        // ----- AVX2 -----
+
+        __attribute__((target("avx2,fma")))
+        void verticalAvx2(const float* const* rows, const float* weights, size_t taps, float* result, size_t count) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256 sum = _mm256_setzero_ps();
+                for (size_t k = 0; k < taps; ++k) {
+                    sum = _mm256_fmadd_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(rows[k] + i), sum);
+                }
+                _mm256_storeu_ps(result + i, sum);
+            }
+            for (; i < count; ++i) {
+                float sum = 0.0f;
+                for (size_t k = 0; k < taps; ++k) {
+                    sum += weights[k] * rows[k][i];
+                }
+                result[i] = sum;
+            }
+        }
+#endif
+
+        void horizontal(const float* row, const Kernel& kernel, const uint32_t* indices, uint32_t width, uint32_t channels, float* result) {
+#ifdef ZVLK_X86
+            if (channels == 4 && BatchMath::getIsa() != BatchMathIsa::eScalar) {
+                return horizontal4Sse(row, kernel.weights.data(), kernel.weights.size(), indices, width, result);
+            }
+#endif
+            horizontalScalar(row, kernel.weights.data(), kernel.weights.size(), indices, width, channels, result);
+        }
+
+        void vertical(const float* const* rows, const Kernel& kernel, float* result, size_t count) {
+            switch (BatchMath::getIsa()) {
+#ifdef ZVLK_X86
+                case BatchMathIsa::eAvx2:
+                    return verticalAvx2(rows, kernel.weights.data(), kernel.weights.size(), result, count);
+                case BatchMathIsa::eSse:
+                    return verticalSse(rows, kernel.weights.data(), kernel.weights.size(), result, count);
+#endif
+                default:
+                    return verticalScalar(rows, kernel.weights.data(), kernel.weights.size(), result, count);
+            }
+        }
+
+        // clamped texels of the larger level for every texel of the smaller one
+        std::vector<uint32_t> kernelIndices(const Kernel& kernel, uint32_t size, uint32_t nextSize) {
+            std::vector<uint32_t> indices;
+            indices.reserve(static_cast<size_t> (nextSize) * kernel.weights.size());
+            for (uint32_t x = 0; x < nextSize; ++x) {
+                for (size_t k = 0; k < kernel.weights.size(); ++k) {
+                    int64_t index = 2 * static_cast<int64_t> (x) + kernel.first + static_cast<int64_t> (k);
+                    indices.push_back(static_cast<uint32_t> (std::min<int64_t>(std::max<int64_t>(index, 0), size - 1)));
+                }
+            }
+            return indices;
+        }
+    }
+
+    MipChain::MipChain(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels, MipFilter filter, bool srgb) {
+        if (width == 0 || height == 0 || channels == 0) {
+            throw std::invalid_argument("mip chain of an empty image");
+        }
+        this->channels = channels;
+        this->widths.push_back(width);
+        this->heights.push_back(height);
+        this->levels.push_back(std::vector<uint8_t>(pixels, pixels + static_cast<size_t> (width) * height * channels));
+
+        // alpha stays linear in sRGB images
+        std::vector<bool> encoded(channels);
+        for (uint32_t c = 0; c < channels; ++c) {
+            encoded[c] = srgb && !((channels == 2 || channels == 4) && c == channels - 1);
+        }
+
+        const float* decode = srgbToLinear();
+        std::vector<float> current(this->levels[0].size());
+        for (size_t i = 0; i < current.size(); ++i) {
+            current[i] = encoded[i % channels] ? decode[pixels[i]] : pixels[i] / 255.0f;
+        }
+
+        Kernel kernel = makeKernel(filter);
+        std::vector<std::vector<float>> linearLevels;
+        while (width > 1 || height > 1) {
+            // a dimension of 1 is not halved, its clamped taps all fall on the same texel
+            uint32_t nextWidth = std::max(width / 2, 1u);
+            uint32_t nextHeight = std::max(height / 2, 1u);
+            size_t rowSize = static_cast<size_t> (width) * channels;
+            size_t nextRowSize = static_cast<size_t> (nextWidth) * channels;
+
+            std::vector<uint32_t> columns = kernelIndices(kernel, width, nextWidth);
+            std::vector<float> horizontalPass(height * nextRowSize);
+            parallelRows(height, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t y = begin; y < end; ++y) {
+                    horizontal(&current[y * rowSize], kernel, columns.data(), nextWidth, channels, &horizontalPass[y * nextRowSize]);
+                }
+            });
+
+            std::vector<uint32_t> rows = kernelIndices(kernel, height, nextHeight);
+            std::vector<float> level(nextHeight * nextRowSize);
+            parallelRows(nextHeight, [&](uint32_t begin, uint32_t end) {
+                std::vector<const float*> sources(kernel.weights.size());
+                for (uint32_t y = begin; y < end; ++y) {
+                    for (size_t k = 0; k < sources.size(); ++k) {
+                        sources[k] = &horizontalPass[rows[y * sources.size() + k] * nextRowSize];
+                    }
+                    vertical(sources.data(), kernel, &level[y * nextRowSize], nextRowSize);
+                }
+            });
+
+            width = nextWidth;
+            height = nextHeight;
+            this->widths.push_back(width);
+            this->heights.push_back(height);
+            linearLevels.push_back(level);
+            current = std::move(level);
+        }
+
+        // levels are independent once filtered, so they are quantized in parallel
+        const uint8_t* encode = linearToSrgb();
+        this->levels.resize(linearLevels.size() + 1);
+        std::vector<std::future<void>> tasks;
+        for (size_t l = 0; l < linearLevels.size(); ++l) {
+            tasks.push_back(std::async(std::launch::async, [&, l]() {
+                const std::vector<float>& source = linearLevels[l];
+                std::vector<uint8_t>& target = this->levels[l + 1];
+                target.resize(source.size());
+                for (size_t i = 0; i < source.size(); ++i) {
+                    // sinc kernels ring, so values may leave the unit range
+                    float value = std::min(std::max(source[i], 0.0f), 1.0f);
+                    target[i] = encoded[i % channels]
+                            ? encode[static_cast<uint32_t> (value * 65535.0f + 0.5f)]
+                            : static_cast<uint8_t> (value * 255.0f + 0.5f);
+                }
+            }));
+        }
+        for (std::future<void>& task : tasks) {
+            task.get();
+        }
+    }
+
+    MipChain::~MipChain() {
+    }
+}
@@ -0,0 +1,271 @@
+/* 
+ * File:   MipmapGenerator.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 00:30
+ */
+
+#include "MipmapGenerator.h"
+#include "ComputeShader.h"
+#include "FileSystem.h"
+#include "Device.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#define MIPMAP_SHADER "mipmap.spv"
+// size of the image array in the shader, enough for 4096x4096
+#define MAX_MIPMAP_LEVELS 13
+#define MIPMAP_GROUP_SIZE 256
+// texels of level 0 reduced by a group along each axis
+#define MIPMAP_GROUP_TILE 32
+
+namespace zvlk {
+
+    namespace {
+
+        struct MipmapParameters {
+            uint32_t levelsNumber;
+            uint32_t groupsNumber;
+            uint32_t counterIndex;
+        };
+
+        struct MipmapSpecialization {
+            int32_t filter;
+            vk::Bool32 srgb;
+        };
+    }
+
+    MipmapGenerator::MipmapGenerator(zvlk::Device* device) {
+        this->device = device;
+        this->shader = nullptr;
+
+        try {
+            this->shader = new ComputeShader(device->getGraphicsDevice(), device->getFileSystem()->read(MIPMAP_SHADER));
+        } catch (const std::runtime_error& e) {
+            // textures fall back to blits
+            std::cout << "Mipmap shader " << MIPMAP_SHADER << " not loaded: " << e.what() << std::endl;
+            return;
+        }
+
+        vk::DescriptorSetLayoutBinding levelsBinding(0, vk::DescriptorType::eStorageImage, MAX_MIPMAP_LEVELS, vk::ShaderStageFlagBits::eCompute);
+        vk::DescriptorSetLayoutBinding countersBinding(1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute);
+        std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {levelsBinding, countersBinding};
+        this->descriptorSetLayout = device->getGraphicsDevice().createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo({},
+                static_cast<uint32_t> (bindings.size()), bindings.data()));
+
+        vk::PushConstantRange pushConstantRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof (MipmapParameters));
+        this->pipelineLayout = device->getGraphicsDevice().createPipelineLayout(vk::PipelineLayoutCreateInfo({},
+                1, &this->descriptorSetLayout, 1, &pushConstantRange));
+    }
+
+    MipmapGenerator::~MipmapGenerator() {
+        if (this->shader == nullptr) {
+            return;
+        }
+        vk::Device graphicsDevice = this->device->getGraphicsDevice();
+        for (auto& pipeline : this->pipelines) {
+            graphicsDevice.destroy(pipeline.second);
+        }
+        graphicsDevice.destroy(this->pipelineLayout);
+        graphicsDevice.destroy(this->descriptorSetLayout);
+        delete this->shader;
+    }
+
+    std::string MipmapGenerator::getUnsupportedReason(vk::Format format, uint32_t width, uint32_t height) {
+        if (this->shader == nullptr) {
+            return "shader " MIPMAP_SHADER " not loaded";
+        }
+        const vk::PhysicalDeviceLimits& limits = this->device->getProperties().limits;
+        if (!this->device->getFeatures().shaderStorageImageArrayDynamicIndexing) {
+            return "no dynamic indexing of storage image arrays";
+        }
+        if (limits.maxComputeWorkGroupInvocations < MIPMAP_GROUP_SIZE || limits.maxComputeWorkGroupSize[0] < MIPMAP_GROUP_SIZE) {
+            return "workgroups of " + std::to_string(MIPMAP_GROUP_SIZE) + " not supported";
+        }
+        // the shader declares its images as rgba8
+        if (format != vk::Format::eR8G8B8A8Unorm) {
+            return "format " + vk::to_string(format) + " is not RGBA";
+        }
+        if (!(this->device->getFormatProperties(format).optimalTilingFeatures & vk::FormatFeatureFlagBits::eStorageImage)) {
+            return "format " + vk::to_string(format) + " is not storage capable";
+        }
+        uint32_t levels = static_cast<uint32_t> (std::floor(std::log2(std::max(width, height)))) + 1;
+        if (levels > MAX_MIPMAP_LEVELS) {
+            return std::to_string(width) + "x" + std::to_string(height) + " is larger than " + std::to_string(1 << (MAX_MIPMAP_LEVELS - 1))
+                    + " texels";
+        }
+        if (levels == 1) {
+            return "a single texel has no mip chain";
+        }
+        return "";
+    }
+
+    vk::Pipeline MipmapGenerator::getPipeline(MipmapFilter filter, bool srgb) {
+        auto found = this->pipelines.find({filter, srgb});
+        if (found != this->pipelines.end()) {
+            return found->second;
+        }
+
+        MipmapSpecialization specialization = {static_cast<int32_t> (filter), srgb ? VK_TRUE : VK_FALSE};
+        std::array<vk::SpecializationMapEntry, 2> entries = {
+            vk::SpecializationMapEntry(0, offsetof(MipmapSpecialization, filter), sizeof (int32_t)),
+            vk::SpecializationMapEntry(1, offsetof(MipmapSpecialization, srgb), sizeof (vk::Bool32))
+        };
+        vk::SpecializationInfo specializationInfo(static_cast<uint32_t> (entries.size()), entries.data(), sizeof (specialization), &specialization);
+        vk::PipelineShaderStageCreateInfo stage = this->shader->getPipelineShaderStageCreateInfo();
+        stage.pSpecializationInfo = &specializationInfo;
+
+        vk::ComputePipelineCreateInfo pipelineInfo({}, stage, this->pipelineLayout);
+        vk::Pipeline pipeline = this->device->getGraphicsDevice().createComputePipelines(vk::PipelineCache(),{pipelineInfo})[0];
+        this->pipelines[{filter, srgb}] = pipeline;
+        return pipeline;
+    }
+
+    void MipmapGenerator::generate(const std::vector<MipmapTarget>& targets, MipmapFilter filter, bool srgb) {
+        if (targets.empty()) {
+            return;
+        }
+        vk::Device graphicsDevice = this->device->getGraphicsDevice();
+        uint32_t count = static_cast<uint32_t> (targets.size());
+        vk::Pipeline pipeline = this->getPipeline(filter, srgb);
+
+        std::array<vk::DescriptorPoolSize, 2> poolSizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, MAX_MIPMAP_LEVELS * count),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, count)
+        };
+        vk::DescriptorPool descriptorPool = graphicsDevice.createDescriptorPool(vk::DescriptorPoolCreateInfo({}, count,
+                static_cast<uint32_t> (poolSizes.size()), poolSizes.data()));
+        std::vector<vk::DescriptorSetLayout> layouts(count, this->descriptorSetLayout);
+        std::vector<vk::DescriptorSet> descriptorSets = graphicsDevice.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(descriptorPool, count, layouts.data()));
+
+        // one counter of finished groups per image
+        vk::Buffer counters;
+        vk::DeviceMemory countersMemory;
+        this->device->createBuffer(count * sizeof (uint32_t), vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, counters, countersMemory);
+
+        std::vector<vk::ImageView> views;
+        std::vector<vk::DescriptorImageInfo> imageInfos(MAX_MIPMAP_LEVELS * count);
+        std::vector<vk::DescriptorBufferInfo> bufferInfos(count);
+        std::vector<vk::WriteDescriptorSet> writes;
+        for (uint32_t i = 0; i < count; ++i) {
+            const MipmapTarget& target = targets[i];
+            for (uint32_t level = 0; level < target.mipLevels; ++level) {
+                views.push_back(graphicsDevice.createImageView(vk::ImageViewCreateInfo({}, target.image, vk::ImageViewType::e2D, target.format,
+                        vk::ComponentMapping(), vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level, 1, 0, 1))));
+            }
+            // slots past the last level are never accessed, but have to hold a valid view
+            for (uint32_t level = 0; level < MAX_MIPMAP_LEVELS; ++level) {
+                vk::ImageView view = views[views.size() - target.mipLevels + std::min(level, target.mipLevels - 1)];
+                imageInfos[i * MAX_MIPMAP_LEVELS + level] = vk::DescriptorImageInfo(vk::Sampler(), view, vk::ImageLayout::eGeneral);
+            }
+            bufferInfos[i] = vk::DescriptorBufferInfo(counters, 0, VK_WHOLE_SIZE);
+            writes.push_back(vk::WriteDescriptorSet(descriptorSets[i], 0, 0, MAX_MIPMAP_LEVELS, vk::DescriptorType::eStorageImage,
+                    &imageInfos[i * MAX_MIPMAP_LEVELS],{},{}));
+            writes.push_back(vk::WriteDescriptorSet(descriptorSets[i], 1, 0, 1, vk::DescriptorType::eStorageBuffer,{}, &bufferInfos[i],{}));
+        }
+        graphicsDevice.updateDescriptorSets(writes,{});
+
+        vk::CommandBuffer commandBuffer = this->device->beginSingleTimeCommands();
+
+        commandBuffer.fillBuffer(counters, 0, VK_WHOLE_SIZE, 0);
+        vk::BufferMemoryBarrier countersBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+                VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, counters, 0, VK_WHOLE_SIZE);
+
+        std::vector<vk::ImageMemoryBarrier> toGeneral;
+        std::vector<vk::ImageMemoryBarrier> toShader;
+        for (const MipmapTarget& target : targets) {
+            toGeneral.push_back(vk::ImageMemoryBarrier(vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead,
+                    vk::ImageLayout::eTransferDstOptimal, vk::ImageLayout::eGeneral, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                    target.image, vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1)));
+            toGeneral.push_back(vk::ImageMemoryBarrier({}, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+                    vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                    target.image, vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 1, target.mipLevels - 1, 0, 1)));
+            toShader.push_back(vk::ImageMemoryBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead,
+                    vk::ImageLayout::eGeneral, vk::ImageLayout::eShaderReadOnlyOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                    target.image, vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, target.mipLevels, 0, 1)));
+        }
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,{}, 0, nullptr,
+                1, &countersBarrier, static_cast<uint32_t> (toGeneral.size()), toGeneral.data());
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline);
+        for (uint32_t i = 0; i < count; ++i) {
+            const MipmapTarget& target = targets[i];
+            uint32_t groupsX = (target.width + MIPMAP_GROUP_TILE - 1) / MIPMAP_GROUP_TILE;
+            uint32_t groupsY = (target.height + MIPMAP_GROUP_TILE - 1) / MIPMAP_GROUP_TILE;
+            MipmapParameters parameters = {target.mipLevels, groupsX * groupsY, i};
+            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, this->pipelineLayout, 0, 1, &descriptorSets[i], 0, nullptr);
+            commandBuffer.pushConstants(this->pipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof (parameters), &parameters);
+            commandBuffer.dispatch(groupsX, groupsY, 1);
+        }
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eFragmentShader,{}, 0, nullptr, 0, nullptr,
+                static_cast<uint32_t> (toShader.size()), toShader.data());
+
+        this->device->endSingleTimeCommands(commandBuffer);
+
+        for (vk::ImageView view : views) {
+            graphicsDevice.destroy(view);
+        }
+        graphicsDevice.destroy(descriptorPool);
+        this->device->freeMemory(counters, countersMemory);
+    }
+
+    void MipmapGenerator::blit(const std::vector<MipmapTarget>& targets) {
+        vk::CommandBuffer commandBuffer = this->device->beginSingleTimeCommands();
+
+        for (const MipmapTarget& target : targets) {
+            vk::ImageMemoryBarrier barrier({},{},{},{}, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, target.image,
+                    vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor,{}, 1, 0, 1));
+
+            int32_t mipWidth = static_cast<int32_t> (target.width);
+            int32_t mipHeight = static_cast<int32_t> (target.height);
+
+            for (uint32_t i = 1; i < target.mipLevels; i++) {
+                barrier.subresourceRange.baseMipLevel = i - 1;
+                barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+                barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+                barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+                barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+
+                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer,{}, 0, nullptr, 0, nullptr, 1, &barrier);
+
+                vk::ImageBlit blit(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, i - 1, 0, 1),{
+                    vk::Offset3D(0, 0, 0), vk::Offset3D(mipWidth, mipHeight, 1)
+                },
+                vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, i, 0, 1),{
+                    vk::Offset3D(0, 0, 0), vk::Offset3D(mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1)
+                });
+
+                commandBuffer.blitImage(target.image, vk::ImageLayout::eTransferSrcOptimal, target.image, vk::ImageLayout::eTransferDstOptimal,
+                        1, &blit, vk::Filter::eLinear);
+
+                barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+                barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+                barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
+                barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+
+                commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,{},
+                0, nullptr, 0, nullptr, 1, &barrier);
+
+                if (mipWidth > 1) mipWidth /= 2;
+                if (mipHeight > 1) mipHeight /= 2;
+            }
+
+            barrier.subresourceRange.baseMipLevel = target.mipLevels - 1;
+            barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+            barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+            barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+            barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,{}, 0, nullptr, 0, nullptr, 1, &barrier);
+        }
+
+        this->device->endSingleTimeCommands(commandBuffer);
+    }
+}
@@ -6,84 +6,176 @@
  */
 
 #include "Model.h"
+#include "AssetCache.h"
+#include "ObjParser.h"
+#include "FileSystem.h"
+#include "MeshSimplifier.h"
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/matrix.hpp>
+
+#include <filesystem>
+#include <future>
+#include <algorithm>
+
+// levels of detail including the loaded model
+#define MAX_LODS 5
+// a level is kept only with at most this fraction of the indices of the previous one
+#define MIN_LOD_REDUCTION 0.8f
+// largest part of merged static models
+#define STATIC_BATCH_MAX_INDICES (3 * 65536)
 
 namespace zvlk {
 
     Model::Model(zvlk::Device* device, const std::string name, std::shared_ptr<zvlk::Frame> frame) {
-        tinyobj::attrib_t attrib;
-        std::vector<tinyobj::shape_t> shapes;
-        std::vector<tinyobj::material_t> materials;
-        std::string warn, err;
+        // material libraries sit next to the model, in the same mount
+        std::string directory = std::filesystem::path(name).parent_path().generic_string();
+        ObjParser parser(device->getFileSystem()->read(name), device->getFileSystem(), directory.empty() ? directory : directory + "/");
 
-        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, name.c_str(), "/tmp/")) {
-            throw std::runtime_error(warn + err);
+        // equal materials of the file collapse into one, so materials are looked up by id
+        std::vector<zvlk::Material*> materialsById;
+        this->lods.push_back({0.0f, 0,
+            {}});
+        std::unordered_map<zvlk::Material*, std::vector<ModelPart>>& modelParts = this->lods[0].modelParts;
+        for (const ObjMaterial& mat : parser.getMaterials()) {
+            std::shared_ptr<zvlk::Material> material = device->getAssetCache()->getMaterial(frame, mat.name,
+                    glm::vec4(mat.ambient, 1.0f), glm::vec4(mat.diffuse, 1.0f), glm::vec4(mat.specular, 1.0f),
+                    mat.shininess, mat.diffuseTexture);
+            materialsById.push_back(material.get());
+            if (modelParts.count(material.get()) == 0) {
+                this->materials.push_back(material.get());
+                this->materialReferences.push_back(material);
+                modelParts[material.get()] = {};
+            }
         }
 
-        std::unordered_map<Vertex, uint32_t> uniqueVertices({});
+        for (const ObjRange& range : parser.getRanges()) {
+            if (range.material < 0) {
+                throw std::runtime_error("faces without a material in " + name);
+            }
+            modelParts[materialsById[range.material]].push_back({range.numberOfIndices, range.indexOffset, {}});
+        }
+        this->vertices = std::move(parser.getVertices());
+        this->indices = std::move(parser.getIndices());
+        if (this->vertices.empty()) {
+            throw std::runtime_error("no faces in " + name);
+        }
+        this->computeBounds();
+        this->generateLods();
+        this->createBuffers(device);
+    }
 
-        for (tinyobj::material_t& mat : materials) {
-            zvlk::Material* newMaterial = new zvlk::Material(device, frame, mat.name,
-                    glm::vec4(mat.ambient[0], mat.ambient[1], mat.ambient[2], 1.0f),
-                    glm::vec4(mat.diffuse[0], mat.diffuse[1], mat.diffuse[2], 1.0f),
-                    glm::vec4(mat.specular[0], mat.specular[1], mat.specular[2], 1.0f),
-                    mat.shininess, mat.diffuse_texname);
-            this->materials.push_back(newMaterial);
-            this->modelParts[newMaterial] = {};
+    Model::Model(zvlk::Device* device, const std::vector<std::pair<zvlk::Model*, glm::mat4>>& sources) {
+        if (sources.empty()) {
+            throw std::runtime_error("no models to merge");
         }
 
-        uint32_t lastIndexOffset = 0;
-        int indiceIndex = 0;
-        int lastMaterial = -1;
-        //TODO sorting by materials
-        for (const auto& shape : shapes) {
-            const tinyobj::mesh_t& mesh = shape.mesh;
-
-            int meshIndiceIndex=0;
-            for (const auto& index : mesh.indices) {
-                Vertex vertex{};
-
-                vertex.position = {
-                    attrib.vertices[3 * index.vertex_index + 0],
-                    attrib.vertices[3 * index.vertex_index + 1],
-                    attrib.vertices[3 * index.vertex_index + 2]
-                };
-
-                vertex.texCoord = {
-                    attrib.texcoords[2 * index.texcoord_index + 0],
-                    1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-                };
-
-                vertex.normal = {
-                    attrib.normals[3 * index.normal_index + 0],
-                    attrib.normals[3 * index.normal_index + 1],
-                    attrib.normals[3 * index.normal_index + 2]
-                };
-                
-                if (uniqueVertices.count(vertex) == 0) {
-                    uniqueVertices[vertex] = static_cast<uint32_t> (this->vertices.size());
-                    this->vertices.push_back(vertex);
-                }
+        // consecutive sources end up in the same parts, so they are ordered along a curve through space
+        std::vector<glm::vec3> centers;
+        for (const auto& source : sources) {
+            const Bounds& sourceBounds = source.first->getBounds();
+            centers.push_back(glm::vec3(source.second * glm::vec4((sourceBounds.min + sourceBounds.max) * 0.5f, 1.0f)));
+        }
+        zvlk::Bounds extent = {centers[0], centers[0]};
+        for (const glm::vec3& center : centers) {
+            extent.min = glm::min(extent.min, center);
+            extent.max = glm::max(extent.max, center);
+        }
+        std::vector<std::pair<uint32_t, size_t>> order;
+        glm::vec3 size = glm::max(extent.max - extent.min, glm::vec3(1e-6f));
+        for (size_t i = 0; i < sources.size(); ++i) {
+            glm::vec3 cell = glm::min((centers[i] - extent.min) / size * 1023.0f, glm::vec3(1023.0f));
+            uint32_t code = 0;
+            for (uint32_t bit = 0; bit < 10; ++bit) {
+                code |= ((static_cast<uint32_t> (cell.x) >> bit) & 1) << (3 * bit)
+                        | ((static_cast<uint32_t> (cell.y) >> bit) & 1) << (3 * bit + 1)
+                        | ((static_cast<uint32_t> (cell.z) >> bit) & 1) << (3 * bit + 2);
+            }
+            order.push_back({code, i});
+        }
+        std::sort(order.begin(), order.end());
 
-                if (lastMaterial == -1) {
-                    lastMaterial = mesh.material_ids[meshIndiceIndex/3];
-                } else if (lastMaterial != mesh.material_ids[meshIndiceIndex/3]) {
-                    this->modelParts[this->materials[lastMaterial]].push_back({indiceIndex - lastIndexOffset, lastIndexOffset});
+        // vertices of every source are transformed once, indices are offset by where they start
+        std::vector<uint32_t> baseVertices(sources.size());
+        for (const auto& entry : order) {
+            const auto& source = sources[entry.second];
+            glm::mat4 normal;
+            BatchMath::normalMatrices(&source.second, &normal, 1);
+            baseVertices[entry.second] = static_cast<uint32_t> (this->vertices.size());
+            for (const Vertex& vertex : source.first->vertices) {
+                this->vertices.push_back({glm::vec3(source.second * glm::vec4(vertex.position, 1.0f)), vertex.texCoord,
+                    glm::normalize(glm::vec3(normal * glm::vec4(vertex.normal, 0.0f)))});
+            }
+            for (size_t m = 0; m < source.first->materials.size(); ++m) {
+                if (std::find(this->materials.begin(), this->materials.end(), source.first->materials[m]) == this->materials.end()) {
+                    this->materials.push_back(source.first->materials[m]);
+                    this->materialReferences.push_back(source.first->materialReferences[m]);
+                }
+            }
+        }
 
-                    lastMaterial = mesh.material_ids[meshIndiceIndex/3];
-                    lastIndexOffset = indiceIndex;
+        // parts of a material are merged up to a size that still culls well
+        this->lods.push_back({0.0f, 0,
+            {}});
+        for (zvlk::Material* material : this->materials) {
+            std::vector<ModelPart>& parts = this->lods[0].modelParts[material];
+            for (const auto& entry : order) {
+                zvlk::Model* source = sources[entry.second].first;
+                // mirroring matrices turn the winding of triangles around
+                bool mirrored = glm::determinant(glm::mat3(sources[entry.second].second)) < 0.0f;
+                if (source->lods[0].modelParts.count(material) == 0) {
+                    continue;
                 }
+                for (const ModelPart& part : source->lods[0].modelParts[material]) {
+                    if (part.numberOfIndices == 0) {
+                        continue;
+                    }
+                    if (parts.empty() || parts.back().numberOfIndices + part.numberOfIndices > STATIC_BATCH_MAX_INDICES) {
+                        parts.push_back({0, static_cast<uint32_t> (this->indices.size()),
+                            {}});
+                    }
+                    for (uint32_t i = part.indexOffset; i < part.indexOffset + part.numberOfIndices; i += 3) {
+                        this->indices.push_back(baseVertices[entry.second] + source->indices[i]);
+                        this->indices.push_back(baseVertices[entry.second] + source->indices[i + (mirrored ? 2 : 1)]);
+                        this->indices.push_back(baseVertices[entry.second] + source->indices[i + (mirrored ? 1 : 2)]);
+                    }
+                    parts.back().numberOfIndices += part.numberOfIndices;
+                }
+            }
+        }
+        if (this->indices.empty()) {
+            throw std::runtime_error("no faces in merged models");
+        }
+
+        this->computeBounds();
+        this->createBuffers(device);
+    }
 
-                this->indices.push_back(uniqueVertices[vertex]);
-                indiceIndex++;
-                meshIndiceIndex++;
+    void Model::computeBounds() {
+        for (auto& parts : this->lods[0].modelParts) {
+            for (ModelPart& part : parts.second) {
+                if (part.numberOfIndices == 0) {
+                    continue;
+                }
+                const glm::vec3& first = this->vertices[this->indices[part.indexOffset]].position;
+                part.bounds = {first, first};
+                for (uint32_t i = part.indexOffset; i < part.indexOffset + part.numberOfIndices; ++i) {
+                    part.bounds.min = glm::min(part.bounds.min, this->vertices[this->indices[i]].position);
+                    part.bounds.max = glm::max(part.bounds.max, this->vertices[this->indices[i]].position);
+                }
             }
+        }
+        this->lods[0].numberOfIndices = static_cast<uint32_t> (this->indices.size());
 
+        this->bounds = {this->vertices[0].position, this->vertices[0].position};
+        for (const Vertex& vertex : this->vertices) {
+            this->bounds.min = glm::min(this->bounds.min, vertex.position);
+            this->bounds.max = glm::max(this->bounds.max, vertex.position);
         }
-        this->modelParts[this->materials[lastMaterial]].push_back({indiceIndex - lastIndexOffset, lastIndexOffset});
+    }
 
+    void Model::createBuffers(zvlk::Device* device) {
         vk::DeviceSize vertexBufferSize = sizeof (this->vertices[0]) * this->vertices.size();
         vk::DeviceSize indicesBufferSize = sizeof (this->indices[0]) * this->indices.size();
         vk::DeviceSize maxStagingBufferSize = std::max(vertexBufferSize, indicesBufferSize);
@@ -112,10 +204,60 @@ namespace zvlk {
         this->device = device;
     }
 
-    Model::~Model() {
-        for (auto material : materials) {
-            delete material;
+    void Model::generateLods() {
+        std::vector<ModelPart> parts;
+        for (zvlk::Material* material : this->materials) {
+            for (const ModelPart& part : this->lods[0].modelParts[material]) {
+                parts.push_back(part);
+            }
         }
+        MeshSimplifier simplifier(this->vertices, this->indices, parts);
+
+        for (uint32_t level = 1; level < MAX_LODS; ++level) {
+            // every level is simplified from the loaded model, parts on separate threads
+            std::vector<std::future<std::vector<uint32_t>>> tasks;
+            std::vector<float> errors(parts.size());
+            for (size_t i = 0; i < parts.size(); ++i) {
+                size_t target = (parts[i].numberOfIndices >> level) / 3 * 3;
+                tasks.push_back(std::async(std::launch::async, [&simplifier, &parts, &errors, i, target]() {
+                    return simplifier.simplify(parts[i], target, errors[i]);
+                }));
+            }
+            std::vector<std::vector<uint32_t>> simplified;
+            for (auto& task : tasks) {
+                simplified.push_back(task.get());
+            }
+
+            // error of a coarser level is never below that of a finer one, so selection may stop at the first too coarse
+            ModelLod lod = {this->lods.back().error, 0,
+                {}};
+            size_t i = 0;
+            for (zvlk::Material* material : this->materials) {
+                lod.modelParts[material] = {};
+                for (size_t j = 0; j < this->lods[0].modelParts[material].size(); ++j, ++i) {
+                    lod.error = std::max(lod.error, errors[i]);
+                    lod.numberOfIndices += static_cast<uint32_t> (simplified[i].size());
+                }
+            }
+            // locked boundaries and seams keep some models from getting much smaller
+            if (lod.numberOfIndices > MIN_LOD_REDUCTION * this->lods.back().numberOfIndices) {
+                break;
+            }
+
+            // parts stay in the order of level 0 even when empty, so they can be matched across levels
+            i = 0;
+            for (zvlk::Material* material : this->materials) {
+                for (const ModelPart& part : this->lods[0].modelParts[material]) {
+                    lod.modelParts[material].push_back({static_cast<uint32_t> (simplified[i].size()), static_cast<uint32_t> (this->indices.size()), part.bounds});
+                    this->indices.insert(this->indices.end(), simplified[i].begin(), simplified[i].end());
+                    i++;
+                }
+            }
+            this->lods.push_back(std::move(lod));
+        }
+    }
+
+    Model::~Model() {
         this->device->freeMemory(this->indexBuffer, this->indexBufferMemory);
         this->device->freeMemory(this->vertexBuffer, this->vertexBufferMemory);
     }
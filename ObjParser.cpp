@@ -0,0 +1,368 @@
+/* 
+ * File:   ObjParser.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 00:30
+ */
+
+#include "ObjParser.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <unordered_map>
+
+// smaller files are not worth splitting between threads
+#define MIN_CHUNK_SIZE (1 << 20)
+
+namespace zvlk {
+
+    namespace {
+
+        // zero based, relative ones count from the end of the attributes of their own chunk
+        struct Index {
+            int32_t value = -1;
+            bool relative = false;
+        };
+
+        struct Corner {
+            Index position;
+            Index texCoord;
+            Index normal;
+        };
+
+        struct Chunk {
+            std::vector<float> positions;
+            std::vector<float> texCoords;
+            std::vector<float> normals;
+            // three per triangle
+            std::vector<Corner> corners;
+            // usemtl names with the first triangle they apply to
+            std::vector<std::pair<uint32_t, std::string>> materials;
+            std::vector<std::string> libraries;
+        };
+
+        // corner with indices into the merged attributes, UINT32_MAX when missing
+        struct Key {
+            uint32_t position;
+            uint32_t texCoord;
+            uint32_t normal;
+
+            bool operator==(const Key& other) const {
+                return position == other.position && texCoord == other.texCoord && normal == other.normal;
+            }
+        };
+
+        struct KeyHash {
+
+            size_t operator()(const Key& key) const {
+                uint64_t value = (static_cast<uint64_t> (key.position) * 0x9E3779B97F4A7C15ULL) ^ (static_cast<uint64_t> (key.texCoord) * 0xC2B2AE3D27D4EB4FULL)
+                        ^ (static_cast<uint64_t> (key.normal) * 0x165667B19E3779F9ULL);
+                return static_cast<size_t> (value ^ (value >> 32));
+            }
+        };
+
+        bool isSpace(char c) {
+            return c == ' ' || c == '\t';
+        }
+
+        const char* skipSpaces(const char* p, const char* end) {
+            while (p < end && isSpace(*p)) {
+                ++p;
+            }
+            return p;
+        }
+
+        bool startsWith(const char* p, const char* end, const char* keyword) {
+            size_t length = std::strlen(keyword);
+            return static_cast<size_t> (end - p) > length && std::memcmp(p, keyword, length) == 0 && isSpace(p[length]);
+        }
+
+        const char* parseFloat(const char* p, const char* end, float& value) {
+            p = skipSpaces(p, end);
+            if (p < end && *p == '+') {
+                ++p;
+            }
+            std::from_chars_result result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) {
+                throw std::runtime_error("malformed number in OBJ file");
+            }
+            return result.ptr;
+        }
+
+        void parseFloats(const char* p, const char* end, std::vector<float>& values, int count) {
+            for (int i = 0; i < count; ++i) {
+                float value = 0.0f;
+                // missing trailing components are zero, extra ones such as vertex colors are ignored
+                if (skipSpaces(p, end) < end) {
+                    p = parseFloat(p, end, value);
+                }
+                values.push_back(value);
+            }
+        }
+
+        const char* parseIndex(const char* p, const char* end, size_t count, Index& index) {
+            int32_t value = 0;
+            std::from_chars_result result = std::from_chars(p, end, value);
+            if (result.ec != std::errc() || value == 0) {
+                throw std::runtime_error("malformed face index in OBJ file");
+            }
+            index.relative = value < 0;
+            index.value = value < 0 ? static_cast<int32_t> (count) + value : value - 1;
+            return result.ptr;
+        }
+
+        void parseFace(const char* p, const char* end, Chunk& chunk, std::vector<Corner>& polygon) {
+            polygon.clear();
+            while ((p = skipSpaces(p, end)) < end) {
+                Corner corner;
+                p = parseIndex(p, end, chunk.positions.size() / 3, corner.position);
+                if (p < end && *p == '/') {
+                    ++p;
+                    if (p < end && *p != '/') {
+                        p = parseIndex(p, end, chunk.texCoords.size() / 2, corner.texCoord);
+                    }
+                    if (p < end && *p == '/') {
+                        p = parseIndex(p + 1, end, chunk.normals.size() / 3, corner.normal);
+                    }
+                }
+                polygon.push_back(corner);
+            }
+            for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+                chunk.corners.push_back(polygon[0]);
+                chunk.corners.push_back(polygon[i]);
+                chunk.corners.push_back(polygon[i + 1]);
+            }
+        }
+
+        std::string parseName(const char* p, const char* end) {
+            p = skipSpaces(p, end);
+            while (end > p && isSpace(end[-1])) {
+                --end;
+            }
+            return std::string(p, end);
+        }
+
+        void parseChunk(const char* begin, const char* end, Chunk& chunk) {
+            std::vector<Corner> polygon;
+            for (const char* line = begin; line < end;) {
+                const char* lineEnd = static_cast<const char*> (std::memchr(line, '\n', end - line));
+                const char* next = lineEnd ? lineEnd + 1 : end;
+                if (!lineEnd) {
+                    lineEnd = end;
+                }
+                if (lineEnd > line && lineEnd[-1] == '\r') {
+                    --lineEnd;
+                }
+
+                const char* p = skipSpaces(line, lineEnd);
+                if (startsWith(p, lineEnd, "v")) {
+                    parseFloats(p + 1, lineEnd, chunk.positions, 3);
+                } else if (startsWith(p, lineEnd, "vt")) {
+                    parseFloats(p + 2, lineEnd, chunk.texCoords, 2);
+                } else if (startsWith(p, lineEnd, "vn")) {
+                    parseFloats(p + 2, lineEnd, chunk.normals, 3);
+                } else if (startsWith(p, lineEnd, "f")) {
+                    parseFace(p + 1, lineEnd, chunk, polygon);
+                } else if (startsWith(p, lineEnd, "usemtl")) {
+                    chunk.materials.push_back({static_cast<uint32_t> (chunk.corners.size() / 3), parseName(p + 6, lineEnd)});
+                } else if (startsWith(p, lineEnd, "mtllib")) {
+                    for (p += 6; (p = skipSpaces(p, lineEnd)) < lineEnd;) {
+                        const char* name = p;
+                        while (p < lineEnd && !isSpace(*p)) {
+                            ++p;
+                        }
+                        chunk.libraries.push_back(std::string(name, p));
+                    }
+                }
+                line = next;
+            }
+        }
+
+        uint32_t resolve(const Index& index, uint32_t offset, uint32_t count) {
+            if (index.value == -1 && !index.relative) {
+                return UINT32_MAX;
+            }
+            int64_t value = index.value + (index.relative ? static_cast<int64_t> (offset) : 0);
+            if (value < 0 || value >= count) {
+                throw std::runtime_error("OBJ face refers to a missing vertex attribute");
+            }
+            return static_cast<uint32_t> (value);
+        }
+    }
+
+    ObjParser::ObjParser(const Blob& content, FileSystem* fileSystem, const std::string& materialDirectory) {
+        const char* begin = reinterpret_cast<const char*> (content.getData());
+        const char* end = begin + content.getSize();
+
+        // chunks end after a line break, so no line is split
+        size_t workers = std::max(1u, std::thread::hardware_concurrency());
+        size_t chunkSize = std::max<size_t>(MIN_CHUNK_SIZE, content.getSize() / workers + 1);
+        std::vector<std::pair<const char*, const char*>> bounds;
+        for (const char* chunkBegin = begin; chunkBegin < end;) {
+            const char* chunkEnd = chunkBegin + std::min<size_t>(chunkSize, end - chunkBegin);
+            const char* lineEnd = chunkEnd < end ? static_cast<const char*> (std::memchr(chunkEnd, '\n', end - chunkEnd)) : nullptr;
+            chunkEnd = lineEnd ? lineEnd + 1 : end;
+            bounds.push_back({chunkBegin, chunkEnd});
+            chunkBegin = chunkEnd;
+        }
+
+        std::vector<Chunk> chunks(bounds.size());
+        std::vector<std::future<void>> tasks;
+        for (size_t i = 1; i < chunks.size(); ++i) {
+            tasks.push_back(std::async(std::launch::async, parseChunk, bounds[i].first, bounds[i].second, std::ref(chunks[i])));
+        }
+        if (!chunks.empty()) {
+            parseChunk(bounds[0].first, bounds[0].second, chunks[0]);
+        }
+        for (std::future<void>& task : tasks) {
+            task.get();
+        }
+
+        for (const Chunk& chunk : chunks) {
+            for (const std::string& library : chunk.libraries) {
+                this->parseMaterials(fileSystem->read(materialDirectory + library));
+            }
+        }
+        // the first material of a name wins, like in tinyobjloader
+        std::unordered_map<std::string, int32_t> materialIds;
+        for (size_t i = 0; i < this->materials.size(); ++i) {
+            materialIds.insert({this->materials[i].name, static_cast<int32_t> (i)});
+        }
+
+        // attributes are concatenated in file order, relative indices are offset by what precedes their chunk
+        std::vector<float> positions, texCoords, normals;
+        std::vector<uint32_t> positionOffsets, texCoordOffsets, normalOffsets;
+        for (const Chunk& chunk : chunks) {
+            positionOffsets.push_back(static_cast<uint32_t> (positions.size() / 3));
+            texCoordOffsets.push_back(static_cast<uint32_t> (texCoords.size() / 2));
+            normalOffsets.push_back(static_cast<uint32_t> (normals.size() / 3));
+            positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+            texCoords.insert(texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+            normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+        }
+
+        std::vector<std::vector<Key>> keys(chunks.size());
+        tasks.clear();
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            tasks.push_back(std::async(std::launch::async, [&, i]() {
+                uint32_t positionsNumber = static_cast<uint32_t> (positions.size() / 3);
+                uint32_t texCoordsNumber = static_cast<uint32_t> (texCoords.size() / 2);
+                uint32_t normalsNumber = static_cast<uint32_t> (normals.size() / 3);
+                keys[i].reserve(chunks[i].corners.size());
+                for (const Corner& corner : chunks[i].corners) {
+                    keys[i].push_back({resolve(corner.position, positionOffsets[i], positionsNumber),
+                        resolve(corner.texCoord, texCoordOffsets[i], texCoordsNumber),
+                        resolve(corner.normal, normalOffsets[i], normalsNumber)});
+                    if (keys[i].back().position == UINT32_MAX) {
+                        throw std::runtime_error("OBJ face without a position");
+                    }
+                }
+            }));
+        }
+        for (std::future<void>& task : tasks) {
+            task.get();
+        }
+
+        // equal index triples are found first, equal vertices written under other indices after
+        std::unordered_map<Key, uint32_t, KeyHash> uniqueKeys;
+        std::unordered_map<Vertex, uint32_t> uniqueVertices;
+        int32_t material = -1;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            const Chunk& chunk = chunks[i];
+            size_t switches = 0;
+            for (size_t corner = 0; corner < keys[i].size(); ++corner) {
+                if (corner % 3 == 0) {
+                    while (switches < chunk.materials.size() && chunk.materials[switches].first == corner / 3) {
+                        auto id = materialIds.find(chunk.materials[switches++].second);
+                        material = id == materialIds.end() ? -1 : id->second;
+                    }
+                    if (this->ranges.empty() || this->ranges.back().material != material) {
+                        this->ranges.push_back({material, static_cast<uint32_t> (this->indices.size()), 0});
+                    }
+                    this->ranges.back().numberOfIndices += 3;
+                }
+
+                const Key& key = keys[i][corner];
+                auto found = uniqueKeys.find(key);
+                if (found != uniqueKeys.end()) {
+                    this->indices.push_back(found->second);
+                    continue;
+                }
+
+                Vertex vertex{};
+                vertex.position = {positions[3 * key.position + 0], positions[3 * key.position + 1], positions[3 * key.position + 2]};
+                if (key.texCoord != UINT32_MAX) {
+                    vertex.texCoord = {texCoords[2 * key.texCoord + 0], 1.0f - texCoords[2 * key.texCoord + 1]};
+                } else {
+                    vertex.texCoord = {0.0f, 1.0f};
+                }
+                if (key.normal != UINT32_MAX) {
+                    vertex.normal = {normals[3 * key.normal + 0], normals[3 * key.normal + 1], normals[3 * key.normal + 2]};
+                }
+
+                auto unique = uniqueVertices.insert({vertex, static_cast<uint32_t> (this->vertices.size())});
+                if (unique.second) {
+                    this->vertices.push_back(vertex);
+                }
+                uniqueKeys[key] = unique.first->second;
+                this->indices.push_back(unique.first->second);
+            }
+            // a usemtl after the last face of the chunk carries over to the next one
+            while (switches < chunk.materials.size()) {
+                auto id = materialIds.find(chunk.materials[switches++].second);
+                material = id == materialIds.end() ? -1 : id->second;
+            }
+        }
+    }
+
+    void ObjParser::parseMaterials(const Blob& content) {
+        const char* begin = reinterpret_cast<const char*> (content.getData());
+        const char* end = begin + content.getSize();
+
+        for (const char* line = begin; line < end;) {
+            const char* lineEnd = static_cast<const char*> (std::memchr(line, '\n', end - line));
+            const char* next = lineEnd ? lineEnd + 1 : end;
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            if (lineEnd > line && lineEnd[-1] == '\r') {
+                --lineEnd;
+            }
+
+            const char* p = skipSpaces(line, lineEnd);
+            if (startsWith(p, lineEnd, "newmtl")) {
+                this->materials.push_back({});
+                this->materials.back().name = parseName(p + 6, lineEnd);
+            } else if (!this->materials.empty()) {
+                ObjMaterial& material = this->materials.back();
+                std::vector<float> values;
+                if (startsWith(p, lineEnd, "Ka")) {
+                    parseFloats(p + 2, lineEnd, values, 3);
+                    material.ambient = glm::vec3(values[0], values[1], values[2]);
+                } else if (startsWith(p, lineEnd, "Kd")) {
+                    parseFloats(p + 2, lineEnd, values, 3);
+                    material.diffuse = glm::vec3(values[0], values[1], values[2]);
+                } else if (startsWith(p, lineEnd, "Ks")) {
+                    parseFloats(p + 2, lineEnd, values, 3);
+                    material.specular = glm::vec3(values[0], values[1], values[2]);
+                } else if (startsWith(p, lineEnd, "Ns")) {
+                    parseFloats(p + 2, lineEnd, values, 1);
+                    material.shininess = values[0];
+                } else if (startsWith(p, lineEnd, "map_Kd")) {
+                    // options such as -bm come before the file name
+                    std::string name = parseName(p + 6, lineEnd);
+                    size_t space = name.find_last_of(" \t");
+                    material.diffuseTexture = space == std::string::npos ? name : name.substr(space + 1);
+                }
+            }
+            line = next;
+        }
+    }
+
+    ObjParser::~ObjParser() {
+    }
+}
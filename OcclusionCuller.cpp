@@ -0,0 +1,364 @@
+/* 
+ * File:   OcclusionCuller.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 02:10
+ */
+
+#include "OcclusionCuller.h"
+#include "Device.h"
+#include "Frame.h"
+#include "Model.h"
+#include "VertexShader.h"
+#include "ComputeShader.h"
+#include "AssetCache.h"
+#include "FileSystem.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+#define OCCLUDER_SHADER "occluder.spv"
+#define PYRAMID_SHADER "hiz.spv"
+#define CULL_SHADER "cull.spv"
+#define PYRAMID_GROUP_SIZE 8
+#define CULL_GROUP_SIZE 64
+
+namespace zvlk {
+
+    namespace {
+
+        struct CullParameters {
+            glm::mat4 viewProj;
+            glm::vec2 pyramidSize;
+            uint32_t drawsNumber;
+        };
+
+        uint32_t previousPowerOfTwo(uint32_t value) {
+            uint32_t result = 1;
+            while (result * 2 <= value) {
+                result *= 2;
+            }
+            return result;
+        }
+    }
+
+    OcclusionCuller::OcclusionCuller(zvlk::Device* device, std::shared_ptr<zvlk::Frame> frame, vk::PipelineLayout pipelineLayout, uint32_t drawsNumber) {
+        this->device = device;
+        this->frame = frame;
+        this->drawsNumber = drawsNumber;
+        this->supported = false;
+        this->occluderShader = nullptr;
+        this->pyramidShader = nullptr;
+        this->cullShader = nullptr;
+
+        // depth of the occluders is sampled for the pyramid
+        this->depthFormat = vk::Format::eD32Sfloat;
+        vk::FormatFeatureFlags depthFeatures = vk::FormatFeatureFlagBits::eDepthStencilAttachment | vk::FormatFeatureFlagBits::eSampledImage;
+        if ((device->getFormatProperties(this->depthFormat).optimalTilingFeatures & depthFeatures) != depthFeatures) {
+            std::cout << "Occlusion culling disabled, depth cannot be sampled" << std::endl;
+            return;
+        }
+
+        try {
+            vk::Device graphicsDevice = device->getGraphicsDevice();
+            this->occluderShader = new VertexShader(graphicsDevice, device->getFileSystem()->read(OCCLUDER_SHADER));
+            this->pyramidShader = new ComputeShader(graphicsDevice, device->getFileSystem()->read(PYRAMID_SHADER));
+            this->cullShader = new ComputeShader(graphicsDevice, device->getFileSystem()->read(CULL_SHADER));
+        } catch (const std::runtime_error& e) {
+            std::cout << "Occlusion culling disabled: " << e.what() << std::endl;
+            delete this->occluderShader;
+            delete this->pyramidShader;
+            delete this->cullShader;
+            this->occluderShader = nullptr;
+            this->pyramidShader = nullptr;
+            this->cullShader = nullptr;
+            return;
+        }
+
+        this->createTargets();
+        this->createPipelines(pipelineLayout);
+        this->createBuffers();
+        this->supported = true;
+    }
+
+    OcclusionCuller::~OcclusionCuller() {
+        if (!this->supported) {
+            return;
+        }
+        vk::Device graphicsDevice = this->device->getGraphicsDevice();
+
+        for (size_t i = 0; i < this->commandsBuffers.size(); ++i) {
+            graphicsDevice.unmapMemory(this->commandsMemory[i]);
+            graphicsDevice.unmapMemory(this->boundsMemory[i]);
+            graphicsDevice.unmapMemory(this->statisticsMemory[i]);
+            this->device->freeMemory(this->commandsBuffers[i], this->commandsMemory[i]);
+            this->device->freeMemory(this->boundsBuffers[i], this->boundsMemory[i]);
+            this->device->freeMemory(this->statisticsBuffers[i], this->statisticsMemory[i]);
+        }
+        this->device->freeMemory(this->occludersBuffer, this->occludersMemory);
+
+        graphicsDevice.destroy(this->descriptorPool);
+        graphicsDevice.destroy(this->cullPipeline);
+        graphicsDevice.destroy(this->cullPipelineLayout);
+        graphicsDevice.destroy(this->cullLayout);
+        graphicsDevice.destroy(this->pyramidPipeline);
+        graphicsDevice.destroy(this->pyramidPipelineLayout);
+        graphicsDevice.destroy(this->pyramidLayout);
+        graphicsDevice.destroy(this->occluderPipeline);
+
+        for (vk::ImageView view : this->pyramidLevelViews) {
+            graphicsDevice.destroy(view);
+        }
+        graphicsDevice.destroy(this->pyramidView);
+        graphicsDevice.destroy(this->pyramidImage);
+        graphicsDevice.free(this->pyramidImageMemory);
+
+        graphicsDevice.destroy(this->framebuffer);
+        graphicsDevice.destroy(this->renderPass);
+        graphicsDevice.destroy(this->depthImageView);
+        graphicsDevice.destroy(this->depthImage);
+        graphicsDevice.free(this->depthImageMemory);
+
+        delete this->cullShader;
+        delete this->pyramidShader;
+        delete this->occluderShader;
+    }
+
+    void OcclusionCuller::createTargets() {
+        vk::Device graphicsDevice = this->device->getGraphicsDevice();
+        uint32_t width = this->frame->getWidth();
+        uint32_t height = this->frame->getHeight();
+
+        this->device->createImage(width, height, 1, vk::SampleCountFlagBits::e1, this->depthFormat, vk::ImageTiling::eOptimal,
+                vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eSampled,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, this->depthImage, this->depthImageMemory);
+        this->depthImageView = this->device->createImageView(this->depthImage, this->depthFormat, vk::ImageAspectFlagBits::eDepth, 1);
+
+        vk::AttachmentDescription depthAttachment({}, this->depthFormat, vk::SampleCountFlagBits::e1,
+                vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
+                vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
+                vk::ImageLayout::eUndefined, vk::ImageLayout::eDepthStencilReadOnlyOptimal);
+        vk::AttachmentReference depthAttachmentRef(0, vk::ImageLayout::eDepthStencilAttachmentOptimal);
+        vk::SubpassDescription subpass({}, vk::PipelineBindPoint::eGraphics, 0, nullptr, 0, nullptr, nullptr, &depthAttachmentRef);
+        std::array<vk::SubpassDependency, 2> dependencies = {
+            // the pyramid of the previous frame must be done reading the depth before it is cleared
+            vk::SubpassDependency(VK_SUBPASS_EXTERNAL, 0,
+            vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests,
+            {}, vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite),
+            vk::SubpassDependency(0, VK_SUBPASS_EXTERNAL,
+            vk::PipelineStageFlagBits::eLateFragmentTests, vk::PipelineStageFlagBits::eComputeShader,
+            vk::AccessFlagBits::eDepthStencilAttachmentWrite, vk::AccessFlagBits::eShaderRead)
+        };
+        this->renderPass = graphicsDevice.createRenderPass(vk::RenderPassCreateInfo({}, 1, &depthAttachment, 1, &subpass,
+                static_cast<uint32_t> (dependencies.size()), dependencies.data()));
+        this->framebuffer = graphicsDevice.createFramebuffer(vk::FramebufferCreateInfo({}, this->renderPass, 1, &this->depthImageView, width, height, 1));
+
+        // power of two levels, so every texel below level 0 covers exactly four of the level above
+        this->pyramidWidth = previousPowerOfTwo(width);
+        this->pyramidHeight = previousPowerOfTwo(height);
+        this->pyramidLevels = static_cast<uint32_t> (std::log2(std::max(this->pyramidWidth, this->pyramidHeight))) + 1;
+        this->device->createImage(this->pyramidWidth, this->pyramidHeight, this->pyramidLevels, vk::SampleCountFlagBits::e1, vk::Format::eR32Sfloat,
+                vk::ImageTiling::eOptimal, vk::ImageUsageFlagBits::eStorage | vk::ImageUsageFlagBits::eSampled,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, this->pyramidImage, this->pyramidImageMemory);
+        this->pyramidView = this->device->createImageView(this->pyramidImage, vk::Format::eR32Sfloat, vk::ImageAspectFlagBits::eColor, this->pyramidLevels);
+        for (uint32_t level = 0; level < this->pyramidLevels; ++level) {
+            this->pyramidLevelViews.push_back(graphicsDevice.createImageView(vk::ImageViewCreateInfo({}, this->pyramidImage, vk::ImageViewType::e2D,
+                    vk::Format::eR32Sfloat, vk::ComponentMapping(), vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level, 1, 0, 1))));
+        }
+
+        // levels are written and sampled in the general layout, so the pyramid never changes layout
+        vk::CommandBuffer commandBuffer = this->device->beginSingleTimeCommands();
+        vk::ImageMemoryBarrier toGeneral({}, vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite,
+                vk::ImageLayout::eUndefined, vk::ImageLayout::eGeneral, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                this->pyramidImage, vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, this->pyramidLevels, 0, 1));
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eComputeShader,{}, 0, nullptr, 0, nullptr, 1, &toGeneral);
+        this->device->endSingleTimeCommands(commandBuffer);
+
+        vk::SamplerCreateInfo samplerInfo({}, vk::Filter::eNearest, vk::Filter::eNearest, vk::SamplerMipmapMode::eNearest,
+                vk::SamplerAddressMode::eClampToEdge, vk::SamplerAddressMode::eClampToEdge, vk::SamplerAddressMode::eClampToEdge,
+                0.0f, VK_FALSE, 1.0f, VK_FALSE, vk::CompareOp::eAlways, 0.0f, static_cast<float> (this->pyramidLevels));
+        this->sampler = this->device->getAssetCache()->getSampler(samplerInfo);
+    }
+
+    void OcclusionCuller::createPipelines(vk::PipelineLayout pipelineLayout) {
+        vk::Device graphicsDevice = this->device->getGraphicsDevice();
+        uint32_t width = this->frame->getWidth();
+        uint32_t height = this->frame->getHeight();
+
+        // positions only, with the stride of full vertices
+        vk::VertexInputBindingDescription binding = Vertex::getBindingDescription();
+        vk::VertexInputAttributeDescription position = Vertex::getAttributeDescriptions()[0];
+        vk::PipelineVertexInputStateCreateInfo vertexInput({}, 1, &binding, 1, &position);
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly({}, vk::PrimitiveTopology::eTriangleList, VK_FALSE);
+        // same flipped viewport and culling as the main pass, so depths match
+        vk::Viewport viewport(0.0f, (float) height, (float) width, -(float) height, 0.0f, 1.0f);
+        vk::Rect2D scissor(vk::Offset2D(0, 0), vk::Extent2D(width, height));
+        vk::PipelineViewportStateCreateInfo viewportState({}, 1, &viewport, 1, &scissor);
+        vk::PipelineRasterizationStateCreateInfo rasterizer({}, VK_FALSE, VK_FALSE, vk::PolygonMode::eFill,
+                vk::CullModeFlagBits::eBack, vk::FrontFace::eCounterClockwise, VK_FALSE, 0.0f, 0.0f, 0.0f, 1.0f);
+        vk::PipelineMultisampleStateCreateInfo multisampling({}, vk::SampleCountFlagBits::e1);
+        vk::PipelineDepthStencilStateCreateInfo depthStencil({}, VK_TRUE, VK_TRUE, vk::CompareOp::eLess);
+        vk::PipelineColorBlendStateCreateInfo colorBlending({}, VK_FALSE, vk::LogicOp::eCopy, 0, nullptr);
+        vk::GraphicsPipelineCreateInfo pipelineInfo({}, 1, &this->occluderShader->getPipelineShaderStageCreateInfo(), &vertexInput, &inputAssembly,{},
+                &viewportState, &rasterizer, &multisampling, &depthStencil, &colorBlending,{}, pipelineLayout, this->renderPass, 0, vk::Pipeline(), -1);
+        this->occluderPipeline = graphicsDevice.createGraphicsPipelines(vk::PipelineCache(),{pipelineInfo})[0];
+
+        std::array<vk::DescriptorSetLayoutBinding, 2> pyramidBindings = {
+            vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageImage, 1, vk::ShaderStageFlagBits::eCompute)
+        };
+        this->pyramidLayout = graphicsDevice.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo({},
+                static_cast<uint32_t> (pyramidBindings.size()), pyramidBindings.data()));
+        this->pyramidPipelineLayout = graphicsDevice.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &this->pyramidLayout));
+        this->pyramidPipeline = graphicsDevice.createComputePipelines(vk::PipelineCache(),{
+            vk::ComputePipelineCreateInfo({}, this->pyramidShader->getPipelineShaderStageCreateInfo(), this->pyramidPipelineLayout)
+        })[0];
+
+        std::array<vk::DescriptorSetLayoutBinding, 5> cullBindings = {
+            vk::DescriptorSetLayoutBinding(0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(3, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute),
+            vk::DescriptorSetLayoutBinding(4, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eCompute)
+        };
+        this->cullLayout = graphicsDevice.createDescriptorSetLayout(vk::DescriptorSetLayoutCreateInfo({},
+                static_cast<uint32_t> (cullBindings.size()), cullBindings.data()));
+        vk::PushConstantRange pushConstantRange(vk::ShaderStageFlagBits::eCompute, 0, sizeof (CullParameters));
+        this->cullPipelineLayout = graphicsDevice.createPipelineLayout(vk::PipelineLayoutCreateInfo({}, 1, &this->cullLayout, 1, &pushConstantRange));
+        this->cullPipeline = graphicsDevice.createComputePipelines(vk::PipelineCache(),{
+            vk::ComputePipelineCreateInfo({}, this->cullShader->getPipelineShaderStageCreateInfo(), this->cullPipelineLayout)
+        })[0];
+    }
+
+    void OcclusionCuller::createBuffers() {
+        vk::Device graphicsDevice = this->device->getGraphicsDevice();
+        uint32_t imagesNumber = this->frame->getImagesNumber();
+        // buffers cannot be empty
+        uint32_t slots = std::max(this->drawsNumber, 1u);
+        vk::DeviceSize commandsSize = slots * sizeof (vk::DrawIndexedIndirectCommand);
+        vk::DeviceSize boundsSize = slots * 2 * sizeof (glm::vec4);
+        vk::MemoryPropertyFlags hostVisible = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+
+        this->commandsBuffers.resize(imagesNumber);
+        this->commandsMemory.resize(imagesNumber);
+        this->commandsData.resize(imagesNumber);
+        this->boundsBuffers.resize(imagesNumber);
+        this->boundsMemory.resize(imagesNumber);
+        this->boundsData.resize(imagesNumber);
+        this->statisticsBuffers.resize(imagesNumber);
+        this->statisticsMemory.resize(imagesNumber);
+        this->statisticsData.resize(imagesNumber);
+        for (uint32_t i = 0; i < imagesNumber; ++i) {
+            this->device->createBuffer(commandsSize, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer,
+                    hostVisible, this->commandsBuffers[i], this->commandsMemory[i]);
+            this->commandsData[i] = static_cast<vk::DrawIndexedIndirectCommand*> (graphicsDevice.mapMemory(this->commandsMemory[i], 0, commandsSize));
+            // slots the engine has not given to any model yet are culled with no instances
+            std::fill_n(this->commandsData[i], slots, vk::DrawIndexedIndirectCommand());
+            this->device->createBuffer(boundsSize, vk::BufferUsageFlagBits::eStorageBuffer, hostVisible, this->boundsBuffers[i], this->boundsMemory[i]);
+            this->boundsData[i] = static_cast<glm::vec4*> (graphicsDevice.mapMemory(this->boundsMemory[i], 0, boundsSize));
+            this->device->createBuffer(sizeof (uint32_t), vk::BufferUsageFlagBits::eStorageBuffer, hostVisible, this->statisticsBuffers[i], this->statisticsMemory[i]);
+            this->statisticsData[i] = static_cast<uint32_t*> (graphicsDevice.mapMemory(this->statisticsMemory[i], 0, sizeof (uint32_t)));
+            *this->statisticsData[i] = 0;
+        }
+
+        // nothing occludes the first frame
+        this->device->createBuffer(commandsSize, vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eIndirectBuffer | vk::BufferUsageFlagBits::eTransferDst,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, this->occludersBuffer, this->occludersMemory);
+        vk::CommandBuffer commandBuffer = this->device->beginSingleTimeCommands();
+        commandBuffer.fillBuffer(this->occludersBuffer, 0, VK_WHOLE_SIZE, 0);
+        this->device->endSingleTimeCommands(commandBuffer);
+
+        std::array<vk::DescriptorPoolSize, 3> poolSizes = {
+            vk::DescriptorPoolSize(vk::DescriptorType::eCombinedImageSampler, this->pyramidLevels + imagesNumber),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageImage, this->pyramidLevels),
+            vk::DescriptorPoolSize(vk::DescriptorType::eStorageBuffer, 4 * imagesNumber)
+        };
+        this->descriptorPool = graphicsDevice.createDescriptorPool(vk::DescriptorPoolCreateInfo({}, this->pyramidLevels + imagesNumber,
+                static_cast<uint32_t> (poolSizes.size()), poolSizes.data()));
+        std::vector<vk::DescriptorSetLayout> pyramidLayouts(this->pyramidLevels, this->pyramidLayout);
+        this->pyramidSets = graphicsDevice.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(this->descriptorPool, this->pyramidLevels, pyramidLayouts.data()));
+        std::vector<vk::DescriptorSetLayout> cullLayouts(imagesNumber, this->cullLayout);
+        this->cullSets = graphicsDevice.allocateDescriptorSets(vk::DescriptorSetAllocateInfo(this->descriptorPool, imagesNumber, cullLayouts.data()));
+
+        // each level reads the one above, level 0 reads the occluder depth
+        std::vector<vk::DescriptorImageInfo> sourceInfos(this->pyramidLevels);
+        std::vector<vk::DescriptorImageInfo> destinationInfos(this->pyramidLevels);
+        std::vector<vk::WriteDescriptorSet> writes;
+        for (uint32_t level = 0; level < this->pyramidLevels; ++level) {
+            sourceInfos[level] = level == 0
+                    ? vk::DescriptorImageInfo(this->sampler, this->depthImageView, vk::ImageLayout::eDepthStencilReadOnlyOptimal)
+                    : vk::DescriptorImageInfo(this->sampler, this->pyramidLevelViews[level - 1], vk::ImageLayout::eGeneral);
+            destinationInfos[level] = vk::DescriptorImageInfo(vk::Sampler(), this->pyramidLevelViews[level], vk::ImageLayout::eGeneral);
+            writes.push_back(vk::WriteDescriptorSet(this->pyramidSets[level], 0, 0, 1, vk::DescriptorType::eCombinedImageSampler, &sourceInfos[level],{},{}));
+            writes.push_back(vk::WriteDescriptorSet(this->pyramidSets[level], 1, 0, 1, vk::DescriptorType::eStorageImage, &destinationInfos[level],{},{}));
+        }
+
+        std::vector<std::array<vk::DescriptorBufferInfo, 4>> bufferInfos(imagesNumber);
+        vk::DescriptorImageInfo pyramidInfo(this->sampler, this->pyramidView, vk::ImageLayout::eGeneral);
+        for (uint32_t i = 0; i < imagesNumber; ++i) {
+            bufferInfos[i] = {
+                vk::DescriptorBufferInfo(this->commandsBuffers[i], 0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(this->boundsBuffers[i], 0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(this->occludersBuffer, 0, VK_WHOLE_SIZE),
+                vk::DescriptorBufferInfo(this->statisticsBuffers[i], 0, VK_WHOLE_SIZE)
+            };
+            writes.push_back(vk::WriteDescriptorSet(this->cullSets[i], 0, 0, 4, vk::DescriptorType::eStorageBuffer,{}, bufferInfos[i].data(),{}));
+            writes.push_back(vk::WriteDescriptorSet(this->cullSets[i], 4, 0, 1, vk::DescriptorType::eCombinedImageSampler, &pyramidInfo,{},{}));
+        }
+        graphicsDevice.updateDescriptorSets(writes,{});
+    }
+
+    uint32_t OcclusionCuller::getOccluded(uint32_t index) {
+        uint32_t occluded = *this->statisticsData[index];
+        *this->statisticsData[index] = 0;
+        return occluded;
+    }
+
+    void OcclusionCuller::beginOccluders(vk::CommandBuffer commandBuffer) {
+        // occluders were written by the culling of the previous frame
+        vk::BufferMemoryBarrier occludersBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eIndirectCommandRead,
+                VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, this->occludersBuffer, 0, VK_WHOLE_SIZE);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect,{},
+                0, nullptr, 1, &occludersBarrier, 0, nullptr);
+
+        vk::ClearValue clearValue(vk::ClearDepthStencilValue(1.0f, 0));
+        vk::RenderPassBeginInfo renderPassInfo(this->renderPass, this->framebuffer,
+                vk::Rect2D(vk::Offset2D(0, 0), vk::Extent2D(this->frame->getWidth(), this->frame->getHeight())), 1, &clearValue);
+        commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, this->occluderPipeline);
+    }
+
+    void OcclusionCuller::endOccluders(vk::CommandBuffer commandBuffer, uint32_t index, const glm::mat4& viewProj) {
+        commandBuffer.endRenderPass();
+
+        // the culling of the previous frame must be done sampling the pyramid before it is written
+        vk::MemoryBarrier pyramidBarrier(vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderWrite);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eComputeShader,{},
+                1, &pyramidBarrier, 0, nullptr, 0, nullptr);
+
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, this->pyramidPipeline);
+        vk::MemoryBarrier levelBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eShaderRead);
+        for (uint32_t level = 0; level < this->pyramidLevels; ++level) {
+            uint32_t width = std::max(this->pyramidWidth >> level, 1u);
+            uint32_t height = std::max(this->pyramidHeight >> level, 1u);
+            commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, this->pyramidPipelineLayout, 0, 1, &this->pyramidSets[level], 0, nullptr);
+            commandBuffer.dispatch((width + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, (height + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, 1);
+            // the next level reads this one, culling reads all of them and overwrites the occluders the depth pass has drawn
+            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader | vk::PipelineStageFlagBits::eDrawIndirect,
+                    vk::PipelineStageFlagBits::eComputeShader,{}, 1, &levelBarrier, 0, nullptr, 0, nullptr);
+        }
+
+        CullParameters parameters = {viewProj, glm::vec2(this->pyramidWidth, this->pyramidHeight), this->drawsNumber};
+        commandBuffer.bindPipeline(vk::PipelineBindPoint::eCompute, this->cullPipeline);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute, this->cullPipelineLayout, 0, 1, &this->cullSets[index], 0, nullptr);
+        commandBuffer.pushConstants(this->cullPipelineLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof (parameters), &parameters);
+        commandBuffer.dispatch((this->drawsNumber + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+        vk::MemoryBarrier commandsBarrier(vk::AccessFlagBits::eShaderWrite, vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eHostRead);
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader, vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eHost,{},
+                1, &commandsBarrier, 0, nullptr, 0, nullptr);
+    }
+}
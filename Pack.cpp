@@ -0,0 +1,204 @@
+/* 
+ * File:   Pack.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 19 października 2026, 01:10
+ */
+
+#include "Pack.h"
+#include "MappedFile.h"
+#include "AssetCache.h"
+#include "Lz4.h"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <thread>
+
+#define PACK_MAGIC "ZVLKPACK"
+#define PACK_VERSION 1
+// payloads start at page boundaries, so they can be mapped and used in place
+#define PACK_ALIGNMENT 4096
+
+namespace zvlk {
+
+    namespace {
+
+        uint64_t align(uint64_t value) {
+            return (value + PACK_ALIGNMENT - 1) / PACK_ALIGNMENT * PACK_ALIGNMENT;
+        }
+    }
+
+    Pack::Pack(const std::string& path) {
+        this->file = std::make_shared<MappedFile>(path);
+        const uint8_t* data = this->file->getData();
+        size_t size = this->file->getSize();
+        if (!Pack::isPack(data, size)) {
+            throw std::runtime_error(path + " is not a pack");
+        }
+
+        PackHeader header;
+        std::memcpy(&header, data, sizeof (header));
+        if (header.version != PACK_VERSION) {
+            throw std::runtime_error(path + " has an unsupported pack version");
+        }
+        if (sizeof (PackHeader) + static_cast<uint64_t> (header.entriesNumber) * sizeof (PackEntry) > size
+                || header.namesOffset > size || header.namesSize > size - header.namesOffset) {
+            throw std::runtime_error(path + " has a damaged pack index");
+        }
+        this->entries = reinterpret_cast<const PackEntry*> (data + sizeof (PackHeader));
+        this->entriesNumber = header.entriesNumber;
+        this->names = reinterpret_cast<const char*> (data + header.namesOffset);
+
+        for (uint32_t i = 0; i < this->entriesNumber; ++i) {
+            const PackEntry& entry = this->entries[i];
+            if (entry.offset > size || entry.size > size - entry.offset
+                    || static_cast<uint64_t> (entry.nameOffset) + entry.nameLength > header.namesSize) {
+                throw std::runtime_error(path + " has a damaged pack entry");
+            }
+        }
+    }
+
+    Pack::~Pack() {
+    }
+
+    bool Pack::isPack(const uint8_t* content, size_t size) {
+        return size >= sizeof (PackHeader) && std::memcmp(content, PACK_MAGIC, 8) == 0;
+    }
+
+    const PackEntry* Pack::find(const std::string& name) const {
+        uint64_t hash = AssetCache::hash(name.data(), name.size());
+        const PackEntry* end = this->entries + this->entriesNumber;
+        const PackEntry* entry = std::lower_bound(this->entries, end, hash, [](const PackEntry& candidate, uint64_t hash) {
+            return candidate.hash < hash;
+        });
+        for (; entry != end && entry->hash == hash; ++entry) {
+            if (entry->nameLength == name.size() && std::memcmp(this->names + entry->nameOffset, name.data(), name.size()) == 0) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    bool Pack::exists(const std::string& name) {
+        return this->find(name) != nullptr;
+    }
+
+    Blob Pack::read(const std::string& name) {
+        const PackEntry* entry = this->find(name);
+        if (!entry) {
+            return Blob();
+        }
+        const uint8_t* payload = this->file->getData() + entry->offset;
+        switch (entry->compression) {
+            case PackCompression::eNone:
+                return Blob(this->file, entry->offset, entry->size);
+            case PackCompression::eLz4:
+            {
+                std::vector<uint8_t> content(entry->originalSize);
+                Lz4::decompress(payload, entry->size, content.data(), content.size());
+                return Blob(std::move(content));
+            }
+            default:
+                throw std::runtime_error("unknown compression of " + name + " in pack");
+        }
+    }
+
+    std::vector<std::string> Pack::list() {
+        std::vector<std::string> result;
+        for (uint32_t i = 0; i < this->entriesNumber; ++i) {
+            result.push_back(std::string(this->names + this->entries[i].nameOffset, this->entries[i].nameLength));
+        }
+        return result;
+    }
+
+    PackWriter::PackWriter() {
+    }
+
+    PackWriter::~PackWriter() {
+    }
+
+    void PackWriter::add(const std::string& name, Blob content, PackCompression compression) {
+        this->inputs.push_back({name, content, compression});
+    }
+
+    void PackWriter::write(const std::string& path) const {
+        // every worker takes every n-th input, results land at the index of their input
+        std::vector<std::vector<uint8_t>> compressed(this->inputs.size());
+        size_t workers = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::future<void>> tasks;
+        for (size_t worker = 0; worker < workers; ++worker) {
+            tasks.push_back(std::async(std::launch::async, [this, &compressed, worker, workers]() {
+                for (size_t i = worker; i < this->inputs.size(); i += workers) {
+                    if (this->inputs[i].compression == PackCompression::eLz4) {
+                        compressed[i] = Lz4::compress(this->inputs[i].content.getData(), this->inputs[i].content.getSize());
+                    }
+                }
+            }));
+        }
+        for (std::future<void>& task : tasks) {
+            task.get();
+        }
+
+        std::vector<PackEntry> entries(this->inputs.size());
+        std::string names;
+        for (size_t i = 0; i < this->inputs.size(); ++i) {
+            const Input& input = this->inputs[i];
+            PackEntry& entry = entries[i];
+            entry.hash = AssetCache::hash(input.name.data(), input.name.size());
+            entry.nameOffset = static_cast<uint32_t> (names.size());
+            entry.nameLength = static_cast<uint32_t> (input.name.size());
+            entry.originalSize = input.content.getSize();
+            // incompressible entries are stored as they are
+            bool smaller = input.compression == PackCompression::eLz4 && compressed[i].size() < input.content.getSize();
+            entry.compression = smaller ? PackCompression::eLz4 : PackCompression::eNone;
+            entry.size = smaller ? compressed[i].size() : input.content.getSize();
+            entry.reserved = 0;
+            names += input.name;
+        }
+
+        std::vector<size_t> order(entries.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return entries[a].hash != entries[b].hash ? entries[a].hash < entries[b].hash : this->inputs[a].name < this->inputs[b].name;
+        });
+
+        PackHeader header;
+        std::memcpy(header.magic, PACK_MAGIC, 8);
+        header.version = PACK_VERSION;
+        header.entriesNumber = static_cast<uint32_t> (entries.size());
+        header.namesOffset = sizeof (PackHeader) + entries.size() * sizeof (PackEntry);
+        header.namesSize = names.size();
+
+        uint64_t offset = align(header.namesOffset + header.namesSize);
+        std::vector<PackEntry> index;
+        for (size_t i : order) {
+            entries[i].offset = offset;
+            offset = align(offset + entries[i].size);
+            index.push_back(entries[i]);
+        }
+
+        std::ofstream output(path, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!output.is_open()) {
+            throw std::runtime_error("failed to open " + path + " for writing");
+        }
+        output.write(reinterpret_cast<const char*> (&header), sizeof (header));
+        output.write(reinterpret_cast<const char*> (index.data()), index.size() * sizeof (PackEntry));
+        output.write(names.data(), names.size());
+        std::vector<char> padding(PACK_ALIGNMENT, 0);
+        uint64_t written = header.namesOffset + header.namesSize;
+        for (size_t i : order) {
+            output.write(padding.data(), entries[i].offset - written);
+            const uint8_t* payload = entries[i].compression == PackCompression::eLz4 ? compressed[i].data() : this->inputs[i].content.getData();
+            output.write(reinterpret_cast<const char*> (payload), entries[i].size);
+            written = entries[i].offset + entries[i].size;
+        }
+        if (!output) {
+            throw std::runtime_error("failed to write " + path);
+        }
+    }
+}
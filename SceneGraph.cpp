@@ -0,0 +1,253 @@
+/* 
+ * File:   SceneGraph.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 18 października 2026, 19:40
+ */
+
+#include "SceneGraph.h"
+#include "BatchMath.h"
+
+#include <stdexcept>
+#include <future>
+#include <thread>
+
+// below this number of dirty nodes spawning workers costs more than it saves
+#define PARALLEL_UPDATE_THRESHOLD 4096
+
+namespace zvlk {
+
+    SceneGraph::SceneGraph() {
+        this->orderChanged = false;
+        this->dirtyCount = 0;
+    }
+
+    SceneGraph::~SceneGraph() {
+    }
+
+    SceneNode SceneGraph::addNode(SceneNode parent) {
+        this->checkParent(parent);
+
+        SceneNode node;
+        if (this->freeNodes.empty()) {
+            node = static_cast<SceneNode> (this->indices.size());
+            this->indices.push_back(0);
+            this->parentNodes.push_back(NO_SCENE_NODE);
+        } else {
+            node = this->freeNodes.back();
+            this->freeNodes.pop_back();
+        }
+
+        uint32_t index = static_cast<uint32_t> (this->parents.size());
+        this->indices[node] = index;
+        this->parentNodes[node] = parent;
+        this->parents.push_back(parent == NO_SCENE_NODE ? NO_SCENE_NODE : this->indices[parent]);
+        this->subtreeSizes.push_back(1);
+        this->locals.push_back(glm::mat4(1.0f));
+        this->worlds.push_back(glm::mat4(1.0f));
+        this->normals.push_back(glm::mat4(1.0f));
+        this->dirty.push_back(1);
+        this->nodes.push_back(node);
+        this->dirtyCount++;
+
+        // a child appended at the end breaks contiguity of its ancestors' subtrees
+        if (parent != NO_SCENE_NODE) {
+            this->orderChanged = true;
+        }
+        return node;
+    }
+
+    void SceneGraph::checkParent(SceneNode parent) const {
+        // a removed node has no slot until the next update, nor after it
+        if (parent != NO_SCENE_NODE && (parent >= this->indices.size() || this->indices[parent] == UINT32_MAX)) {
+            throw std::invalid_argument("parent scene node does not exist");
+        }
+    }
+
+    void SceneGraph::removeNode(SceneNode node) {
+        uint32_t index = this->indices[node];
+        SceneNode parent = this->parentNodes[node];
+
+        for (SceneNode child = 0; child < this->parentNodes.size(); ++child) {
+            if (this->parentNodes[child] == node && this->indices[child] != UINT32_MAX) {
+                this->parentNodes[child] = parent;
+                this->dirty[this->indices[child]] = 1;
+                this->dirtyCount++;
+            }
+        }
+
+        this->nodes[index] = NO_SCENE_NODE;
+        this->indices[node] = UINT32_MAX;
+        this->parentNodes[node] = NO_SCENE_NODE;
+        this->freeNodes.push_back(node);
+        this->orderChanged = true;
+    }
+
+    void SceneGraph::setParent(SceneNode node, SceneNode parent) {
+        this->checkParent(parent);
+        for (SceneNode ancestor = parent; ancestor != NO_SCENE_NODE; ancestor = this->parentNodes[ancestor]) {
+            if (ancestor == node) {
+                throw std::invalid_argument("scene node cannot become its own descendant");
+            }
+        }
+
+        this->parentNodes[node] = parent;
+        this->dirty[this->indices[node]] = 1;
+        this->dirtyCount++;
+        this->orderChanged = true;
+    }
+
+    void SceneGraph::setLocal(SceneNode node, const glm::mat4& local) {
+        uint32_t index = this->indices[node];
+        this->locals[index] = local;
+        this->dirty[index] = 1;
+        this->dirtyCount++;
+    }
+
+    const glm::mat4& SceneGraph::getLocal(SceneNode node) const {
+        return this->locals[this->indices[node]];
+    }
+
+    const glm::mat4& SceneGraph::getWorld(SceneNode node) const {
+        return this->worlds[this->indices[node]];
+    }
+
+    const glm::mat4& SceneGraph::getNormal(SceneNode node) const {
+        return this->normals[this->indices[node]];
+    }
+
+    void SceneGraph::sort() {
+        std::vector<std::vector<SceneNode>> children(this->indices.size());
+        std::vector<SceneNode> roots;
+
+        // walking the current order keeps siblings in their relative order
+        for (SceneNode node : this->nodes) {
+            if (node == NO_SCENE_NODE) {
+                continue;
+            }
+            SceneNode parent = this->parentNodes[node];
+            if (parent == NO_SCENE_NODE) {
+                roots.push_back(node);
+            } else {
+                children[parent].push_back(node);
+            }
+        }
+
+        size_t count = this->indices.size() - this->freeNodes.size();
+        std::vector<uint32_t> parents;
+        std::vector<glm::mat4> locals, worlds, normals;
+        std::vector<uint8_t> dirty;
+        std::vector<SceneNode> nodes;
+        std::vector<uint32_t> newIndices(this->indices.size(), UINT32_MAX);
+        parents.reserve(count);
+        locals.reserve(count);
+        worlds.reserve(count);
+        normals.reserve(count);
+        dirty.reserve(count);
+        nodes.reserve(count);
+
+        std::vector<SceneNode> stack;
+        for (SceneNode root : roots) {
+            stack.push_back(root);
+            while (!stack.empty()) {
+                SceneNode node = stack.back();
+                stack.pop_back();
+
+                uint32_t oldIndex = this->indices[node];
+                SceneNode parent = this->parentNodes[node];
+                newIndices[node] = static_cast<uint32_t> (nodes.size());
+                parents.push_back(parent == NO_SCENE_NODE ? NO_SCENE_NODE : newIndices[parent]);
+                locals.push_back(this->locals[oldIndex]);
+                worlds.push_back(this->worlds[oldIndex]);
+                normals.push_back(this->normals[oldIndex]);
+                dirty.push_back(this->dirty[oldIndex]);
+                nodes.push_back(node);
+
+                for (auto child = children[node].rbegin(); child != children[node].rend(); ++child) {
+                    stack.push_back(*child);
+                }
+            }
+        }
+
+        std::vector<uint32_t> subtreeSizes(nodes.size(), 1);
+        for (size_t i = nodes.size(); i-- > 0;) {
+            if (parents[i] != NO_SCENE_NODE) {
+                subtreeSizes[parents[i]] += subtreeSizes[i];
+            }
+        }
+
+        this->parents.swap(parents);
+        this->subtreeSizes.swap(subtreeSizes);
+        this->locals.swap(locals);
+        this->worlds.swap(worlds);
+        this->normals.swap(normals);
+        this->dirty.swap(dirty);
+        this->nodes.swap(nodes);
+        this->indices.swap(newIndices);
+        this->orderChanged = false;
+    }
+
+    void SceneGraph::updateRange(uint32_t begin, uint32_t end) {
+        uint32_t runBegin = end;
+        for (uint32_t i = begin; i < end; ++i) {
+            uint32_t parent = this->parents[i];
+            if (parent != NO_SCENE_NODE && this->dirty[parent]) {
+                this->dirty[i] = 1;
+            }
+            if (!this->dirty[i]) {
+                // normal matrices are computed in batches over runs of dirty nodes
+                if (runBegin < i) {
+                    BatchMath::normalMatrices(&this->worlds[runBegin], &this->normals[runBegin], i - runBegin);
+                }
+                runBegin = end;
+                continue;
+            }
+
+            if (parent == NO_SCENE_NODE) {
+                this->worlds[i] = this->locals[i];
+            } else {
+                this->worlds[i] = this->worlds[parent] * this->locals[i];
+            }
+            if (runBegin == end) {
+                runBegin = i;
+            }
+        }
+        if (runBegin < end) {
+            BatchMath::normalMatrices(&this->worlds[runBegin], &this->normals[runBegin], end - runBegin);
+        }
+    }
+
+    void SceneGraph::update() {
+        if (this->orderChanged) {
+            this->sort();
+        }
+        if (this->dirtyCount == 0) {
+            return;
+        }
+
+        uint32_t count = this->getNodesNumber();
+        uint32_t workers = std::thread::hardware_concurrency();
+        if (workers <= 1 || this->dirtyCount < PARALLEL_UPDATE_THRESHOLD) {
+            this->updateRange(0, count);
+        } else {
+            // root subtrees are independent, so they are split between workers at root boundaries
+            uint32_t chunk = (count + workers - 1) / workers;
+            std::vector<std::future<void>> tasks;
+            uint32_t begin = 0;
+            while (begin < count) {
+                uint32_t end = begin;
+                while (end < count && end - begin < chunk) {
+                    end += this->subtreeSizes[end];
+                }
+                tasks.push_back(std::async(std::launch::async, &SceneGraph::updateRange, this, begin, end));
+                begin = end;
+            }
+            for (std::future<void>& task : tasks) {
+                task.get();
+            }
+        }
+
+        std::fill(this->dirty.begin(), this->dirty.end(), 0);
+        this->dirtyCount = 0;
+    }
+}
@@ -7,30 +7,18 @@
 
 #include "Shader.h"
 
-#include <iostream>
-#include <vector>
-#include <fstream>
+#include <stdexcept>
 
 namespace zvlk {
 
-    Shader::Shader(vk::Device device, const char* name, vk::ShaderStageFlagBits stage) {
+    Shader::Shader(vk::Device device, const Blob& code, vk::ShaderStageFlagBits stage) {
         this->device = device;
 
-        std::ifstream file(name, std::ios::ate | std::ios::binary);
-
-        if (!file.is_open()) {
-            throw std::runtime_error("failed to open file!");
+        if (code.isEmpty() || code.getSize() % sizeof (uint32_t) != 0) {
+            throw std::runtime_error("shader code is not SPIR-V!");
         }
 
-        size_t fileSize = (size_t) file.tellg();
-        std::vector<char> buffer(fileSize);
-
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-
-        file.close();
-
-        this->shaderModule = this->device.createShaderModule(vk::ShaderModuleCreateInfo({}, buffer.size(), reinterpret_cast<const uint32_t*> (buffer.data())));
+        this->shaderModule = this->device.createShaderModule(vk::ShaderModuleCreateInfo({}, code.getSize(), reinterpret_cast<const uint32_t*> (code.getData())));
         this->shaderStageInfo = vk::PipelineShaderStageCreateInfo({}, stage, this->shaderModule, "main");
     }
 
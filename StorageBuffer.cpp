@@ -0,0 +1,79 @@
+/* 
+ * File:   StorageBuffer.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 18 października 2026, 22:10
+ */
+
+#include "StorageBuffer.h"
+
+namespace zvlk {
+
+    StorageBuffer::StorageBuffer(zvlk::Device* device, vk::DeviceSize capacity, std::shared_ptr<zvlk::Frame> frame) {
+        this->device = device;
+        this->initialCapacity = capacity;
+        this->create(frame);
+    }
+
+    StorageBuffer::~StorageBuffer() {
+        this->destroy();
+    }
+
+    void StorageBuffer::create(std::shared_ptr<zvlk::Frame> frame) {
+        this->capacities.resize(frame->getImagesNumber(), this->initialCapacity);
+        this->buffers.resize(frame->getImagesNumber());
+        this->buffersMemory.resize(frame->getImagesNumber());
+
+        for (size_t i = 0; i < frame->getImagesNumber(); i++) {
+            this->device->createBuffer(this->capacities[i], vk::BufferUsageFlagBits::eStorageBuffer,
+                    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                    this->buffers[i], this->buffersMemory[i]);
+        }
+    }
+
+    void StorageBuffer::destroy() {
+        for (size_t i = 0; i < this->buffers.size(); i++) {
+            this->device->freeMemory(this->buffers[i], this->buffersMemory[i]);
+        }
+        this->buffers.clear();
+        this->buffersMemory.clear();
+        this->capacities.clear();
+    }
+
+    void StorageBuffer::resize(std::shared_ptr<zvlk::Frame> frame) {
+        if (this->buffers.size() == frame->getImagesNumber()) {
+            return;
+        }
+        for (size_t i = 0; i < this->buffers.size(); i++) {
+            this->device->destroyLater(this->buffers[i]);
+            this->device->destroyLater(this->buffersMemory[i]);
+        }
+        this->buffers.clear();
+        this->buffersMemory.clear();
+        this->capacities.clear();
+        this->create(frame);
+    }
+
+    bool StorageBuffer::write(uint32_t index, const void* content, vk::DeviceSize size) {
+        bool reallocated = false;
+        if (size > this->capacities[index]) {
+            while (this->capacities[index] < size) {
+                this->capacities[index] *= 2;
+            }
+            this->device->freeMemory(this->buffers[index], this->buffersMemory[index]);
+            this->device->createBuffer(this->capacities[index], vk::BufferUsageFlagBits::eStorageBuffer,
+                    vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+                    this->buffers[index], this->buffersMemory[index]);
+            reallocated = true;
+        }
+
+        if (size > 0) {
+            this->device->copyMemory(size, const_cast<void*> (content), this->buffersMemory[index]);
+        }
+        return reallocated;
+    }
+
+    vk::DescriptorBufferInfo StorageBuffer::getDescriptorBufferInfo(uint32_t index) {
+        return vk::DescriptorBufferInfo(this->buffers[index], 0, VK_WHOLE_SIZE);
+    }
+}
@@ -7,128 +7,419 @@
 
 #include "Texture.h"
 #include "Device.h"
+#include "AssetCache.h"
+#include "TextureStreamer.h"
+#include "MipmapGenerator.h"
+#include "Ktx2.h"
+#include "MipChain.h"
+#include "BlockCompressor.h"
+#include "FileSystem.h"
+
 #include <stdexcept>
+#include <filesystem>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// levels up to this size are resident as soon as a streamed texture is created
+#define STREAMING_RESIDENT_SIZE 64
+
 namespace zvlk {
 
+    namespace {
+
+        struct CookedFormat {
+            const char* extension;
+            vk::Format format;
+        };
+
+        // in order of preference, best quality first
+        const CookedFormat COOKED_FORMATS[] = {
+            {".bc7.ktx2", vk::Format::eBc7SrgbBlock},
+            {".etc2.ktx2", vk::Format::eEtc2R8G8B8SrgbBlock},
+            {".bc1.ktx2", vk::Format::eBc1RgbSrgbBlock}
+        };
+
+        std::string cookedPath(const std::string& texturePath, const char* extension) {
+            return std::filesystem::path(texturePath).replace_extension("").string() + extension;
+        }
+
+        vk::Format channelsFormat(uint32_t channels) {
+            switch (channels) {
+                case 1:
+                    return vk::Format::eR8Srgb;
+                case 2:
+                    return vk::Format::eR8G8Srgb;
+                default:
+                    return vk::Format::eR8G8B8A8Srgb;
+            }
+        }
+
+        // grey is replicated to the colour channels and alpha of images without it is opaque
+        vk::ComponentMapping channelsSwizzle(uint32_t channels) {
+            switch (channels) {
+                case 1:
+                    return vk::ComponentMapping(vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eOne);
+                case 2:
+                    return vk::ComponentMapping(vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eG);
+                default:
+                    return vk::ComponentMapping();
+            }
+        }
+
+        // one and two channel sRGB formats are optional, RGBA stands in for them
+        uint32_t supportedChannels(Device* device, uint32_t channels) {
+            const vk::FormatFeatureFlags features = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+            if (channels < 4 && (device->getFormatProperties(channelsFormat(channels)).optimalTilingFeatures & features) != features) {
+                return 4;
+            }
+            return channels;
+        }
+
+        // the fewest channels holding the pixels: grey, grey with alpha or RGBA
+        uint32_t countChannels(const uint8_t* pixels, size_t count, uint32_t channels) {
+            bool grey = true, opaque = true;
+            for (size_t i = 0; i < count && (grey || opaque); ++i) {
+                const uint8_t* pixel = pixels + i * channels;
+                if (channels >= 3) {
+                    grey = grey && pixel[0] == pixel[1] && pixel[1] == pixel[2];
+                }
+                if (channels == 2 || channels == 4) {
+                    opaque = opaque && pixel[channels - 1] == 255;
+                }
+            }
+            return grey ? (opaque ? 1 : 2) : 4;
+        }
+
+        std::vector<uint8_t> packChannels(const uint8_t* pixels, size_t count, uint32_t channels, uint32_t packedChannels) {
+            std::vector<uint8_t> packed(count * packedChannels);
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t* pixel = pixels + i * channels;
+                uint8_t* target = &packed[i * packedChannels];
+                uint8_t alpha = channels == 2 || channels == 4 ? pixel[channels - 1] : 255;
+                target[0] = pixel[0];
+                if (packedChannels == 2) {
+                    target[1] = alpha;
+                } else if (packedChannels == 4) {
+                    target[1] = channels < 3 ? pixel[0] : pixel[1];
+                    target[2] = channels < 3 ? pixel[0] : pixel[2];
+                    target[3] = alpha;
+                }
+            }
+            return packed;
+        }
+    }
+
     Texture::Texture(Device* device, std::string texturePath) {
+        this->streamer = nullptr;
+        std::string cooked = Texture::findCooked(device, texturePath);
+        Blob content = device->getFileSystem()->read(cooked.empty() ? texturePath : cooked);
+        this->loadContent(device, content.getData(), content.getSize());
+    }
+
+    Texture::Texture(Device* device, const unsigned char* content, size_t size) {
+        this->streamer = nullptr;
+        this->loadContent(device, content, size);
+    }
+
+    Texture::Texture(Device* device, std::vector<unsigned char> content, TextureStreamer* streamer) {
+        this->deviceObject = device;
         this->device = device->getGraphicsDevice();
+        this->streamer = streamer;
+        this->version = 0;
+
+        std::vector<std::vector<uint8_t>> tail;
+        if (Ktx2::isKtx2(content.data(), content.size())) {
+            Ktx2 ktx(content.data(), content.size());
+            this->format = ktx.getFormat();
+            this->channels = 4;
+            this->width = ktx.getWidth();
+            this->height = ktx.getHeight();
+            this->mipLevels = ktx.getLevelsNumber();
+            for (uint32_t i = 0; i < this->mipLevels; ++i) {
+                if (std::max(this->width >> i, this->height >> i) <= STREAMING_RESIDENT_SIZE) {
+                    tail.push_back(ktx.getLevel(i));
+                }
+            }
+        } else {
+            int texWidth, texHeight, texChannels;
+            if (!stbi_info_from_memory(content.data(), static_cast<int> (content.size()), &texWidth, &texHeight, &texChannels)) {
+                throw std::runtime_error("failed to load texture image!");
+            }
+            // only the header is read here, so just the channels of the file are known and not its content
+            this->channels = supportedChannels(device, texChannels < 3 ? static_cast<uint32_t> (texChannels) : 4);
+            this->format = channelsFormat(this->channels);
+            this->width = static_cast<uint32_t> (texWidth);
+            this->height = static_cast<uint32_t> (texHeight);
+            this->mipLevels = static_cast<uint32_t> (std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
+            // decoding takes the whole image, so a neutral texel stands in until a worker is done
+            std::vector<uint8_t> placeholder = {128, 128, 128, 255};
+            tail.push_back(packChannels(placeholder.data(), 1, 4, this->channels));
+        }
+        if (tail.empty()) {
+            throw std::runtime_error("streamed texture has no small mip levels");
+        }
+        this->residentLevel = this->mipLevels - static_cast<uint32_t> (tail.size());
+
+        std::vector<vk::BufferImageCopy> regions;
+        std::vector<uint8_t> staged;
+        for (uint32_t i = this->residentLevel; i < this->mipLevels; ++i) {
+            regions.push_back(vk::BufferImageCopy(staged.size(), 0, 0,
+                    vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, i, 0, 1), vk::Offset3D(0, 0, 0),
+                    vk::Extent3D(std::max(this->width >> i, 1u), std::max(this->height >> i, 1u), 1)));
+            const std::vector<uint8_t>& level = tail[i - this->residentLevel];
+            staged.insert(staged.end(), level.begin(), level.end());
+            // keeps offsets a multiple of the texel block size
+            staged.resize((staged.size() + 15) / 16 * 16);
+        }
+
+        vk::Buffer stagingBuffer;
+        vk::DeviceMemory stagingBufferMemory;
+        device->copyMemory(staged.size(), staged.data(), stagingBuffer, stagingBufferMemory);
+
+        // memory of the whole chain is allocated up front, only its content streams
+        device->createImage(this->width, this->height, this->mipLevels,
+                vk::SampleCountFlagBits::e1, this->format, vk::ImageTiling::eOptimal,
+                vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, this->image, this->imageMemory);
+        this->size = this->device.getImageMemoryRequirements(this->image).size;
+
+        // every level is left readable by shaders, those not resident yet are excluded by the sampler
+        vk::CommandBuffer commandBuffer = device->beginSingleTimeCommands();
+        vk::ImageMemoryBarrier barrier({}, vk::AccessFlagBits::eTransferWrite,
+                vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, this->image,
+                vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, this->mipLevels, 0, 1));
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,{}, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        commandBuffer.copyBufferToImage(stagingBuffer, this->image, vk::ImageLayout::eTransferDstOptimal,
+                static_cast<uint32_t> (regions.size()), regions.data());
+
+        barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+        barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,{}, 0, nullptr, 0, nullptr, 1, &barrier);
+        device->endSingleTimeCommands(commandBuffer);
+
+        device->freeMemory(stagingBuffer, stagingBufferMemory);
+
+        this->imageView = device->createImageView(this->image, this->format, vk::ImageAspectFlagBits::eColor, this->mipLevels,
+                channelsSwizzle(this->channels));
+        this->updateSampler();
+
+        streamer->add(this, std::move(content));
+    }
+
+    void Texture::loadContent(Device* device, const unsigned char* content, size_t size) {
+        if (Ktx2::isKtx2(content, size)) {
+            Ktx2 ktx(content, size);
+            this->channels = 4;
+            this->loadLevels(device, ktx.getFormat(), ktx.getWidth(), ktx.getHeight(), ktx.getLevels());
+            return;
+        }
 
         int texWidth, texHeight, texChannels;
-        stbi_uc* pixels = stbi_load(texturePath.data(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+        stbi_uc* pixels = stbi_load_from_memory(content, static_cast<int> (size), &texWidth, &texHeight, &texChannels, 0);
 
         if (!pixels) {
             throw std::runtime_error("failed to load texture image!");
         }
 
-        vk::DeviceSize imageSize = texWidth * texHeight * 4;
-        vk::Buffer stagingBuffer;
-        vk::DeviceMemory stagingBufferMemory;
-        device->copyMemory(imageSize, pixels, stagingBuffer, stagingBufferMemory);
+        this->load(device, pixels, texWidth, texHeight, texChannels);
+    }
 
+    void Texture::load(Device* device, unsigned char* pixels, int texWidth, int texHeight, int texChannels) {
+        this->deviceObject = device;
+        this->device = device->getGraphicsDevice();
+        this->width = static_cast<uint32_t> (texWidth);
+        this->height = static_cast<uint32_t> (texHeight);
+        this->residentLevel = 0;
+        this->version = 0;
+
+        // grey images and opaque alpha are common, they are stored with fewer channels and swizzled back
+        size_t count = static_cast<size_t> (texWidth) * texHeight;
+        this->channels = supportedChannels(device, countChannels(pixels, count, static_cast<uint32_t> (texChannels)));
+        this->format = channelsFormat(this->channels);
+        std::vector<uint8_t> packed = packChannels(pixels, count, static_cast<uint32_t> (texChannels), this->channels);
         stbi_image_free(pixels);
 
+        // sRGB formats are rarely storage capable, so the compute shader writes levels through a UNORM alias
+        MipmapGenerator* generator = device->getMipmapGenerator();
+        std::string unsupported = this->channels == 4 ? generator->getUnsupportedReason(vk::Format::eR8G8B8A8Unorm, this->width, this->height)
+                : std::to_string(this->channels) + " channel images are not RGBA";
+        bool compute = unsupported.empty();
+        if (!compute) {
+            std::cout << "Texture " << this->width << "x" << this->height << " not mipmapped by the compute shader: " << unsupported << std::endl;
+        }
+        const vk::FormatFeatureFlags blitFeatures = vk::FormatFeatureFlagBits::eBlitSrc | vk::FormatFeatureFlagBits::eBlitDst
+                | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+        if (!compute && (device->getFormatProperties(this->format).optimalTilingFeatures & blitFeatures) != blitFeatures) {
+            // neither storage nor linear blitting, the chain is filtered on the host and uploaded whole
+            MipChain mipChain(packed.data(), this->width, this->height, this->channels, MipFilter::eBox, true);
+            this->loadLevels(device, this->format, this->width, this->height, mipChain.getLevels(), channelsSwizzle(this->channels));
+            return;
+        }
+
+        vk::Buffer stagingBuffer;
+        vk::DeviceMemory stagingBufferMemory;
+        device->copyMemory(packed.size(), packed.data(), stagingBuffer, stagingBufferMemory);
+
         this->mipLevels = static_cast<uint32_t> (std::floor(std::log2(std::max(texWidth, texHeight)))) + 1;
 
+        vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+        usage |= compute ? vk::ImageUsageFlagBits::eStorage : vk::ImageUsageFlagBits::eTransferSrc;
+
         device->createImage(texWidth, texHeight, this->mipLevels,
-                vk::SampleCountFlagBits::e1, vk::Format::eR8G8B8A8Srgb, vk::ImageTiling::eOptimal,
-                vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferSrc,
-                vk::MemoryPropertyFlagBits::eDeviceLocal, this->image, this->imageMemory);
+                vk::SampleCountFlagBits::e1, compute ? vk::Format::eR8G8B8A8Unorm : this->format, vk::ImageTiling::eOptimal,
+                usage, vk::MemoryPropertyFlagBits::eDeviceLocal, this->image, this->imageMemory,
+                compute ? vk::ImageCreateFlagBits::eMutableFormat : vk::ImageCreateFlags());
+        this->size = this->device.getImageMemoryRequirements(this->image).size;
 
-        device->transitionImageLayout(this->image, vk::Format::eR8G8B8A8Srgb,
+        device->transitionImageLayout(this->image, this->format,
                 vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, this->mipLevels);
         device->copyBufferToImage(stagingBuffer, this->image, static_cast<uint32_t> (texWidth), static_cast<uint32_t> (texHeight));
 
         device->freeMemory(stagingBuffer, stagingBufferMemory);
 
-        if (!(device->getFormatProperties(vk::Format::eR8G8B8A8Srgb).optimalTilingFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
-            throw std::runtime_error("texture image format does not support linear blitting!");
+        if (compute) {
+            generator->generate({
+                {this->image, vk::Format::eR8G8B8A8Unorm, this->width, this->height, this->mipLevels}
+            });
+        } else {
+            generator->blit({
+                {this->image, this->format, this->width, this->height, this->mipLevels}
+            });
         }
 
-        vk::CommandBuffer commandBuffer = device->beginSingleTimeCommands();
+        this->imageView = device->createImageView(this->image, this->format,
+                vk::ImageAspectFlagBits::eColor, this->mipLevels, channelsSwizzle(this->channels));
+        this->updateSampler();
+    }
 
-        vk::ImageMemoryBarrier barrier({},
-        {
-        },
-        {
-        },
-        {
-        }, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image,
-                vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor,{}, 1, 0, 1));
-
-        int32_t mipWidth = texWidth;
-        int32_t mipHeight = texHeight;
-
-        for (uint32_t i = 1; i < mipLevels; i++) {
-            barrier.subresourceRange.baseMipLevel = i - 1;
-            barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-            barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
-            barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
-            barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
-
-            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                    vk::PipelineStageFlagBits::eTransfer,{},
-            0, nullptr,
-            0, nullptr,
-            1, &barrier);
-
-            vk::ImageBlit blit(vk::ImageSubresourceLayers(
-                    vk::ImageAspectFlagBits::eColor, i - 1, 0, 1),{
-                vk::Offset3D(0, 0, 0), vk::Offset3D(mipWidth, mipHeight, 1)
-            },
-            vk::ImageSubresourceLayers(
-                    vk::ImageAspectFlagBits::eColor, i, 0, 1), {
-                vk::Offset3D(0, 0, 0), vk::Offset3D(mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1)
-            });
+    void Texture::loadLevels(Device* device, vk::Format format, uint32_t width, uint32_t height,
+            const std::vector<std::vector<uint8_t>>& levels, vk::ComponentMapping components) {
+        this->deviceObject = device;
+        this->device = device->getGraphicsDevice();
+        this->format = format;
+        this->mipLevels = static_cast<uint32_t> (levels.size());
+        this->width = width;
+        this->height = height;
+        this->residentLevel = 0;
+        this->version = 0;
+
+        // every level goes into one staging buffer and one copy, no blits are needed
+        std::vector<vk::BufferImageCopy> regions;
+        std::vector<uint8_t> content;
+        for (uint32_t i = 0; i < this->mipLevels; ++i) {
+            regions.push_back(vk::BufferImageCopy(content.size(), 0, 0,
+                    vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, i, 0, 1), vk::Offset3D(0, 0, 0),
+                    vk::Extent3D(std::max(width >> i, 1u), std::max(height >> i, 1u), 1)));
+            content.insert(content.end(), levels[i].begin(), levels[i].end());
+            // keeps offsets a multiple of four and of the texel block size, small levels of single channel images are not
+            content.resize((content.size() + 15) / 16 * 16);
+        }
 
-            commandBuffer.blitImage(image, vk::ImageLayout::eTransferSrcOptimal, image, vk::ImageLayout::eTransferDstOptimal, 1, &blit, vk::Filter::eLinear);
+        vk::Buffer stagingBuffer;
+        vk::DeviceMemory stagingBufferMemory;
+        device->copyMemory(content.size(), content.data(), stagingBuffer, stagingBufferMemory);
 
-            barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
-            barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-            barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
-            barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+        device->createImage(width, height, this->mipLevels,
+                vk::SampleCountFlagBits::e1, format, vk::ImageTiling::eOptimal,
+                vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled,
+                vk::MemoryPropertyFlagBits::eDeviceLocal, this->image, this->imageMemory);
+        this->size = this->device.getImageMemoryRequirements(this->image).size;
 
-            commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
-                    vk::PipelineStageFlagBits::eFragmentShader,{},
-            0, nullptr, 0, nullptr, 1, &barrier);
+        vk::CommandBuffer commandBuffer = device->beginSingleTimeCommands();
+        vk::ImageMemoryBarrier barrier({}, vk::AccessFlagBits::eTransferWrite,
+                vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, this->image,
+                vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, this->mipLevels, 0, 1));
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,{}, 0, nullptr, 0, nullptr, 1, &barrier);
 
-            if (mipWidth > 1) mipWidth /= 2;
-            if (mipHeight > 1) mipHeight /= 2;
-        }
+        commandBuffer.copyBufferToImage(stagingBuffer, this->image, vk::ImageLayout::eTransferDstOptimal,
+                static_cast<uint32_t> (regions.size()), regions.data());
 
-        barrier.subresourceRange.baseMipLevel = mipLevels - 1;
-        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
-        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
         barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
         barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+        barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,{}, 0, nullptr, 0, nullptr, 1, &barrier);
+        device->endSingleTimeCommands(commandBuffer);
 
-        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,{},
-        0, nullptr,
-        0, nullptr,
-        1, &barrier);
+        device->freeMemory(stagingBuffer, stagingBufferMemory);
 
+        this->imageView = device->createImageView(this->image, format, vk::ImageAspectFlagBits::eColor, this->mipLevels, components);
 
-        device->endSingleTimeCommands(commandBuffer);
+        this->updateSampler();
+    }
+
+    std::string Texture::findCooked(Device* device, const std::string& texturePath) {
+        const vk::FormatFeatureFlags features = vk::FormatFeatureFlagBits::eSampledImage | vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+        for (const CookedFormat& cooked : COOKED_FORMATS) {
+            std::string path = cookedPath(texturePath, cooked.extension);
+            if ((device->getFormatProperties(cooked.format).optimalTilingFeatures & features) == features
+                    && device->getFileSystem()->exists(path)) {
+                return path;
+            }
+        }
+        return std::string();
+    }
 
-        this->imageView = device->createImageView(this->image, vk::Format::eR8G8B8A8Srgb,
-                vk::ImageAspectFlagBits::eColor, this->mipLevels);
+    void Texture::cook(const std::string& texturePath) {
+        int texWidth, texHeight, texChannels;
+        stbi_uc* pixels = stbi_load(texturePath.data(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
 
+        if (!pixels) {
+            throw std::runtime_error("failed to load texture image!");
+        }
+
+        // cooked once offline, so the sharper and slower kernel is affordable
+        MipChain mipChain(pixels, static_cast<uint32_t> (texWidth), static_cast<uint32_t> (texHeight), 4, MipFilter::eKaiser, true);
+        stbi_image_free(pixels);
+
+        for (const CookedFormat& cooked : COOKED_FORMATS) {
+            Ktx2 ktx(cooked.format, mipChain.getWidth(0), mipChain.getHeight(0));
+            for (uint32_t i = 0; i < mipChain.getLevelsNumber(); ++i) {
+                const uint8_t* level = mipChain.getLevel(i).data();
+                uint32_t width = mipChain.getWidth(i), height = mipChain.getHeight(i);
+                switch (cooked.format) {
+                    case vk::Format::eBc7SrgbBlock:
+                        ktx.addLevel(BlockCompressor::compressBc7(level, width, height));
+                        break;
+                    case vk::Format::eEtc2R8G8B8SrgbBlock:
+                        ktx.addLevel(BlockCompressor::compressEtc2(level, width, height));
+                        break;
+                    default:
+                        ktx.addLevel(BlockCompressor::compressBc1(level, width, height));
+                        break;
+                }
+            }
+            ktx.write(cookedPath(texturePath, cooked.extension));
+        }
+    }
+
+    void Texture::updateSampler() {
+        // levels below the minimal LOD are never sampled, so they may still be streaming
         vk::SamplerCreateInfo samplerInfo({}, vk::Filter::eLinear, vk::Filter::eLinear, vk::SamplerMipmapMode::eLinear,
                 vk::SamplerAddressMode::eRepeat, vk::SamplerAddressMode::eRepeat, vk::SamplerAddressMode::eRepeat,
                 0.0f, VK_TRUE, 16.0f, VK_FALSE, vk::CompareOp::eAlways,
-                0.0f, static_cast<float> (mipLevels), vk::BorderColor::eIntOpaqueBlack, VK_FALSE);
+                static_cast<float> (this->residentLevel), static_cast<float> (this->mipLevels), vk::BorderColor::eIntOpaqueBlack, VK_FALSE);
+        this->sampler = this->deviceObject->getAssetCache()->getSampler(samplerInfo);
+    }
 
-        this->sampler = this->device.createSampler(samplerInfo);
+    void Texture::setResidentLevel(uint32_t level) {
+        this->residentLevel = level;
+        this->updateSampler();
+        this->version++;
     }
 
     Texture::~Texture() {
-        this->device.destroy(this->sampler);
-        this->device.destroy(this->imageView);
-        this->device.destroy(this->image);
-        this->device.free(this->imageMemory);
+        if (this->streamer) {
+            this->streamer->remove(this);
+        }
+        // materials of frames in flight may still sample it
+        this->deviceObject->destroyLater(this->imageView);
+        this->deviceObject->destroyLater(this->image);
+        this->deviceObject->destroyLater(this->imageMemory);
     }
 
     vk::DescriptorImageInfo Texture::getDescriptorImageInfo(uint32_t index) {
@@ -0,0 +1,306 @@
+/* 
+ * File:   TextureStreamer.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ * 
+ * Created on 18 października 2026, 23:40
+ */
+
+#include "TextureStreamer.h"
+#include "Device.h"
+#include "Texture.h"
+#include "Ktx2.h"
+#include "MipChain.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#define MAX_STREAMING_WORKERS 4
+#define DEFAULT_STREAMING_BUDGET (4 * 1024 * 1024)
+// buffer offsets of copies have to be a multiple of the texel block size
+#define STAGING_ALIGNMENT 16
+
+namespace zvlk {
+
+    TextureStreamer::TextureStreamer(zvlk::Device* device) {
+        this->device = device;
+        this->budget = DEFAULT_STREAMING_BUDGET;
+        this->stopping = false;
+
+        uint32_t cores = std::thread::hardware_concurrency();
+        uint32_t count = cores > 2 ? std::min(cores - 1, static_cast<uint32_t> (MAX_STREAMING_WORKERS)) : 1;
+        for (uint32_t i = 0; i < count; ++i) {
+            this->workers.push_back(std::thread(&TextureStreamer::work, this));
+        }
+    }
+
+    TextureStreamer::~TextureStreamer() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->stopping = true;
+        }
+        this->condition.notify_all();
+        for (std::thread& worker : this->workers) {
+            worker.join();
+        }
+        this->retire(true);
+    }
+
+    void TextureStreamer::add(Texture* texture, std::vector<unsigned char> content) {
+        std::shared_ptr<StreamedTexture> streamed = std::make_shared<StreamedTexture>();
+        streamed->texture = texture;
+        streamed->content = std::move(content);
+        streamed->channels = texture->getChannels();
+        streamed->levelsNumber = texture->getLevelsNumber();
+        // the resident tail of an image which has to be decoded first is a placeholder, so it is uploaded again
+        bool placeholder = !Ktx2::isKtx2(streamed->content.data(), streamed->content.size());
+        streamed->uploadedLevel = placeholder ? texture->getLevelsNumber() : texture->getResidentLevel();
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->textures[texture] = streamed;
+            this->queue.push_back(streamed);
+        }
+        this->condition.notify_one();
+    }
+
+    void TextureStreamer::remove(Texture* texture) {
+        auto found = this->textures.find(texture);
+        if (found == this->textures.end()) {
+            return;
+        }
+        if (found->second->uploadedLevel < texture->getResidentLevel()) {
+            // levels of the texture are still being copied
+            this->retire(true);
+        }
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        found->second->removed = true;
+        this->textures.erase(found);
+    }
+
+    void TextureStreamer::request(Texture* texture, float pixels) {
+        auto found = this->textures.find(texture);
+        if (found != this->textures.end()) {
+            found->second->requestedPixels = std::max(found->second->requestedPixels, pixels);
+        }
+    }
+
+    uint32_t TextureStreamer::getWantedLevel(const StreamedTexture& streamed) const {
+        uint32_t levels = streamed.texture->getLevelsNumber();
+        if (streamed.requestedPixels <= 0.0f) {
+            // not seen during the frame, nothing more is needed
+            return levels;
+        }
+        float size = static_cast<float> (std::max(streamed.texture->getWidth(), streamed.texture->getHeight()));
+        if (streamed.requestedPixels >= size) {
+            return 0;
+        }
+        uint32_t level = static_cast<uint32_t> (std::floor(std::log2(size / streamed.requestedPixels)));
+        return std::min(level, levels - 1);
+    }
+
+    void TextureStreamer::update() {
+        this->retire(false);
+
+        std::vector<StreamedTexture*> candidates;
+        uint32_t pending = 0;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            for (auto& entry : this->textures) {
+                StreamedTexture& streamed = *entry.second;
+                uint32_t wanted = this->getWantedLevel(streamed);
+                if (wanted < streamed.texture->getResidentLevel()) {
+                    pending++;
+                }
+                if (streamed.decoded && wanted < streamed.uploadedLevel) {
+                    candidates.push_back(&streamed);
+                }
+            }
+        }
+        this->statistics.texturesPending = pending;
+
+        // textures largest on screen go first
+        std::sort(candidates.begin(), candidates.end(), [](const StreamedTexture* a, const StreamedTexture * b) {
+            return a->requestedPixels > b->requestedPixels;
+        });
+
+        struct PlannedLevel {
+            StreamedTexture* streamed;
+            uint32_t level;
+            vk::DeviceSize offset;
+        };
+        std::vector<PlannedLevel> planned;
+        vk::DeviceSize total = 0;
+        bool full = false;
+        for (StreamedTexture* streamed : candidates) {
+            uint32_t wanted = this->getWantedLevel(*streamed);
+            // smaller levels first, so residency always covers a contiguous tail of the chain
+            while (!full && streamed->uploadedLevel > wanted) {
+                uint32_t level = streamed->uploadedLevel - 1;
+                vk::DeviceSize size = streamed->levels[level].size();
+                // a level larger than the whole budget still goes, alone
+                if (total > 0 && total + size > this->budget) {
+                    full = true;
+                    break;
+                }
+                planned.push_back({streamed, level, total});
+                total = (total + size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+                streamed->uploadedLevel = level;
+            }
+        }
+        for (auto& entry : this->textures) {
+            entry.second->requestedPixels = 0.0f;
+        }
+        if (planned.empty()) {
+            return;
+        }
+
+        vk::Device graphicsDevice = this->device->getGraphicsDevice();
+        Upload upload;
+        this->device->createStagingBuffer(total, upload.stagingBuffer, upload.stagingBufferMemory);
+        uint8_t* data = static_cast<uint8_t*> (graphicsDevice.mapMemory(upload.stagingBufferMemory, 0, total));
+        for (const PlannedLevel& level : planned) {
+            const std::vector<uint8_t>& content = level.streamed->levels[level.level];
+            memcpy(data + level.offset, content.data(), content.size());
+            this->statistics.bytesUploaded += content.size();
+        }
+        graphicsDevice.unmapMemory(upload.stagingBufferMemory);
+
+        std::vector<vk::ImageMemoryBarrier> toTransfer;
+        std::vector<vk::ImageMemoryBarrier> toShader;
+        vk::PipelineStageFlags sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
+        for (const PlannedLevel& level : planned) {
+            vk::ImageMemoryBarrier barrier({}, vk::AccessFlagBits::eTransferWrite,
+                    vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+                    level.streamed->texture->getImage(), vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, level.level, 1, 0, 1));
+            // a level below the minimal LOD is not sampled, so its content can be discarded,
+            // a placeholder still is by frames in flight
+            if (level.level >= level.streamed->texture->getResidentLevel()) {
+                barrier.srcAccessMask = vk::AccessFlagBits::eShaderRead;
+                barrier.oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+                sourceStage |= vk::PipelineStageFlagBits::eFragmentShader;
+            }
+            toTransfer.push_back(barrier);
+            barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+            barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+            barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+            barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+            toShader.push_back(barrier);
+            upload.levels.push_back({level.streamed->texture, level.level});
+        }
+
+        std::vector<vk::CommandBuffer> commandBuffers;
+        this->device->allocateCommandBuffers(1, commandBuffers);
+        upload.commandBuffer = commandBuffers[0];
+        upload.commandBuffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        upload.commandBuffer.pipelineBarrier(sourceStage, vk::PipelineStageFlagBits::eTransfer,{}, 0, nullptr, 0, nullptr,
+                static_cast<uint32_t> (toTransfer.size()), toTransfer.data());
+        for (const PlannedLevel& level : planned) {
+            Texture* texture = level.streamed->texture;
+            vk::BufferImageCopy region(level.offset, 0, 0,
+                    vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, level.level, 0, 1), vk::Offset3D(0, 0, 0),
+                    vk::Extent3D(std::max(texture->getWidth() >> level.level, 1u), std::max(texture->getHeight() >> level.level, 1u), 1));
+            upload.commandBuffer.copyBufferToImage(upload.stagingBuffer, texture->getImage(), vk::ImageLayout::eTransferDstOptimal, 1, &region);
+        }
+        upload.commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,{}, 0, nullptr, 0, nullptr,
+                static_cast<uint32_t> (toShader.size()), toShader.data());
+        upload.commandBuffer.end();
+
+        // submitted ahead of the frame on the same queue, the fence only tells when the staging memory is free
+        upload.fence = graphicsDevice.createFence(vk::FenceCreateInfo());
+        vk::SubmitInfo submitInfo(0, nullptr, nullptr, 1, &upload.commandBuffer, 0, nullptr);
+        this->device->submitGraphics(&submitInfo, upload.fence);
+        this->uploads.push_back(upload);
+    }
+
+    void TextureStreamer::retire(bool wait) {
+        vk::Device graphicsDevice = this->device->getGraphicsDevice();
+        while (!this->uploads.empty()) {
+            Upload& upload = this->uploads.front();
+            if (wait) {
+                graphicsDevice.waitForFences(1, &upload.fence, VK_TRUE, UINT64_MAX);
+            } else if (graphicsDevice.getFenceStatus(upload.fence) != vk::Result::eSuccess) {
+                // later uploads are not retired before earlier ones, so residency stays contiguous
+                break;
+            }
+
+            for (auto& level : upload.levels) {
+                Texture* texture = level.first;
+                if (level.second < texture->getResidentLevel()) {
+                    texture->setResidentLevel(level.second);
+                }
+                auto found = this->textures.find(texture);
+                if (found != this->textures.end()) {
+                    std::vector<uint8_t>().swap(found->second->levels[level.second]);
+                }
+                this->statistics.levelsUploaded++;
+            }
+
+            std::vector<vk::CommandBuffer> commandBuffers = {upload.commandBuffer};
+            this->device->freeCommandBuffers(commandBuffers);
+            graphicsDevice.destroy(upload.fence);
+            this->device->freeMemory(upload.stagingBuffer, upload.stagingBufferMemory);
+            this->uploads.pop_front();
+        }
+    }
+
+    void TextureStreamer::work() {
+        while (true) {
+            std::shared_ptr<StreamedTexture> streamed;
+            {
+                std::unique_lock<std::mutex> lock(this->mutex);
+                this->condition.wait(lock, [this]() {
+                    return this->stopping || !this->queue.empty();
+                });
+                if (this->stopping) {
+                    return;
+                }
+                streamed = this->queue.front();
+                this->queue.pop_front();
+                if (streamed->removed) {
+                    continue;
+                }
+            }
+
+            std::vector<std::vector<uint8_t>> levels;
+            try {
+                levels = TextureStreamer::decode(streamed->content, streamed->channels);
+            } catch (const std::exception& e) {
+                std::cerr << "failed to decode streamed texture: " << e.what() << std::endl;
+            }
+            if (levels.size() != streamed->levelsNumber) {
+                // the texture keeps its resident tail
+                levels.clear();
+            }
+
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (streamed->removed) {
+                continue;
+            }
+            streamed->levels = std::move(levels);
+            std::vector<unsigned char>().swap(streamed->content);
+            streamed->decoded = !streamed->levels.empty();
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> TextureStreamer::decode(const std::vector<unsigned char>& content, uint32_t channels) {
+        if (Ktx2::isKtx2(content.data(), content.size())) {
+            Ktx2 ktx(content.data(), content.size());
+            return ktx.getLevels();
+        }
+
+        int texWidth, texHeight, texChannels;
+        stbi_uc* pixels = stbi_load_from_memory(content.data(), static_cast<int> (content.size()), &texWidth, &texHeight, &texChannels, static_cast<int> (channels));
+        if (!pixels) {
+            throw std::runtime_error("failed to load texture image!");
+        }
+        MipChain mipChain(pixels, static_cast<uint32_t> (texWidth), static_cast<uint32_t> (texHeight), channels, MipFilter::eBox, true);
+        stbi_image_free(pixels);
+
+        return mipChain.getLevels();
+    }
+}
@@ -6,38 +6,73 @@
  */
 
 #include "TransformationMatrices.h"
+#include "BatchMath.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace zvlk {
 
     TransformationMatrices::~TransformationMatrices() {
+        if (this->sceneGraph) {
+            this->sceneGraph->removeNode(this->sceneNode);
+        }
     }
 
     TransformationMatrices::TransformationMatrices(zvlk::Device* device, std::shared_ptr<zvlk::Frame> frame) : UniformBuffer(device, sizeof (TransformationMatricesUBO), frame) {
         this->ubos.resize(frame->getImagesNumber());
         this->current = glm::mat4(1.0f);
+        this->currentNormal = glm::mat4(1.0f);
+        this->sceneGraph = nullptr;
+        this->sceneNode = NO_SCENE_NODE;
+    }
+
+    TransformationMatrices::TransformationMatrices(zvlk::Device* device, std::shared_ptr<zvlk::Frame> frame,
+            zvlk::SceneGraph* sceneGraph, zvlk::TransformationMatrices* parent) : TransformationMatrices(device, frame) {
+        this->sceneGraph = sceneGraph;
+        this->sceneNode = sceneGraph->addNode(parent ? parent->getSceneNode() : NO_SCENE_NODE);
     }
 
     void* TransformationMatrices::update(uint32_t index, float time) {
-        this->ubos[index].model = glm::mat4(this->current);
+        if (this->sceneGraph) {
+            this->ubos[index].model = this->sceneGraph->getWorld(this->sceneNode);
+            this->ubos[index].normal = this->sceneGraph->getNormal(this->sceneNode);
+        } else {
+            this->ubos[index].model = this->current;
+            this->ubos[index].normal = this->currentNormal;
+        }
         return &this->ubos[index];
     }
 
+    void TransformationMatrices::resize(uint32_t imagesNumber) {
+        this->ubos.resize(imagesNumber);
+    }
+
+    const glm::mat4& TransformationMatrices::getModelMatrix() const {
+        return this->sceneGraph ? this->sceneGraph->getWorld(this->sceneNode) : this->current;
+    }
+
+    void TransformationMatrices::apply(const glm::mat4& transformation) {
+        if (this->sceneGraph) {
+            this->sceneGraph->setLocal(this->sceneNode, transformation * this->sceneGraph->getLocal(this->sceneNode));
+        } else {
+            this->current = transformation * this->current;
+            BatchMath::normalMatrices(&this->current, &this->currentNormal, 1);
+        }
+    }
+
     TransformationMatrices& TransformationMatrices::rotate(float angleDegrees, glm::vec3 direction) {
-        this->current = glm::rotate(glm::mat4(1.0f), glm::radians(angleDegrees), direction) * this->current;
+        this->apply(glm::rotate(glm::mat4(1.0f), glm::radians(angleDegrees), direction));
         return *this;
     }
 
     TransformationMatrices& TransformationMatrices::translate(glm::vec3 vector) {
-        this->current = glm::translate(glm::mat4(1.0f), vector) * this->current;
+        this->apply(glm::translate(glm::mat4(1.0f), vector));
         return *this;
     }
 
     TransformationMatrices& TransformationMatrices::scale(glm::vec3 vector) {
-        this->current = glm::scale(glm::mat4(1.0f), vector)* this->current;
+        this->apply(glm::scale(glm::mat4(1.0f), vector));
         return *this;
     }
 
 }
-
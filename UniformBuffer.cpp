@@ -40,6 +40,25 @@ namespace zvlk {
         }
     }
 
+    void UniformBuffer::resize(std::shared_ptr<zvlk::Frame> frame) {
+        uint32_t imagesNumber = frame->getImagesNumber();
+        if (this->uniformBuffers.size() == imagesNumber) {
+            return;
+        }
+        for (size_t i = 0; i < uniformBuffers.size(); i++) {
+            this->device->destroyLater(uniformBuffers[i]);
+            this->device->destroyLater(uniformBuffersMemory[i]);
+        }
+        uniformBuffers.clear();
+        uniformBuffersMemory.clear();
+
+        this->create(frame);
+        this->resize(imagesNumber);
+        for (uint32_t i = 0; i < imagesNumber; i++) {
+            this->update(i);
+        }
+    }
+
     void UniformBuffer::update(uint32_t index) {
         static auto startTime = std::chrono::high_resolution_clock::now();
 
@@ -17,6 +17,9 @@ namespace zvlk {
 
         this->window = glfwCreateWindow(width, height, title.data(), nullptr, nullptr);
         this->callback = callback;
+        this->windowedWidth = width;
+        this->windowedHeight = height;
+        glfwGetWindowPos(this->window, &this->windowedX, &this->windowedY);
 
         glfwSetWindowUserPointer(window, this);
         glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
@@ -32,12 +35,16 @@ namespace zvlk {
     void Window::toggleFullscreen() {
         GLFWmonitor *currentMonitor = glfwGetWindowMonitor(this->window);
         if (currentMonitor) {
-            std::tuple<int,int> size = this->getSize();
-            const GLFWvidmode* mode = glfwGetVideoMode(currentMonitor);
-            glfwSetWindowMonitor(this->window, nullptr, 0, 0, std::get<0>(size), std::get<1>(size), mode->refreshRate);
+            // back where the window was, rendering goes on with the swapchain recreated from the fullscreen one
+            glfwSetWindowMonitor(this->window, nullptr, this->windowedX, this->windowedY,
+                    this->windowedWidth, this->windowedHeight, GLFW_DONT_CARE);
         } else {
+            glfwGetWindowPos(this->window, &this->windowedX, &this->windowedY);
+            glfwGetWindowSize(this->window, &this->windowedWidth, &this->windowedHeight);
+
             int monitorCount;
             GLFWmonitor** monitors = glfwGetMonitors(&monitorCount);
+            // in the current mode of the monitor, so the display does not switch modes
             const GLFWvidmode* mode = glfwGetVideoMode(monitors[0]);
 
             glfwWindowHint(GLFW_RED_BITS, mode->redBits);
@@ -62,9 +69,10 @@ namespace zvlk {
 
     void Window::waitResize() {
         int width = 0, height = 0;
+        glfwGetFramebufferSize(this->window, &width, &height);
         while (width == 0 || height == 0) {
-            glfwGetFramebufferSize(this->window, &width, &height);
             glfwWaitEvents();
+            glfwGetFramebufferSize(this->window, &width, &height);
         }
     }
 
@@ -6,6 +6,5 @@
 # Created on 2020-02-11, 21:30:05
 #
 
-/home/michal/glslc/install/bin/glslc shader.vert -o vert.spv
-/home/michal/glslc/install/bin/glslc shader.frag -o frag.spv
-
+# the rules live in the Makefile, GLSLC may name a compiler other than glslc from the PATH
+cd "$(dirname "$0")" && exec make -f Makefile shaders
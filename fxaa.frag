@@ -0,0 +1,134 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// fast approximate anti-aliasing: edges are found from luminance contrast, followed along
+// their direction to their ends and the pixel is resampled across the edge by how close it is to one
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D scene;
+
+// contrast below which a pixel is not on an edge, absolute and relative to the brightest neighbour
+#define EDGE_THRESHOLD_MIN 0.0312
+#define EDGE_THRESHOLD_MAX 0.125
+#define SUBPIXEL_QUALITY 0.75
+#define ITERATIONS 12
+
+float luma(vec3 color) {
+    // perceptual, the scene image holds linear values
+    return sqrt(dot(color, vec3(0.299, 0.587, 0.114)));
+}
+
+float lumaAt(vec2 uv) {
+    return luma(texture(scene, uv).rgb);
+}
+
+void main() {
+    vec2 inverseSize = 1.0 / vec2(textureSize(scene, 0));
+    vec2 uv = gl_FragCoord.xy * inverseSize;
+
+    vec3 colorCenter = texture(scene, uv).rgb;
+    float lumaCenter = luma(colorCenter);
+    float lumaDown = luma(textureOffset(scene, uv, ivec2(0, -1)).rgb);
+    float lumaUp = luma(textureOffset(scene, uv, ivec2(0, 1)).rgb);
+    float lumaLeft = luma(textureOffset(scene, uv, ivec2(-1, 0)).rgb);
+    float lumaRight = luma(textureOffset(scene, uv, ivec2(1, 0)).rgb);
+
+    float lumaMin = min(lumaCenter, min(min(lumaDown, lumaUp), min(lumaLeft, lumaRight)));
+    float lumaMax = max(lumaCenter, max(max(lumaDown, lumaUp), max(lumaLeft, lumaRight)));
+    float lumaRange = lumaMax - lumaMin;
+    if (lumaRange < max(EDGE_THRESHOLD_MIN, lumaMax * EDGE_THRESHOLD_MAX)) {
+        outColor = vec4(colorCenter, 1.0);
+        return;
+    }
+
+    float lumaDownLeft = luma(textureOffset(scene, uv, ivec2(-1, -1)).rgb);
+    float lumaUpRight = luma(textureOffset(scene, uv, ivec2(1, 1)).rgb);
+    float lumaUpLeft = luma(textureOffset(scene, uv, ivec2(-1, 1)).rgb);
+    float lumaDownRight = luma(textureOffset(scene, uv, ivec2(1, -1)).rgb);
+
+    float lumaDownUp = lumaDown + lumaUp;
+    float lumaLeftRight = lumaLeft + lumaRight;
+    float lumaLeftCorners = lumaDownLeft + lumaUpLeft;
+    float lumaDownCorners = lumaDownLeft + lumaDownRight;
+    float lumaRightCorners = lumaDownRight + lumaUpRight;
+    float lumaUpCorners = lumaUpRight + lumaUpLeft;
+
+    // direction of the edge from second differences across rows and columns
+    float edgeHorizontal = abs(-2.0 * lumaLeft + lumaLeftCorners) + abs(-2.0 * lumaCenter + lumaDownUp) * 2.0
+            + abs(-2.0 * lumaRight + lumaRightCorners);
+    float edgeVertical = abs(-2.0 * lumaUp + lumaUpCorners) + abs(-2.0 * lumaCenter + lumaLeftRight) * 2.0
+            + abs(-2.0 * lumaDown + lumaDownCorners);
+    bool isHorizontal = edgeHorizontal >= edgeVertical;
+
+    // side of the pixel the edge lies on
+    float luma1 = isHorizontal ? lumaDown : lumaLeft;
+    float luma2 = isHorizontal ? lumaUp : lumaRight;
+    float gradient1 = luma1 - lumaCenter;
+    float gradient2 = luma2 - lumaCenter;
+    bool is1Steepest = abs(gradient1) >= abs(gradient2);
+    float gradientScaled = 0.25 * max(abs(gradient1), abs(gradient2));
+
+    float stepLength = isHorizontal ? inverseSize.y : inverseSize.x;
+    float lumaLocalAverage;
+    if (is1Steepest) {
+        stepLength = -stepLength;
+        lumaLocalAverage = 0.5 * (luma1 + lumaCenter);
+    } else {
+        lumaLocalAverage = 0.5 * (luma2 + lumaCenter);
+    }
+
+    vec2 edgeUv = uv;
+    if (isHorizontal) {
+        edgeUv.y += stepLength * 0.5;
+    } else {
+        edgeUv.x += stepLength * 0.5;
+    }
+
+    // both ends of the edge, with steps growing away from the pixel
+    vec2 offset = isHorizontal ? vec2(inverseSize.x, 0.0) : vec2(0.0, inverseSize.y);
+    vec2 uv1 = edgeUv - offset;
+    vec2 uv2 = edgeUv + offset;
+    float lumaEnd1 = lumaAt(uv1) - lumaLocalAverage;
+    float lumaEnd2 = lumaAt(uv2) - lumaLocalAverage;
+    bool reached1 = abs(lumaEnd1) >= gradientScaled;
+    bool reached2 = abs(lumaEnd2) >= gradientScaled;
+    for (int i = 1; i < ITERATIONS && !(reached1 && reached2); ++i) {
+        float quality = i < 5 ? 1.0 : (i < 9 ? 2.0 : 4.0);
+        if (!reached1) {
+            uv1 -= offset * quality;
+            lumaEnd1 = lumaAt(uv1) - lumaLocalAverage;
+            reached1 = abs(lumaEnd1) >= gradientScaled;
+        }
+        if (!reached2) {
+            uv2 += offset * quality;
+            lumaEnd2 = lumaAt(uv2) - lumaLocalAverage;
+            reached2 = abs(lumaEnd2) >= gradientScaled;
+        }
+    }
+
+    float distance1 = isHorizontal ? uv.x - uv1.x : uv.y - uv1.y;
+    float distance2 = isHorizontal ? uv2.x - uv.x : uv2.y - uv.y;
+    bool isDirection1 = distance1 < distance2;
+    float distanceFinal = min(distance1, distance2);
+    float edgeThickness = distance1 + distance2;
+
+    // only when the nearer end varies the other way than the pixel does it belong to the edge
+    bool isLumaCenterSmaller = lumaCenter < lumaLocalAverage;
+    bool correctVariation = ((isDirection1 ? lumaEnd1 : lumaEnd2) < 0.0) != isLumaCenterSmaller;
+    float finalOffset = correctVariation ? 0.5 - distanceFinal / edgeThickness : 0.0;
+
+    // thin features shorter than a pixel are blended by the contrast with the neighbourhood
+    float lumaAverage = (1.0 / 12.0) * (2.0 * (lumaDownUp + lumaLeftRight) + lumaLeftCorners + lumaRightCorners);
+    float subPixelOffset1 = clamp(abs(lumaAverage - lumaCenter) / lumaRange, 0.0, 1.0);
+    float subPixelOffset2 = (-2.0 * subPixelOffset1 + 3.0) * subPixelOffset1 * subPixelOffset1;
+    finalOffset = max(finalOffset, subPixelOffset2 * subPixelOffset2 * SUBPIXEL_QUALITY);
+
+    vec2 finalUv = uv;
+    if (isHorizontal) {
+        finalUv.y += finalOffset * stepLength;
+    } else {
+        finalUv.x += finalOffset * stepLength;
+    }
+    outColor = vec4(texture(scene, finalUv).rgb, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in vec3 inNormal;
+
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec4 outNormal;
+layout(location = 2) out vec4 outSpecular;
+layout(location = 3) out vec4 outAmbient;
+
+layout(set = 2, binding = 0) uniform sampler2D texSampler;
+layout(set = 2, binding = 1) uniform MaterialUbo {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    float shiness;
+} materialUbo;
+
+void main() {
+    outAlbedo = vec4(materialUbo.diffuse.rgb * texture(texSampler, inTexCoord).rgb, 1.0);
+    outNormal = vec4(normalize(inNormal), materialUbo.shiness);
+    outSpecular = vec4(materialUbo.specular.rgb, 1.0);
+    outAmbient = vec4(materialUbo.ambient.rgb, 1.0);
+}
@@ -0,0 +1,78 @@
+/* 
+ * File:   AssetCache.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 18 października 2026, 22:55
+ */
+
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <vulkan/vulkan.hpp>
+
+#include <glm/vec4.hpp>
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    class Device;
+    class Frame;
+    class Texture;
+    class Material;
+
+    struct AssetCacheStatistics {
+        uint64_t texturesLoaded = 0;
+        uint64_t textureHits = 0;
+        uint64_t materialsCreated = 0;
+        uint64_t materialHits = 0;
+        uint64_t samplersCreated = 0;
+        uint64_t samplerHits = 0;
+        // device memory which would have been allocated again without the cache
+        uint64_t bytesSaved = 0;
+    };
+
+    /*
+     * Shares textures, materials and samplers between models. Textures are keyed by
+     * normalized path and by content hash, so copies of a file under other names are
+     * loaded once too. Textures and materials are released with their last user,
+     * samplers live as long as the device.
+     */
+    class AssetCache {
+    public:
+        AssetCache() = delete;
+        AssetCache(const AssetCache& orig) = delete;
+        AssetCache(zvlk::Device* device);
+        virtual ~AssetCache();
+
+        std::shared_ptr<zvlk::Texture> getTexture(const std::string& path);
+        std::shared_ptr<zvlk::Material> getMaterial(std::shared_ptr<zvlk::Frame> frame, const std::string& name,
+                glm::vec4 ambient, glm::vec4 diffuse, glm::vec4 specular, float shiness, const std::string& diffuseTextureName);
+        vk::Sampler getSampler(const vk::SamplerCreateInfo& samplerInfo);
+
+        // size, format and device memory of every live texture, with the total
+        void reportMemory(std::ostream& output) const;
+
+        inline const AssetCacheStatistics& getStatistics() const {
+            return this->statistics;
+        }
+
+        static uint64_t hash(const void* content, size_t size);
+    private:
+        zvlk::Device* device;
+        std::unordered_map<std::string, std::weak_ptr<zvlk::Texture>> texturesByPath;
+        // by content hash, with the size of the content, which has to match too
+        std::unordered_map<uint64_t, std::pair<size_t, std::weak_ptr<zvlk::Texture>>> texturesByContent;
+        std::unordered_map<std::string, std::weak_ptr<zvlk::Material>> materials;
+        // few distinct samplers exist, a linear search over them is enough
+        std::vector<std::pair<vk::SamplerCreateInfo, vk::Sampler>> samplers;
+        AssetCacheStatistics statistics;
+    };
+}
+#endif /* ASSETCACHE_H */
+
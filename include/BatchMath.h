@@ -0,0 +1,73 @@
+/* 
+ * File:   BatchMath.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 18 października 2026, 21:05
+ */
+
+#ifndef BATCHMATH_H
+#define BATCHMATH_H
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace zvlk {
+
+    struct Bounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    struct BoundsSoA {
+        std::vector<float> minX, minY, minZ;
+        std::vector<float> maxX, maxY, maxZ;
+
+        void resize(size_t size) {
+            for (std::vector<float>* component : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ}) {
+                component->resize(size);
+            }
+        }
+
+        size_t size() const {
+            return minX.size();
+        }
+    };
+
+    enum class BatchMathIsa {
+        eScalar, eSse, eAvx2
+    };
+
+    /*
+     * Kernels working on arrays of objects. The instruction set is detected once at
+     * startup (AVX2, SSE or plain scalar code) and can be forced for comparisons.
+     */
+    class BatchMath {
+    public:
+        BatchMath() = delete;
+
+        static BatchMathIsa getIsa();
+        static void setIsa(BatchMathIsa isa);
+
+        // result[i] = a[i] * b[i], result may be a or b
+        static void multiply(const glm::mat4* a, const glm::mat4* b, glm::mat4* result, size_t count);
+        // result[i] = a * b[i]
+        static void multiply(const glm::mat4& a, const glm::mat4* b, glm::mat4* result, size_t count);
+        // inverse transpose of the upper 3x3, stored in a mat4 with the remaining elements of identity
+        static void normalMatrices(const glm::mat4* matrices, glm::mat4* normals, size_t count);
+        // axis aligned bounds of transformed boxes, written at offset of the SoA arrays
+        static void transformBounds(const glm::mat4* matrices, const Bounds* bounds, BoundsSoA& result, size_t offset, size_t count);
+        // planes as (normal, distance) with normals pointing inside, Vulkan depth range
+        static void extractFrustumPlanes(const glm::mat4& viewProj, glm::vec4 planes[6]);
+        // visible[i] is 1 when the box intersects or lies inside the frustum
+        static void testFrustum(const glm::vec4 planes[6], const BoundsSoA& bounds, uint8_t* visible);
+    };
+}
+#endif /* BATCHMATH_H */
+
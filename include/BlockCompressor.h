@@ -0,0 +1,40 @@
+/* 
+ * File:   BlockCompressor.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 18 października 2026, 23:35
+ */
+
+#ifndef BLOCKCOMPRESSOR_H
+#define BLOCKCOMPRESSOR_H
+
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    /*
+     * Encoders of 4x4 block compressed formats from RGBA8 pixels. They favour speed of
+     * the offline cook over the last bit of quality: endpoints come from the principal
+     * axis of each block and indices are picked as the nearest palette entries.
+     */
+    class BlockCompressor {
+    public:
+        BlockCompressor() = delete;
+
+        // BC1 without alpha, 8 bytes per block
+        static std::vector<uint8_t> compressBc1(const uint8_t* rgba, uint32_t width, uint32_t height);
+        // BC7 mode 6 only, 16 bytes per block
+        static std::vector<uint8_t> compressBc7(const uint8_t* rgba, uint32_t width, uint32_t height);
+        // ETC2 RGB8 using ETC1 compatible blocks only, 8 bytes per block
+        static std::vector<uint8_t> compressEtc2(const uint8_t* rgba, uint32_t width, uint32_t height);
+    private:
+        static void fetchBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint8_t block[64]);
+        static void principalAxis(const uint8_t block[64], uint32_t channels, float minimum[4], float maximum[4]);
+        static void encodeBc1Block(const uint8_t block[64], uint8_t* output);
+        static void encodeBc7Block(const uint8_t block[64], uint8_t* output);
+        static void encodeEtc2Block(const uint8_t block[64], uint8_t* output);
+    };
+}
+#endif /* BLOCKCOMPRESSOR_H */
+
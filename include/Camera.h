@@ -10,7 +10,10 @@
 
 #include "UniformBuffer.h"
 
+#include <cstddef>
+
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 #include <glm/mat4x4.hpp>
 
 namespace zvlk {
@@ -20,8 +23,13 @@ namespace zvlk {
         glm::mat4 proj;
         alignas(16) glm::vec3 eye;
         alignas(16) glm::vec3 center;
+        alignas(16) glm::mat4 viewProj;
+        // for reconstructing positions from depth
+        alignas(16) glm::mat4 invViewProj;
     };
 
+    static_assert(offsetof(CameraUBO, invViewProj) == 224, "CameraUBO must follow the std140 layout of the shaders");
+
     class Camera : public UniformBuffer {
     public:
         Camera() = delete;
@@ -34,6 +42,30 @@ namespace zvlk {
         
         Camera& rotateEye(float angle, glm::vec3 axis=glm::vec3(0.0f, 1.0f, 0.0f));
         Camera& translateEye(glm::vec3 vector);
+
+        // planes of the frustum from the last update
+        inline const glm::vec4* getFrustumPlanes() const {
+            return this->frustumPlanes;
+        }
+
+        // matrices from the last update
+        inline const glm::mat4& getView() const {
+            return this->view;
+        }
+
+        inline const glm::mat4& getProjection() const {
+            return this->projection;
+        }
+
+        inline float getNear() const {
+            return this->near;
+        }
+
+        inline float getFar() const {
+            return this->far;
+        }
+    protected:
+        virtual void resize(uint32_t imagesNumber);
     private:
         glm::vec3 eye;
         glm::vec3 center;
@@ -41,6 +73,9 @@ namespace zvlk {
         glm::vec3 up;
         float near;
         float far;
+        glm::vec4 frustumPlanes[6];
+        glm::mat4 view;
+        glm::mat4 projection;
 
         std::shared_ptr<zvlk::Frame> frame;
         std::vector<CameraUBO> ubos;
@@ -0,0 +1,60 @@
+/* 
+ * File:   CommandRecorder.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 03:20
+ */
+
+#ifndef COMMANDRECORDER_H
+#define COMMANDRECORDER_H
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstdint>
+
+#define RECORDER_MAX_SETS 4
+
+namespace zvlk {
+
+    struct RecorderStatistics {
+        uint64_t pipelineBinds = 0;
+        uint64_t descriptorSetBinds = 0;
+        // vertex and index buffers
+        uint64_t bufferBinds = 0;
+        // calls skipped because the state was already bound
+        uint64_t bindsSkipped = 0;
+    };
+
+    /*
+     * Records graphics state into a command buffer, skipping binds of what is
+     * already bound. All sets are bound with one pipeline layout, so they stay
+     * valid when pipelines change.
+     */
+    class CommandRecorder {
+    public:
+        CommandRecorder() = delete;
+        CommandRecorder(const CommandRecorder& orig) = delete;
+        CommandRecorder(vk::CommandBuffer commandBuffer, vk::PipelineLayout pipelineLayout);
+        virtual ~CommandRecorder() = default;
+
+        void bindPipeline(vk::Pipeline pipeline);
+        void bindDescriptorSet(uint32_t set, vk::DescriptorSet descriptorSet);
+        void bindVertexBuffer(vk::Buffer buffer);
+        void bindIndexBuffer(vk::Buffer buffer);
+
+        inline const RecorderStatistics& getStatistics() const {
+            return this->statistics;
+        }
+    private:
+        vk::CommandBuffer commandBuffer;
+        vk::PipelineLayout pipelineLayout;
+        vk::Pipeline pipeline;
+        std::array<vk::DescriptorSet, RECORDER_MAX_SETS> descriptorSets;
+        vk::Buffer vertexBuffer;
+        vk::Buffer indexBuffer;
+        RecorderStatistics statistics;
+    };
+}
+#endif /* COMMANDRECORDER_H */
+
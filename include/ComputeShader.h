@@ -0,0 +1,28 @@
+/* 
+ * File:   ComputeShader.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 00:30
+ */
+
+#ifndef COMPUTESHADER_H
+#define COMPUTESHADER_H
+
+#include <vulkan/vulkan.hpp>
+
+#include "Shader.h"
+
+namespace zvlk {
+
+    class ComputeShader : public Shader {
+    public:
+        ComputeShader() = delete;
+        ComputeShader(const ComputeShader& orig) = delete;
+        ComputeShader(vk::Device device, const zvlk::Blob& code);
+        virtual ~ComputeShader();
+    private:
+
+    };
+}
+#endif /* COMPUTESHADER_H */
+
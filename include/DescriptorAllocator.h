@@ -0,0 +1,95 @@
+/* 
+ * File:   DescriptorAllocator.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 03:50
+ */
+
+#ifndef DESCRIPTORALLOCATOR_H
+#define DESCRIPTORALLOCATOR_H
+
+#include "DescriptorCache.h"
+
+#include <vulkan/vulkan.hpp>
+
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    class Device;
+
+    struct DescriptorAllocatorStatistics {
+        uint32_t pools = 0;
+        uint64_t setsAllocated = 0;
+        // sets returned from the cache instead of being allocated and written
+        uint64_t setsShared = 0;
+        // sets taken from the released ones instead of a pool
+        uint64_t setsRecycled = 0;
+        uint64_t setsWritten = 0;
+        double writeMilliseconds = 0.0;
+    };
+
+    /*
+     * Allocates descriptor sets from pools which grow in chunks. Resetting returns
+     * every pool of the current size for reuse once no frame uses it, smaller ones
+     * are destroyed so the pool count stays bounded across resets. Sets asked for by content are
+     * kept in a descriptor cache, so equal sets are shared. Registered layouts have one resource per binding and are written
+     * through descriptor update templates when the device has them.
+     */
+    class DescriptorAllocator {
+    public:
+        DescriptorAllocator() = delete;
+        DescriptorAllocator(const DescriptorAllocator& orig) = delete;
+        DescriptorAllocator(zvlk::Device* device);
+        virtual ~DescriptorAllocator();
+
+        // bindings of the layout in the order of the infos given when writing
+        void registerLayout(vk::DescriptorSetLayout layout, const std::vector<vk::DescriptorSetLayoutBinding>& bindings);
+        // a set of its own, which its owner may write again
+        vk::DescriptorSet allocate(vk::DescriptorSetLayout layout);
+        // a set with the contents, shared with every caller asking for the same
+        vk::DescriptorSet get(vk::DescriptorSetLayout layout, const std::vector<zvlk::DescriptorInfo>& infos);
+        // writes a set again, a cached one is then found by its new contents
+        void write(vk::DescriptorSet set, vk::DescriptorSetLayout layout, const std::vector<zvlk::DescriptorInfo>& infos);
+        // gives up one use of a set, which no frame in flight may still read, shared sets are kept until
+        // their last user releases them and then allocated again for the layout
+        void release(vk::DescriptorSetLayout layout, vk::DescriptorSet set);
+        // frees every set once no frame in flight uses it, pools are kept for the next allocations
+        void reset();
+
+        inline const DescriptorAllocatorStatistics& getStatistics() const {
+            return this->statistics;
+        }
+    private:
+        struct RegisteredLayout {
+            std::vector<uint32_t> bindings;
+            std::vector<vk::DescriptorType> types;
+            VkDescriptorUpdateTemplateKHR updateTemplate;
+        };
+
+        zvlk::Device* device;
+        vk::Device graphicsDevice;
+        PFN_vkCreateDescriptorUpdateTemplateKHR createDescriptorUpdateTemplate;
+        PFN_vkDestroyDescriptorUpdateTemplateKHR destroyDescriptorUpdateTemplate;
+        PFN_vkUpdateDescriptorSetWithTemplateKHR updateDescriptorSetWithTemplate;
+
+        std::vector<vk::DescriptorPool> usedPools;
+        std::vector<vk::DescriptorPool> freePools;
+        // sets each pool was created for
+        std::unordered_map<VkDescriptorPool, uint32_t> poolSets;
+        vk::DescriptorPool currentPool;
+        uint32_t setsPerPool;
+        uint64_t resets;
+        std::unordered_map<VkDescriptorSetLayout, RegisteredLayout> layouts;
+        zvlk::DescriptorCache cache;
+        std::unordered_map<VkDescriptorSetLayout, std::vector<vk::DescriptorSet>> released;
+        DescriptorAllocatorStatistics statistics;
+
+        vk::DescriptorPool createPool();
+        vk::DescriptorSet allocateFromPools(vk::DescriptorSetLayout layout);
+    };
+}
+#endif /* DESCRIPTORALLOCATOR_H */
+
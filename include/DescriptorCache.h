@@ -0,0 +1,78 @@
+/* 
+ * File:   DescriptorCache.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 20 października 2026, 01:00
+ */
+
+#ifndef DESCRIPTORCACHE_H
+#define DESCRIPTORCACHE_H
+
+#include <vulkan/vulkan.hpp>
+
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace zvlk {
+
+    // resource of one binding, the image or the buffer part is used depending on its type
+    struct DescriptorInfo {
+        vk::DescriptorImageInfo image;
+        vk::DescriptorBufferInfo buffer;
+
+        DescriptorInfo(const vk::DescriptorImageInfo& image) : image(image) {
+        }
+
+        DescriptorInfo(const vk::DescriptorBufferInfo& buffer) : buffer(buffer) {
+        }
+
+        bool operator==(const DescriptorInfo& other) const {
+            return image == other.image && buffer == other.buffer;
+        }
+    };
+
+    /*
+     * Descriptor sets shared by content, keyed by a hash of the layout and the bound
+     * resources and counting their users. Only bookkeeping, the sets are allocated,
+     * written and freed by the descriptor allocator.
+     */
+    class DescriptorCache {
+    public:
+        DescriptorCache() = default;
+        DescriptorCache(const DescriptorCache& orig) = delete;
+        virtual ~DescriptorCache() = default;
+
+        // the set with the contents, with one more user, or a null one
+        vk::DescriptorSet find(vk::DescriptorSetLayout layout, const std::vector<zvlk::DescriptorInfo>& infos);
+        // a set just written with the contents, with its first user
+        void insert(vk::DescriptorSetLayout layout, const std::vector<zvlk::DescriptorInfo>& infos, vk::DescriptorSet set);
+        // contents of a set were written again, a cached one is then found by the new ones
+        void update(vk::DescriptorSet set, vk::DescriptorSetLayout layout, const std::vector<zvlk::DescriptorInfo>& infos);
+        // gives up one use of a set, true when nobody uses it anymore or it was not cached
+        bool release(vk::DescriptorSet set);
+        void clear();
+
+        inline bool contains(vk::DescriptorSet set) const {
+            return this->hashes.count(set) != 0;
+        }
+
+        static size_t hash(vk::DescriptorSetLayout layout, const std::vector<zvlk::DescriptorInfo>& infos);
+    private:
+        struct CachedSet {
+            vk::DescriptorSetLayout layout;
+            std::vector<zvlk::DescriptorInfo> infos;
+            vk::DescriptorSet set;
+            uint32_t users;
+        };
+
+        std::unordered_map<size_t, std::vector<CachedSet>> sets;
+        std::unordered_map<VkDescriptorSet, size_t> hashes;
+
+        // number of users of the set
+        uint32_t remove(vk::DescriptorSet set);
+    };
+}
+#endif /* DESCRIPTORCACHE_H */
+
@@ -11,13 +11,20 @@
 #include <vulkan/vulkan.hpp>
 #include <vector>
 #include <iostream>
+#include <string>
 #include <set>
+#include <list>
+#include <functional>
 
 #include "Frame.h"
 
 namespace zvlk {
 
     class Frame;
+    class AssetCache;
+    class TextureStreamer;
+    class MipmapGenerator;
+    class FileSystem;
 
     typedef struct QueueFamilyIndices {
         uint32_t graphicsFamily;
@@ -33,6 +40,14 @@ namespace zvlk {
 
     } QueueFamilyIndices;
 
+    struct DestructionStatistics {
+        // waiting for the frames which may use them
+        uint64_t pending = 0;
+        uint64_t destroyed = 0;
+        // destroyed at once, no frame was in flight
+        uint64_t immediate = 0;
+    };
+
     typedef struct SwapChainSupportDetails {
         vk::SurfaceCapabilitiesKHR capabilities;
         std::vector<vk::SurfaceFormatKHR> formats;
@@ -60,21 +75,34 @@ namespace zvlk {
         const vk::PhysicalDeviceMemoryProperties& getMemoryProperties();
         const vk::FormatProperties getFormatProperties(vk::Format format);
         vk::SampleCountFlagBits getMaxUsableSampleCount();
+        // highest count supported by both color and depth attachments, not above the one requested
+        vk::SampleCountFlagBits getUsableSampleCount(vk::SampleCountFlagBits requested);
 
         std::shared_ptr<zvlk::Frame> initializeForGraphics(vk::SurfaceKHR surface, const std::vector<const char*>, const std::vector<const char*> deviceExtensions);
 
+        // significant bits of timestamps written on the graphics queue, 0 when it writes none
+        inline uint32_t getTimestampValidBits() const {
+            return this->timestampValidBits;
+        }
+
         bool doesSupportExtensions(const std::vector<const char*> extensions);
+        bool isExtensionEnabled(const std::string& extension) const;
         bool doesSupportGraphics(vk::SurfaceKHR surface);
 
         zvlk::SwapChainSupportDetails querySwapChainSupport(vk::SurfaceKHR surface);
         zvlk::QueueFamilyIndices findQueueFamilies(vk::SurfaceKHR surface);
         void transitionImageLayout(vk::Image image, vk::Format format, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, uint32_t mipLevels);
 
-        vk::ImageView createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels);
+        vk::ImageView createImageView(vk::Image image, vk::Format format, vk::ImageAspectFlags aspectFlags, uint32_t mipLevels,
+                vk::ComponentMapping components = vk::ComponentMapping());
         void createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
                 vk::SampleCountFlagBits numSamples,
                 vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage,
-                vk::MemoryPropertyFlags properties, vk::Image& image, vk::DeviceMemory& imageMemory);
+                vk::MemoryPropertyFlags properties, vk::Image& image, vk::DeviceMemory& imageMemory,
+                vk::ImageCreateFlags flags = vk::ImageCreateFlags());
+        // single level attachment living only within render passes, true when its memory is lazily allocated
+        bool createTransientImage(uint32_t width, uint32_t height, vk::SampleCountFlagBits numSamples, vk::Format format,
+                vk::ImageUsageFlags usage, vk::Image& image, vk::DeviceMemory& imageMemory);
         void createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties, vk::Buffer& buffer, vk::DeviceMemory& bufferMemory);
         void bindBuffer(vk::Buffer& buffer, vk::DeviceMemory& memory, vk::DeviceSize offset);
         void createVertexBuffer(vk::DeviceSize size, vk::Buffer& buffer);
@@ -95,8 +123,50 @@ namespace zvlk {
 
         void allocateCommandBuffers(uint32_t frameNumbers, std::vector<vk::CommandBuffer>& commandBuffers);
 
+        // textures, materials and samplers shared by everything created on this device
+        inline zvlk::AssetCache* getAssetCache() {
+            return this->assetCache;
+        }
+
+        inline zvlk::TextureStreamer* getTextureStreamer() {
+            return this->textureStreamer;
+        }
+
+        inline zvlk::MipmapGenerator* getMipmapGenerator() {
+            return this->mipmapGenerator;
+        }
+
+        // assets are read through it, so they may come from mounted archives
+        inline zvlk::FileSystem* getFileSystem() {
+            return this->fileSystem;
+        }
+
         void submitGraphics(vk::SubmitInfo* submitInfo, vk::Fence fence);
+        // a frame, which every object dropped before it was submitted may be used by until the fence signals
+        void submitFrame(vk::SubmitInfo* submitInfo, vk::Fence fence);
         vk::Result present(vk::PresentInfoKHR* presentInfo);
+
+        // destroys the object once every frame submitted so far is complete
+        template<typename Handle>
+        void destroyLater(Handle handle) {
+            if (handle) {
+                vk::Device graphicsDevice = this->graphicsDevice;
+                this->deferDestruction([graphicsDevice, handle]() {
+                    graphicsDevice.destroy(handle);
+                });
+            }
+        }
+        void destroyLater(vk::DeviceMemory memory);
+        // for objects destroyed through their owner
+        void deferDestruction(std::function<void()> destroy);
+        // destroys what the completed frames were the last to use, without waiting for any
+        void collectGarbage();
+        // waits for the device, after which nothing is in use
+        void waitIdle();
+
+        inline const DestructionStatistics& getDestructionStatistics() const {
+            return this->destructionStatistics;
+        }
         
         friend std::ostream& operator<<(std::ostream& os, const Device& device);
     private:
@@ -105,13 +175,37 @@ namespace zvlk {
         vk::PhysicalDeviceFeatures deviceFeatures;
         vk::PhysicalDeviceMemoryProperties memoryProperties;
         std::vector<vk::ExtensionProperties> availableExtensions;
+        std::vector<const char*> enabledExtensions;
         std::vector<vk::QueueFamilyProperties> queueFamilies;
         vk::Device graphicsDevice;
         vk::Queue graphicsQueue;
         vk::Queue presentQueue;
+        uint32_t timestampValidBits = 0;
         vk::CommandPool commandPool;
+        zvlk::AssetCache* assetCache;
+        zvlk::TextureStreamer* textureStreamer;
+        zvlk::MipmapGenerator* mipmapGenerator;
+        zvlk::FileSystem* fileSystem;
+
+        struct SubmittedFrame {
+            uint64_t number;
+            vk::Fence fence;
+        };
+
+        struct Destruction {
+            // the last frame which may use the object
+            uint64_t frame;
+            std::function<void()> destroy;
+        };
+
+        uint64_t framesSubmitted = 0;
+        uint64_t framesCompleted = 0;
+        std::list<SubmittedFrame> framesInFlight;
+        std::list<Destruction> destructions;
+        DestructionStatistics destructionStatistics;
 
         uint32_t findMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
+        bool hasMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties);
     };
 }
 #endif /* DEVICE_H */
@@ -0,0 +1,65 @@
+/* 
+ * File:   DrawList.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 03:05
+ */
+
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace zvlk {
+
+    /*
+     * Draws of a frame ordered by 64 bit keys. From the most significant bits a key
+     * holds the pass, pipeline, material, mesh and view depth, so sorting groups
+     * draws sharing state and orders each group front to back. Items are indices
+     * into the caller's own array of draws.
+     */
+    class DrawList {
+    public:
+        DrawList() = default;
+        DrawList(const DrawList& orig) = delete;
+        virtual ~DrawList() = default;
+
+        // identifiers are truncated to the bits of their field, negative depths sort first
+        static uint64_t makeKey(uint32_t pass, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+        static uint32_t getPass(uint64_t key);
+
+        inline void clear() {
+            this->keys.clear();
+            this->items.clear();
+        }
+
+        inline void add(uint64_t key, uint32_t item) {
+            this->keys.push_back(key);
+            this->items.push_back(item);
+        }
+
+        // radix sort, stable for equal keys
+        void sort();
+
+        inline size_t size() const {
+            return this->items.size();
+        }
+
+        inline uint32_t operator[](size_t i) const {
+            return this->items[i];
+        }
+
+        inline uint64_t getKey(size_t i) const {
+            return this->keys[i];
+        }
+    private:
+        std::vector<uint64_t> keys;
+        std::vector<uint32_t> items;
+        std::vector<uint64_t> sortedKeys;
+        std::vector<uint32_t> sortedItems;
+    };
+}
+#endif /* DRAWLIST_H */
+
@@ -10,6 +10,7 @@
 #include <vulkan/vulkan.hpp>
 
 #include <list>
+#include <unordered_map>
 
 #include "VertexShader.h"
 #include "FragmentShader.h"
@@ -18,27 +19,94 @@
 #include "TransformationMatrices.h"
 #include "Camera.h"
 #include "Light.h"
+#include "BatchMath.h"
+#include "OcclusionCuller.h"
+#include "DrawList.h"
+#include "DescriptorAllocator.h"
 
 const int MAX_FRAMES_IN_FLIGHT = 2;
 
 namespace zvlk {
 
+    // shaders and models given to the engine, a handle stays invalid after what it refers to is removed
+    struct ShaderHandle {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    struct ModelHandle {
+        uint32_t index;
+        uint32_t generation;
+    };
+
     typedef struct ModelUnit {
-        zvlk::Model& model;
-        zvlk::TransformationMatrices& matrix;
-        vk::DescriptorPool descriptorPool;
+        zvlk::Model* model;
+        zvlk::TransformationMatrices* matrix;
+        // of the parts of every material of the model, the model's own unless replaced
+        std::vector<zvlk::Material*> materials;
+        // matrix set per image, material sets per material and image
+        std::vector<vk::DescriptorSet> matrixSets;
         std::vector<vk::DescriptorSet> descriptorSets;
+        // texture versions written into the material sets, per material and image
+        std::vector<uint64_t> textureVersions;
+        // identifiers of the model and of its materials in draw keys
+        uint32_t meshId;
+        std::vector<uint32_t> materialIds;
+        // consecutive draw slots of the parts at full detail
+        uint32_t firstSlot;
+        uint32_t slotsNumber;
+        // frame in which the slots were taken, occluder commands of earlier frames belong to their last model
+        uint64_t slotsFrame;
+        // merged static models of the unit, created by compile
+        bool isBatch;
+        bool isStatic;
+        // record of the handle, batches have none
+        uint32_t handle;
     } ModelUnit;
 
     typedef struct ExecutionUnit {
         zvlk::VertexShader& vertexShader;
         zvlk::FragmentShader& fragmentShader;
-        vk::DescriptorPool descriptorPool;
-        std::vector<vk::DescriptorSet> descriptorSets;
         std::list<ModelUnit> models;
         vk::Pipeline graphicsPipeline;
+        // drawn only through the batch, which compile merges them into
+        std::list<ModelUnit> staticModels;
+        zvlk::Model* staticBatch;
+        zvlk::TransformationMatrices* staticMatrices;
+        // static models changed, only this batch with its sets and draw slots is rebuilt before the next frame
+        bool staticChanged;
     } ExecutionUnit;
 
+    // a visible part as recorded in one frame, ordered through the draw list
+    struct PartDraw {
+        ExecutionUnit* unit;
+        ModelUnit* model;
+        // position of the material in its model
+        uint32_t materialIndex;
+        const ModelPart* modelPart;
+        uint32_t slot;
+    };
+
+    struct EngineStatistics {
+        // of the last recorded frame
+        uint64_t trianglesSubmitted = 0;
+        // what the frame would submit with every model at full detail
+        uint64_t trianglesWithoutLod = 0;
+        uint64_t drawsFrustumCulled = 0;
+        // found by the pyramid test the last time the same image was rendered
+        uint64_t drawsOccluded = 0;
+        // of the main render pass, the last time the same image was rendered
+        uint64_t fragmentInvocations = 0;
+        uint64_t drawCalls = 0;
+        uint64_t pipelineBinds = 0;
+        uint64_t descriptorSetBinds = 0;
+        uint64_t bufferBinds = 0;
+        uint64_t bindsSkipped = 0;
+        // GPU time of the whole frame and of its post-process pass, the last time the same image was rendered
+        float gpuMilliseconds = 0.0f;
+        float postProcessMilliseconds = 0.0f;
+    };
+
     class EngineCallback {
     public:
         virtual void update(uint32_t frameIndex) = 0;
@@ -59,20 +127,76 @@ namespace zvlk {
 
         inline void setCamera(zvlk::Camera *camera) {
             this->camera = camera;
+            this->lights->setCamera(camera);
         }
 
         inline void attachLight(zvlk::Light* light) {
+            // binned into clusters before every frame
             this->lights->addLight(light);
-            for (uint32_t i = 0; i < this->frameNumber; ++i) {
-                dynamic_cast<zvlk::UniformBuffer*>(this->lights)->update(i);
-            }
         }
 
-        void enableShaders(zvlk::VertexShader& vertexShader, zvlk::FragmentShader& fragmentShader);
-        void draw(zvlk::Model& model, zvlk::TransformationMatrices& transformationMatrices);
+        // attenuated lights are not shaded where they give less than this fraction of their color, 0 shades them everywhere
+        inline void setLightCutoff(float cutoff) {
+            this->lights->setCutoff(cutoff);
+        }
+
+        // models drawn afterwards without shaders given use these
+        zvlk::ShaderHandle enableShaders(zvlk::VertexShader& vertexShader, zvlk::FragmentShader& fragmentShader);
+        // with every model drawn with the shaders
+        void disableShaders(zvlk::ShaderHandle shaders);
+        // shaders of the fullscreen lighting subpass, used when the frame renders deferred
+        void enableDeferredLighting(zvlk::VertexShader& vertexShader, zvlk::FragmentShader& fragmentShader);
+        // position only shader of a depth prepass, after which the main pass shades only the visible fragments
+        void enableDepthPrepass(zvlk::VertexShader& vertexShader);
+        // fullscreen pass sampling the scene image, used when the anti-aliasing mode of the frame has one
+        void enablePostProcess(zvlk::VertexShader& vertexShader, zvlk::FragmentShader& fragmentShader);
+        zvlk::ModelHandle draw(zvlk::Model& model, zvlk::TransformationMatrices& transformationMatrices);
+        zvlk::ModelHandle draw(zvlk::ShaderHandle shaders, zvlk::Model& model, zvlk::TransformationMatrices& transformationMatrices);
+        // for models that never move, those of a unit are merged into a few draws of pre-transformed geometry
+        zvlk::ModelHandle drawStatic(zvlk::Model& model, zvlk::TransformationMatrices& transformationMatrices);
+        // after compile these change only the sets and draw slots of the model, what they free is destroyed
+        // by the device once no frame in flight uses it, for static models only the batch of their unit is rebuilt
+        void removeModel(zvlk::ModelHandle model);
+        void setModelMatrices(zvlk::ModelHandle model, zvlk::TransformationMatrices& transformationMatrices);
+        void setModelMaterial(zvlk::ModelHandle model, uint32_t materialIndex, zvlk::Material& material);
+        // moves models with the matrices between the static and the moving ones, batches are rebuilt before the next frame
+        void setStatic(zvlk::TransformationMatrices& transformationMatrices, bool isStatic);
         void compile();
+        // after the frame was recreated in a compatible render pass, replaces only what depends on its size
+        void resize();
         vk::Bool32 execute(vk::Bool32 framebufferResized);
+
+        // largest error of a simplified model in pixels, 0 draws everything at full detail
+        inline void setLodThreshold(float pixels) {
+            this->lodThreshold = pixels;
+        }
+
+        // takes effect on the next compile, without it only draws outside the frustum are dropped
+        inline void setOcclusionCulling(bool enabled) {
+            this->occlusionCulling = enabled;
+        }
+
+        inline const EngineStatistics& getStatistics() const {
+            return this->statistics;
+        }
+
+        inline const DescriptorAllocatorStatistics& getDescriptorStatistics() const {
+            return this->descriptorAllocator->getStatistics();
+        }
     private:
+        struct UnitRecord {
+            uint32_t generation;
+            bool live;
+            std::list<ExecutionUnit>::iterator unit;
+        };
+
+        struct ModelRecord {
+            uint32_t generation;
+            bool live;
+            std::list<ExecutionUnit>::iterator unit;
+            std::list<ModelUnit>::iterator model;
+        };
+
         std::list<ExecutionUnit> units;
         std::vector<vk::CommandBuffer> commandBuffers;
         vk::Device device;
@@ -85,16 +209,87 @@ namespace zvlk {
         vk::DescriptorSetLayout sceneLayout;
         vk::DescriptorSetLayout modelLayout;
         vk::DescriptorSetLayout materialLayout;
-        vk::DescriptorPool descriptorPool;
+        zvlk::DescriptorAllocator* descriptorAllocator;
         std::vector<vk::DescriptorSet> descriptorSets;
         vk::PipelineLayout pipelineLayout;
 
+        zvlk::VertexShader* lightingVertexShader = nullptr;
+        zvlk::FragmentShader* lightingFragmentShader = nullptr;
+        vk::DescriptorSetLayout inputLayout;
+        vk::DescriptorSet inputDescriptorSet;
+        vk::PipelineLayout lightingPipelineLayout;
+        vk::Pipeline lightingPipeline;
+
+        zvlk::VertexShader* prepassVertexShader = nullptr;
+        vk::Pipeline prepassPipeline;
+        // one query per image, exists when the device counts pipeline statistics
+        vk::QueryPool statisticsQueryPool;
+        std::vector<bool> statisticsQueried;
+        // per image, exists when the device writes timestamps on the graphics queue
+        vk::QueryPool timestampQueryPool;
+        std::vector<bool> timestampsQueried;
+
+        zvlk::VertexShader* postVertexShader = nullptr;
+        zvlk::FragmentShader* postFragmentShader = nullptr;
+        vk::DescriptorSetLayout postLayout;
+        vk::PipelineLayout postPipelineLayout;
+        vk::DescriptorSet postDescriptorSet;
+        vk::Pipeline postPipeline;
+
         std::vector<vk::Semaphore> imageAvailableSemaphores;
         std::vector<vk::Semaphore> renderFinishedSemaphores;
         std::vector<vk::Fence> inFlightFences;
         std::vector<vk::Fence> imagesInFlight;
         std::list<EngineCallback*> callbacks;
         size_t currentFrame = 0;
+        float lodThreshold = 1.0f;
+        EngineStatistics statistics;
+        bool occlusionCulling = true;
+        zvlk::OcclusionCuller* occlusionCuller = nullptr;
+        bool compiled = false;
+
+        std::vector<UnitRecord> unitRecords;
+        std::vector<uint32_t> freeUnitRecords;
+        std::vector<ModelRecord> modelRecords;
+        std::vector<uint32_t> freeModelRecords;
+        uint64_t frameCounter = 0;
+
+        // every part of every model at full detail has a draw slot, kept while the model is drawn
+        uint32_t slotsNumber = 0;
+        // first slot and length of ranges of removed models
+        std::vector<std::pair<uint32_t, uint32_t>> freeSlots;
+        std::unordered_map<zvlk::Model*, uint32_t> meshIds;
+        std::unordered_map<zvlk::Material*, uint32_t> materialIds;
+        std::vector<zvlk::Bounds> drawBounds;
+        std::vector<glm::mat4> drawMatrices;
+        zvlk::BoundsSoA drawWorldBounds;
+        std::vector<uint8_t> drawVisible;
+        std::vector<zvlk::PartDraw> partDraws;
+        zvlk::DrawList drawList;
+
+        // command buffers are recorded every frame, for the detail of models seen from the camera
+        void record(uint32_t index);
+        uint32_t selectLod(const ModelUnit& model) const;
+        void drawPart(uint32_t index, size_t slot, const zvlk::ModelPart& modelPart);
+        void writeSceneDescriptors(uint32_t index);
+        void streamTextures(uint32_t index);
+        void compileDeferredLighting();
+        void writeInputDescriptors();
+        void compilePostProcess();
+        void writePostDescriptors();
+        void compileDepthPrepass();
+        void compileStaticBatch(ExecutionUnit& unit);
+        void releaseStaticBatch(ExecutionUnit& unit);
+        void resizeImages();
+        void compilePipeline(ExecutionUnit& unit);
+        static const vk::PipelineDynamicStateCreateInfo* dynamicViewportState();
+        void compileModel(ModelUnit& model);
+        void releaseModel(ModelUnit& model);
+        uint32_t allocateSlots(uint32_t count);
+        zvlk::ModelHandle addModel(std::list<ExecutionUnit>::iterator unit, zvlk::Model& model,
+                zvlk::TransformationMatrices& transformationMatrices, bool isStatic);
+        ModelUnit& getModel(zvlk::ModelHandle model);
+        void freeModelRecord(uint32_t index);
     };
 }
 #endif /* ENGINE_H */
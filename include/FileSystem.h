@@ -0,0 +1,95 @@
+/* 
+ * File:   FileSystem.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 00:50
+ */
+
+#ifndef FILESYSTEM_H
+#define FILESYSTEM_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    class MappedFile;
+
+    /*
+     * Read only bytes of an asset, either owned or a view of a mapped file which is
+     * kept alive as long as any copy of the blob. Copies share the bytes.
+     */
+    class Blob {
+    public:
+        Blob();
+        Blob(std::vector<uint8_t> content);
+        Blob(std::shared_ptr<zvlk::MappedFile> file);
+        // part of a mapped file
+        Blob(std::shared_ptr<zvlk::MappedFile> file, size_t offset, size_t size);
+
+        inline const uint8_t* getData() const {
+            return this->data;
+        }
+
+        inline size_t getSize() const {
+            return this->size;
+        }
+
+        inline bool isEmpty() const {
+            return this->size == 0;
+        }
+    private:
+        std::shared_ptr<const std::vector<uint8_t>> content;
+        std::shared_ptr<zvlk::MappedFile> file;
+        const uint8_t* data;
+        size_t size;
+    };
+
+    // directory or archive whose files are visible in the file system, reads may come from many threads
+    class Mount {
+    public:
+        virtual ~Mount() = default;
+
+        virtual bool exists(const std::string& name) = 0;
+        // empty when the mount does not have the file
+        virtual Blob read(const std::string& name) = 0;
+        virtual std::vector<std::string> list() = 0;
+    };
+
+    /*
+     * Virtual file system serving assets from mounted directories and zip archives
+     * as memory, so nothing is extracted to disk. Mounts added later shadow earlier
+     * ones, names found in no mount are read from the real file system. Names use
+     * forward slashes and are relative to the mount root. Files needed soon can be
+     * prefetched, they are read and decompressed in parallel and kept until read.
+     */
+    class FileSystem {
+    public:
+        FileSystem();
+        FileSystem(const FileSystem& orig) = delete;
+        virtual ~FileSystem();
+
+        zvlk::Mount* mountDirectory(const std::string& path);
+        zvlk::Mount* mountArchive(const std::string& path);
+        zvlk::Mount* mountPack(const std::string& path);
+        zvlk::Mount* mount(std::unique_ptr<zvlk::Mount> mount);
+
+        bool exists(const std::string& name);
+        Blob read(const std::string& name);
+        // names which cannot be read are skipped, reading them later reports the error
+        void prefetch(const std::vector<std::string>& names);
+    private:
+        std::vector<std::unique_ptr<zvlk::Mount>> mounts;
+        std::unordered_map<std::string, Blob> prefetched;
+        // guards the mounts and prefetched files, not the reads themselves
+        std::mutex mutex;
+
+        zvlk::Mount* find(const std::string& name);
+    };
+}
+#endif /* FILESYSTEM_H */
+
@@ -18,7 +18,7 @@ namespace zvlk {
     public:
         FragmentShader() = delete;
         FragmentShader(const FragmentShader& orig) = delete;
-        FragmentShader(vk::Device device, const char* name);
+        FragmentShader(vk::Device device, const zvlk::Blob& code);
         virtual ~FragmentShader();
     private:
 
@@ -20,6 +20,31 @@ namespace zvlk {
     class Device;
     struct SwapChainSupportDetails;
 
+    enum class RenderMode {
+        // single subpass shading every fragment as it is rasterized
+        eForward,
+        // geometry subpass filling the G-buffer, then a lighting subpass reading it as input attachments
+        eDeferred
+    };
+
+    enum class AntiAliasing {
+        // multisampled attachments resolved at the end of the pass, every fragment shaded once per pixel
+        eMsaa,
+        // as eMsaa, with a fraction of the samples of a pixel shaded separately
+        eMsaaSampleShading,
+        // single sample rendering smoothed along luminance edges by a fullscreen post-process pass
+        eFxaa
+    };
+
+    struct AttachmentStatistics {
+        // memory of the attachments other than swapchain images
+        vk::DeviceSize allocated = 0;
+        // part of it allocated lazily, backed by the device only as far as rendering needs
+        vk::DeviceSize lazilyAllocated = 0;
+        // of the lazily allocated part, what the device has actually committed
+        vk::DeviceSize committed = 0;
+    };
+
     class Frame {
     public:
         Frame() = delete;
@@ -29,6 +54,10 @@ namespace zvlk {
 
         void create(zvlk::Device* device, vk::SurfaceKHR surface);
         void destroy();
+        // new swapchain from the current one and attachments of its size, without waiting for the device;
+        // false when the render pass had to be replaced, so pipelines created for the old one are invalid,
+        // or when the number of images changed, so everything kept per image has to be compiled again
+        bool recreate(vk::SurfaceKHR surface);
 
         inline void attachWindow(std::shared_ptr<zvlk::Window> window) {
             this->window = window;
@@ -44,9 +73,63 @@ namespace zvlk {
             return this->swapChain;
         };
 
+        // takes effect on the next create or recreate
+        inline void setRenderMode(RenderMode renderMode) {
+            this->renderMode = renderMode;
+            this->configurationChanged = true;
+        }
+
+        inline RenderMode getRenderMode() const {
+            return this->renderMode;
+        }
+
+        inline vk::SampleCountFlagBits getSampleCount() const {
+            return this->sampleCount;
+        }
+
+        // takes effect on the next create or recreate, the highest supported count up to the one given is used,
+        // deferred frames are single sampled whatever the mode
+        inline void setAntiAliasing(AntiAliasing antiAliasing, vk::SampleCountFlagBits sampleCount = vk::SampleCountFlagBits::e4,
+                float minSampleShading = 0.5f) {
+            this->antiAliasing = antiAliasing;
+            this->requestedSampleCount = sampleCount;
+            this->minSampleShading = minSampleShading;
+            this->configurationChanged = true;
+        }
+
+        inline AntiAliasing getAntiAliasing() const {
+            return this->antiAliasing;
+        }
+
+        // fraction of samples shaded separately, 0 when every fragment is shaded once
+        inline float getMinSampleShading() const {
+            return this->antiAliasing == AntiAliasing::eMsaaSampleShading && this->sampleCount != vk::SampleCountFlagBits::e1
+                    ? this->minSampleShading : 0.0f;
+        }
+
+        // render pass drawing the swapchain image from the scene image, when the mode has a post-process pass
+        inline vk::RenderPass getPostRenderPass() const {
+            return this->postRenderPass;
+        }
+
+        inline vk::ImageView getSceneImageView() const {
+            return this->sceneImageView;
+        }
+
+        inline uint32_t getColorAttachmentsNumber() const {
+            return this->renderMode == RenderMode::eDeferred ? static_cast<uint32_t> (this->gBufferImages.size()) : 1;
+        }
+
+        // G-buffer views followed by depth, in the order of input attachment indices of the lighting subpass
+        std::vector<vk::ImageView> getInputAttachments() const;
+
         vk::RenderPassBeginInfo getRenderPassBeginInfo(uint32_t index) const;
+        vk::RenderPassBeginInfo getPostRenderPassBeginInfo(uint32_t index) const;
+
+        AttachmentStatistics getAttachmentStatistics() const;
     private:
         std::shared_ptr<zvlk::Window> window;
+        zvlk::Device* device;
         vk::Device graphicsDevice;
 
         vk::SwapchainKHR swapChain;
@@ -56,6 +139,7 @@ namespace zvlk {
         std::vector<vk::ImageView> swapChainImageViews;
 
         vk::RenderPass renderPass;
+        vk::Format depthFormat;
         vk::Image colorImage;
         vk::DeviceMemory colorImageMemory;
         vk::ImageView colorImageView;
@@ -65,10 +149,40 @@ namespace zvlk {
         std::vector<vk::Framebuffer> swapChainFramebuffers;
         std::vector<vk::ClearValue> clearValues;
 
+        RenderMode renderMode = RenderMode::eForward;
+        AntiAliasing antiAliasing = AntiAliasing::eMsaa;
+        vk::SampleCountFlagBits requestedSampleCount = vk::SampleCountFlagBits::e4;
+        float minSampleShading = 0.5f;
+        // the render passes are out of date with the mode
+        bool configurationChanged = false;
+        vk::SampleCountFlagBits sampleCount;
+        std::vector<vk::Image> gBufferImages;
+        std::vector<vk::DeviceMemory> gBufferImagesMemory;
+        std::vector<vk::ImageView> gBufferImageViews;
+
+        vk::Image sceneImage;
+        vk::DeviceMemory sceneImageMemory;
+        vk::ImageView sceneImageView;
+        vk::RenderPass postRenderPass;
+        std::vector<vk::Framebuffer> postFramebuffers;
+
+        AttachmentStatistics attachmentStatistics;
+        std::vector<vk::DeviceMemory> lazyMemory;
+
         vk::SurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats);
         vk::PresentModeKHR chooseSwapPresentMode(const std::vector<vk::PresentModeKHR>& availablePresentModes);
         vk::Extent2D chooseSwapExtent(const vk::SurfaceCapabilitiesKHR & capabilities);
         vk::Format findDepthFormat(zvlk::Device* device);
+        void createSwapChain(vk::SurfaceKHR surface, uint32_t imageCount, vk::SwapchainKHR oldSwapChain);
+        void createRenderPasses();
+        void createRenderPass();
+        void createPostRenderPass();
+        void addPostDependencies(std::vector<vk::SubpassDependency>& dependencies, uint32_t lastSubpass);
+        void createDeferredRenderPass();
+        void createAttachments();
+        void createAttachment(vk::SampleCountFlagBits samples, vk::Format format, vk::ImageUsageFlags usage,
+                vk::Image& image, vk::DeviceMemory& memory);
+        void destroyAttachments();
 
     };
 }
@@ -0,0 +1,68 @@
+/* 
+ * File:   Ktx2.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 18 października 2026, 23:50
+ */
+
+#ifndef KTX2_H
+#define KTX2_H
+
+#include <vulkan/vulkan.hpp>
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace zvlk {
+
+    /*
+     * KTX2 container of a single 2D image with its mip levels, limited to what the
+     * texture cook writes: block compressed formats with no supercompression.
+     */
+    class Ktx2 {
+    public:
+        Ktx2() = delete;
+        Ktx2(vk::Format format, uint32_t width, uint32_t height);
+        Ktx2(const uint8_t* content, size_t size);
+        virtual ~Ktx2();
+
+        static bool isKtx2(const uint8_t* content, size_t size);
+
+        // levels are added from the largest one
+        void addLevel(std::vector<uint8_t> level);
+        std::vector<uint8_t> serialize() const;
+        void write(const std::string& path) const;
+
+        inline vk::Format getFormat() const {
+            return this->format;
+        }
+
+        inline uint32_t getWidth() const {
+            return this->width;
+        }
+
+        inline uint32_t getHeight() const {
+            return this->height;
+        }
+
+        inline uint32_t getLevelsNumber() const {
+            return static_cast<uint32_t> (this->levels.size());
+        }
+
+        inline const std::vector<uint8_t>& getLevel(uint32_t level) const {
+            return this->levels[level];
+        }
+
+        inline const std::vector<std::vector<uint8_t>>& getLevels() const {
+            return this->levels;
+        }
+    private:
+        vk::Format format;
+        uint32_t width;
+        uint32_t height;
+        std::vector<std::vector<uint8_t>> levels;
+    };
+}
+#endif /* KTX2_H */
+
@@ -9,24 +9,43 @@
 #define LIGHT_H
 
 #include "UniformBuffer.h"
-#define MAX_LIGHTS 8
+#include "StorageBuffer.h"
+#include "Camera.h"
+
+#define CLUSTERS_X 16
+#define CLUSTERS_Y 9
+#define CLUSTERS_Z 24
 
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
 namespace zvlk {
 
-    struct LightUBO {
+    // std430 layout of a single light in the lights storage buffer
+    struct LightData {
         alignas(16) glm::vec3 position;
         alignas(16) glm::vec4 color;
         alignas(16) float attenuation;
     };
-    
+
     struct LightsUBO {
-        alignas(16) float numberOfLights;
-        alignas(16) LightUBO lights[MAX_LIGHTS];
+        uint32_t numberOfLights;
+        // lights with no attenuation reach every cluster, their indices lead the index list
+        uint32_t numberOfGlobalLights;
+        uint32_t clustersX;
+        uint32_t clustersY;
+        uint32_t clustersZ;
+        float near;
+        float far;
+        float width;
+        float height;
     };
-    
+
+    struct LightCluster {
+        uint32_t offset;
+        uint32_t count;
+    };
+
     class Light {
     public:
         Light() = delete;
@@ -34,6 +53,8 @@ namespace zvlk {
         Light(glm::vec3 position, glm::vec4 color, float attenuation);
         virtual ~Light();
 
+        // distance beyond which the light contributes less than the cutoff, infinite without attenuation or a cutoff
+        float getRadius(float cutoff) const;
     private:
         glm::vec3 position;
         glm::vec4 color;
@@ -41,6 +62,14 @@ namespace zvlk {
         friend class Lights; 
     };
 
+    /*
+     * Lights are binned on the host into a grid of view space clusters, tiled in screen
+     * space and sliced exponentially in depth, so that every fragment only loops over
+     * lights which can reach its cluster. An attenuated light reaches as far as its
+     * contribution stays above the cutoff, by default one step of 8 bit color. This is
+     * an approximation: past the radius each light drops up to a cutoff times its color,
+     * which a cutoff of 0 avoids by shading every light everywhere, as before clustering.
+     */
     class Lights : public UniformBuffer {
     public:
         Lights() = delete;
@@ -49,16 +78,55 @@ namespace zvlk {
         virtual ~Lights();
         
         void addLight(zvlk::Light* light) {
-            if (this->lights.size() == MAX_LIGHTS) {
-                throw std::runtime_error("Maximum number of lights reached");
-            }
             this->lights.push_back(light);
         }
+
+        inline void setCamera(zvlk::Camera* camera) {
+            this->camera = camera;
+        }
+
+        inline size_t getLightsNumber() const {
+            return this->lights.size();
+        }
+
+        // fraction of a light's color below which it is not shaded, 0 shades every light everywhere
+        inline void setCutoff(float cutoff) {
+            this->cutoff = cutoff;
+        }
+
+        inline float getCutoff() const {
+            return this->cutoff;
+        }
+
+        // true once per reallocation of storage buffers of the image
+        bool wereBuffersReallocated(uint32_t index);
+
+        vk::DescriptorBufferInfo getLightsBufferInfo(uint32_t index);
+        vk::DescriptorBufferInfo getClustersBufferInfo(uint32_t index);
+        vk::DescriptorBufferInfo getLightIndicesBufferInfo(uint32_t index);
     protected:
         virtual void* update(uint32_t index, float time);
+        virtual void resize(uint32_t imagesNumber);
     private:
         std::vector<zvlk::Light*> lights;
         std::vector<LightsUBO> ubos;
+        std::shared_ptr<zvlk::Frame> frame;
+        zvlk::Camera* camera;
+        float cutoff;
+
+        zvlk::StorageBuffer* lightsBuffer;
+        zvlk::StorageBuffer* clustersBuffer;
+        zvlk::StorageBuffer* lightIndicesBuffer;
+        std::vector<uint8_t> reallocated;
+
+        std::vector<LightData> lightData;
+        std::vector<LightCluster> clusters;
+        std::vector<uint32_t> lightIndices;
+        // inclusive cluster ranges per light, as (x, y, z) minimum and maximum
+        std::vector<glm::uvec3> lightMinimums;
+        std::vector<glm::uvec3> lightMaximums;
+
+        void bin(LightsUBO& header);
     };
 
 }
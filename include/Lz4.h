@@ -0,0 +1,34 @@
+/* 
+ * File:   Lz4.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 01:10
+ */
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace zvlk {
+
+    /*
+     * LZ4 block format, without the frame around it. The compressor is the greedy
+     * single hash table one, fast rather than tight; the decompressor validates
+     * every length and offset, so damaged data throws instead of overrunning.
+     */
+    class Lz4 {
+    public:
+        Lz4() = delete;
+
+        static std::vector<uint8_t> compress(const uint8_t* source, size_t size);
+        // the decompressed size is not stored in a block, it has to be known
+        static void decompress(const uint8_t* source, size_t size, uint8_t* destination, size_t destinationSize);
+    private:
+        static void writeLength(std::vector<uint8_t>& output, size_t length);
+    };
+}
+#endif /* LZ4_H */
+
@@ -0,0 +1,42 @@
+/* 
+ * File:   MappedFile.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 00:30
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace zvlk {
+
+    /*
+     * Read only view of a whole file mapped into memory, pages are read by the
+     * system when they are touched, so large files are neither copied nor read
+     * through streams.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = delete;
+        MappedFile(const MappedFile& orig) = delete;
+        MappedFile(const std::string& path);
+        virtual ~MappedFile();
+
+        inline const uint8_t* getData() const {
+            return this->data;
+        }
+
+        inline size_t getSize() const {
+            return this->size;
+        }
+    private:
+        const uint8_t* data;
+        size_t size;
+    };
+}
+#endif /* MAPPEDFILE_H */
+
@@ -12,6 +12,7 @@
 #include "Texture.h"
 #include <glm/vec4.hpp>
 #include <vector>
+#include <memory>
 
 namespace zvlk {
 
@@ -30,12 +31,17 @@ namespace zvlk {
         virtual ~Material();
         
         vk::DescriptorImageInfo getDescriptorImageInfo(uint32_t index);
+
+        inline std::shared_ptr<zvlk::Texture> getTexture() const {
+            return this->diffuseTexture;
+        }
     protected:
         virtual void* update(uint32_t index, float time);
+        virtual void resize(uint32_t imagesNumber);
     private:
         std::vector<MaterialUBO> ubos;
         std::string name;
-        zvlk::Texture* diffuseTexture;
+        std::shared_ptr<zvlk::Texture> diffuseTexture;
     };
 
 }
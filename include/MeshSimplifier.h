@@ -0,0 +1,44 @@
+/* 
+ * File:   MeshSimplifier.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 01:40
+ */
+
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include "Model.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    /*
+     * Reduces triangles of model parts by quadric error edge collapses. A vertex is
+     * only ever moved onto one of its neighbours, so simplified parts are new index
+     * lists over the unchanged vertex buffer. Vertices on the boundary between parts
+     * are locked, texture seams and open borders only collapse along themselves, so
+     * parts of different materials still meet and seams do not tear.
+     */
+    class MeshSimplifier {
+    public:
+        MeshSimplifier() = delete;
+        MeshSimplifier(const MeshSimplifier& orig) = delete;
+        MeshSimplifier(const std::vector<zvlk::Vertex>& vertices, const std::vector<uint32_t>& indices, const std::vector<zvlk::ModelPart>& parts);
+        virtual ~MeshSimplifier();
+
+        // triangles of the part reduced towards the target count of indices, which may not be reached,
+        // error is set to the distance the surface may have moved, in model space
+        std::vector<uint32_t> simplify(const zvlk::ModelPart& part, size_t targetIndices, float& error) const;
+    private:
+        const std::vector<zvlk::Vertex>& vertices;
+        const std::vector<uint32_t>& indices;
+        // vertices of equal position share an id
+        std::vector<uint32_t> positionIds;
+        std::vector<uint8_t> lockedPositions;
+    };
+}
+#endif /* MESHSIMPLIFIER_H */
+
@@ -0,0 +1,69 @@
+/* 
+ * File:   MipChain.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 18 października 2026, 23:30
+ */
+
+#ifndef MIPCHAIN_H
+#define MIPCHAIN_H
+
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    enum class MipFilter {
+        // 2x2 average
+        eBox,
+        // windowed sinc kernels, sharper and slower
+        eKaiser,
+        eLanczos
+    };
+
+    /*
+     * Full chain of mip levels computed on the host, for any number of 8 bit channels
+     * per pixel. Every level is decimated from the previous one by a separable kernel
+     * in floating point, in linear space when the colour channels are sRGB encoded
+     * (alpha, the last of two or four channels, is always linear). Rows are filtered with SIMD
+     * instructions of BatchMath's instruction set and split between threads.
+     */
+    class MipChain {
+    public:
+        MipChain() = delete;
+        MipChain(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels,
+                MipFilter filter = MipFilter::eBox, bool srgb = false);
+        virtual ~MipChain();
+
+        inline uint32_t getLevelsNumber() const {
+            return static_cast<uint32_t> (this->levels.size());
+        }
+
+        inline uint32_t getWidth(uint32_t level) const {
+            return this->widths[level];
+        }
+
+        inline uint32_t getHeight(uint32_t level) const {
+            return this->heights[level];
+        }
+
+        inline uint32_t getChannels() const {
+            return this->channels;
+        }
+
+        inline const std::vector<uint8_t>& getLevel(uint32_t level) const {
+            return this->levels[level];
+        }
+
+        inline const std::vector<std::vector<uint8_t>>& getLevels() const {
+            return this->levels;
+        }
+    private:
+        uint32_t channels;
+        std::vector<uint32_t> widths;
+        std::vector<uint32_t> heights;
+        std::vector<std::vector<uint8_t>> levels;
+    };
+}
+#endif /* MIPCHAIN_H */
+
@@ -0,0 +1,71 @@
+/* 
+ * File:   MipmapGenerator.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 00:30
+ */
+
+#ifndef MIPMAPGENERATOR_H
+#define MIPMAPGENERATOR_H
+
+#include <vulkan/vulkan.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    class Device;
+    class ComputeShader;
+
+    enum class MipmapFilter {
+        eAverage, eMinimum, eMaximum
+    };
+
+    struct MipmapTarget {
+        vk::Image image;
+        // format of the storage views, for sRGB textures its UNORM alias, blits use the image as created
+        vk::Format format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipLevels;
+    };
+
+    /*
+     * Builds mip chains on the device with a compute shader. All levels of an image
+     * come from a single dispatch, a batch of images from one command buffer; filtering
+     * happens in linear space. Images need storage usage and, when sRGB, a mutable
+     * format, so that levels can be written through UNORM views. Other images get
+     * the chain of linear blits.
+     */
+    class MipmapGenerator {
+    public:
+        MipmapGenerator() = delete;
+        MipmapGenerator(const MipmapGenerator& orig) = delete;
+        MipmapGenerator(zvlk::Device* device);
+        virtual ~MipmapGenerator();
+
+        // false when the shader, a device feature or format support is missing, or the image is too large
+        inline bool isSupported(vk::Format format, uint32_t width, uint32_t height) {
+            return this->getUnsupportedReason(format, width, height).empty();
+        }
+        // why the images are left to blits, empty when they are not
+        std::string getUnsupportedReason(vk::Format format, uint32_t width, uint32_t height);
+        // level 0 of every target is in eTransferDstOptimal, all levels end in eShaderReadOnlyOptimal
+        void generate(const std::vector<MipmapTarget>& targets, MipmapFilter filter = MipmapFilter::eAverage, bool srgb = true);
+        // the same with a blit and two barriers per level, for formats with linear blitting and transfer source usage
+        void blit(const std::vector<MipmapTarget>& targets);
+    private:
+        zvlk::Device* device;
+        zvlk::ComputeShader* shader;
+        vk::DescriptorSetLayout descriptorSetLayout;
+        vk::PipelineLayout pipelineLayout;
+        std::map<std::pair<MipmapFilter, bool>, vk::Pipeline> pipelines;
+
+        vk::Pipeline getPipeline(MipmapFilter filter, bool srgb);
+    };
+}
+#endif /* MIPMAPGENERATOR_H */
+
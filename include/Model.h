@@ -14,14 +14,18 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
 
 #include <array>
+#include <unordered_map>
+#include <utility>
 
 #include "Device.h"
 #include "Frame.h"
 #include "Material.h"
+#include "BatchMath.h"
 
 namespace zvlk {
 
@@ -53,6 +57,16 @@ namespace zvlk {
     struct ModelPart {
         uint32_t numberOfIndices;
         uint32_t indexOffset;
+        // of the triangles at full detail, in model space
+        zvlk::Bounds bounds;
+    };
+
+    // simplified version of the whole model, over the same vertices, with a part for every part of level 0
+    struct ModelLod {
+        // how far the surface may be from the original one, in model space
+        float error;
+        uint32_t numberOfIndices;
+        std::unordered_map<zvlk::Material*, std::vector<ModelPart>> modelParts;
     };
 
     class Model {
@@ -60,6 +74,8 @@ namespace zvlk {
         Model() = delete;
         Model(const Model& orig) = delete;
         Model(zvlk::Device* device, const std::string name, std::shared_ptr<zvlk::Frame> frame);
+        // static models merged into one, with vertices transformed by the matrix of each and no simplified levels
+        Model(zvlk::Device* device, const std::vector<std::pair<zvlk::Model*, glm::mat4>>& sources);
         virtual ~Model();
 
         inline vk::Buffer getVertexBuffer() {
@@ -74,21 +90,38 @@ namespace zvlk {
             return this->materials;
         }
         
-        inline std::vector<zvlk::ModelPart>& getModelParts(zvlk::Material* material) {
-            return this->modelParts[material];
+        // level 0 is the model as loaded, each next one has about half of the triangles
+        inline std::vector<zvlk::ModelPart>& getModelParts(zvlk::Material* material, uint32_t lod = 0) {
+            return this->lods[lod].modelParts[material];
+        }
+
+        inline const std::vector<zvlk::ModelLod>& getLods() const {
+            return this->lods;
+        }
+
+        // axis aligned, in model space
+        inline const zvlk::Bounds& getBounds() const {
+            return this->bounds;
         }
 
     private:
         zvlk::Device* device;
-        std::unordered_map<zvlk::Material*, std::vector<ModelPart>> modelParts;
+        std::vector<zvlk::ModelLod> lods;
         std::vector<zvlk::Material*> materials;
+        // materials may be shared with other models through the asset cache
+        std::vector<std::shared_ptr<zvlk::Material>> materialReferences;
         
         std::vector<Vertex> vertices;
         std::vector<uint32_t> indices;
+        zvlk::Bounds bounds;
         vk::Buffer vertexBuffer;
         vk::Buffer indexBuffer;
         vk::DeviceMemory vertexBufferMemory;
         vk::DeviceMemory indexBufferMemory;
+
+        void computeBounds();
+        void generateLods();
+        void createBuffers(zvlk::Device* device);
     };
 }
 
@@ -0,0 +1,78 @@
+/* 
+ * File:   ObjParser.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 00:30
+ */
+
+#ifndef OBJPARSER_H
+#define OBJPARSER_H
+
+#include "Model.h"
+#include "FileSystem.h"
+
+#include <glm/vec3.hpp>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    struct ObjMaterial {
+        std::string name;
+        glm::vec3 ambient = glm::vec3(0.0f);
+        glm::vec3 diffuse = glm::vec3(0.0f);
+        glm::vec3 specular = glm::vec3(0.0f);
+        float shininess = 1.0f;
+        std::string diffuseTexture;
+    };
+
+    // consecutive indices drawn with one material, -1 when the faces have none
+    struct ObjRange {
+        int32_t material;
+        uint32_t indexOffset;
+        uint32_t numberOfIndices;
+    };
+
+    /*
+     * Wavefront OBJ and MTL reader producing vertex and index arrays ready for upload.
+     * The content, usually a mapped file, is split into chunks at line ends, chunks are
+     * parsed on separate threads and merged in file order, so the result does not
+     * depend on the number of threads. Polygons are triangulated as fans, equal
+     * vertices are stored once and texture coordinates are flipped for Vulkan.
+     */
+    class ObjParser {
+    public:
+        ObjParser() = delete;
+        ObjParser(const ObjParser& orig) = delete;
+        // material libraries are read through the file system, relative to the given directory
+        ObjParser(const zvlk::Blob& content, zvlk::FileSystem* fileSystem, const std::string& materialDirectory);
+        virtual ~ObjParser();
+
+        inline std::vector<zvlk::Vertex>& getVertices() {
+            return this->vertices;
+        }
+
+        inline std::vector<uint32_t>& getIndices() {
+            return this->indices;
+        }
+
+        inline std::vector<zvlk::ObjMaterial>& getMaterials() {
+            return this->materials;
+        }
+
+        inline std::vector<zvlk::ObjRange>& getRanges() {
+            return this->ranges;
+        }
+    private:
+        std::vector<zvlk::Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<zvlk::ObjMaterial> materials;
+        std::vector<zvlk::ObjRange> ranges;
+
+        void parseMaterials(const zvlk::Blob& content);
+    };
+}
+#endif /* OBJPARSER_H */
+
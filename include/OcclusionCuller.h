@@ -0,0 +1,138 @@
+/* 
+ * File:   OcclusionCuller.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 02:10
+ */
+
+#ifndef OCCLUSIONCULLER_H
+#define OCCLUSIONCULLER_H
+
+#include <vulkan/vulkan.hpp>
+
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    class Device;
+    class Frame;
+    class VertexShader;
+    class ComputeShader;
+
+    /*
+     * Hierarchical depth occlusion culling in two phases. Draws visible in the last
+     * frame are rendered first into a depth only pass, a pyramid of farthest depths
+     * is reduced from it and the bounds of every draw of this frame are tested
+     * against the pyramid in a compute pass, so only draws hidden behind geometry
+     * seen from the current camera are dropped. Results are written into indirect
+     * draw commands, which also become the occluders of the next frame.
+     *
+     * Draws have fixed slots, the engine fills commands and world bounds of a slot
+     * every frame and sets no instances for those outside the frustum.
+     */
+    class OcclusionCuller {
+    public:
+        OcclusionCuller() = delete;
+        OcclusionCuller(const OcclusionCuller& orig) = delete;
+        // pipeline layout is that of the engine, with the camera in set 0 and the model matrix in set 1
+        OcclusionCuller(zvlk::Device* device, std::shared_ptr<zvlk::Frame> frame, vk::PipelineLayout pipelineLayout, uint32_t drawsNumber);
+        virtual ~OcclusionCuller();
+
+        // false when the shaders or a format are missing, draws are then submitted directly
+        inline bool isSupported() const {
+            return this->supported;
+        }
+
+        // slots the buffers have room for
+        inline uint32_t getDrawsNumber() const {
+            return this->drawsNumber;
+        }
+
+        // host visible, written before the frame of the image is recorded
+        inline vk::DrawIndexedIndirectCommand* getCommands(uint32_t index) {
+            return this->commandsData[index];
+        }
+
+        // minimum and maximum corner of every slot
+        inline glm::vec4* getBounds(uint32_t index) {
+            return this->boundsData[index];
+        }
+
+        inline vk::Buffer getCommandsBuffer(uint32_t index) const {
+            return this->commandsBuffers[index];
+        }
+
+        inline vk::Buffer getOccludersBuffer() const {
+            return this->occludersBuffer;
+        }
+
+        // draws found occluded when the image was rendered last time, read once its fence is signaled
+        uint32_t getOccluded(uint32_t index);
+
+        // starts the depth pass, in which the engine draws every slot from the occluders buffer
+        void beginOccluders(vk::CommandBuffer commandBuffer);
+        // ends the depth pass, builds the pyramid and culls the slots of the image
+        void endOccluders(vk::CommandBuffer commandBuffer, uint32_t index, const glm::mat4& viewProj);
+    private:
+        zvlk::Device* device;
+        std::shared_ptr<zvlk::Frame> frame;
+        uint32_t drawsNumber;
+        bool supported;
+
+        zvlk::VertexShader* occluderShader;
+        zvlk::ComputeShader* pyramidShader;
+        zvlk::ComputeShader* cullShader;
+
+        vk::Format depthFormat;
+        vk::Image depthImage;
+        vk::DeviceMemory depthImageMemory;
+        vk::ImageView depthImageView;
+        vk::RenderPass renderPass;
+        vk::Framebuffer framebuffer;
+        vk::Pipeline occluderPipeline;
+
+        uint32_t pyramidWidth;
+        uint32_t pyramidHeight;
+        uint32_t pyramidLevels;
+        vk::Image pyramidImage;
+        vk::DeviceMemory pyramidImageMemory;
+        vk::ImageView pyramidView;
+        std::vector<vk::ImageView> pyramidLevelViews;
+        vk::Sampler sampler;
+
+        vk::DescriptorSetLayout pyramidLayout;
+        vk::PipelineLayout pyramidPipelineLayout;
+        vk::Pipeline pyramidPipeline;
+        vk::DescriptorSetLayout cullLayout;
+        vk::PipelineLayout cullPipelineLayout;
+        vk::Pipeline cullPipeline;
+        vk::DescriptorPool descriptorPool;
+        std::vector<vk::DescriptorSet> pyramidSets;
+        std::vector<vk::DescriptorSet> cullSets;
+
+        // per image, persistently mapped
+        std::vector<vk::Buffer> commandsBuffers;
+        std::vector<vk::DeviceMemory> commandsMemory;
+        std::vector<vk::DrawIndexedIndirectCommand*> commandsData;
+        std::vector<vk::Buffer> boundsBuffers;
+        std::vector<vk::DeviceMemory> boundsMemory;
+        std::vector<glm::vec4*> boundsData;
+        std::vector<vk::Buffer> statisticsBuffers;
+        std::vector<vk::DeviceMemory> statisticsMemory;
+        std::vector<uint32_t*> statisticsData;
+        // commands of the last culled frame
+        vk::Buffer occludersBuffer;
+        vk::DeviceMemory occludersMemory;
+
+        void createTargets();
+        void createPipelines(vk::PipelineLayout pipelineLayout);
+        void createBuffers();
+    };
+}
+#endif /* OCCLUSIONCULLER_H */
+
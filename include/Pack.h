@@ -0,0 +1,96 @@
+/* 
+ * File:   Pack.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 01:10
+ */
+
+#ifndef PACK_H
+#define PACK_H
+
+#include "FileSystem.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    class MappedFile;
+
+    enum class PackCompression : uint32_t {
+        eNone = 0,
+        eLz4 = 1
+    };
+
+    struct PackHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t entriesNumber;
+        // names of all entries, one after another, the index follows the header
+        uint64_t namesOffset;
+        uint64_t namesSize;
+    };
+
+    struct PackEntry {
+        uint64_t hash;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t originalSize;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        PackCompression compression;
+        uint32_t reserved;
+    };
+
+    /*
+     * Native archive of assets. The header is followed by an index of entries sorted
+     * by the hash of their names and by the names. Payloads start at page boundaries,
+     * so the file is mapped and uncompressed entries are handed out as views of the
+     * mapping without a copy. LZ4 entries are decompressed on read, the file system
+     * prefetches many of them in parallel.
+     */
+    class Pack : public Mount {
+    public:
+        Pack() = delete;
+        Pack(const Pack& orig) = delete;
+        Pack(const std::string& path);
+        virtual ~Pack();
+
+        bool exists(const std::string& name) override;
+        Blob read(const std::string& name) override;
+        std::vector<std::string> list() override;
+
+        static bool isPack(const uint8_t* content, size_t size);
+    private:
+        std::shared_ptr<zvlk::MappedFile> file;
+        const PackEntry* entries;
+        uint32_t entriesNumber;
+        const char* names;
+
+        const PackEntry* find(const std::string& name) const;
+    };
+
+    // builds packs, entries are compressed in parallel when written
+    class PackWriter {
+    public:
+        PackWriter();
+        PackWriter(const PackWriter& orig) = delete;
+        virtual ~PackWriter();
+
+        void add(const std::string& name, zvlk::Blob content, zvlk::PackCompression compression);
+        void write(const std::string& path) const;
+    private:
+
+        struct Input {
+            std::string name;
+            zvlk::Blob content;
+            zvlk::PackCompression compression;
+        };
+
+        std::vector<Input> inputs;
+    };
+}
+#endif /* PACK_H */
+
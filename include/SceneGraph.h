@@ -0,0 +1,76 @@
+/* 
+ * File:   SceneGraph.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 18 października 2026, 19:40
+ */
+
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    typedef uint32_t SceneNode;
+
+    const SceneNode NO_SCENE_NODE = UINT32_MAX;
+
+    /*
+     * Transform hierarchy kept as structure of arrays. Arrays are indexed in depth-first
+     * order, so a parent always precedes its children and every subtree is a contiguous
+     * range; nodes are addressed by stable handles mapped onto those indices.
+     */
+    class SceneGraph {
+    public:
+        SceneGraph();
+        SceneGraph(const SceneGraph& orig) = delete;
+        virtual ~SceneGraph();
+
+        // parent must be a live node, removed ones are rejected
+        SceneNode addNode(SceneNode parent = NO_SCENE_NODE);
+        // children of the removed node are attached to its parent
+        void removeNode(SceneNode node);
+        void setParent(SceneNode node, SceneNode parent);
+        void setLocal(SceneNode node, const glm::mat4& local);
+
+        const glm::mat4& getLocal(SceneNode node) const;
+        const glm::mat4& getWorld(SceneNode node) const;
+        const glm::mat4& getNormal(SceneNode node) const;
+
+        inline uint32_t getNodesNumber() const {
+            return static_cast<uint32_t> (this->parents.size());
+        }
+
+        // propagates dirty local matrices to world and normal matrices
+        void update();
+    private:
+        // per index, in depth-first order
+        std::vector<uint32_t> parents;
+        std::vector<uint32_t> subtreeSizes;
+        std::vector<glm::mat4> locals;
+        std::vector<glm::mat4> worlds;
+        std::vector<glm::mat4> normals;
+        std::vector<uint8_t> dirty;
+        std::vector<SceneNode> nodes;
+
+        // per handle
+        std::vector<uint32_t> indices;
+        std::vector<SceneNode> parentNodes;
+        std::vector<SceneNode> freeNodes;
+
+        bool orderChanged;
+        uint32_t dirtyCount;
+
+        void checkParent(SceneNode parent) const;
+        void sort();
+        void updateRange(uint32_t begin, uint32_t end);
+    };
+}
+#endif /* SCENEGRAPH_H */
+
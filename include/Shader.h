@@ -10,13 +10,16 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include "FileSystem.h"
+
 namespace zvlk {
 
     class Shader {
     protected:
         Shader() = delete;
         Shader(const Shader& orig) = delete;
-        Shader(vk::Device device, const char* name, vk::ShaderStageFlagBits stage);
+        // SPIR-V code, usually read through the file system of the device
+        Shader(vk::Device device, const zvlk::Blob& code, vk::ShaderStageFlagBits stage);
         virtual ~Shader();
         
     public:
@@ -0,0 +1,45 @@
+/* 
+ * File:   StorageBuffer.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 18 października 2026, 22:10
+ */
+
+#ifndef STORAGEBUFFER_H
+#define STORAGEBUFFER_H
+
+#include <vulkan/vulkan.hpp>
+
+#include "Device.h"
+#include "Frame.h"
+
+namespace zvlk {
+
+    /*
+     * Host visible storage buffer per swap chain image, growing on demand.
+     */
+    class StorageBuffer {
+    public:
+        StorageBuffer() = delete;
+        StorageBuffer(const StorageBuffer& orig) = delete;
+        StorageBuffer(zvlk::Device* device, vk::DeviceSize capacity, std::shared_ptr<zvlk::Frame> frame);
+        virtual ~StorageBuffer();
+
+        void create(std::shared_ptr<zvlk::Frame> frame);
+        void destroy();
+        // follows the number of images of a recreated swapchain, old buffers go once frames in flight complete
+        void resize(std::shared_ptr<zvlk::Frame> frame);
+        // returns true when the buffer was reallocated and descriptors pointing to it must be written again
+        bool write(uint32_t index, const void* content, vk::DeviceSize size);
+        vk::DescriptorBufferInfo getDescriptorBufferInfo(uint32_t index);
+    private:
+        zvlk::Device* device;
+        vk::DeviceSize initialCapacity;
+        std::vector<vk::DeviceSize> capacities;
+        std::vector<vk::Buffer> buffers;
+        std::vector<vk::DeviceMemory> buffersMemory;
+    };
+}
+
+#endif /* STORAGEBUFFER_H */
+
@@ -11,10 +11,12 @@
 #include <vulkan/vulkan.hpp>
 
 #include <string>
+#include <vector>
 
 namespace zvlk {
 
     class Device;
+    class TextureStreamer;
 
     class Texture {
     public:
@@ -22,16 +24,85 @@ namespace zvlk {
         Texture(const Texture& orig) = delete;
 
         Texture(Device* device, std::string texturePath);
+        // encoded image file already in memory
+        Texture(Device* device, const unsigned char* content, size_t size);
+        // only the smallest levels are loaded, the streamer uploads the others when they are needed
+        Texture(Device* device, std::vector<unsigned char> content, TextureStreamer* streamer);
         virtual ~Texture();
 
         vk::DescriptorImageInfo getDescriptorImageInfo(uint32_t index);
+
+        // cooked sibling of the image in a compressed format the device can sample, or empty
+        static std::string findCooked(Device* device, const std::string& texturePath);
+        // writes BC7, BC1 and ETC2 siblings of the image, each with its full mip chain
+        static void cook(const std::string& texturePath);
+
+        // bytes of device memory backing the image
+        inline vk::DeviceSize getSize() const {
+            return this->size;
+        }
+
+        inline vk::Image getImage() const {
+            return this->image;
+        }
+
+        inline uint32_t getWidth() const {
+            return this->width;
+        }
+
+        inline uint32_t getHeight() const {
+            return this->height;
+        }
+
+        inline vk::Format getFormat() const {
+            return this->format;
+        }
+
+        // channels stored per texel, the view swizzles fewer than four to RGBA
+        inline uint32_t getChannels() const {
+            return this->channels;
+        }
+
+        inline uint32_t getLevelsNumber() const {
+            return this->mipLevels;
+        }
+
+        // the most detailed level which can be sampled
+        inline uint32_t getResidentLevel() const {
+            return this->residentLevel;
+        }
+
+        // changes whenever the descriptor image info does
+        inline uint64_t getVersion() const {
+            return this->version;
+        }
+
+        void setResidentLevel(uint32_t level);
     private:
+        zvlk::Device* deviceObject;
         vk::Device device;
+        vk::Format format;
+        uint32_t channels;
         uint32_t mipLevels;
+        uint32_t width;
+        uint32_t height;
+        uint32_t residentLevel;
+        uint64_t version;
+        vk::DeviceSize size;
         vk::Image image;
         vk::ImageView imageView;
         vk::DeviceMemory imageMemory;
+        // owned by the asset cache of the device
         vk::Sampler sampler;
+        zvlk::TextureStreamer* streamer;
+
+        void updateSampler();
+        // KTX2 or an image format known to stb_image
+        void loadContent(Device* device, const unsigned char* content, size_t size);
+        void load(Device* device, unsigned char* pixels, int texWidth, int texHeight, int texChannels);
+        // a complete chain, compressed or filtered on the host, in one staging buffer and one copy
+        void loadLevels(Device* device, vk::Format format, uint32_t width, uint32_t height,
+                const std::vector<std::vector<uint8_t>>& levels, vk::ComponentMapping components = vk::ComponentMapping());
     };
 }
 #endif /* TEXTURE_H */
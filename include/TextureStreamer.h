@@ -0,0 +1,117 @@
+/* 
+ * File:   TextureStreamer.h
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 18 października 2026, 23:40
+ */
+
+#ifndef TEXTURESTREAMER_H
+#define TEXTURESTREAMER_H
+
+#include <vulkan/vulkan.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace zvlk {
+
+    class Device;
+    class Texture;
+
+    struct TextureStreamerStatistics {
+        uint64_t levelsUploaded = 0;
+        uint64_t bytesUploaded = 0;
+        // textures with requested levels which are not resident yet
+        uint32_t texturesPending = 0;
+    };
+
+    /*
+     * Streams mip levels of textures progressively. A texture starts with only its
+     * smallest levels resident, the encoded image is decoded into levels on worker
+     * threads and the levels the screen needs are uploaded a few per frame, within
+     * a byte budget, without waiting for the device. Residency follows the screen
+     * size requested for every texture during the frame.
+     */
+    class TextureStreamer {
+    public:
+        TextureStreamer() = delete;
+        TextureStreamer(const TextureStreamer& orig) = delete;
+        TextureStreamer(zvlk::Device* device);
+        virtual ~TextureStreamer();
+
+        void add(zvlk::Texture* texture, std::vector<unsigned char> content);
+        void remove(zvlk::Texture* texture);
+        // pixels covered on screen by a mesh sampling the texture, the largest request of a frame wins
+        void request(zvlk::Texture* texture, float pixels);
+        // retires finished uploads and records new ones, once per frame
+        void update();
+
+        inline bool isEnabled() const {
+            return this->budget > 0;
+        }
+
+        // bytes uploaded per frame, zero loads textures whole and synchronously
+        inline void setBudget(vk::DeviceSize budget) {
+            this->budget = budget;
+        }
+
+        inline vk::DeviceSize getBudget() const {
+            return this->budget;
+        }
+
+        inline const TextureStreamerStatistics& getStatistics() const {
+            return this->statistics;
+        }
+    private:
+
+        struct StreamedTexture {
+            zvlk::Texture* texture;
+            std::vector<unsigned char> content;
+            // of the decoded pixels, as the texture stores them
+            uint32_t channels;
+            // copied, so workers never read a texture removed while they decode
+            uint32_t levelsNumber;
+            // filled by a worker, guarded by the mutex until decoded is set
+            std::vector<std::vector<uint8_t>> levels;
+            bool decoded = false;
+            bool removed = false;
+            // lowest level recorded for upload, levels from here up to the resident one are in flight
+            uint32_t uploadedLevel;
+            float requestedPixels = 0.0f;
+        };
+
+        struct Upload {
+            vk::CommandBuffer commandBuffer;
+            vk::Fence fence;
+            vk::Buffer stagingBuffer;
+            vk::DeviceMemory stagingBufferMemory;
+            std::vector<std::pair<zvlk::Texture*, uint32_t>> levels;
+        };
+
+        zvlk::Device* device;
+        vk::DeviceSize budget;
+        std::unordered_map<zvlk::Texture*, std::shared_ptr<StreamedTexture>> textures;
+        std::list<Upload> uploads;
+        TextureStreamerStatistics statistics;
+
+        std::vector<std::thread> workers;
+        std::deque<std::shared_ptr<StreamedTexture>> queue;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping;
+
+        void work();
+        static std::vector<std::vector<uint8_t>> decode(const std::vector<unsigned char>& content, uint32_t channels);
+        void retire(bool wait);
+        uint32_t getWantedLevel(const StreamedTexture& streamed) const;
+    };
+}
+#endif /* TEXTURESTREAMER_H */
+
@@ -9,6 +9,7 @@
 #define TRANSFORMATIONMATRICES_H
 
 #include "UniformBuffer.h"
+#include "SceneGraph.h"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -21,6 +22,8 @@ namespace zvlk {
 
     struct TransformationMatricesUBO {
         glm::mat4 model;
+        // transpose of the inverse of the model 3x3, padded to mat4 for std140
+        glm::mat4 normal;
     };
 
     class TransformationMatrices : public UniformBuffer {
@@ -28,16 +31,30 @@ namespace zvlk {
         TransformationMatrices() = delete;
         TransformationMatrices(const TransformationMatrices& orig) = delete;
         TransformationMatrices(zvlk::Device* device, std::shared_ptr<zvlk::Frame> frame);
+        TransformationMatrices(zvlk::Device* device, std::shared_ptr<zvlk::Frame> frame,
+                zvlk::SceneGraph* sceneGraph, zvlk::TransformationMatrices* parent = nullptr);
         virtual ~TransformationMatrices();
         
         TransformationMatrices& rotate(float angleDegrees, glm::vec3 direction);
         TransformationMatrices& translate(glm::vec3 vector);
         TransformationMatrices& scale(glm::vec3 vector);
+
+        inline zvlk::SceneNode getSceneNode() const {
+            return this->sceneNode;
+        }
+
+        const glm::mat4& getModelMatrix() const;
     protected:
         void* update(uint32_t index, float time);
+        void resize(uint32_t imagesNumber);
     private:
         std::vector<TransformationMatricesUBO> ubos;
         glm::mat4 current;
+        glm::mat4 currentNormal;
+        zvlk::SceneGraph* sceneGraph;
+        zvlk::SceneNode sceneNode;
+
+        void apply(const glm::mat4& transformation);
     };
 }
 #endif /* TRANSFORMATIONMATRICES_H */
@@ -24,11 +24,15 @@ namespace zvlk {
         
         void create(std::shared_ptr<zvlk::Frame> frame);
         void destroy();
+        // follows the number of images of a recreated swapchain, old buffers go once frames in flight complete
+        void resize(std::shared_ptr<zvlk::Frame> frame);
         void update(uint32_t index);
         vk::DeviceSize getSize();
         vk::DescriptorBufferInfo getDescriptorBufferInfo(uint32_t frame);
     protected:
         virtual void* update(uint32_t index, float time) = 0;
+        // host copies per image, every image is updated right after
+        virtual void resize(uint32_t imagesNumber) = 0;
     private:
         zvlk::Device* device;
         vk::DeviceSize size;
@@ -26,6 +26,7 @@ namespace zvlk {
         Window(const Window& orig) = delete;
         virtual ~Window();
 
+        // blocks only while the framebuffer is empty, as when minimized
         void waitResize();
         std::tuple<int, int> getSize();
         bool isClosed();
@@ -36,6 +37,11 @@ namespace zvlk {
     private:
         GLFWwindow *window;
         WindowCallback *callback;
+        // restored when leaving fullscreen
+        int windowedX;
+        int windowedY;
+        int windowedWidth;
+        int windowedHeight;
     };
 
 }
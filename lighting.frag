@@ -0,0 +1,116 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform CameraUbo {
+    mat4 view;
+    mat4 proj;
+    vec3 eye;
+    vec3 center;
+    mat4 viewProj;
+    mat4 invViewProj;
+} cameraUbo;
+
+struct Light {
+  vec3 position;
+  vec4 color;
+  float attenuation;
+};
+
+layout(set = 0, binding = 1) uniform LightsUbo {
+    uint numberOfLights;
+    uint numberOfGlobalLights;
+    uint clustersX;
+    uint clustersY;
+    uint clustersZ;
+    float near;
+    float far;
+    float width;
+    float height;
+} lightsUbo;
+
+layout(std430, set = 0, binding = 2) readonly buffer LightsBuffer {
+    Light lights[];
+} lightsBuffer;
+
+layout(std430, set = 0, binding = 3) readonly buffer ClustersBuffer {
+    uvec2 clusters[];
+} clustersBuffer;
+
+layout(std430, set = 0, binding = 4) readonly buffer LightIndicesBuffer {
+    uint indices[];
+} lightIndicesBuffer;
+
+layout(input_attachment_index = 0, set = 1, binding = 0) uniform subpassInput inputAlbedo;
+layout(input_attachment_index = 1, set = 1, binding = 1) uniform subpassInput inputNormal;
+layout(input_attachment_index = 2, set = 1, binding = 2) uniform subpassInput inputSpecular;
+layout(input_attachment_index = 3, set = 1, binding = 3) uniform subpassInput inputAmbient;
+layout(input_attachment_index = 4, set = 1, binding = 4) uniform subpassInput inputDepth;
+
+vec3 position;
+vec3 normal;
+vec3 viewDirection;
+vec3 albedo;
+vec3 specularColor;
+vec3 ambient;
+float shiness;
+
+vec4 shade(uint lightIndex) {
+    Light light = lightsBuffer.lights[lightIndex];
+
+    //diffuse
+    vec3 lightDirection = normalize(light.position - position);
+    float diffuse = max(dot(normal, lightDirection), 0.0);
+
+    //specular
+    vec3 reflectDirection = reflect(-lightDirection, normal);
+    float specular = pow(max(dot(viewDirection, reflectDirection), 0.0), shiness);
+
+    //attenuation
+    float distance = length(light.position - position);
+    float attenuation = min(light.attenuation > 0 ? 1.0 / (light.attenuation * distance * distance) : 1.0, 1.0);
+
+    //total
+    return vec4(0.1 * ambient + diffuse * albedo + specular * specularColor, 1.0) * light.color * attenuation;
+}
+
+void main() {
+    float depth = subpassLoad(inputDepth).r;
+    if (depth >= 1.0) {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    // geometry was rasterized with a flipped viewport, so rows grow with decreasing NDC y
+    vec2 screen = gl_FragCoord.xy / vec2(lightsUbo.width, lightsUbo.height);
+    vec4 world = cameraUbo.invViewProj * vec4(screen.x * 2.0 - 1.0, 1.0 - screen.y * 2.0, depth, 1.0);
+    position = world.xyz / world.w;
+
+    vec4 normalShiness = subpassLoad(inputNormal);
+    normal = normalize(normalShiness.xyz);
+    shiness = normalShiness.w;
+    albedo = subpassLoad(inputAlbedo).rgb;
+    specularColor = subpassLoad(inputSpecular).rgb;
+    ambient = subpassLoad(inputAmbient).rgb;
+    viewDirection = normalize(cameraUbo.eye - position);
+
+    outColor = vec4(0.0);
+
+    for (uint i = 0; i < lightsUbo.numberOfGlobalLights; ++i) {
+        outColor += shade(lightIndicesBuffer.indices[i]);
+    }
+
+    //cluster of the pixel, the same grid as lights are binned into
+    float viewDepth = -(cameraUbo.view * vec4(position, 1.0)).z;
+    uint slice = uint(clamp(log(viewDepth / lightsUbo.near) / log(lightsUbo.far / lightsUbo.near) * lightsUbo.clustersZ,
+            0.0, lightsUbo.clustersZ - 1.0));
+    uvec2 tile = min(uvec2(screen * vec2(lightsUbo.clustersX, lightsUbo.clustersY)),
+            uvec2(lightsUbo.clustersX - 1, lightsUbo.clustersY - 1));
+    uvec2 cluster = clustersBuffer.clusters[(slice * lightsUbo.clustersY + tile.y) * lightsUbo.clustersX + tile.x];
+
+    for (uint i = cluster.x; i < cluster.x + cluster.y; ++i) {
+        outColor += shade(lightIndicesBuffer.indices[i]);
+    }
+    outColor = vec4(outColor.xyz, 1.0);
+}
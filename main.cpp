@@ -5,8 +5,11 @@
 #include <chrono>
 #include <sstream>
 #include <iomanip>
-#include <zip.h>
-#include <fstream>
+#include <random>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
 
 #include "Window.h"
 #include "Vulkan.h"
@@ -16,8 +19,13 @@
 #include "VertexShader.h"
 #include "FragmentShader.h"
 #include "TransformationMatrices.h"
+#include "SceneGraph.h"
 #include "Engine.h"
 #include "Camera.h"
+#include "AssetCache.h"
+#include "TextureStreamer.h"
+#include "FileSystem.h"
+#include "Pack.h"
 
 #ifdef NDEBUG
 const bool enableValidationLayers = false;
@@ -28,6 +36,16 @@ const bool enableValidationLayers = true;
 class BallApplication : public zvlk::WindowCallback, zvlk::DeviceAssessment, zvlk::EngineCallback {
 public:
 
+    // additional lights scattered around the room, to stress the light clustering
+    // a negative texture budget keeps the default of the streamer
+    // a negative light cutoff keeps the default of the lights
+    explicit BallApplication(uint32_t stressLights = 0, bool deferred = false, int64_t textureBudget = -1, float lodThreshold = 1.0f,
+            bool occlusionCulling = true, bool depthPrepass = false, zvlk::AntiAliasing antiAliasing = zvlk::AntiAliasing::eMsaa,
+            vk::SampleCountFlagBits sampleCount = vk::SampleCountFlagBits::e4, float lightCutoff = -1.0f) :
+    stressLights(stressLights), deferred(deferred), textureBudget(textureBudget), lodThreshold(lodThreshold), occlusionCulling(occlusionCulling),
+    depthPrepass(depthPrepass), antiAliasing(antiAliasing), sampleCount(sampleCount), lightCutoff(lightCutoff) {
+    }
+
     void run() {
         init();
         mainLoop();
@@ -43,6 +61,13 @@ private:
     zvlk::Model* ball;
     zvlk::VertexShader *vertexShader;
     zvlk::FragmentShader *fragmentShader;
+    zvlk::VertexShader *lightingVertexShader = nullptr;
+    zvlk::FragmentShader *lightingFragmentShader = nullptr;
+    zvlk::VertexShader *prepassVertexShader = nullptr;
+    // loaded once FXAA is first selected
+    zvlk::VertexShader *postVertexShader = nullptr;
+    zvlk::FragmentShader *fxaaFragmentShader = nullptr;
+    zvlk::SceneGraph* sceneGraph;
     zvlk::TransformationMatrices *transformationMatrices;
     zvlk::TransformationMatrices *ballTransformationMatrices;
     zvlk::Engine* engine;
@@ -52,6 +77,19 @@ private:
     bool framebufferResized = false;
     float ballFallingSpeed = 0.0f;
     float ballDistance = 0.0f;
+    uint32_t stressLights;
+    bool deferred;
+    int64_t textureBudget;
+    float lodThreshold;
+    bool occlusionCulling;
+    bool depthPrepass;
+    zvlk::AntiAliasing antiAliasing;
+    vk::SampleCountFlagBits sampleCount;
+    float lightCutoff;
+    // places the stress lights, L doubles them while running
+    std::mt19937 random{7};
+    // sum of GPU times and frames measured for every number of lights and anti-aliasing mode
+    std::map<std::pair<uint32_t, std::string>, std::pair<double, uint64_t>> gpuTimes;
 
     void init() {
         this->window = std::shared_ptr<zvlk::Window>(new zvlk::Window(800, 600, std::string("Vulkan"), dynamic_cast<WindowCallback*> (this)));
@@ -60,35 +98,124 @@ private:
         this->vulkan->addSurface(this->window);
         this->device = this->vulkan->getDevice(this);
 
+        // models are read straight from their archives, nothing is extracted to disk
+        zvlk::FileSystem* fileSystem = this->device->getFileSystem();
+        fileSystem->mountArchive("ball.zip");
+        fileSystem->mountArchive("room.zip");
+        // built by `make pack`, shadows the loose files and archives above
+        if (std::filesystem::is_regular_file("assets.pack")) {
+            fileSystem->mountPack("assets.pack");
+        }
+        auto loadStart = std::chrono::high_resolution_clock::now();
+        std::vector<std::string> prefetched = {"room.obj", "room.mtl", "ball.obj", "ball.mtl", "vert.spv"};
+        if (this->deferred) {
+            prefetched.insert(prefetched.end(),{"gbuffer.spv", "lighting_vert.spv", "lighting_frag.spv"});
+        } else {
+            prefetched.push_back("frag.spv");
+        }
+        if (this->depthPrepass) {
+            prefetched.push_back("prepass.spv");
+        }
+        if (this->antiAliasing == zvlk::AntiAliasing::eFxaa) {
+            prefetched.insert(prefetched.end(),{"lighting_vert.spv", "fxaa.spv"});
+        }
+        fileSystem->prefetch(prefetched);
+
         this->frame = this->vulkan->initializeDeviceForGraphics(this->device);
         this->frame->attachWindow(this->window);
+        this->frame->setAntiAliasing(this->antiAliasing, this->sampleCount);
+        if (this->deferred) {
+            this->frame->setRenderMode(zvlk::RenderMode::eDeferred);
+        }
+        // nothing has been rendered yet, so the frame of the defaults goes at once
+        this->frame->destroy();
+        this->frame->create(this->device, this->vulkan->getSurface());
+
+        if (this->textureBudget >= 0) {
+            this->device->getTextureStreamer()->setBudget(static_cast<vk::DeviceSize> (this->textureBudget));
+        }
+
+        this->room = new zvlk::Model(this->device, "room.obj", this->frame);
+        this->ball = new zvlk::Model(this->device, "ball.obj", this->frame);
 
-        this->room = new zvlk::Model(this->device, "/tmp/room.obj", this->frame);
-        this->ball = new zvlk::Model(this->device, "/tmp/ball.obj", this->frame);
+        const zvlk::AssetCacheStatistics& cacheStatistics = this->device->getAssetCache()->getStatistics();
+        std::cout << "Asset cache: " << cacheStatistics.texturesLoaded << " textures loaded, " << cacheStatistics.textureHits << " reused, "
+                << cacheStatistics.materialsCreated << " materials created, " << cacheStatistics.materialHits << " reused, "
+                << cacheStatistics.bytesSaved << " bytes saved" << std::endl;
+        this->device->getAssetCache()->reportMemory(std::cout);
 
-        this->vertexShader = new zvlk::VertexShader(this->device->getGraphicsDevice(), "vert.spv");
-        this->fragmentShader = new zvlk::FragmentShader(this->device->getGraphicsDevice(), "frag.spv");
+        this->vertexShader = new zvlk::VertexShader(this->device->getGraphicsDevice(), fileSystem->read("vert.spv"));
+        this->fragmentShader = new zvlk::FragmentShader(this->device->getGraphicsDevice(), fileSystem->read(this->deferred ? "gbuffer.spv" : "frag.spv"));
+        if (this->deferred) {
+            this->lightingVertexShader = new zvlk::VertexShader(this->device->getGraphicsDevice(), fileSystem->read("lighting_vert.spv"));
+            this->lightingFragmentShader = new zvlk::FragmentShader(this->device->getGraphicsDevice(), fileSystem->read("lighting_frag.spv"));
+        }
+        if (this->depthPrepass) {
+            this->prepassVertexShader = new zvlk::VertexShader(this->device->getGraphicsDevice(), fileSystem->read("prepass.spv"));
+        }
+        auto loadEnd = std::chrono::high_resolution_clock::now();
+        std::cout << "Assets loaded in " << std::chrono::duration<float, std::chrono::milliseconds::period>(loadEnd - loadStart).count()
+                << " ms" << std::endl;
 
         this->camera = new zvlk::Camera(device, frame, glm::vec3(10.0f, 10.0f, 10.0f),
                 glm::vec3(0.0f, 0.0f, 0.0f), 45.0f, glm::vec3(0.0f, 1.0f, 0.0f), 0.1f, 2500.0f);
-        this->transformationMatrices = new zvlk::TransformationMatrices(this->device, this->frame);
+        this->sceneGraph = new zvlk::SceneGraph();
+        this->transformationMatrices = new zvlk::TransformationMatrices(this->device, this->frame, this->sceneGraph);
         this->transformationMatrices->scale(glm::vec3(10, 10, 10));
-        this->ballTransformationMatrices = new zvlk::TransformationMatrices(this->device, this->frame);
+        this->ballTransformationMatrices = new zvlk::TransformationMatrices(this->device, this->frame, this->sceneGraph);
 
         this->engine = new zvlk::Engine(this->frame, this->device);
         this->engine->setCamera(this->camera);
+        this->engine->setLodThreshold(this->lodThreshold);
+        this->engine->setOcclusionCulling(this->occlusionCulling);
         this->engine->attachLight(new zvlk::Light({10.0f, 10.0f, 10.0f},
         {
             1.0f, 1.0f, 1.0f, 1.0f
         }, 0.0f));
+        if (this->lightCutoff >= 0.0f) {
+            this->engine->setLightCutoff(this->lightCutoff);
+        }
+        this->scatterLights(this->stressLights);
         this->engine->enableShaders(*this->vertexShader, *this->fragmentShader);
-        this->engine->draw(*this->room, *this->transformationMatrices);
+        if (this->deferred) {
+            this->engine->enableDeferredLighting(*this->lightingVertexShader, *this->lightingFragmentShader);
+        }
+        if (this->depthPrepass) {
+            this->engine->enableDepthPrepass(*this->prepassVertexShader);
+        }
+        if (this->antiAliasing == zvlk::AntiAliasing::eFxaa) {
+            this->enablePostProcess();
+        }
+        // the room never moves, so it is drawn from a batch of pre-transformed geometry
+        this->engine->drawStatic(*this->room, *this->transformationMatrices);
         this->engine->draw(*this->ball, *this->ballTransformationMatrices);
+        // static batches are built from world matrices
+        this->sceneGraph->update();
         this->engine->compile();
 
+        const zvlk::DescriptorAllocatorStatistics& descriptorStatistics = this->engine->getDescriptorStatistics();
+        std::cout << "Descriptors: " << descriptorStatistics.pools << " pools, " << descriptorStatistics.setsAllocated << " sets allocated, "
+                << descriptorStatistics.setsShared << " shared, " << descriptorStatistics.setsWritten << " written in "
+                << descriptorStatistics.writeMilliseconds << " ms" << std::endl;
+        zvlk::AttachmentStatistics attachmentStatistics = this->frame->getAttachmentStatistics();
+        std::cout << "Attachments: " << attachmentStatistics.allocated / (1024 * 1024) << " MB, "
+                << attachmentStatistics.lazilyAllocated / (1024 * 1024) << " MB lazily allocated" << std::endl;
+
         this->engine->addCallback(this);
     }
 
+    void scatterLights(uint32_t count) {
+        std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> intensity(0.05f, 0.5f);
+        std::uniform_real_distribution<float> attenuation(2.0f, 10.0f);
+        for (uint32_t i = 0; i < count; ++i) {
+            this->engine->attachLight(new zvlk::Light({position(this->random), position(this->random) * 0.5f + 5.0f, position(this->random)},
+            {
+                intensity(this->random), intensity(this->random), intensity(this->random), 1.0f
+            }, attenuation(this->random)));
+        }
+    }
+
     int assess(zvlk::Device* device) {
         const vk::PhysicalDeviceProperties& deviceProperties = device->getProperties();
         const vk::PhysicalDeviceFeatures& deviceFeatures = device->getFeatures();
@@ -150,21 +277,39 @@ private:
 
         startTime = currentTime;
 
+        this->sceneGraph->update();
         static_cast<zvlk::UniformBuffer*> (this->transformationMatrices)->update(frameIndex);
         static_cast<zvlk::UniformBuffer*> (this->ballTransformationMatrices)->update(frameIndex);
         static_cast<zvlk::UniformBuffer*> (this->camera)->update(frameIndex);
     }
 
+    void enablePostProcess() {
+        if (this->postVertexShader != nullptr) {
+            return;
+        }
+        zvlk::FileSystem* fileSystem = this->device->getFileSystem();
+        this->postVertexShader = new zvlk::VertexShader(this->device->getGraphicsDevice(), fileSystem->read("lighting_vert.spv"));
+        this->fxaaFragmentShader = new zvlk::FragmentShader(this->device->getGraphicsDevice(), fileSystem->read("fxaa.spv"));
+        this->engine->enablePostProcess(*this->postVertexShader, *this->fxaaFragmentShader);
+    }
+
     void recreateSwapChain() {
+        // no swapchain can have an empty extent, rendering stops while the window is minimized
         this->window->waitResize();
 
-        this->device->getGraphicsDevice().waitIdle();
-
-        this->frame->destroy();
-        this->engine->clean();
+        // switched to with M, the shaders are read here rather than in the key callback
+        if (this->frame->getAntiAliasing() == zvlk::AntiAliasing::eFxaa) {
+            this->enablePostProcess();
+        }
 
-        this->frame->create(this->device, this->vulkan->getSurface());
-        this->engine->compile();
+        // the old swapchain is handed over to the new one and retired with the attachments once
+        // frames in flight complete, so rendering goes on without waiting for the device
+        if (this->frame->recreate(this->vulkan->getSurface())) {
+            this->engine->resize();
+        } else {
+            this->engine->clean();
+            this->engine->compile();
+        }
 
         this->framebufferResized = false;
     }
@@ -181,12 +326,37 @@ private:
                 this->recreateSwapChain();
             }
 
+            const zvlk::EngineStatistics& statistics = this->engine->getStatistics();
+            if (statistics.gpuMilliseconds > 0.0f) {
+                std::pair<double, uint64_t>& gpuTime = this->gpuTimes[{this->stressLights + 1, this->antiAliasingName()}];
+                gpuTime.first += statistics.gpuMilliseconds;
+                gpuTime.second++;
+            }
+
             auto currentTime = std::chrono::high_resolution_clock::now();
             float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
             frames = frames + 1;
 
+            // lazily allocated attachments take memory only when they spill out of tile memory
+            zvlk::AttachmentStatistics attachments = this->frame->getAttachmentStatistics();
             std::ostringstream ss;
-            ss << std::fixed << std::setprecision(2) << static_cast<float> (frames) / time << " FPS";
+            ss << std::fixed << std::setprecision(2) << static_cast<float> (frames) / time << " FPS, "
+                    << this->stressLights + 1 << " lights (L doubles), "
+                    << this->device->getTextureStreamer()->getStatistics().texturesPending << " textures streaming, "
+                    << this->engine->getStatistics().trianglesSubmitted << " triangles ("
+                    << this->engine->getStatistics().trianglesWithoutLod << " without LOD), "
+                    << this->engine->getStatistics().drawsFrustumCulled << " draws outside frustum, "
+                    << this->engine->getStatistics().drawsOccluded << " occluded, "
+                    << this->engine->getStatistics().fragmentInvocations << " fragments shaded, "
+                    << this->engine->getStatistics().drawCalls << " draws, "
+                    << this->engine->getStatistics().pipelineBinds + this->engine->getStatistics().descriptorSetBinds
+                    + this->engine->getStatistics().bufferBinds << " binds ("
+                    << this->engine->getStatistics().bindsSkipped << " skipped), "
+                    << this->device->getDestructionStatistics().pending << " objects awaiting destruction, "
+                    << (attachments.allocated - attachments.lazilyAllocated + attachments.committed) / (1024 * 1024) << " MB of "
+                    << attachments.allocated / (1024 * 1024) << " MB attachments committed, "
+                    << this->antiAliasingName() << " (M switches) " << statistics.gpuMilliseconds << " ms GPU, "
+                    << statistics.postProcessMilliseconds << " ms post-process";
             glfwSetWindowTitle(this->window->getWindow(), ss.str().data());
 
             if (frames == 100) {
@@ -195,7 +365,27 @@ private:
             }
         }
 
-        device->getGraphicsDevice().waitIdle();
+        this->device->waitIdle();
+
+        for (const auto& gpuTime : this->gpuTimes) {
+            std::cout << gpuTime.first.first << " lights, " << gpuTime.first.second << ": " << gpuTime.second.first / gpuTime.second.second
+                    << " ms GPU per frame over " << gpuTime.second.second << " frames" << std::endl;
+        }
+    }
+
+    std::string antiAliasingName() {
+        std::ostringstream name;
+        switch (this->frame->getAntiAliasing()) {
+            case zvlk::AntiAliasing::eFxaa:
+                return "FXAA";
+            case zvlk::AntiAliasing::eMsaaSampleShading:
+                name << "MSAA " << static_cast<uint32_t> (this->frame->getSampleCount()) << "x, "
+                        << this->frame->getMinSampleShading() << " sample shading";
+                return name.str();
+            default:
+                name << "MSAA " << static_cast<uint32_t> (this->frame->getSampleCount()) << "x";
+                return name.str();
+        }
     }
 
     void cleanup() {
@@ -203,10 +393,16 @@ private:
 
         delete this->vertexShader;
         delete this->fragmentShader;
+        delete this->lightingVertexShader;
+        delete this->lightingFragmentShader;
+        delete this->prepassVertexShader;
+        delete this->postVertexShader;
+        delete this->fxaaFragmentShader;
 
         delete this->camera;
         delete this->transformationMatrices;
         delete this->ballTransformationMatrices;
+        delete this->sceneGraph;
         delete this->room;
         delete this->ball;
     }
@@ -220,6 +416,16 @@ private:
 
         if (key == GLFW_KEY_F && action == GLFW_PRESS) {
             window->toggleFullscreen();
+        } else if (key == GLFW_KEY_M && action == GLFW_PRESS) {
+            // next anti-aliasing mode, the frame is recreated with it before the next frame
+            this->antiAliasing = static_cast<zvlk::AntiAliasing> ((static_cast<int> (this->antiAliasing) + 1) % 3);
+            this->frame->setAntiAliasing(this->antiAliasing, this->sampleCount);
+            this->framebufferResized = true;
+        } else if (key == GLFW_KEY_L && action == GLFW_PRESS) {
+            // binned with the others from the next frame on
+            uint32_t added = this->stressLights + 1;
+            this->scatterLights(added);
+            this->stressLights += added;
         } else if ((key == GLFW_KEY_A || key == GLFW_KEY_D || key == GLFW_KEY_W || key == GLFW_KEY_S)
                 && action == GLFW_RELEASE) {
             this->lastKeys.erase(key);
@@ -229,40 +435,108 @@ private:
 
 };
 
-int inflateModel(std::string source, std::string dest) {
-    int errorp;
-    zip_t* zipSource = zip_open((source + ".zip").data(), ZIP_RDONLY, &errorp);
-    if (zipSource == NULL) {
-        return errorp;
-    }
-
-    for (auto ext :{".obj", ".mtl"}) {
-        zip_file_t* sourceFile = zip_fopen(zipSource, (source + ext).data(), ZIP_FL_UNCHANGED);
-
-        zip_stat_t stat;
-        if (zip_stat(zipSource, (source + ext).data(), ZIP_FL_UNCHANGED, &stat) == -1) {
-            return -1;
-        }
-
-        char* buffer = new char[stat.size];
-        if (zip_fread(sourceFile, buffer, stat.size) == -1) {
-            return -1;
+int main(int argc, char** argv) {
+    uint32_t stressLights = 0;
+    bool deferred = false;
+    int64_t textureBudget = -1;
+    float lodThreshold = 1.0f;
+    bool occlusionCulling = true;
+    bool depthPrepass = false;
+    zvlk::AntiAliasing antiAliasing = zvlk::AntiAliasing::eMsaa;
+    vk::SampleCountFlagBits sampleCount = vk::SampleCountFlagBits::e4;
+    float lightCutoff = -1.0f;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--cook") == 0) {
+            // offline step: compress the given images next to them and quit
+            try {
+                for (int j = i + 1; j < argc; ++j) {
+                    zvlk::Texture::cook(argv[j]);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+            return EXIT_SUCCESS;
+        } else if (std::strcmp(argv[i], "--pack") == 0 && i + 1 < argc) {
+            // offline step: --pack output [--lz4] inputs..., archives and directories are added with all their files
+            try {
+                std::string output = argv[i + 1];
+                zvlk::PackCompression compression = zvlk::PackCompression::eNone;
+                zvlk::FileSystem inputs;
+                zvlk::PackWriter writer;
+                for (int j = i + 2; j < argc; ++j) {
+                    std::string input = argv[j];
+                    zvlk::Mount* mount = nullptr;
+                    if (input == "--lz4") {
+                        compression = zvlk::PackCompression::eLz4;
+                        continue;
+                    } else if (std::filesystem::is_directory(input)) {
+                        mount = inputs.mountDirectory(input);
+                    } else if (std::filesystem::path(input).extension() == ".zip") {
+                        mount = inputs.mountArchive(input);
+                    }
+                    if (mount) {
+                        for (const std::string& name : mount->list()) {
+                            writer.add(name, mount->read(name), compression);
+                        }
+                    } else {
+                        writer.add(std::filesystem::path(input).filename().generic_string(), inputs.read(input), compression);
+                    }
+                }
+                writer.write(output);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+            return EXIT_SUCCESS;
+        } else if (std::strcmp(argv[i], "--lights") == 0 && i + 1 < argc) {
+            stressLights = static_cast<uint32_t> (std::stoul(argv[++i]));
+        } else if (std::strcmp(argv[i], "--light-cutoff") == 0 && i + 1 < argc) {
+            // fraction of their color below which lights are not shaded, 1/256 by default, 0 shades every light everywhere
+            lightCutoff = std::stof(argv[++i]);
+            if (lightCutoff < 0.0f || lightCutoff >= 1.0f) {
+                std::cerr << "--light-cutoff must be from 0 to below 1" << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (std::strcmp(argv[i], "--deferred") == 0) {
+            deferred = true;
+        } else if (std::strcmp(argv[i], "--texture-budget") == 0 && i + 1 < argc) {
+            // KiB uploaded per frame, 0 loads every texture whole
+            textureBudget = static_cast<int64_t> (std::stoll(argv[++i])) * 1024;
+        } else if (std::strcmp(argv[i], "--lod-threshold") == 0 && i + 1 < argc) {
+            // pixels of error allowed for simplified models, 0 draws full detail
+            lodThreshold = std::stof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-occlusion") == 0) {
+            occlusionCulling = false;
+        } else if (std::strcmp(argv[i], "--prepass") == 0) {
+            // compare fragments shaded in the title with and without it
+            depthPrepass = true;
+        } else if (std::strcmp(argv[i], "--aa") == 0 && i + 1 < argc) {
+            // msaa, msaa-shading or fxaa, M cycles through them while running
+            std::string mode = argv[++i];
+            if (mode == "fxaa") {
+                antiAliasing = zvlk::AntiAliasing::eFxaa;
+            } else if (mode == "msaa-shading") {
+                antiAliasing = zvlk::AntiAliasing::eMsaaSampleShading;
+            } else if (mode == "msaa") {
+                antiAliasing = zvlk::AntiAliasing::eMsaa;
+            } else {
+                std::cerr << "--aa must be msaa, msaa-shading or fxaa" << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            // highest supported count up to this one is used
+            unsigned long samples = std::stoul(argv[++i]);
+            if (samples == 0 || samples > 64 || (samples & (samples - 1)) != 0) {
+                std::cerr << "--samples must be a power of two from 1 to 64" << std::endl;
+                return EXIT_FAILURE;
+            }
+            sampleCount = static_cast<vk::SampleCountFlagBits> (samples);
         }
-
-        std::ofstream output((dest + source + ext).data(), std::ios::out | std::ios::binary);
-        output.write(buffer, stat.size);
-        output.close();
-
-        delete[] buffer;
     }
-    return 0;
-}
-
-int main() {
-    inflateModel("ball", "/tmp/");
-    inflateModel("room", "/tmp/");
 
-    BallApplication app;
+    BallApplication app(stressLights, deferred, textureBudget, lodThreshold, occlusionCulling, depthPrepass, antiAliasing, sampleCount,
+            lightCutoff);
 
     try {
         app.run();
@@ -35,16 +35,37 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/AssetCache.o \
+	${OBJECTDIR}/BatchMath.o \
+	${OBJECTDIR}/BlockCompressor.o \
 	${OBJECTDIR}/Camera.o \
+	${OBJECTDIR}/CommandRecorder.o \
+	${OBJECTDIR}/ComputeShader.o \
+	${OBJECTDIR}/DescriptorAllocator.o \
+	${OBJECTDIR}/DescriptorCache.o \
 	${OBJECTDIR}/Device.o \
+	${OBJECTDIR}/DrawList.o \
 	${OBJECTDIR}/Engine.o \
+	${OBJECTDIR}/FileSystem.o \
 	${OBJECTDIR}/FragmentShader.o \
 	${OBJECTDIR}/Frame.o \
+	${OBJECTDIR}/Ktx2.o \
 	${OBJECTDIR}/Light.o \
+	${OBJECTDIR}/Lz4.o \
+	${OBJECTDIR}/MappedFile.o \
 	${OBJECTDIR}/Material.o \
+	${OBJECTDIR}/MeshSimplifier.o \
+	${OBJECTDIR}/MipChain.o \
+	${OBJECTDIR}/MipmapGenerator.o \
 	${OBJECTDIR}/Model.o \
+	${OBJECTDIR}/ObjParser.o \
+	${OBJECTDIR}/OcclusionCuller.o \
+	${OBJECTDIR}/Pack.o \
+	${OBJECTDIR}/SceneGraph.o \
 	${OBJECTDIR}/Shader.o \
+	${OBJECTDIR}/StorageBuffer.o \
 	${OBJECTDIR}/Texture.o \
+	${OBJECTDIR}/TextureStreamer.o \
 	${OBJECTDIR}/TransformationMatrices.o \
 	${OBJECTDIR}/UniformBuffer.o \
 	${OBJECTDIR}/VertexShader.o \
@@ -53,6 +74,40 @@ OBJECTFILES= \
 	${OBJECTDIR}/main.o
 
 
+# Test Directory
+TESTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}/tests
+
+# Test Files
+TESTFILES= \
+	${TESTDIR}/TestFiles/SceneGraphTest \
+	${TESTDIR}/TestFiles/BatchMathTest \
+	${TESTDIR}/TestFiles/BatchMathBenchmark \
+	${TESTDIR}/TestFiles/DrawListTest \
+	${TESTDIR}/TestFiles/Lz4Test \
+	${TESTDIR}/TestFiles/PackBenchmark \
+	${TESTDIR}/TestFiles/ObjParserTest \
+	${TESTDIR}/TestFiles/ObjParserBenchmark \
+	${TESTDIR}/TestFiles/MeshSimplifierTest \
+	${TESTDIR}/TestFiles/DescriptorCacheTest \
+	${TESTDIR}/TestFiles/MipmapBenchmark
+
+# Test Object Files
+TESTOBJECTFILES= \
+	${TESTDIR}/tests/SceneGraphTest.o \
+	${TESTDIR}/tests/BatchMathTest.o \
+	${TESTDIR}/tests/BatchMathBenchmark.o \
+	${TESTDIR}/tests/DrawListTest.o \
+	${TESTDIR}/tests/Lz4Test.o \
+	${TESTDIR}/tests/PackBenchmark.o \
+	${TESTDIR}/tests/ObjParserTest.o \
+	${TESTDIR}/tests/ObjParserBenchmark.o \
+	${TESTDIR}/tests/MeshSimplifierTest.o \
+	${TESTDIR}/tests/DescriptorCacheTest.o \
+	${TESTDIR}/tests/MipmapBenchmark.o
+
+# Object Files linked into the tests, everything but the application entry point
+TESTLINKFILES=$(filter-out ${OBJECTDIR}/main.o,${OBJECTFILES})
+
 # C Compiler Flags
 CFLAGS=
 
@@ -67,7 +122,7 @@ FFLAGS=
 ASFLAGS=
 
 # Link Libraries and Options
-LDLIBSOPTIONS=`pkg-config --libs vulkan` `pkg-config --libs glfw3` `pkg-config --libs libzip` `pkg-config --libs glm`  
+LDLIBSOPTIONS=`pkg-config --libs vulkan` `pkg-config --libs glfw3` `pkg-config --libs libzip` `pkg-config --libs glm` -pthread  
 
 # Build Targets
 .build-conf: ${BUILD_SUBPROJECTS}
@@ -77,21 +132,66 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/vulkanstarter: ${OBJECTFILES}
 	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
 	g++ -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/vulkanstarter ${OBJECTFILES} ${LDLIBSOPTIONS}
 
+${OBJECTDIR}/AssetCache.o: AssetCache.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/AssetCache.o AssetCache.cpp
+
+${OBJECTDIR}/BatchMath.o: BatchMath.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/BatchMath.o BatchMath.cpp
+
+${OBJECTDIR}/BlockCompressor.o: BlockCompressor.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/BlockCompressor.o BlockCompressor.cpp
+
 ${OBJECTDIR}/Camera.o: Camera.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Camera.o Camera.cpp
 
+${OBJECTDIR}/CommandRecorder.o: CommandRecorder.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/CommandRecorder.o CommandRecorder.cpp
+
+${OBJECTDIR}/ComputeShader.o: ComputeShader.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ComputeShader.o ComputeShader.cpp
+
+${OBJECTDIR}/DescriptorAllocator.o: DescriptorAllocator.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DescriptorAllocator.o DescriptorAllocator.cpp
+
+${OBJECTDIR}/DescriptorCache.o: DescriptorCache.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DescriptorCache.o DescriptorCache.cpp
+
 ${OBJECTDIR}/Device.o: Device.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Device.o Device.cpp
 
+${OBJECTDIR}/DrawList.o: DrawList.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/DrawList.o DrawList.cpp
+
 ${OBJECTDIR}/Engine.o: Engine.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Engine.o Engine.cpp
 
+${OBJECTDIR}/FileSystem.o: FileSystem.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/FileSystem.o FileSystem.cpp
+
 ${OBJECTDIR}/FragmentShader.o: FragmentShader.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -102,31 +202,91 @@ ${OBJECTDIR}/Frame.o: Frame.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Frame.o Frame.cpp
 
+${OBJECTDIR}/Ktx2.o: Ktx2.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Ktx2.o Ktx2.cpp
+
 ${OBJECTDIR}/Light.o: Light.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Light.o Light.cpp
 
+${OBJECTDIR}/Lz4.o: Lz4.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Lz4.o Lz4.cpp
+
+${OBJECTDIR}/MappedFile.o: MappedFile.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MappedFile.o MappedFile.cpp
+
 ${OBJECTDIR}/Material.o: Material.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Material.o Material.cpp
 
+${OBJECTDIR}/MeshSimplifier.o: MeshSimplifier.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MeshSimplifier.o MeshSimplifier.cpp
+
+${OBJECTDIR}/MipChain.o: MipChain.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MipChain.o MipChain.cpp
+
+${OBJECTDIR}/MipmapGenerator.o: MipmapGenerator.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/MipmapGenerator.o MipmapGenerator.cpp
+
 ${OBJECTDIR}/Model.o: Model.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Model.o Model.cpp
 
+${OBJECTDIR}/ObjParser.o: ObjParser.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/ObjParser.o ObjParser.cpp
+
+${OBJECTDIR}/OcclusionCuller.o: OcclusionCuller.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/OcclusionCuller.o OcclusionCuller.cpp
+
+${OBJECTDIR}/Pack.o: Pack.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Pack.o Pack.cpp
+
+${OBJECTDIR}/SceneGraph.o: SceneGraph.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/SceneGraph.o SceneGraph.cpp
+
 ${OBJECTDIR}/Shader.o: Shader.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Shader.o Shader.cpp
 
+${OBJECTDIR}/StorageBuffer.o: StorageBuffer.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/StorageBuffer.o StorageBuffer.cpp
+
 ${OBJECTDIR}/Texture.o: Texture.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
 	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/Texture.o Texture.cpp
 
+${OBJECTDIR}/TextureStreamer.o: TextureStreamer.cpp
+	${MKDIR} -p ${OBJECTDIR}
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/TextureStreamer.o TextureStreamer.cpp
+
 ${OBJECTDIR}/TransformationMatrices.o: TransformationMatrices.cpp
 	${MKDIR} -p ${OBJECTDIR}
 	${RM} "$@.d"
@@ -160,6 +320,126 @@ ${OBJECTDIR}/main.o: main.cpp
 # Subprojects
 .build-subprojects:
 
+# Build Test Targets
+.build-tests-conf: .build-tests-subprojects .build-conf ${TESTFILES}
+.build-tests-subprojects:
+
+${TESTDIR}/TestFiles/SceneGraphTest: ${TESTDIR}/tests/SceneGraphTest.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/SceneGraphTest $^ ${LDLIBSOPTIONS} -lboost_unit_test_framework
+
+${TESTDIR}/tests/SceneGraphTest.o: tests/SceneGraphTest.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/SceneGraphTest.o tests/SceneGraphTest.cpp
+
+${TESTDIR}/TestFiles/BatchMathTest: ${TESTDIR}/tests/BatchMathTest.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/BatchMathTest $^ ${LDLIBSOPTIONS} -lboost_unit_test_framework
+
+${TESTDIR}/tests/BatchMathTest.o: tests/BatchMathTest.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/BatchMathTest.o tests/BatchMathTest.cpp
+
+${TESTDIR}/TestFiles/BatchMathBenchmark: ${TESTDIR}/tests/BatchMathBenchmark.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/BatchMathBenchmark $^ ${LDLIBSOPTIONS} 
+
+${TESTDIR}/tests/BatchMathBenchmark.o: tests/BatchMathBenchmark.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/BatchMathBenchmark.o tests/BatchMathBenchmark.cpp
+
+${TESTDIR}/TestFiles/DrawListTest: ${TESTDIR}/tests/DrawListTest.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/DrawListTest $^ ${LDLIBSOPTIONS} -lboost_unit_test_framework
+
+${TESTDIR}/tests/DrawListTest.o: tests/DrawListTest.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/DrawListTest.o tests/DrawListTest.cpp
+
+${TESTDIR}/TestFiles/Lz4Test: ${TESTDIR}/tests/Lz4Test.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/Lz4Test $^ ${LDLIBSOPTIONS} -lboost_unit_test_framework
+
+${TESTDIR}/tests/Lz4Test.o: tests/Lz4Test.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/Lz4Test.o tests/Lz4Test.cpp
+
+${TESTDIR}/TestFiles/PackBenchmark: ${TESTDIR}/tests/PackBenchmark.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/PackBenchmark $^ ${LDLIBSOPTIONS} 
+
+${TESTDIR}/tests/PackBenchmark.o: tests/PackBenchmark.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/PackBenchmark.o tests/PackBenchmark.cpp
+
+${TESTDIR}/TestFiles/ObjParserTest: ${TESTDIR}/tests/ObjParserTest.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/ObjParserTest $^ ${LDLIBSOPTIONS} -lboost_unit_test_framework
+
+${TESTDIR}/tests/ObjParserTest.o: tests/ObjParserTest.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/ObjParserTest.o tests/ObjParserTest.cpp
+
+${TESTDIR}/TestFiles/ObjParserBenchmark: ${TESTDIR}/tests/ObjParserBenchmark.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/ObjParserBenchmark $^ ${LDLIBSOPTIONS} 
+
+${TESTDIR}/tests/ObjParserBenchmark.o: tests/ObjParserBenchmark.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/ObjParserBenchmark.o tests/ObjParserBenchmark.cpp
+
+${TESTDIR}/TestFiles/MeshSimplifierTest: ${TESTDIR}/tests/MeshSimplifierTest.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/MeshSimplifierTest $^ ${LDLIBSOPTIONS} -lboost_unit_test_framework
+
+${TESTDIR}/tests/MeshSimplifierTest.o: tests/MeshSimplifierTest.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/MeshSimplifierTest.o tests/MeshSimplifierTest.cpp
+
+${TESTDIR}/TestFiles/DescriptorCacheTest: ${TESTDIR}/tests/DescriptorCacheTest.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/DescriptorCacheTest $^ ${LDLIBSOPTIONS} -lboost_unit_test_framework
+
+${TESTDIR}/tests/DescriptorCacheTest.o: tests/DescriptorCacheTest.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/DescriptorCacheTest.o tests/DescriptorCacheTest.cpp
+
+${TESTDIR}/TestFiles/MipmapBenchmark: ${TESTDIR}/tests/MipmapBenchmark.o ${TESTLINKFILES}
+	${MKDIR} -p ${TESTDIR}/TestFiles
+	${LINK.cc} -o ${TESTDIR}/TestFiles/MipmapBenchmark $^ ${LDLIBSOPTIONS} 
+
+${TESTDIR}/tests/MipmapBenchmark.o: tests/MipmapBenchmark.cpp
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O3 -w -s -DNDEBUG -Iinclude `pkg-config --cflags vulkan` `pkg-config --cflags glfw3` `pkg-config --cflags libzip` `pkg-config --cflags glm` -std=c++17  -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/MipmapBenchmark.o tests/MipmapBenchmark.cpp
+
+# Run Test Targets, benchmarks are run by 'make benchmark'
+.test-conf:
+	@if [ "${TEST}" = "" ]; \
+	then  \
+	    ${TESTDIR}/TestFiles/SceneGraphTest && \
+	    ${TESTDIR}/TestFiles/BatchMathTest && \
+	    ${TESTDIR}/TestFiles/DrawListTest && \
+	    ${TESTDIR}/TestFiles/Lz4Test && \
+	    ${TESTDIR}/TestFiles/ObjParserTest && \
+	    ${TESTDIR}/TestFiles/MeshSimplifierTest && \
+	    ${TESTDIR}/TestFiles/DescriptorCacheTest && \
+	    true; \
+	else  \
+	    ./${TEST}; \
+	fi
+
+
 # Clean Targets
 .clean-conf: ${CLEAN_SUBPROJECTS}
 	${RM} -r ${CND_BUILDDIR}/${CND_CONF}
@@ -0,0 +1,23 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Depth only pass of the parts visible in the last frame, they occlude the rest.
+
+layout(set = 0, binding = 0) uniform CameraUbo {
+    mat4 view;
+    mat4 proj;
+    vec3 eye;
+    vec3 center;
+    mat4 viewProj;
+} cameraUbo;
+
+layout(set = 1, binding = 0) uniform TransformationUbo {
+    mat4 model;
+    mat4 normal;
+} transformationUbo;
+
+layout(location = 0) in vec3 inPosition;
+
+void main() {
+    gl_Position = cameraUbo.viewProj * transformationUbo.model * vec4(inPosition, 1.0);
+}
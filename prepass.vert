@@ -0,0 +1,27 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+// Depth only prepass. Position is computed exactly as in shader.vert, the main
+// pass then tests for equal depth and shades every pixel once.
+
+layout(set = 0, binding = 0) uniform CameraUbo {
+    mat4 view;
+    mat4 proj;
+    vec3 eye;
+    vec3 center;
+    mat4 viewProj;
+} cameraUbo;
+
+layout(set = 1, binding = 0) uniform TransformationUbo {
+    mat4 model;
+    mat4 normal;
+} transformationUbo;
+
+layout(location = 0) in vec3 inPosition;
+
+invariant gl_Position;
+
+void main() {
+    vec3 position = (transformationUbo.model * vec4(inPosition, 1.0)).xyz;
+    gl_Position = cameraUbo.viewProj * vec4(position, 1.0);
+}
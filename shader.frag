@@ -12,6 +12,7 @@ layout(set = 0, binding = 0) uniform CameraUbo {
     mat4 proj;
     vec3 eye;
     vec3 center;
+    mat4 viewProj;
 } cameraUbo;
 
 struct Light {
@@ -20,12 +21,30 @@ struct Light {
   float attenuation;
 };
 
-#define MAX_LIGHTS 8
 layout(set = 0, binding = 1) uniform LightsUbo {
-    float numberOfLights;
-    Light lights[MAX_LIGHTS];
+    uint numberOfLights;
+    uint numberOfGlobalLights;
+    uint clustersX;
+    uint clustersY;
+    uint clustersZ;
+    float near;
+    float far;
+    float width;
+    float height;
 } lightsUbo;
 
+layout(std430, set = 0, binding = 2) readonly buffer LightsBuffer {
+    Light lights[];
+} lightsBuffer;
+
+layout(std430, set = 0, binding = 3) readonly buffer ClustersBuffer {
+    uvec2 clusters[];
+} clustersBuffer;
+
+layout(std430, set = 0, binding = 4) readonly buffer LightIndicesBuffer {
+    uint indices[];
+} lightIndicesBuffer;
+
 layout(set = 2, binding = 0) uniform sampler2D texSampler;
 layout(set = 2, binding = 1) uniform MaterialUbo {
     vec4 ambient;
@@ -34,30 +53,46 @@ layout(set = 2, binding = 1) uniform MaterialUbo {
     float shiness;
 } materialUbo;
 
-void main() {
-    outColor = vec4(0.0);
+vec4 shade(uint lightIndex, vec3 normal, vec3 viewDirection, vec3 textureColor) {
+    Light light = lightsBuffer.lights[lightIndex];
+
+    //diffuse
+    vec3 lightDirection = normalize(light.position - inPosition);
+    float diffuse = max(dot(normal, lightDirection), 0.0);
 
-    for (int i=0; i< lightsUbo.numberOfLights; ++i) {
-        vec3 lightPosition = lightsUbo.lights[i].position;
-        vec4 lightColor = lightsUbo.lights[i].color;
-        vec3 cameraPosition = cameraUbo.eye;
+    //specular
+    vec3 reflectDirection = reflect(-lightDirection, normal);
+    float specular = pow(max(dot(viewDirection, reflectDirection), 0.0), materialUbo.shiness);
 
-        //diffuse
-        vec3 normal = normalize(inNormal);
-        vec3 lightDirection = normalize(lightPosition - inPosition);  
-        float diffuse = max(dot(normal, lightDirection), 0.0);
+    //attenuation
+    float distance = length(light.position - inPosition);
+    float attenuation = min(light.attenuation > 0 ? 1.0 / (light.attenuation * distance * distance) : 1.0, 1.0);
 
-        //specular
-        vec3 viewDirection = normalize(cameraPosition - inPosition);
-        vec3 reflectDirection = reflect(-lightDirection, normal);
-        float specular = pow(max(dot(viewDirection, reflectDirection), 0.0), materialUbo.shiness);  
+    //total
+    return vec4(0.1 * materialUbo.ambient.rgb + diffuse * materialUbo.diffuse.rgb * textureColor + specular * materialUbo.specular.rgb, 1.0) * light.color * attenuation;
+}
+
+void main() {
+    vec3 normal = normalize(inNormal);
+    vec3 viewDirection = normalize(cameraUbo.eye - inPosition);
+    vec3 textureColor = texture(texSampler, inTexCoord).rgb;
+
+    outColor = vec4(0.0);
+
+    for (uint i = 0; i < lightsUbo.numberOfGlobalLights; ++i) {
+        outColor += shade(lightIndicesBuffer.indices[i], normal, viewDirection, textureColor);
+    }
 
-        //attenuation
-        float distance = length(lightPosition - inPosition);
-        float attenuation = min(lightsUbo.lights[i].attenuation > 0 ? 1.0 / (lightsUbo.lights[i].attenuation * distance * distance) : 1.0, 1.0);
+    //cluster of the fragment, the same grid as lights are binned into
+    float depth = -(cameraUbo.view * vec4(inPosition, 1.0)).z;
+    uint slice = uint(clamp(log(depth / lightsUbo.near) / log(lightsUbo.far / lightsUbo.near) * lightsUbo.clustersZ,
+            0.0, lightsUbo.clustersZ - 1.0));
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / vec2(lightsUbo.width, lightsUbo.height) * vec2(lightsUbo.clustersX, lightsUbo.clustersY)),
+            uvec2(lightsUbo.clustersX - 1, lightsUbo.clustersY - 1));
+    uvec2 cluster = clustersBuffer.clusters[(slice * lightsUbo.clustersY + tile.y) * lightsUbo.clustersX + tile.x];
 
-        //total
-        outColor += vec4(0.1 * materialUbo.ambient.rgb + diffuse * materialUbo.diffuse.rgb * texture(texSampler, inTexCoord).rgb + specular * materialUbo.specular.rgb, 1.0) * lightColor * attenuation;
+    for (uint i = cluster.x; i < cluster.x + cluster.y; ++i) {
+        outColor += shade(lightIndicesBuffer.indices[i], normal, viewDirection, textureColor);
     }
     outColor = vec4(outColor.xyz, 1.0);
-}
\ No newline at end of file
+}
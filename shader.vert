@@ -6,10 +6,12 @@ layout(set = 0, binding = 0) uniform CameraUbo {
     mat4 proj;
     vec3 eye;
     vec3 center;
+    mat4 viewProj;
 } cameraUbo;
 
 layout(set = 1, binding = 0) uniform TransformationUbo {
     mat4 model;
+    mat4 normal;
 } transformationUbo;
 
 layout(location = 0) in vec3 inPosition;
@@ -20,10 +22,13 @@ layout(location = 0) out vec3 outPosition;
 layout(location = 1) out vec2 outTexCoord;
 layout(location = 2) out vec3 outNormal;
 
+// matched by prepass.vert, so depths of both passes test equal
+invariant gl_Position;
+
 void main() {
     outPosition = (transformationUbo.model * vec4(inPosition, 1.0)).xyz;
-    outNormal = mat3(transpose(inverse(transformationUbo.model))) * inNormal;
+    outNormal = mat3(transformationUbo.normal) * inNormal;
     outTexCoord = inTexCoord;
     
-    gl_Position = cameraUbo.proj * cameraUbo.view * vec4(outPosition, 1.0);
+    gl_Position = cameraUbo.viewProj * vec4(outPosition, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+ * File:   BatchMathBenchmark.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 22:10
+ */
+
+#include "BatchMath.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/matrix.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// every kernel at 10k, 100k and 1M objects (or the counts given as arguments), on glm and on every
+// instruction set of the processor, best of the repetitions
+#define REPETITIONS 7
+
+namespace {
+
+    double best(const std::function<void()>& run) {
+        double result = 1e30;
+        for (int i = 0; i < REPETITIONS; ++i) {
+            auto start = std::chrono::high_resolution_clock::now();
+            run();
+            auto end = std::chrono::high_resolution_clock::now();
+            result = std::min(result, std::chrono::duration<double, std::chrono::milliseconds::period>(end - start).count());
+        }
+        return result;
+    }
+
+    void report(const std::string& kernel, const std::string& isa, size_t count, double milliseconds, double baseline,
+            const char* baselineName = "glm") {
+        std::cout << std::left << std::setw(16) << kernel << std::setw(8) << isa << std::right << std::setw(9) << count
+                << std::fixed << std::setprecision(3) << std::setw(11) << milliseconds << " ms" << std::setw(9)
+                << milliseconds * 1e6 / count << " ns/object" << std::setprecision(2) << std::setw(8) << baseline / milliseconds
+                << "x " << baselineName << std::endl;
+    }
+
+    const char* isaName(zvlk::BatchMathIsa isa) {
+        switch (isa) {
+            case zvlk::BatchMathIsa::eAvx2:
+                return "avx2";
+            case zvlk::BatchMathIsa::eSse:
+                return "sse";
+            default:
+                return "scalar";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; ++i) {
+        counts.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (counts.empty()) {
+        counts = {10000, 100000, 1000000};
+    }
+
+    zvlk::BatchMathIsa supported = zvlk::BatchMath::getIsa();
+    std::vector<zvlk::BatchMathIsa> isas;
+    for (zvlk::BatchMathIsa isa : {zvlk::BatchMathIsa::eScalar, zvlk::BatchMathIsa::eSse, zvlk::BatchMathIsa::eAvx2}) {
+        if (static_cast<int> (isa) <= static_cast<int> (supported)) {
+            isas.push_back(isa);
+        }
+    }
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    glm::mat4 viewProj = glm::perspective(glm::radians(45.0f), 1.5f, 0.1f, 100.0f)
+            * glm::lookAt(glm::vec3(20.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::vec4 planes[6];
+    zvlk::BatchMath::extractFrustumPlanes(viewProj, planes);
+
+    for (size_t count : counts) {
+        std::vector<glm::mat4> a(count), b(count), result(count);
+        std::vector<zvlk::Bounds> bounds(count);
+        for (size_t i = 0; i < count; ++i) {
+            a[i] = glm::translate(glm::mat4(1.0f), glm::vec3(value(random), value(random), value(random)));
+            b[i] = glm::rotate(glm::mat4(1.0f), value(random), glm::normalize(glm::vec3(value(random), value(random), 1.0f)));
+            glm::vec3 corner(value(random), value(random), value(random));
+            bounds[i] = {corner, corner + glm::vec3(1.0f)};
+        }
+        zvlk::BoundsSoA transformed;
+        transformed.resize(count);
+        std::vector<uint8_t> visible(count);
+
+        double glmMultiply = best([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                result[i] = a[i] * b[i];
+            }
+        });
+        report("multiply", "glm", count, glmMultiply, glmMultiply);
+        for (zvlk::BatchMathIsa isa : isas) {
+            zvlk::BatchMath::setIsa(isa);
+            report("multiply", isaName(isa), count, best([&]() {
+                zvlk::BatchMath::multiply(a.data(), b.data(), result.data(), count);
+            }), glmMultiply);
+        }
+
+        double glmNormals = best([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                result[i] = glm::mat4(glm::transpose(glm::inverse(glm::mat3(b[i]))));
+            }
+        });
+        report("normalMatrices", "glm", count, glmNormals, glmNormals);
+        for (zvlk::BatchMathIsa isa : isas) {
+            zvlk::BatchMath::setIsa(isa);
+            report("normalMatrices", isaName(isa), count, best([&]() {
+                zvlk::BatchMath::normalMatrices(b.data(), result.data(), count);
+            }), glmNormals);
+        }
+
+        // glm has no batch counterpart of these, the scalar kernels are the baseline
+        zvlk::BatchMath::setIsa(zvlk::BatchMathIsa::eScalar);
+        double scalarBounds = best([&]() {
+            zvlk::BatchMath::transformBounds(a.data(), bounds.data(), transformed, 0, count);
+        });
+        double scalarFrustum = best([&]() {
+            zvlk::BatchMath::testFrustum(planes, transformed, visible.data());
+        });
+        for (zvlk::BatchMathIsa isa : isas) {
+            zvlk::BatchMath::setIsa(isa);
+            report("transformBounds", isaName(isa), count, best([&]() {
+                zvlk::BatchMath::transformBounds(a.data(), bounds.data(), transformed, 0, count);
+            }), scalarBounds, "scalar");
+        }
+        for (zvlk::BatchMathIsa isa : isas) {
+            zvlk::BatchMath::setIsa(isa);
+            report("testFrustum", isaName(isa), count, best([&]() {
+                zvlk::BatchMath::testFrustum(planes, transformed, visible.data());
+            }), scalarFrustum, "scalar");
+        }
+        zvlk::BatchMath::setIsa(supported);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,249 @@
+/*
+ * File:   BatchMathTest.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 21:50
+ */
+
+#define BOOST_TEST_MODULE BatchMath
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "BatchMath.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/matrix.hpp>
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    // odd counts leave tails after the vector widths
+    const size_t COUNTS[] = {1, 7, 8, 9, 1003};
+
+    std::vector<zvlk::BatchMathIsa> supportedIsas() {
+        zvlk::BatchMathIsa supported = zvlk::BatchMath::getIsa();
+        std::vector<zvlk::BatchMathIsa> isas;
+        for (zvlk::BatchMathIsa isa : {zvlk::BatchMathIsa::eScalar, zvlk::BatchMathIsa::eSse, zvlk::BatchMathIsa::eAvx2}) {
+            if (static_cast<int> (isa) <= static_cast<int> (supported)) {
+                isas.push_back(isa);
+            }
+        }
+        return isas;
+    }
+
+    // restores the detected instruction set for the following cases
+    struct IsaFixture {
+        zvlk::BatchMathIsa detected = zvlk::BatchMath::getIsa();
+
+        ~IsaFixture() {
+            zvlk::BatchMath::setIsa(this->detected);
+        }
+    };
+
+    std::vector<glm::mat4> randomMatrices(size_t count, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> offset(-50.0f, 50.0f);
+        std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+        std::uniform_real_distribution<float> scale(0.2f, 4.0f);
+        std::vector<glm::mat4> matrices;
+        for (size_t i = 0; i < count; ++i) {
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(offset(random), offset(random), offset(random)));
+            m = glm::rotate(m, angle(random), glm::normalize(glm::vec3(offset(random), offset(random), offset(random) + 0.1f)));
+            matrices.push_back(glm::scale(m, glm::vec3(scale(random), scale(random), scale(random))));
+        }
+        return matrices;
+    }
+
+    void checkClose(float actual, float expected) {
+        BOOST_CHECK_SMALL(actual - expected, 1e-4f * (1.0f + std::fabs(expected)));
+    }
+
+    void checkClose(const glm::mat4& actual, const glm::mat4& expected) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                checkClose(actual[c][r], expected[c][r]);
+            }
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(kernels, IsaFixture)
+
+BOOST_AUTO_TEST_CASE(multipliesPairsLikeGlm) {
+    for (zvlk::BatchMathIsa isa : supportedIsas()) {
+        zvlk::BatchMath::setIsa(isa);
+        for (size_t count : COUNTS) {
+            std::vector<glm::mat4> a = randomMatrices(count, 1), b = randomMatrices(count, 2), result(count);
+            zvlk::BatchMath::multiply(a.data(), b.data(), result.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                checkClose(result[i], a[i] * b[i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multipliesInPlace) {
+    for (zvlk::BatchMathIsa isa : supportedIsas()) {
+        zvlk::BatchMath::setIsa(isa);
+        for (size_t count : COUNTS) {
+            std::vector<glm::mat4> a = randomMatrices(count, 1), b = randomMatrices(count, 2);
+            std::vector<glm::mat4> intoA = a, intoB = b;
+            zvlk::BatchMath::multiply(intoA.data(), b.data(), intoA.data(), count);
+            zvlk::BatchMath::multiply(a.data(), intoB.data(), intoB.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                checkClose(intoA[i], a[i] * b[i]);
+                checkClose(intoB[i], a[i] * b[i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multipliesByOneMatrixLikeGlm) {
+    for (zvlk::BatchMathIsa isa : supportedIsas()) {
+        zvlk::BatchMath::setIsa(isa);
+        for (size_t count : COUNTS) {
+            glm::mat4 a = randomMatrices(1, 3)[0];
+            std::vector<glm::mat4> b = randomMatrices(count, 4), result(count);
+            zvlk::BatchMath::multiply(a, b.data(), result.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                checkClose(result[i], a * b[i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(computesNormalMatricesLikeGlm) {
+    for (zvlk::BatchMathIsa isa : supportedIsas()) {
+        zvlk::BatchMath::setIsa(isa);
+        for (size_t count : COUNTS) {
+            std::vector<glm::mat4> matrices = randomMatrices(count, 5), normals(count);
+            zvlk::BatchMath::normalMatrices(matrices.data(), normals.data(), count);
+            for (size_t i = 0; i < count; ++i) {
+                checkClose(normals[i], glm::mat4(glm::transpose(glm::inverse(glm::mat3(matrices[i])))));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(transformsBoundsLikeGlm) {
+    for (zvlk::BatchMathIsa isa : supportedIsas()) {
+        zvlk::BatchMath::setIsa(isa);
+        for (size_t count : COUNTS) {
+            std::vector<glm::mat4> matrices = randomMatrices(count, 6);
+            std::vector<zvlk::Bounds> bounds;
+            std::mt19937 random(7);
+            std::uniform_real_distribution<float> coordinate(-3.0f, 3.0f);
+            for (size_t i = 0; i < count; ++i) {
+                glm::vec3 a(coordinate(random), coordinate(random), coordinate(random));
+                glm::vec3 b(coordinate(random), coordinate(random), coordinate(random));
+                bounds.push_back({glm::min(a, b), glm::max(a, b)});
+            }
+
+            // written after an untouched prefix
+            const size_t offset = 3;
+            zvlk::BoundsSoA result;
+            result.resize(offset + count);
+            zvlk::BatchMath::transformBounds(matrices.data(), bounds.data(), result, offset, count);
+
+            for (size_t i = 0; i < count; ++i) {
+                // the box around all eight transformed corners
+                glm::vec3 min(INFINITY), max(-INFINITY);
+                for (int corner = 0; corner < 8; ++corner) {
+                    glm::vec3 point((corner & 1) ? bounds[i].max.x : bounds[i].min.x, (corner & 2) ? bounds[i].max.y : bounds[i].min.y,
+                            (corner & 4) ? bounds[i].max.z : bounds[i].min.z);
+                    glm::vec3 transformed = glm::vec3(matrices[i] * glm::vec4(point, 1.0f));
+                    min = glm::min(min, transformed);
+                    max = glm::max(max, transformed);
+                }
+                size_t j = offset + i;
+                checkClose(result.minX[j], min.x);
+                checkClose(result.minY[j], min.y);
+                checkClose(result.minZ[j], min.z);
+                checkClose(result.maxX[j], max.x);
+                checkClose(result.maxY[j], max.y);
+                checkClose(result.maxZ[j], max.z);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testsFrustumLikeScalarPlanes) {
+    glm::mat4 proj = glm::perspective(glm::radians(60.0f), 1.5f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::vec4 planes[6];
+    zvlk::BatchMath::extractFrustumPlanes(proj * view, planes);
+
+    std::mt19937 random(8);
+    std::uniform_real_distribution<float> coordinate(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> size(0.1f, 10.0f);
+    for (size_t count : COUNTS) {
+        zvlk::BoundsSoA bounds;
+        bounds.resize(count);
+        std::vector<uint8_t> expected(count);
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 min(coordinate(random), coordinate(random), coordinate(random));
+            glm::vec3 max = min + glm::vec3(size(random), size(random), size(random));
+            bounds.minX[i] = min.x;
+            bounds.minY[i] = min.y;
+            bounds.minZ[i] = min.z;
+            bounds.maxX[i] = max.x;
+            bounds.maxY[i] = max.y;
+            bounds.maxZ[i] = max.z;
+
+            // outside when the corner furthest along some plane's normal is behind it
+            expected[i] = 1;
+            for (int p = 0; p < 6; ++p) {
+                glm::vec3 corner(planes[p].x > 0.0f ? max.x : min.x, planes[p].y > 0.0f ? max.y : min.y, planes[p].z > 0.0f ? max.z : min.z);
+                if (glm::dot(glm::vec3(planes[p]), corner) + planes[p].w < 0.0f) {
+                    expected[i] = 0;
+                }
+            }
+        }
+
+        for (zvlk::BatchMathIsa isa : supportedIsas()) {
+            zvlk::BatchMath::setIsa(isa);
+            std::vector<uint8_t> visible(count, 2);
+            zvlk::BatchMath::testFrustum(planes, bounds, visible.data());
+            BOOST_CHECK_EQUAL_COLLECTIONS(visible.begin(), visible.end(), expected.begin(), expected.end());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_CASE(extractsNormalizedPlanesPointingInside) {
+    glm::mat4 proj = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 10.0f);
+    glm::vec4 planes[6];
+    zvlk::BatchMath::extractFrustumPlanes(proj, planes);
+
+    // the camera looks down -z, a point on the axis between the clip planes is inside all of them
+    glm::vec4 inside(0.0f, 0.0f, -5.0f, 1.0f);
+    for (int p = 0; p < 6; ++p) {
+        checkClose(glm::length(glm::vec3(planes[p])), 1.0f);
+        BOOST_CHECK_GT(glm::dot(planes[p], inside), 0.0f);
+    }
+    // near and far planes at their distances
+    checkClose(glm::dot(planes[4], glm::vec4(0.0f, 0.0f, -1.0f, 1.0f)), 0.0f);
+    checkClose(glm::dot(planes[5], glm::vec4(0.0f, 0.0f, -10.0f, 1.0f)), 0.0f);
+}
+
+BOOST_AUTO_TEST_CASE(leavesDegeneratePlanesFinite) {
+    glm::vec4 planes[6];
+    zvlk::BatchMath::extractFrustumPlanes(glm::mat4(0.0f), planes);
+    for (int p = 0; p < 6; ++p) {
+        for (int c = 0; c < 4; ++c) {
+            BOOST_CHECK(std::isfinite(planes[p][c]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rejectsUnsupportedInstructionSets) {
+    if (zvlk::BatchMath::getIsa() != zvlk::BatchMathIsa::eAvx2) {
+        BOOST_CHECK_THROW(zvlk::BatchMath::setIsa(zvlk::BatchMathIsa::eAvx2), std::invalid_argument);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * File:   DescriptorCacheTest.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 20 października 2026, 01:20
+ */
+
+#define BOOST_TEST_MODULE DescriptorCache
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DescriptorCache.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    // the cache only compares and hashes handles, so made up ones need no device
+    template<typename Handle>
+    Handle handle(uint64_t value) {
+        typename Handle::CType raw;
+        std::memcpy(&raw, &value, sizeof (raw));
+        return Handle(raw);
+    }
+
+    std::vector<zvlk::DescriptorInfo> buffers(uint64_t first, uint64_t second) {
+        return {vk::DescriptorBufferInfo(handle<vk::Buffer>(first), 0, 256), vk::DescriptorBufferInfo(handle<vk::Buffer>(second), 256, 64)};
+    }
+
+    const vk::DescriptorSetLayout LAYOUT = handle<vk::DescriptorSetLayout>(0x10);
+    const vk::DescriptorSetLayout OTHER_LAYOUT = handle<vk::DescriptorSetLayout>(0x20);
+}
+
+BOOST_AUTO_TEST_CASE(sharesSetsOfEqualContents) {
+    zvlk::DescriptorCache cache;
+    vk::DescriptorSet set = handle<vk::DescriptorSet>(0x100);
+    BOOST_CHECK(!cache.find(LAYOUT, buffers(1, 2)));
+    cache.insert(LAYOUT, buffers(1, 2), set);
+
+    BOOST_CHECK(cache.contains(set));
+    BOOST_CHECK(cache.find(LAYOUT, buffers(1, 2)) == set);
+    // other resources, their order or another layout are other sets
+    BOOST_CHECK(!cache.find(LAYOUT, buffers(1, 3)));
+    BOOST_CHECK(!cache.find(LAYOUT, buffers(2, 1)));
+    BOOST_CHECK(!cache.find(OTHER_LAYOUT, buffers(1, 2)));
+}
+
+BOOST_AUTO_TEST_CASE(tellsImagesFromBuffers) {
+    zvlk::DescriptorCache cache;
+    std::vector<zvlk::DescriptorInfo> image = {vk::DescriptorImageInfo(handle<vk::Sampler>(1), handle<vk::ImageView>(2),
+        vk::ImageLayout::eShaderReadOnlyOptimal)};
+    std::vector<zvlk::DescriptorInfo> otherLayout = {vk::DescriptorImageInfo(handle<vk::Sampler>(1), handle<vk::ImageView>(2),
+        vk::ImageLayout::eGeneral)};
+    cache.insert(LAYOUT, image, handle<vk::DescriptorSet>(0x100));
+    cache.insert(LAYOUT, buffers(1, 2), handle<vk::DescriptorSet>(0x200));
+
+    BOOST_CHECK(cache.find(LAYOUT, image) == handle<vk::DescriptorSet>(0x100));
+    BOOST_CHECK(cache.find(LAYOUT, buffers(1, 2)) == handle<vk::DescriptorSet>(0x200));
+    BOOST_CHECK(!cache.find(LAYOUT, otherLayout));
+}
+
+BOOST_AUTO_TEST_CASE(keepsSetsUntilTheLastUserReleasesThem) {
+    zvlk::DescriptorCache cache;
+    vk::DescriptorSet set = handle<vk::DescriptorSet>(0x100);
+    cache.insert(LAYOUT, buffers(1, 2), set);
+    cache.find(LAYOUT, buffers(1, 2));
+    cache.find(LAYOUT, buffers(1, 2));
+
+    BOOST_CHECK(!cache.release(set));
+    BOOST_CHECK(!cache.release(set));
+    BOOST_CHECK(cache.release(set));
+    BOOST_CHECK(!cache.contains(set));
+    BOOST_CHECK(!cache.find(LAYOUT, buffers(1, 2)));
+}
+
+BOOST_AUTO_TEST_CASE(releasesSetsItDoesNotHold) {
+    zvlk::DescriptorCache cache;
+    BOOST_CHECK(cache.release(handle<vk::DescriptorSet>(0x100)));
+}
+
+BOOST_AUTO_TEST_CASE(findsRewrittenSetsByTheirNewContents) {
+    zvlk::DescriptorCache cache;
+    vk::DescriptorSet set = handle<vk::DescriptorSet>(0x100);
+    cache.insert(LAYOUT, buffers(1, 2), set);
+    cache.find(LAYOUT, buffers(1, 2));
+
+    cache.update(set, LAYOUT, buffers(3, 4));
+    BOOST_CHECK(!cache.find(LAYOUT, buffers(1, 2)));
+    BOOST_CHECK(cache.find(LAYOUT, buffers(3, 4)) == set);
+    // the two users before the write and the one who found it after
+    BOOST_CHECK(!cache.release(set));
+    BOOST_CHECK(!cache.release(set));
+    BOOST_CHECK(cache.release(set));
+
+    // writes of sets it does not hold are not cached
+    vk::DescriptorSet own = handle<vk::DescriptorSet>(0x200);
+    cache.update(own, LAYOUT, buffers(5, 6));
+    BOOST_CHECK(!cache.contains(own));
+    BOOST_CHECK(!cache.find(LAYOUT, buffers(5, 6)));
+}
+
+BOOST_AUTO_TEST_CASE(holdsManySets) {
+    zvlk::DescriptorCache cache;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        cache.insert(i % 2 ? LAYOUT : OTHER_LAYOUT, buffers(i, i + 1), handle<vk::DescriptorSet>(i << 8));
+    }
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        BOOST_CHECK(cache.find(i % 2 ? LAYOUT : OTHER_LAYOUT, buffers(i, i + 1)) == handle<vk::DescriptorSet>(i << 8));
+    }
+
+    cache.clear();
+    BOOST_CHECK(!cache.contains(handle<vk::DescriptorSet>(1 << 8)));
+    BOOST_CHECK(!cache.find(LAYOUT, buffers(1, 2)));
+}
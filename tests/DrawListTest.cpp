@@ -0,0 +1,102 @@
+/*
+ * File:   DrawListTest.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 22:40
+ */
+
+#define BOOST_TEST_MODULE DrawList
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DrawList.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // sorts the list and checks it against a stable sort of the same key and item pairs
+    void checkSorted(zvlk::DrawList& list) {
+        std::vector<std::pair<uint64_t, uint32_t>> expected;
+        for (size_t i = 0; i < list.size(); ++i) {
+            expected.push_back({list.getKey(i), list[i]});
+        }
+        std::stable_sort(expected.begin(), expected.end(), [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+            return a.first < b.first;
+        });
+
+        list.sort();
+        BOOST_REQUIRE_EQUAL(list.size(), expected.size());
+        for (size_t i = 0; i < list.size(); ++i) {
+            BOOST_CHECK_EQUAL(list.getKey(i), expected[i].first);
+            BOOST_CHECK_EQUAL(list[i], expected[i].second);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sortsRandomKeys) {
+    std::mt19937_64 random(1);
+    zvlk::DrawList list;
+    for (uint32_t i = 0; i < 10000; ++i) {
+        list.add(random(), i);
+    }
+    checkSorted(list);
+}
+
+BOOST_AUTO_TEST_CASE(keepsOrderOfEqualKeys) {
+    // few distinct keys, most of the digits are the same in all of them
+    std::mt19937 random(2);
+    std::uniform_int_distribution<uint32_t> state(0, 3);
+    std::uniform_real_distribution<float> depth(0.0f, 100.0f);
+    zvlk::DrawList list;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        list.add(zvlk::DrawList::makeKey(state(random), state(random), state(random), 7, i % 3 == 0 ? 1.0f : depth(random)), i);
+    }
+    checkSorted(list);
+}
+
+BOOST_AUTO_TEST_CASE(sortsSmallAndUniformLists) {
+    zvlk::DrawList list;
+    list.sort();
+    BOOST_CHECK_EQUAL(list.size(), 0u);
+
+    list.add(5, 0);
+    checkSorted(list);
+
+    list.clear();
+    for (uint32_t i = 0; i < 100; ++i) {
+        list.add(42, i);
+    }
+    checkSorted(list);
+}
+
+BOOST_AUTO_TEST_CASE(ordersFieldsByPrecedence) {
+    using zvlk::DrawList;
+    // pass over pipeline over material over mesh over depth
+    BOOST_CHECK_LT(DrawList::makeKey(0, 255, 65535, 65535, 1000.0f), DrawList::makeKey(1, 0, 0, 0, 0.0f));
+    BOOST_CHECK_LT(DrawList::makeKey(1, 0, 65535, 65535, 1000.0f), DrawList::makeKey(1, 1, 0, 0, 0.0f));
+    BOOST_CHECK_LT(DrawList::makeKey(1, 1, 0, 65535, 1000.0f), DrawList::makeKey(1, 1, 1, 0, 0.0f));
+    BOOST_CHECK_LT(DrawList::makeKey(1, 1, 1, 0, 1000.0f), DrawList::makeKey(1, 1, 1, 1, 0.0f));
+    BOOST_CHECK_EQUAL(DrawList::getPass(DrawList::makeKey(9, 3, 2, 1, 5.0f)), 9u);
+}
+
+BOOST_AUTO_TEST_CASE(ordersDepthFrontToBack) {
+    using zvlk::DrawList;
+    BOOST_CHECK_LT(DrawList::makeKey(0, 0, 0, 0, -3.0f), DrawList::makeKey(0, 0, 0, 0, 0.5f));
+    BOOST_CHECK_EQUAL(DrawList::makeKey(0, 0, 0, 0, -3.0f), DrawList::makeKey(0, 0, 0, 0, 0.0f));
+    float previous = 0.01f;
+    for (float depth = 0.02f; depth < 10000.0f; depth *= 1.5f) {
+        BOOST_CHECK_LT(DrawList::makeKey(0, 0, 0, 0, previous), DrawList::makeKey(0, 0, 0, 0, depth));
+        previous = depth;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(truncatesIdentifiersToTheirFields) {
+    using zvlk::DrawList;
+    // the overflowing bits do not leak into the neighbouring fields
+    BOOST_CHECK_EQUAL(DrawList::makeKey(16, 256, 65536, 65536, 0.0f), DrawList::makeKey(0, 0, 0, 0, 0.0f));
+    BOOST_CHECK_EQUAL(DrawList::makeKey(17, 257, 65537, 65537, 0.0f), DrawList::makeKey(1, 1, 1, 1, 0.0f));
+}
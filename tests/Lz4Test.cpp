@@ -0,0 +1,125 @@
+/*
+ * File:   Lz4Test.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 23:00
+ */
+
+#define BOOST_TEST_MODULE Lz4
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "Lz4.h"
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::vector<uint8_t> roundTrip(const std::vector<uint8_t>& content) {
+        std::vector<uint8_t> compressed = zvlk::Lz4::compress(content.data(), content.size());
+        std::vector<uint8_t> result(content.size());
+        zvlk::Lz4::decompress(compressed.data(), compressed.size(), result.data(), result.size());
+        return result;
+    }
+
+    void checkRoundTrip(const std::vector<uint8_t>& content) {
+        std::vector<uint8_t> result = roundTrip(content);
+        BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), content.begin(), content.end());
+    }
+
+    std::vector<uint8_t> randomBytes(size_t size, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::vector<uint8_t> content(size);
+        for (uint8_t& byte : content) {
+            byte = static_cast<uint8_t> (random());
+        }
+        return content;
+    }
+
+    // lines of an OBJ file, repetitive like the assets
+    std::vector<uint8_t> text(size_t lines) {
+        std::mt19937 random(3);
+        std::string content;
+        for (size_t i = 0; i < lines; ++i) {
+            content += "v " + std::to_string(random() % 1000 / 100.0) + " " + std::to_string(random() % 1000 / 100.0) + " 0.000000\n";
+        }
+        return std::vector<uint8_t>(content.begin(), content.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(roundTripsShortInputs) {
+    // below and around the minimum match and the end of block limits
+    for (size_t size = 0; size <= 40; ++size) {
+        checkRoundTrip(randomBytes(size, static_cast<uint32_t> (size)));
+        checkRoundTrip(std::vector<uint8_t>(size, 'a'));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(roundTripsIncompressibleInputs) {
+    std::vector<uint8_t> content = randomBytes(100000, 1);
+    std::vector<uint8_t> compressed = zvlk::Lz4::compress(content.data(), content.size());
+    // literal runs longer than 270 bytes need several length bytes
+    BOOST_CHECK_LE(compressed.size(), content.size() + content.size() / 255 + 16);
+    checkRoundTrip(content);
+}
+
+BOOST_AUTO_TEST_CASE(roundTripsAndShrinksText) {
+    std::vector<uint8_t> content = text(20000);
+    std::vector<uint8_t> compressed = zvlk::Lz4::compress(content.data(), content.size());
+    BOOST_CHECK_LT(compressed.size(), content.size() / 2);
+    checkRoundTrip(content);
+}
+
+BOOST_AUTO_TEST_CASE(roundTripsOverlappingMatches) {
+    // periods shorter than the matches copy from the output being written
+    for (size_t period = 1; period <= 9; ++period) {
+        std::vector<uint8_t> pattern = randomBytes(period, 10 + static_cast<uint32_t> (period));
+        std::vector<uint8_t> content;
+        for (size_t i = 0; i < 5000; ++i) {
+            content.push_back(pattern[i % period]);
+        }
+        checkRoundTrip(content);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(roundTripsMatchesBeyondTheWindow) {
+    // a block repeated after more than 64 KiB cannot be referenced
+    std::vector<uint8_t> block = randomBytes(1000, 4);
+    std::vector<uint8_t> content = block;
+    std::vector<uint8_t> filler = randomBytes(70000, 5);
+    content.insert(content.end(), filler.begin(), filler.end());
+    content.insert(content.end(), block.begin(), block.end());
+    checkRoundTrip(content);
+}
+
+BOOST_AUTO_TEST_CASE(roundTripsLargeMixedInputs) {
+    std::vector<uint8_t> content;
+    for (uint32_t part = 0; part < 16; ++part) {
+        std::vector<uint8_t> piece = part % 2 ? randomBytes(30000 + part, part) : text(1000 + part);
+        content.insert(content.end(), piece.begin(), piece.end());
+    }
+    checkRoundTrip(content);
+}
+
+BOOST_AUTO_TEST_CASE(rejectsDamagedBlocks) {
+    std::vector<uint8_t> content = text(1000);
+    std::vector<uint8_t> compressed = zvlk::Lz4::compress(content.data(), content.size());
+    std::vector<uint8_t> result(content.size());
+
+    // cut short, smaller or larger than the original
+    BOOST_CHECK_THROW(zvlk::Lz4::decompress(compressed.data(), compressed.size() / 2, result.data(), result.size()), std::runtime_error);
+    BOOST_CHECK_THROW(zvlk::Lz4::decompress(compressed.data(), compressed.size(), result.data(), result.size() - 1), std::runtime_error);
+    std::vector<uint8_t> larger(content.size() + 1);
+    BOOST_CHECK_THROW(zvlk::Lz4::decompress(compressed.data(), compressed.size(), larger.data(), larger.size()), std::runtime_error);
+
+    // a match reaching before the start of the output: one literal, then offset 2
+    const uint8_t before[] = {0x10, 'x', 0x02, 0x00, 0x00};
+    std::vector<uint8_t> output(5);
+    BOOST_CHECK_THROW(zvlk::Lz4::decompress(before, sizeof (before), output.data(), output.size()), std::runtime_error);
+    // and a zero offset
+    const uint8_t zero[] = {0x10, 'x', 0x00, 0x00, 0x00};
+    BOOST_CHECK_THROW(zvlk::Lz4::decompress(zero, sizeof (zero), output.data(), output.size()), std::runtime_error);
+}
@@ -0,0 +1,188 @@
+/*
+ * File:   MeshSimplifierTest.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 20 października 2026, 00:30
+ */
+
+#define BOOST_TEST_MODULE MeshSimplifier
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "MeshSimplifier.h"
+
+#include <cmath>
+#include <set>
+#include <vector>
+
+namespace {
+
+    /*
+     * Height field of size x size quads over the unit square, split into two parts at the
+     * middle column. The middle row is a texture seam, its vertices are duplicated with
+     * another texture coordinate for the quads above it.
+     */
+    struct Grid {
+        int size;
+        std::vector<zvlk::Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<zvlk::ModelPart> parts;
+        // of the vertices on the middle row, below and above the seam
+        std::vector<uint32_t> seam, seamSiblings;
+
+        Grid(int size, float amplitude) : size(size) {
+            std::vector<uint32_t> ids;
+            for (int i = 0; i <= size; ++i) {
+                for (int j = 0; j <= size; ++j) {
+                    ids.push_back(this->add(i, j, amplitude, 0.0f));
+                }
+            }
+            for (int j = 0; j <= size; ++j) {
+                this->seam.push_back(ids[this->at(size / 2, j)]);
+                this->seamSiblings.push_back(this->add(size / 2, j, amplitude, 1.0f));
+            }
+
+            auto id = [&](int i, int j, int quadRow) {
+                return i == size / 2 && quadRow >= size / 2 ? this->seamSiblings[j] : ids[this->at(i, j)];
+            };
+            for (int part = 0; part < 2; ++part) {
+                uint32_t offset = static_cast<uint32_t> (this->indices.size());
+                for (int i = 0; i < size; ++i) {
+                    for (int j = part * size / 2; j < (part + 1) * size / 2; ++j) {
+                        uint32_t a = id(i, j, i), b = id(i + 1, j, i), c = id(i + 1, j + 1, i), d = id(i, j + 1, i);
+                        this->indices.insert(this->indices.end(), {a, b, c, a, c, d});
+                    }
+                }
+                zvlk::ModelPart modelPart{};
+                modelPart.numberOfIndices = static_cast<uint32_t> (this->indices.size()) - offset;
+                modelPart.indexOffset = offset;
+                this->parts.push_back(modelPart);
+            }
+        }
+
+        int at(int i, int j) const {
+            return i * (this->size + 1) + j;
+        }
+
+        uint32_t add(int i, int j, float amplitude, float u) {
+            zvlk::Vertex vertex{};
+            vertex.position = glm::vec3(i / float(this->size), j / float(this->size), amplitude * std::sin(i * 0.4f) * std::cos(j * 0.3f));
+            vertex.texCoord = glm::vec2(u, 0.0f);
+            this->vertices.push_back(vertex);
+            return static_cast<uint32_t> (this->vertices.size() - 1);
+        }
+
+        std::set<uint32_t> used(const zvlk::ModelPart& part) const {
+            return std::set<uint32_t>(this->indices.begin() + part.indexOffset, this->indices.begin() + part.indexOffset + part.numberOfIndices);
+        }
+    };
+
+    // triangles over vertices the part already used, each with three distinct corners
+    void checkValid(const Grid& grid, const zvlk::ModelPart& part, const std::vector<uint32_t>& simplified) {
+        BOOST_REQUIRE_EQUAL(simplified.size() % 3, 0u);
+        std::set<uint32_t> used = grid.used(part);
+        for (size_t i = 0; i < simplified.size(); i += 3) {
+            uint32_t a = simplified[i], b = simplified[i + 1], c = simplified[i + 2];
+            BOOST_CHECK(used.count(a) && used.count(b) && used.count(c));
+            BOOST_CHECK(a != b && b != c && a != c);
+        }
+    }
+
+    float area(const Grid& grid, const std::vector<uint32_t>& indices) {
+        float result = 0.0f;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            glm::vec3 a = grid.vertices[indices[i]].position, b = grid.vertices[indices[i + 1]].position, c = grid.vertices[indices[i + 2]].position;
+            result += 0.5f * glm::length(glm::cross(b - a, c - a));
+        }
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(reducesTrianglesTowardsTheTarget) {
+    Grid grid(32, 0.1f);
+    zvlk::MeshSimplifier simplifier(grid.vertices, grid.indices, grid.parts);
+    for (const zvlk::ModelPart& part : grid.parts) {
+        float previousError = 0.0f;
+        size_t previousSize = part.numberOfIndices;
+        for (float ratio : {0.5f, 0.25f, 0.1f}) {
+            float error = -1.0f;
+            std::vector<uint32_t> simplified = simplifier.simplify(part, static_cast<size_t> (part.numberOfIndices * ratio), error);
+            checkValid(grid, part, simplified);
+            BOOST_CHECK_LT(simplified.size(), previousSize);
+            // coarser levels move the surface further
+            BOOST_CHECK_GE(error, previousError);
+            previousSize = simplified.size();
+            previousError = error;
+        }
+        BOOST_CHECK_LE(previousSize, part.numberOfIndices / 4);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(keepsVerticesSharedBetweenParts) {
+    Grid grid(32, 0.1f);
+    zvlk::MeshSimplifier simplifier(grid.vertices, grid.indices, grid.parts);
+    std::set<uint32_t> first = grid.used(grid.parts[0]), second = grid.used(grid.parts[1]), shared;
+    for (uint32_t vertex : first) {
+        if (second.count(vertex)) {
+            shared.insert(vertex);
+        }
+    }
+    BOOST_REQUIRE(!shared.empty());
+
+    for (const zvlk::ModelPart& part : grid.parts) {
+        float error;
+        std::vector<uint32_t> simplified = simplifier.simplify(part, part.numberOfIndices / 10, error);
+        std::set<uint32_t> used(simplified.begin(), simplified.end());
+        for (uint32_t vertex : shared) {
+            BOOST_CHECK(used.count(vertex));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(movesSeamVerticesTogether) {
+    Grid grid(32, 0.1f);
+    zvlk::MeshSimplifier simplifier(grid.vertices, grid.indices, grid.parts);
+    for (const zvlk::ModelPart& part : grid.parts) {
+        float error;
+        std::vector<uint32_t> simplified = simplifier.simplify(part, part.numberOfIndices / 10, error);
+        std::set<uint32_t> used(simplified.begin(), simplified.end()), original = grid.used(part);
+        // a seam position left on one side is left on the other, so the texture seam does not open
+        for (size_t j = 0; j < grid.seam.size(); ++j) {
+            if (original.count(grid.seam[j])) {
+                BOOST_CHECK_EQUAL(used.count(grid.seam[j]), used.count(grid.seamSiblings[j]));
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(simplifiesFlatSurfacesWithoutError) {
+    Grid grid(32, 0.0f);
+    zvlk::MeshSimplifier simplifier(grid.vertices, grid.indices, grid.parts);
+    for (const zvlk::ModelPart& part : grid.parts) {
+        float error;
+        std::vector<uint32_t> simplified = simplifier.simplify(part, part.numberOfIndices / 10, error);
+        checkValid(grid, part, simplified);
+        BOOST_CHECK_LE(simplified.size(), part.numberOfIndices / 4);
+        BOOST_CHECK_SMALL(error, 1e-4f);
+        // facing up as all the original triangles, none turned over or flattened to a line
+        for (size_t i = 0; i < simplified.size(); i += 3) {
+            glm::vec3 a = grid.vertices[simplified[i]].position, b = grid.vertices[simplified[i + 1]].position;
+            glm::vec3 c = grid.vertices[simplified[i + 2]].position;
+            BOOST_CHECK_GT(glm::cross(b - a, c - a).z, 0.0f);
+        }
+        // the borders stay where they were, so the part covers the same area
+        std::vector<uint32_t> original(grid.indices.begin() + part.indexOffset, grid.indices.begin() + part.indexOffset + part.numberOfIndices);
+        BOOST_CHECK_CLOSE(area(grid, simplified), area(grid, original), 0.1f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(keepsPartsAtOrBelowTheTarget) {
+    Grid grid(8, 0.1f);
+    zvlk::MeshSimplifier simplifier(grid.vertices, grid.indices, grid.parts);
+    const zvlk::ModelPart& part = grid.parts[0];
+    float error = -1.0f;
+    std::vector<uint32_t> simplified = simplifier.simplify(part, part.numberOfIndices, error);
+    std::vector<uint32_t> original(grid.indices.begin() + part.indexOffset, grid.indices.begin() + part.indexOffset + part.numberOfIndices);
+    BOOST_CHECK(simplified == original);
+    BOOST_CHECK_EQUAL(error, 0.0f);
+}
@@ -0,0 +1,133 @@
+/*
+ * File:   MipmapBenchmark.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 20 października 2026, 02:00
+ */
+
+#include "Vulkan.h"
+#include "Window.h"
+#include "Device.h"
+#include "MipmapGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// builds the mip chains of square RGBA textures (256 to 4096 texels by default) with the compute
+// shader and with the chain of blits, best of the repetitions of recording, submitting and waiting
+// for one command buffer; run from the directory with mipmap.spv, lavapipe is used when present
+#define REPETITIONS 10
+#define PREFERRED_DEVICE "llvmpipe"
+
+namespace {
+
+    class Application : public zvlk::WindowCallback, public zvlk::DeviceAssessment {
+    public:
+
+        void resize(int width, int height) override {
+        }
+
+        void key(int key, int action, int mods) override {
+        }
+
+        int assess(zvlk::Device* device) override {
+            if (!this->vulkan->doesDeviceSupportExtensions(device) || !this->vulkan->doesDeviceSupportGraphics(device)) {
+                return 0;
+            }
+            return std::string(device->getProperties().deviceName).find(PREFERRED_DEVICE) != std::string::npos ? 2 : 1;
+        }
+
+        zvlk::Vulkan* vulkan = nullptr;
+    };
+
+    // level 0 is uploaded again before every repetition, outside of the time measured
+    double best(zvlk::Device* device, const zvlk::MipmapTarget& target, vk::Buffer pixels, const std::function<void()>& generate) {
+        double result = 1e30;
+        for (int i = 0; i < REPETITIONS; ++i) {
+            device->transitionImageLayout(target.image, target.format, vk::ImageLayout::eUndefined, vk::ImageLayout::eTransferDstOptimal,
+                    target.mipLevels);
+            device->copyBufferToImage(pixels, target.image, target.width, target.height);
+            auto start = std::chrono::high_resolution_clock::now();
+            generate();
+            auto end = std::chrono::high_resolution_clock::now();
+            result = std::min(result, std::chrono::duration<double, std::chrono::milliseconds::period>(end - start).count());
+        }
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        std::vector<uint32_t> sizes;
+        for (int i = 1; i < argc; ++i) {
+            sizes.push_back(static_cast<uint32_t> (std::stoul(argv[i])));
+        }
+        if (sizes.empty()) {
+            sizes = {256, 512, 1024, 2048, 4096};
+        }
+
+        // the surface goes before the window does
+        Application application;
+        std::shared_ptr<zvlk::Window> window(new zvlk::Window(64, 64, std::string("Mipmap benchmark"), &application));
+        zvlk::Vulkan vulkan(false, std::string("Mipmap benchmark"));
+        application.vulkan = &vulkan;
+        vulkan.addSurface(window);
+        zvlk::Device* device = vulkan.getDevice(&application);
+        std::shared_ptr<zvlk::Frame> frame = vulkan.initializeDeviceForGraphics(device);
+        std::cout << "Device: " << device->getProperties().deviceName << std::endl;
+
+        zvlk::MipmapGenerator* generator = device->getMipmapGenerator();
+        for (uint32_t size : sizes) {
+            zvlk::MipmapTarget target = {vk::Image(), vk::Format::eR8G8B8A8Unorm, size, size,
+                static_cast<uint32_t> (std::floor(std::log2(size))) + 1};
+            std::string unsupported = generator->getUnsupportedReason(target.format, size, size);
+
+            std::vector<uint8_t> content(static_cast<size_t> (size) * size * 4);
+            for (size_t i = 0; i < content.size(); ++i) {
+                content[i] = static_cast<uint8_t> ((i * 2654435761u) >> 24);
+            }
+            vk::Buffer pixels;
+            vk::DeviceMemory pixelsMemory;
+            device->copyMemory(content.size(), content.data(), pixels, pixelsMemory);
+
+            vk::DeviceMemory imageMemory;
+            vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eSampled;
+            if (unsupported.empty()) {
+                usage |= vk::ImageUsageFlagBits::eStorage;
+            }
+            device->createImage(size, size, target.mipLevels, vk::SampleCountFlagBits::e1, target.format, vk::ImageTiling::eOptimal, usage,
+                    vk::MemoryPropertyFlagBits::eDeviceLocal, target.image, imageMemory);
+
+            double blit = best(device, target, pixels, [&]() {
+                generator->blit({target});
+            });
+            std::cout << std::setw(5) << size << "x" << std::left << std::setw(5) << size << std::right << std::setw(3) << target.mipLevels
+                    << " levels  blit " << std::fixed << std::setprecision(3) << std::setw(9) << blit << " ms";
+            if (unsupported.empty()) {
+                double compute = best(device, target, pixels, [&]() {
+                    generator->generate({target}, zvlk::MipmapFilter::eAverage, false);
+                });
+                std::cout << "  compute " << std::setw(9) << compute << " ms" << std::setprecision(2) << std::setw(7) << blit / compute << "x blit";
+            } else {
+                std::cout << "  compute skipped, " << unsupported;
+            }
+            std::cout << std::endl;
+
+            device->getGraphicsDevice().destroy(target.image);
+            device->getGraphicsDevice().freeMemory(imageMemory);
+            device->freeMemory(pixels, pixelsMemory);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
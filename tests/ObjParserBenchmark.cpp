@@ -0,0 +1,164 @@
+/*
+ * File:   ObjParserBenchmark.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 20 października 2026, 00:10
+ */
+
+#include "ObjParser.h"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// loads the given OBJ files (viking_room.obj and 64 copies of it in one file by default) with
+// tinyobjloader and the vertex deduplication Model did before the parser, then with the parser,
+// best of the repetitions with the page cache warm
+#define REPETITIONS 5
+#define SCRATCH "/tmp/zvlk-obj-benchmark"
+#define COPIES 64
+
+namespace {
+
+    // every material library is empty, the files come without theirs
+    class EmptyLibraries : public zvlk::Mount {
+    public:
+
+        bool exists(const std::string& name) override {
+            return std::filesystem::path(name).extension() == ".mtl";
+        }
+
+        zvlk::Blob read(const std::string& name) override {
+            return zvlk::Blob();
+        }
+
+        std::vector<std::string> list() override {
+            return {};
+        }
+    };
+
+    double best(const std::function<size_t()>& run, size_t& indices) {
+        double result = 1e30;
+        for (int i = 0; i < REPETITIONS; ++i) {
+            auto start = std::chrono::high_resolution_clock::now();
+            indices = run();
+            auto end = std::chrono::high_resolution_clock::now();
+            result = std::min(result, std::chrono::duration<double, std::chrono::milliseconds::period>(end - start).count());
+        }
+        return result;
+    }
+
+    void report(const std::string& path, const std::string& loader, uintmax_t size, size_t indices, double milliseconds, double baseline) {
+        std::cout << std::left << std::setw(48) << path << " " << std::setw(8) << loader << std::right << std::setw(10) << indices
+                << " indices" << std::fixed << std::setprecision(3) << std::setw(11) << milliseconds << " ms" << std::setprecision(1)
+                << std::setw(9) << size / milliseconds / 1000.0 << " MB/s" << std::setprecision(2) << std::setw(8)
+                << baseline / milliseconds << "x tinyobj" << std::endl;
+    }
+
+    size_t loadWithTinyObj(const std::string& path) {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+        std::string directory = std::filesystem::path(path).parent_path().string();
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, path.c_str(), directory.empty() ? "./" : (directory + "/").c_str())) {
+            throw std::runtime_error(warn + err);
+        }
+
+        std::vector<zvlk::Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::unordered_map<zvlk::Vertex, uint32_t> uniqueVertices;
+        for (const tinyobj::shape_t& shape : shapes) {
+            for (const tinyobj::index_t& index : shape.mesh.indices) {
+                zvlk::Vertex vertex{};
+                vertex.position = {attrib.vertices[3 * index.vertex_index + 0], attrib.vertices[3 * index.vertex_index + 1],
+                    attrib.vertices[3 * index.vertex_index + 2]};
+                vertex.texCoord = {0.0f, 1.0f};
+                if (index.texcoord_index >= 0) {
+                    vertex.texCoord = {attrib.texcoords[2 * index.texcoord_index + 0], 1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
+                }
+                if (index.normal_index >= 0) {
+                    vertex.normal = {attrib.normals[3 * index.normal_index + 0], attrib.normals[3 * index.normal_index + 1],
+                        attrib.normals[3 * index.normal_index + 2]};
+                }
+                auto unique = uniqueVertices.insert({vertex, static_cast<uint32_t> (vertices.size())});
+                if (unique.second) {
+                    vertices.push_back(vertex);
+                }
+                indices.push_back(unique.first->second);
+            }
+        }
+        return indices.size();
+    }
+
+    size_t loadWithParser(const std::string& path) {
+        zvlk::FileSystem fileSystem;
+        fileSystem.mount(std::make_unique<EmptyLibraries>());
+        std::string directory = std::filesystem::path(path).parent_path().string();
+        zvlk::ObjParser parser(fileSystem.read(path), &fileSystem, directory.empty() ? "" : directory + "/");
+        return parser.getIndices().size();
+    }
+
+    // the faces of the copies index the first one, which is enough to load
+    std::string repeat(const std::string& path, int copies) {
+        std::ifstream input(path, std::ios::in | std::ios::binary);
+        if (!input.is_open()) {
+            throw std::runtime_error("failed to open file " + path);
+        }
+        std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        std::string repeated = std::string(SCRATCH "/") + std::filesystem::path(path).stem().string() + "_x" + std::to_string(copies) + ".obj";
+        std::ofstream output(repeated, std::ios::out | std::ios::binary | std::ios::trunc);
+        for (int i = 0; i < copies; ++i) {
+            output << content;
+        }
+        return repeated;
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        std::vector<std::string> paths;
+        for (int i = 1; i < argc; ++i) {
+            paths.push_back(argv[i]);
+        }
+        if (paths.empty()) {
+            std::filesystem::create_directories(SCRATCH);
+            paths = {"viking_room.obj", repeat("viking_room.obj", COPIES)};
+        }
+
+        for (const std::string& path : paths) {
+            uintmax_t size = std::filesystem::file_size(path);
+            size_t tinyObjIndices, parserIndices;
+            double baseline = best([&]() {
+                return loadWithTinyObj(path);
+            }, tinyObjIndices);
+            report(path, "tinyobj", size, tinyObjIndices, baseline, baseline);
+            double milliseconds = best([&]() {
+                return loadWithParser(path);
+            }, parserIndices);
+            report(path, "parser", size, parserIndices, milliseconds, baseline);
+            if (parserIndices != tinyObjIndices) {
+                throw std::runtime_error(path + " has a different number of indices than tinyobjloader found");
+            }
+        }
+        std::filesystem::remove_all(SCRATCH);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,246 @@
+/*
+ * File:   ObjParserTest.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 23:40
+ */
+
+#define BOOST_TEST_MODULE ObjParser
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ObjParser.h"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    // files kept in memory, for the material libraries
+    class MemoryMount : public zvlk::Mount {
+    public:
+
+        MemoryMount(std::unordered_map<std::string, std::string> files) : files(std::move(files)) {
+        }
+
+        bool exists(const std::string& name) override {
+            return this->files.count(name) != 0;
+        }
+
+        zvlk::Blob read(const std::string& name) override {
+            auto file = this->files.find(name);
+            if (file == this->files.end()) {
+                return zvlk::Blob();
+            }
+            return zvlk::Blob(std::vector<uint8_t>(file->second.begin(), file->second.end()));
+        }
+
+        std::vector<std::string> list() override {
+            std::vector<std::string> names;
+            for (const auto& file : this->files) {
+                names.push_back(file.first);
+            }
+            return names;
+        }
+    private:
+        std::unordered_map<std::string, std::string> files;
+    };
+
+    struct Reference {
+        std::vector<zvlk::Vertex> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<zvlk::ObjRange> ranges;
+        std::vector<tinyobj::material_t> materials;
+    };
+
+    // what Model built from tinyobjloader before the parser, with polygons split into fans
+    Reference loadWithTinyObj(const std::string& obj, const std::string& mtl) {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        Reference reference;
+        std::string warn, err;
+        std::istringstream objStream(obj), mtlStream(mtl);
+        tinyobj::MaterialStreamReader materialReader(mtlStream);
+        if (!tinyobj::LoadObj(&attrib, &shapes, &reference.materials, &warn, &err, &objStream, &materialReader, false)) {
+            throw std::runtime_error(warn + err);
+        }
+
+        std::unordered_map<zvlk::Vertex, uint32_t> uniqueVertices;
+        for (const tinyobj::shape_t& shape : shapes) {
+            size_t first = 0;
+            for (size_t face = 0; face < shape.mesh.num_face_vertices.size(); ++face) {
+                size_t corners = shape.mesh.num_face_vertices[face];
+                for (size_t i = 1; i + 1 < corners; ++i) {
+                    int32_t material = shape.mesh.material_ids[face];
+                    if (reference.ranges.empty() || reference.ranges.back().material != material) {
+                        reference.ranges.push_back({material, static_cast<uint32_t> (reference.indices.size()), 0});
+                    }
+                    reference.ranges.back().numberOfIndices += 3;
+
+                    for (size_t corner : {first, first + i, first + i + 1}) {
+                        const tinyobj::index_t& index = shape.mesh.indices[corner];
+                        zvlk::Vertex vertex{};
+                        vertex.position = {attrib.vertices[3 * index.vertex_index + 0], attrib.vertices[3 * index.vertex_index + 1],
+                            attrib.vertices[3 * index.vertex_index + 2]};
+                        vertex.texCoord = {0.0f, 1.0f};
+                        if (index.texcoord_index >= 0) {
+                            vertex.texCoord = {attrib.texcoords[2 * index.texcoord_index + 0], 1.0f - attrib.texcoords[2 * index.texcoord_index + 1]};
+                        }
+                        if (index.normal_index >= 0) {
+                            vertex.normal = {attrib.normals[3 * index.normal_index + 0], attrib.normals[3 * index.normal_index + 1],
+                                attrib.normals[3 * index.normal_index + 2]};
+                        }
+                        auto unique = uniqueVertices.insert({vertex, static_cast<uint32_t> (reference.vertices.size())});
+                        if (unique.second) {
+                            reference.vertices.push_back(vertex);
+                        }
+                        reference.indices.push_back(unique.first->second);
+                    }
+                }
+                first += corners;
+            }
+        }
+        return reference;
+    }
+
+    void checkSame(zvlk::ObjParser& parser, const Reference& reference) {
+        BOOST_REQUIRE_EQUAL(parser.getVertices().size(), reference.vertices.size());
+        for (size_t i = 0; i < reference.vertices.size(); ++i) {
+            BOOST_REQUIRE(parser.getVertices()[i] == reference.vertices[i]);
+        }
+        BOOST_CHECK(parser.getIndices() == reference.indices);
+
+        BOOST_REQUIRE_EQUAL(parser.getRanges().size(), reference.ranges.size());
+        for (size_t i = 0; i < reference.ranges.size(); ++i) {
+            BOOST_CHECK_EQUAL(parser.getRanges()[i].material, reference.ranges[i].material);
+            BOOST_CHECK_EQUAL(parser.getRanges()[i].indexOffset, reference.ranges[i].indexOffset);
+            BOOST_CHECK_EQUAL(parser.getRanges()[i].numberOfIndices, reference.ranges[i].numberOfIndices);
+        }
+
+        BOOST_REQUIRE_EQUAL(parser.getMaterials().size(), reference.materials.size());
+        for (size_t i = 0; i < reference.materials.size(); ++i) {
+            const zvlk::ObjMaterial& material = parser.getMaterials()[i];
+            const tinyobj::material_t& expected = reference.materials[i];
+            BOOST_CHECK_EQUAL(material.name, expected.name);
+            BOOST_CHECK(material.ambient == glm::vec3(expected.ambient[0], expected.ambient[1], expected.ambient[2]));
+            BOOST_CHECK(material.diffuse == glm::vec3(expected.diffuse[0], expected.diffuse[1], expected.diffuse[2]));
+            BOOST_CHECK(material.specular == glm::vec3(expected.specular[0], expected.specular[1], expected.specular[2]));
+            BOOST_CHECK_EQUAL(material.shininess, expected.shininess);
+            BOOST_CHECK_EQUAL(material.diffuseTexture, expected.diffuse_texname);
+        }
+    }
+
+    zvlk::Blob blobOf(const std::string& content) {
+        return zvlk::Blob(std::vector<uint8_t>(content.begin(), content.end()));
+    }
+
+    const char* MATERIALS = "newmtl red\nKa 0.1 0 0\nKd 0.9 0.1 0.1\nKs 1 1 1\nNs 32\nmap_Kd -bm 0.5 red.png\n\n"
+            "newmtl green\r\nKd 0.1 0.9 0.1\r\nNs 8\r\n";
+
+    /*
+     * Strips of quads several megabytes long, so the file is split into chunks when there are
+     * threads for them. Positions and normals are indexed relative to the end of the file read
+     * so far and texture coordinates absolutely, faces mix the attributes they have and polygons
+     * of three to five corners, materials switch every few strips.
+     */
+    std::string strips(int rows, int columns) {
+        std::ostringstream obj;
+        obj << "# generated\nmtllib materials.mtl\n";
+        const char* materials[] = {"red", "green", "unknown"};
+        int texCoords = 0;
+        for (int row = 0; row < rows; ++row) {
+            if (row % 16 == 0) {
+                obj << "usemtl " << materials[row / 16 % 3] << "\n";
+            }
+            for (int c = 0; c <= columns; ++c) {
+                obj << "v " << c * 0.25f << " " << row * 0.5f << " " << (c % 3) * 1e-3f << "\n";
+                obj << "v " << c * 0.25f << " " << row * 0.5f + 0.5f << " " << (c % 5 + 1) * -0.125f << (c % 7 == 0 ? "\r\n" : "\n");
+                obj << "vt +" << c / float(columns) << " " << row % 2 << "\n";
+            }
+            obj << "vn 0 0 1\n";
+            int count = 2 * (columns + 1);
+            for (int c = 0; c < columns; ++c) {
+                int bottom = 2 * c - count, top = bottom + 1, nextBottom = bottom + 2, nextTop = bottom + 3;
+                int tc = texCoords + c + 1;
+                switch (c % 4) {
+                    case 0:
+                        // over two columns
+                        obj << "f " << bottom << " " << nextBottom << " " << nextBottom + 2 << " " << nextTop + 2 << " " << top << "\n";
+                        break;
+                    case 1:
+                        obj << "f " << bottom << "/" << tc << " " << nextBottom << "/" << tc + 1 << " " << nextTop << "/" << tc + 1
+                                << " " << top << "/" << tc << "\n";
+                        break;
+                    case 2:
+                        obj << "f " << bottom << "//-1 " << nextBottom << "//-1 " << nextTop << "//-1\n";
+                        obj << "f " << bottom << "//-1 " << nextTop << "//-1 " << top << "//-1\n";
+                        break;
+                    default:
+                        obj << "f " << bottom << "/" << tc << "/-1 " << nextBottom << "/" << tc + 1 << "/-1 " << nextTop << "/"
+                                << tc + 1 << "/-1 " << top << "/" << tc << "/-1\n";
+                }
+            }
+            texCoords += columns + 1;
+        }
+        return obj.str();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(matchesTinyObjOnVikingRoom) {
+    const std::string materials = "newmtl Texture1\nNs 10\nKa 1 1 1\nKd 0.8 0.8 0.8\nKs 0.5 0.5 0.5\nmap_Kd viking_room.png\n";
+    zvlk::FileSystem fileSystem;
+    fileSystem.mount(std::make_unique<MemoryMount>(std::unordered_map<std::string, std::string>{
+        {"viking_room.mtl", materials}
+    }));
+    zvlk::Blob content = fileSystem.read("viking_room.obj");
+    zvlk::ObjParser parser(content, &fileSystem, "");
+
+    Reference reference = loadWithTinyObj(std::string(reinterpret_cast<const char*> (content.getData()), content.getSize()), materials);
+    BOOST_CHECK_EQUAL(reference.indices.size(), 3u * 3828u);
+    checkSame(parser, reference);
+}
+
+BOOST_AUTO_TEST_CASE(matchesTinyObjAcrossChunks) {
+    std::string obj = strips(800, 64);
+    BOOST_REQUIRE_GT(obj.size(), 4u << 20);
+    zvlk::FileSystem fileSystem;
+    fileSystem.mount(std::make_unique<MemoryMount>(std::unordered_map<std::string, std::string>{
+        {"assets/materials.mtl", MATERIALS}
+    }));
+    zvlk::ObjParser parser(blobOf(obj), &fileSystem, "assets/");
+    checkSame(parser, loadWithTinyObj(obj, MATERIALS));
+}
+
+BOOST_AUTO_TEST_CASE(readsMaterialOptionsAndDuplicates) {
+    const std::string materials = std::string(MATERIALS) + "newmtl red\nKd 0 0 0\n";
+    const std::string obj = "mtllib materials.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl red\nf 1 2 3\nusemtl nothing\nf 1 2 3\n";
+    zvlk::FileSystem fileSystem;
+    fileSystem.mount(std::make_unique<MemoryMount>(std::unordered_map<std::string, std::string>{
+        {"materials.mtl", materials}
+    }));
+    zvlk::ObjParser parser(blobOf(obj), &fileSystem, "");
+
+    BOOST_REQUIRE_EQUAL(parser.getMaterials().size(), 3u);
+    BOOST_CHECK_EQUAL(parser.getMaterials()[0].diffuseTexture, "red.png");
+    // the first material of a name is used, unknown ones leave the faces without a material
+    BOOST_REQUIRE_EQUAL(parser.getRanges().size(), 2u);
+    BOOST_CHECK_EQUAL(parser.getRanges()[0].material, 0);
+    BOOST_CHECK_EQUAL(parser.getRanges()[1].material, -1);
+    BOOST_CHECK_EQUAL(parser.getVertices().size(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(rejectsMalformedFaces) {
+    zvlk::FileSystem fileSystem;
+    for (const char* obj : {"v 0 0 0\nf 1 2 3\n", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/4 2 3\n",
+        "v 0 0 x\n"}) {
+        BOOST_CHECK_THROW(zvlk::ObjParser(blobOf(obj), &fileSystem, ""), std::runtime_error);
+    }
+}
@@ -0,0 +1,207 @@
+/*
+ * File:   PackBenchmark.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 23:20
+ */
+
+#include "FileSystem.h"
+#include "Pack.h"
+
+#include <zip.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// loads every file of the given archives (ball.zip and room.zip by default) the way the
+// application did before the file system, extracting them with libzip to /tmp and reading
+// the copies, then from the archives mounted in memory and from packs built of the same
+// files, best of the repetitions with the page cache warm
+#define REPETITIONS 5
+#define SCRATCH "/tmp/zvlk-pack-benchmark"
+
+namespace {
+
+    double best(const std::function<size_t()>& run, size_t& bytes) {
+        double result = 1e30;
+        for (int i = 0; i < REPETITIONS; ++i) {
+            auto start = std::chrono::high_resolution_clock::now();
+            bytes = run();
+            auto end = std::chrono::high_resolution_clock::now();
+            result = std::min(result, std::chrono::duration<double, std::chrono::milliseconds::period>(end - start).count());
+        }
+        return result;
+    }
+
+    void report(const std::string& flow, size_t bytes, double milliseconds, double baseline) {
+        std::cout << std::left << std::setw(20) << flow << std::right << std::setw(12) << bytes << " B" << std::fixed
+                << std::setprecision(3) << std::setw(11) << milliseconds << " ms" << std::setprecision(1) << std::setw(9)
+                << bytes / milliseconds / 1000.0 << " MB/s" << std::setprecision(2) << std::setw(8) << baseline / milliseconds
+                << "x zip + /tmp" << std::endl;
+    }
+
+    // the former inflateModel, for every file of the archive, followed by reading the copies back
+    size_t extractAndRead(const std::vector<std::string>& archives) {
+        size_t bytes = 0;
+        std::vector<std::string> extracted;
+        for (const std::string& path : archives) {
+            int error;
+            zip_t* archive = zip_open(path.c_str(), ZIP_RDONLY, &error);
+            if (!archive) {
+                throw std::runtime_error("failed to open archive " + path);
+            }
+            zip_int64_t entries = zip_get_num_entries(archive, 0);
+            for (zip_int64_t i = 0; i < entries; ++i) {
+                zip_stat_t stat;
+                if (zip_stat_index(archive, i, 0, &stat) != 0 || stat.name[std::strlen(stat.name) - 1] == '/') {
+                    continue;
+                }
+                zip_file_t* file = zip_fopen_index(archive, i, 0);
+                std::vector<char> buffer(stat.size);
+                zip_fread(file, buffer.data(), buffer.size());
+                zip_fclose(file);
+
+                std::string destination = std::string(SCRATCH "/extracted/") + std::filesystem::path(stat.name).filename().string();
+                std::ofstream output(destination, std::ios::out | std::ios::binary);
+                output.write(buffer.data(), buffer.size());
+                extracted.push_back(destination);
+            }
+            zip_discard(archive);
+        }
+        for (const std::string& path : extracted) {
+            std::ifstream input(path, std::ios::in | std::ios::binary);
+            std::vector<char> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+            bytes += content.size();
+        }
+        return bytes;
+    }
+
+    size_t readAll(zvlk::FileSystem& fileSystem, const std::vector<std::string>& names) {
+        size_t bytes = 0;
+        for (const std::string& name : names) {
+            bytes += fileSystem.read(name).getSize();
+        }
+        return bytes;
+    }
+
+    std::vector<std::string> namesOf(const std::vector<std::string>& archives) {
+        zvlk::FileSystem fileSystem;
+        std::vector<std::string> names;
+        for (const std::string& archive : archives) {
+            for (const std::string& name : fileSystem.mountArchive(archive)->list()) {
+                if (name.back() != '/') {
+                    names.push_back(name);
+                }
+            }
+        }
+        return names;
+    }
+
+    void writePack(const std::string& path, const std::vector<std::string>& archives, zvlk::PackCompression compression) {
+        zvlk::FileSystem inputs;
+        zvlk::PackWriter writer;
+        for (const std::string& archive : archives) {
+            zvlk::Mount* mount = inputs.mountArchive(archive);
+            for (const std::string& name : mount->list()) {
+                if (name.back() != '/') {
+                    writer.add(name, mount->read(name), compression);
+                }
+            }
+        }
+        writer.write(path);
+    }
+
+    uintmax_t sizeOf(const std::vector<std::string>& archives) {
+        uintmax_t size = 0;
+        for (const std::string& archive : archives) {
+            size += std::filesystem::file_size(archive);
+        }
+        return size;
+    }
+
+    // every file read from the pack has the bytes it has in the archives
+    void verify(const std::string& pack, const std::vector<std::string>& archives, const std::vector<std::string>& names) {
+        zvlk::FileSystem zips, packed;
+        for (const std::string& archive : archives) {
+            zips.mountArchive(archive);
+        }
+        packed.mountPack(pack);
+        for (const std::string& name : names) {
+            zvlk::Blob expected = zips.read(name), actual = packed.read(name);
+            if (expected.getSize() != actual.getSize() || std::memcmp(expected.getData(), actual.getData(), expected.getSize()) != 0) {
+                throw std::runtime_error(name + " differs in " + pack);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> archives;
+    for (int i = 1; i < argc; ++i) {
+        archives.push_back(argv[i]);
+    }
+    if (archives.empty()) {
+        archives = {"ball.zip", "room.zip"};
+    }
+
+    try {
+        std::filesystem::create_directories(SCRATCH "/extracted");
+        std::vector<std::string> names = namesOf(archives);
+        writePack(SCRATCH "/stored.pack", archives, zvlk::PackCompression::eNone);
+        writePack(SCRATCH "/lz4.pack", archives, zvlk::PackCompression::eLz4);
+        verify(SCRATCH "/stored.pack", archives, names);
+        verify(SCRATCH "/lz4.pack", archives, names);
+        std::cout << names.size() << " files, zip " << sizeOf(archives) << " B, stored pack "
+                << std::filesystem::file_size(SCRATCH "/stored.pack") << " B, LZ4 pack " << std::filesystem::file_size(SCRATCH "/lz4.pack") << " B" << std::endl;
+
+        size_t bytes;
+        double baseline = best([&]() {
+            return extractAndRead(archives);
+        }, bytes);
+        report("zip + /tmp", bytes, baseline, baseline);
+
+        double milliseconds = best([&]() {
+            zvlk::FileSystem fileSystem;
+            for (const std::string& archive : archives) {
+                fileSystem.mountArchive(archive);
+            }
+            return readAll(fileSystem, names);
+        }, bytes);
+        report("zip mount", bytes, milliseconds, baseline);
+
+        for (const char* pack : {"stored.pack", "lz4.pack"}) {
+            std::string path = std::string(SCRATCH "/") + pack;
+            milliseconds = best([&]() {
+                zvlk::FileSystem fileSystem;
+                fileSystem.mountPack(path);
+                return readAll(fileSystem, names);
+            }, bytes);
+            report(pack, bytes, milliseconds, baseline);
+
+            // as at startup, decompressed in parallel ahead of the reads
+            milliseconds = best([&]() {
+                zvlk::FileSystem fileSystem;
+                fileSystem.mountPack(path);
+                fileSystem.prefetch(names);
+                return readAll(fileSystem, names);
+            }, bytes);
+            report(std::string(pack) + " prefetch", bytes, milliseconds, baseline);
+        }
+        std::filesystem::remove_all(SCRATCH);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/*
+ * File:   SceneGraphTest.cpp
+ * Author: Michał Żelechowski <MichalZelechowski@github.com>
+ *
+ * Created on 19 października 2026, 21:30
+ */
+
+#define BOOST_TEST_MODULE SceneGraph
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "SceneGraph.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/matrix.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    glm::mat4 randomLocal(std::mt19937& random) {
+        std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+        std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+        std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+        glm::mat4 local = glm::translate(glm::mat4(1.0f), glm::vec3(offset(random), offset(random), offset(random)));
+        local = glm::rotate(local, angle(random), glm::vec3(0.3f, 1.0f, -0.2f));
+        return glm::scale(local, glm::vec3(scale(random), scale(random), scale(random)));
+    }
+
+    void checkClose(const glm::mat4& actual, const glm::mat4& expected) {
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                BOOST_CHECK_SMALL(actual[c][r] - expected[c][r], 1e-3f * (1.0f + std::fabs(expected[c][r])));
+            }
+        }
+    }
+
+    glm::mat4 normalOf(const glm::mat4& world) {
+        return glm::mat4(glm::transpose(glm::inverse(glm::mat3(world))));
+    }
+
+    // random forest built with the graph and mirrored by plain parent links
+    struct Forest {
+        zvlk::SceneGraph graph;
+        std::vector<zvlk::SceneNode> nodes;
+        std::vector<size_t> parents;
+        std::vector<glm::mat4> locals;
+
+        Forest(size_t count, uint32_t seed) {
+            std::mt19937 random(seed);
+            for (size_t i = 0; i < count; ++i) {
+                // every eighth node is a root, the others hang under any earlier node
+                size_t parent = i % 8 == 0 ? SIZE_MAX : std::uniform_int_distribution<size_t>(0, i - 1)(random);
+                zvlk::SceneNode node = this->graph.addNode(parent == SIZE_MAX ? zvlk::NO_SCENE_NODE : this->nodes[parent]);
+                glm::mat4 local = randomLocal(random);
+                this->graph.setLocal(node, local);
+                this->nodes.push_back(node);
+                this->parents.push_back(parent);
+                this->locals.push_back(local);
+            }
+        }
+
+        glm::mat4 world(size_t i) const {
+            glm::mat4 result = this->locals[i];
+            for (size_t parent = this->parents[i]; parent != SIZE_MAX; parent = this->parents[parent]) {
+                result = this->locals[parent] * result;
+            }
+            return result;
+        }
+
+        void check() const {
+            for (size_t i = 0; i < this->nodes.size(); ++i) {
+                glm::mat4 expected = this->world(i);
+                checkClose(this->graph.getWorld(this->nodes[i]), expected);
+                checkClose(this->graph.getNormal(this->nodes[i]), normalOf(expected));
+            }
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(propagatesToDescendants) {
+    Forest forest(200, 1);
+    forest.graph.update();
+    forest.check();
+}
+
+BOOST_AUTO_TEST_CASE(propagatesInParallel) {
+    // above the threshold of dirty nodes the update is split between workers
+    Forest forest(20000, 2);
+    forest.graph.update();
+    forest.check();
+}
+
+BOOST_AUTO_TEST_CASE(updatesOnlyChangedSubtrees) {
+    Forest forest(500, 3);
+    forest.graph.update();
+
+    std::mt19937 random(4);
+    for (size_t i = 0; i < forest.nodes.size(); i += 7) {
+        forest.locals[i] = randomLocal(random);
+        forest.graph.setLocal(forest.nodes[i], forest.locals[i]);
+    }
+    forest.graph.update();
+    forest.check();
+}
+
+BOOST_AUTO_TEST_CASE(reparentsChildrenOfRemovedNodes) {
+    zvlk::SceneGraph graph;
+    zvlk::SceneNode root = graph.addNode();
+    zvlk::SceneNode middle = graph.addNode(root);
+    zvlk::SceneNode leaf = graph.addNode(middle);
+    glm::mat4 rootLocal = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    glm::mat4 middleLocal = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 2.0f, 0.0f));
+    glm::mat4 leafLocal = glm::scale(glm::mat4(1.0f), glm::vec3(3.0f));
+    graph.setLocal(root, rootLocal);
+    graph.setLocal(middle, middleLocal);
+    graph.setLocal(leaf, leafLocal);
+    graph.update();
+    checkClose(graph.getWorld(leaf), rootLocal * middleLocal * leafLocal);
+
+    graph.removeNode(middle);
+    graph.update();
+    BOOST_CHECK_EQUAL(graph.getNodesNumber(), 2u);
+    checkClose(graph.getWorld(leaf), rootLocal * leafLocal);
+
+    // the freed handle is reused
+    BOOST_CHECK_EQUAL(graph.addNode(leaf), middle);
+}
+
+BOOST_AUTO_TEST_CASE(rejectsRemovedParents) {
+    zvlk::SceneGraph graph;
+    zvlk::SceneNode root = graph.addNode();
+    zvlk::SceneNode removed = graph.addNode(root);
+    graph.removeNode(removed);
+
+    // before and after the update which drops its slot
+    BOOST_CHECK_THROW(graph.addNode(removed), std::invalid_argument);
+    graph.update();
+    BOOST_CHECK_THROW(graph.addNode(removed), std::invalid_argument);
+    BOOST_CHECK_THROW(graph.setParent(root, removed), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(rejectsCycles) {
+    zvlk::SceneGraph graph;
+    zvlk::SceneNode root = graph.addNode();
+    zvlk::SceneNode child = graph.addNode(root);
+    BOOST_CHECK_THROW(graph.setParent(root, child), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(movesSubtreesToNewParents) {
+    zvlk::SceneGraph graph;
+    zvlk::SceneNode first = graph.addNode();
+    zvlk::SceneNode second = graph.addNode();
+    zvlk::SceneNode child = graph.addNode(first);
+    glm::mat4 firstLocal = glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    glm::mat4 secondLocal = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, 5.0f));
+    graph.setLocal(first, firstLocal);
+    graph.setLocal(second, secondLocal);
+    graph.update();
+    checkClose(graph.getWorld(child), firstLocal);
+
+    graph.setParent(child, second);
+    graph.update();
+    checkClose(graph.getWorld(child), secondLocal);
+}